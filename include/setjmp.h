@@ -19,6 +19,8 @@
  * [2] - saved bp (base pointer)
  * [3] - saved ax (accumulator)
  * [4] - reserved for future use
+ * [5..12] - saved callee-saved registers (s0-s7), which hold locals the
+ *            compiler keeps in registers
  *
  * Implementation Strategy:
  * setjmp and longjmp are implemented using dedicated VM instructions:
@@ -59,11 +61,11 @@
 /*
  * jmp_buf type: execution context buffer
  *
- * Array of 5 long long values to hold VM state:
+ * Array of 13 long long values to hold VM state:
  * - Alignment: 8 bytes (natural alignment of long long)
- * - Size: 40 bytes total (5 * 8 bytes)
+ * - Size: 104 bytes total (13 * 8 bytes)
  */
-typedef long long jmp_buf[5];
+typedef long long jmp_buf[13];
 
 /*
  * setjmp(env) - Save execution context
@@ -19,239 +19,465 @@
 
 #include "jcc.h"
 #include "./internal.h"
+#include <limits.h>
+#ifdef __APPLE__
+#include <mach-o/dyld.h>
+#endif
 
-// Bytecode file format (V1 - register-based VM):
+// Bytecode file format (V4 - register-based VM, compact text):
 //   Magic: "JCC\0" (4 bytes)
-//   Version: 1 (4 bytes)
+//   Version: 4 (4 bytes)
 //   Flags: JCCFlags bitfield (4 bytes)
-//   Text size: size in bytes (8 bytes)
+//   Text words: size of the decoded text segment in 64-bit words (8 bytes)
+//   Text size: size of the compact text in bytes (8 bytes)
 //   Data size: size in bytes (8 bytes)
 //   Main offset: instruction index of main() (8 bytes)
-//   Text segment: bytecode (text_size bytes)
+//   FFI count: entries in the FFI table (8 bytes)
+//   Relocation count: entries in the relocation table (8 bytes)
+//   Opcode hash: opcode_table_hash() of the jcc that saved it (8 bytes)
+//   Text segment: compact encoding (text_size bytes)
 //   Data segment: global data (data_size bytes)
+//   FFI table: per function the name length (4 bytes), the name, num_args,
+//     returns_double, is_variadic, num_fixed_args (4 bytes each) and
+//     double_arg_mask (8 bytes)
+//   Relocations: text_seg word index << 1 | RELOC_DATA/RELOC_TEXT (8 bytes
+//     each) of LI3 immediates holding a data or text address
+// Older versions, and files whose opcode hash differs, were saved for
+// another instruction set and are rejected.
+//
+// Executables saved by cc_save_executable() are a copy of the running jcc
+// binary followed by a bytecode image and a trailer: the image size and
+// JCC_EXEC_MAGIC (8 bytes each).
+//
+// Compact text encoding. text_seg keeps one 64-bit word per opcode and
+// operand; on disk each instruction starts with one 32-bit word
+//   [op:8][R:1][rd:5][rs1:5][rs2:5][imm:8]
+// R is set when the first operand is a register word (every field below 32),
+// which is then packed into rd/rs1/rs2. The next operand is inlined in imm
+// when it fits in [-127, 127]; imm == -128 means it follows as an extension
+// like every later operand does: one word holding value << 1 if the value
+// fits in 31 bits, otherwise the word 1 followed by the 64-bit value as two
+// words (low half first). vm_insn_size() gives the operand count, and jump
+// and call targets are stored as text_seg word indices. Opcode 0xFF marks a
+// word that does not decode to an instruction, stored as one extension.
 
-// Helper: get the number of operand words consumed by an opcode
-// Returns 0 for simple opcodes, 1 for RRR/RR format, 2 for RI format or special
-static int get_opcode_operand_count(int op) {
-    switch (op) {
-        // Control flow with address operand (1 word)
-        case JMP:
-        case CALL:
-            return 1;
-        
-        // Control flow with register + address (2 words: [rs] [target])
-        case JZ3:
-        case JNZ3:
-            return 2;
-        
-        // RI format: [rd] [immediate] (2 words)
-        case LI3:
-        case LEA3:
-            return 2;
-        
-        // RRI format: [rd|rs] [immediate] (2 words)
-        case ADDI3:
-        case CHKA3:
-        case CHKT3:
-            return 2;
-        
-        // ENT3: [stack_size|param_count] [float_param_mask] (2 words)
-        case ENT3:
-            return 2;
-        
-        // ADJ has 1 immediate operand
-        case ADJ:
-            return 1;
-        
-        // JMPT (jump table): [table_addr] [count] [default_addr] (3 words)
-        case JMPT:
-            return 3;
-        
-        // RRR format: [rd|rs1|rs2] (1 word)
-        case ADD3: case SUB3: case MUL3: case DIV3: case MOD3:
-        case AND3: case OR3: case XOR3: case SHL3: case SHR3:
-        case SEQ3: case SNE3: case SLT3: case SGE3: case SGT3: case SLE3:
-        case MOV3:
-        case FADD3: case FSUB3: case FMUL3: case FDIV3:
-        case FEQ3: case FNE3: case FLT3: case FLE3: case FGT3: case FGE3:
-            return 1;
-        
-        // RR format: [rd|rs] (1 word)
-        case NEG3: case NOT3: case BNOT3:
-        case LDR_B: case LDR_H: case LDR_W: case LDR_D:
-        case STR_B: case STR_H: case STR_W: case STR_D:
-        case FLDR: case FSTR:
-        case FNEG3:
-        case I2F3: case F2I3: case FR2R: case R2FR:
-        case SX1: case SX2: case SX4: case ZX1: case ZX2: case ZX4:
-        case CHKP3:
-            return 1;
-        
-        // R format: [rs] (1 word)
-        case PSH3: case POP3:
-        case CALLI: case JMPI:
-            return 1;
-        
-        // CALLF: [ffi_index] [arg_count] (2 words)
-        case CALLF:
-            return 2;
-        
-        // Memory ops: varying operand counts
-        case MALC: case MFRE: case MCPY: case REALC: case CALC:
-            return 1;  // These use register conventions, 1 operand word for register encoding
-        
-        // Safety/debug opcodes with operands
-        case CHKB: case CHKI: case MARKI: case MARKA: case CHKPA: case MARKP:
-        case SCOPEIN: case SCOPEOUT: case CHKL: case MARKR: case MARKW:
-            return 1;
-        
-        // SETJMP/LONGJMP: [buf_reg] [val_reg] (1 word RR format)
-        case SETJMP: case LONGJMP:
-            return 1;
-        
-        // Zero operand opcodes
-        case LEV3:
-        case RETBUF:
-            return 0;
-        
-        default:
-            return 0;  // Unknown - assume no operands
+#define JCC_EXEC_MAGIC "JCCEXEC\0"
+#define JCC_EXEC_TRAILER 16
+
+#define JCC_BYTECODE_VERSION 4
+
+// FNV-1a hash of the opcode names in OPS_X order. Adding, removing or
+// reordering an opcode renumbers the ones after it, so bytecode is only
+// loaded by a jcc with the same table.
+uint64_t opcode_table_hash(void) {
+    static const char *names[] = {
+#define X(NAME) #NAME,
+        OPS_X
+#undef X
+    };
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        for (const char *c = names[i];; c++) {
+            hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+            if (!*c)
+                break;
+        }
     }
+    return hash;
 }
 
-// Helper: check if an opcode has an address operand that needs relocation
-static int opcode_has_address(int op) {
-    return (op == JMP || op == CALL || op == JZ3 || op == JNZ3);
-}
+#define COMPACT_RAW 0xFF
+#define COMPACT_EXT (-128)
+#define COMPACT_REG_MASK 0x1F1F1FLL
+
+typedef struct {
+    uint32_t *words;
+    long long len;
+    long long capacity;
+} CompactText;
 
-// Helper: get the operand index (0-based) that contains the address
-static int get_address_operand_index(int op) {
-    switch (op) {
-        case JMP:
-        case CALL:
-            return 0;  // First operand is address
-        case JZ3:
-        case JNZ3:
-            return 1;  // Second operand is address (first is register)
-        default:
+static int compact_push(CompactText *out, uint32_t word) {
+    if (out->len == out->capacity) {
+        long long capacity = out->capacity ? out->capacity * 2 : 1024;
+        uint32_t *words = realloc(out->words, capacity * sizeof(uint32_t));
+        if (!words)
             return -1;
+        out->words = words;
+        out->capacity = capacity;
     }
+    out->words[out->len++] = word;
+    return 0;
 }
 
-int cc_save_bytecode(JCC *vm, const char *path) {
-    if (!vm || !path) {
-        fprintf(stderr, "error: invalid arguments to cc_save_bytecode\n");
+static int compact_push_ext(CompactText *out, long long value) {
+    if (value >= -(1LL << 30) && value < (1LL << 30))
+        return compact_push(out, (uint32_t)value << 1);
+    if (compact_push(out, 1) != 0 ||
+        compact_push(out, (uint32_t)value) != 0 ||
+        compact_push(out, (uint32_t)((unsigned long long)value >> 32)) != 0)
         return -1;
+    return 0;
+}
+
+// Encode text_seg[1..count) (targets already converted to word indices)
+static int compact_encode(const long long *text, long long count,
+                          CompactText *out) {
+    for (long long i = 1; i < count;) {
+        long long op = text[i];
+        int len = (op >= 0 && op < NUM_OPS) ? vm_insn_size((int)op) : 0;
+        if (len == 0 || i + len > count) {
+            if (compact_push(out, COMPACT_RAW) != 0 ||
+                compact_push_ext(out, op) != 0)
+                return -1;
+            i++;
+            continue;
+        }
+
+        const long long *operand = &text[i + 1];
+        const long long *operand_end = &text[i + len];
+        uint32_t word = (uint32_t)op;
+        if (operand < operand_end && (*operand & ~COMPACT_REG_MASK) == 0) {
+            word |= 1u << 8;
+            word |= (uint32_t)(*operand & 0x1F) << 9;
+            word |= (uint32_t)((*operand >> 8) & 0x1F) << 14;
+            word |= (uint32_t)((*operand >> 16) & 0x1F) << 19;
+            operand++;
+        }
+        bool inline_imm = operand < operand_end && *operand > COMPACT_EXT &&
+                          *operand <= 127;
+        if (inline_imm)
+            word |= (uint32_t)(*operand++ & 0xFF) << 24;
+        else
+            word |= (uint32_t)(COMPACT_EXT & 0xFF) << 24;
+
+        if (compact_push(out, word) != 0)
+            return -1;
+        for (; operand < operand_end; operand++) {
+            if (compact_push_ext(out, *operand) != 0)
+                return -1;
+        }
+        i += len;
     }
-    
-    if (!vm->text_seg || !vm->data_seg) {
-        fprintf(stderr, "error: no bytecode to save (compile first)\n");
+    return 0;
+}
+
+// Read one extension operand at *pos, or return -1 past the end
+static int compact_read_ext(const uint32_t *words, long long count,
+                            long long *pos, long long *value) {
+    if (*pos >= count)
         return -1;
+    uint32_t word = words[(*pos)++];
+    if (!(word & 1)) {
+        *value = (int32_t)word >> 1;
+        return 0;
     }
-    
-    FILE *f = fopen(path, "wb");
-    if (!f) {
-        fprintf(stderr, "error: failed to open %s for writing: %s\n", path, strerror(errno));
+    if (*pos + 2 > count)
         return -1;
+    unsigned long long lo = words[*pos], hi = words[*pos + 1];
+    *value = (long long)(lo | (hi << 32));
+    *pos += 2;
+    return 0;
+}
+
+// Decode into text[1..), returning the number of text_seg words used
+// (including text[0]) or -1 if the encoding is malformed or exceeds capacity
+static long long compact_decode(const uint32_t *words, long long count,
+                                long long *text, long long capacity) {
+    long long n = 1;
+    for (long long pos = 0; pos < count;) {
+        uint32_t word = words[pos++];
+        int op = word & 0xFF;
+        if (op == COMPACT_RAW) {
+            if (n >= capacity ||
+                compact_read_ext(words, count, &pos, &text[n]) != 0)
+                return -1;
+            n++;
+            continue;
+        }
+        if (op >= NUM_OPS)
+            return -1;
+
+        int len = vm_insn_size(op);
+        if (n + len > capacity)
+            return -1;
+        long long *operand = &text[n + 1];
+        long long *operand_end = &text[n + len];
+        text[n] = op;
+        if ((word >> 8) & 1) {
+            if (operand == operand_end)
+                return -1;
+            *operand++ = ENCODE_RRR((word >> 9) & 0x1F, (word >> 14) & 0x1F,
+                                    (word >> 19) & 0x1F);
+        }
+        int imm = (int8_t)(word >> 24);
+        if (imm != COMPACT_EXT && operand < operand_end)
+            *operand++ = imm;
+        for (; operand < operand_end; operand++) {
+            if (compact_read_ext(words, count, &pos, operand) != 0)
+                return -1;
+        }
+        n += len;
     }
-    
+    return n;
+}
+
+// Where a relocated LI3 immediate points: into the data segment (stored as
+// a byte offset) or into the text segment (stored as a word index)
+#define RELOC_DATA 0
+#define RELOC_TEXT 1
+
+// Write the bytecode image of vm to f
+static int write_bytecode(JCC *vm, FILE *f) {
     // Calculate sizes
-    long long text_size = (vm->text_ptr - vm->text_seg + 1) * sizeof(long long);
+    long long text_words = vm->text_ptr - vm->text_seg + 1;
     long long data_size = vm->data_ptr - vm->data_seg;
     long long main_offset = vm->text_seg[0];  // main() instruction index
-    long long num_instructions = text_size / sizeof(long long);
     long long text_base = (long long)vm->text_seg;
-    long long text_end = text_base + text_size;
+    long long text_end = (long long)(vm->text_seg + text_words);
+    long long data_base = (long long)vm->data_seg;
+    long long *relocs = NULL;
+    long long reloc_count = 0;
+    CompactText compact = {0};
     
     // Create a copy of text segment for address conversion
-    long long *text_copy = malloc(text_size);
+    long long *text_copy = malloc(text_words * sizeof(long long));
     if (!text_copy) {
         fprintf(stderr, "error: failed to allocate temporary buffer\n");
-        fclose(f);
         return -1;
     }
-    memcpy(text_copy, vm->text_seg, text_size);
+    memcpy(text_copy, vm->text_seg, text_words * sizeof(long long));
     
-    // Mark which positions are operands (not opcodes)
-    char *is_operand = calloc(num_instructions, 1);
-    if (!is_operand) {
-        fprintf(stderr, "error: failed to allocate operand map\n");
-        free(text_copy);
-        fclose(f);
-        return -1;
-    }
+    // Convert absolute jump/call targets to word indices, and LI3 addresses
+    // of globals, string literals and functions to relocations.
     // Note: text_seg[0] is metadata (main entry offset), skip it
-    is_operand[0] = 1;  // Mark position 0 as "operand" to skip it
-    for (long long i = 1; i < num_instructions; i++) {
-        if (is_operand[i]) continue;
-        int op = text_copy[i];
-        int operand_count = get_opcode_operand_count(op);
-        for (int j = 1; j <= operand_count && i + j < num_instructions; j++) {
-            is_operand[i + j] = 1;
+    for (long long i = 1; i < text_words;) {
+        long long op = text_copy[i];
+        int len = (op >= 0 && op < NUM_OPS) ? vm_insn_size((int)op) : 1;
+        int addr_idx = (op >= 0 && op < NUM_OPS) ? vm_target_operand((int)op) : 0;
+        if (addr_idx && i + addr_idx < text_words) {
+            long long value = text_copy[i + addr_idx];
+            // Only convert if this looks like a text segment address
+            if (value >= text_base && value < text_end) {
+                long long offset = (value - text_base) / sizeof(long long);
+                text_copy[i + addr_idx] = offset;
+                if (vm->debug_vm) {
+                    printf("Save: Converting address at [%lld+%d]: 0x%llx -> offset %lld\n",
+                           i, addr_idx, value, offset);
+                }
+            }
         }
-    }
-    
-    // Convert absolute addresses to relative offsets
-    for (long long i = 0; i < num_instructions; i++) {
-        if (is_operand[i]) continue;
-        
-        int op = text_copy[i];
-        if (opcode_has_address(op)) {
-            int addr_idx = get_address_operand_index(op);
-            if (addr_idx >= 0 && i + 1 + addr_idx < num_instructions) {
-                long long value = text_copy[i + 1 + addr_idx];
-                // Only convert if this looks like a text segment address
-                if (value >= text_base && value < text_end) {
-                    long long offset = (value - text_base) / sizeof(long long);
-                    text_copy[i + 1 + addr_idx] = offset;
-                    if (vm->debug_vm) {
-                        printf("Save: Converting address at [%lld+%d]: 0x%llx -> offset %lld\n",
-                               i, addr_idx + 1, value, offset);
-                    }
+        if (op >= 0 && op < NUM_OPS && vm_superop_base((int)op) == LI3 &&
+            i + 2 < text_words) {
+            long long value = text_copy[i + 2];
+            int kind = -1;
+            if (value >= data_base && value <= data_base + data_size) {
+                text_copy[i + 2] = value - data_base;
+                kind = RELOC_DATA;
+            } else if (value >= text_base && value < text_end) {
+                text_copy[i + 2] = (value - text_base) / sizeof(long long);
+                kind = RELOC_TEXT;
+            }
+            if (kind >= 0) {
+                long long *grown = realloc(relocs, (reloc_count + 1) * sizeof(long long));
+                if (!grown) {
+                    fprintf(stderr, "error: failed to allocate relocation table\n");
+                    free(relocs);
+                    free(text_copy);
+                    return -1;
                 }
+                relocs = grown;
+                relocs[reloc_count++] = ((i + 2) << 1) | kind;
             }
         }
+        i += len;
     }
-    free(is_operand);
+    
+    if (compact_encode(text_copy, text_words, &compact) != 0) {
+        fprintf(stderr, "error: failed to allocate compact text buffer\n");
+        free(text_copy);
+        free(compact.words);
+        free(relocs);
+        return -1;
+    }
+    free(text_copy);
+    long long text_size = compact.len * sizeof(uint32_t);
+    long long ffi_count = vm->compiler.ffi_count;
+    uint64_t opcodes = opcode_table_hash();
     
     // Write header
     if (fwrite(JCC_MAGIC, 1, 4, f) != 4) goto write_error;
     
-    int version = 1;  // Version 1 for register-based VM
+    int version = JCC_BYTECODE_VERSION;
     if (fwrite(&version, sizeof(int), 1, f) != 1) goto write_error;
     
     uint32_t flags = vm->flags;
     if (fwrite(&flags, sizeof(uint32_t), 1, f) != 1) goto write_error;
     
+    if (fwrite(&text_words, sizeof(long long), 1, f) != 1) goto write_error;
     if (fwrite(&text_size, sizeof(long long), 1, f) != 1) goto write_error;
     if (fwrite(&data_size, sizeof(long long), 1, f) != 1) goto write_error;
     if (fwrite(&main_offset, sizeof(long long), 1, f) != 1) goto write_error;
+    if (fwrite(&ffi_count, sizeof(long long), 1, f) != 1) goto write_error;
+    if (fwrite(&reloc_count, sizeof(long long), 1, f) != 1) goto write_error;
+    if (fwrite(&opcodes, sizeof(uint64_t), 1, f) != 1) goto write_error;
     
     // Write text segment
-    if (fwrite(text_copy, 1, text_size, f) != (size_t)text_size) goto write_error;
-    free(text_copy);
-    text_copy = NULL;
+    if (text_size > 0 &&
+        fwrite(compact.words, 1, text_size, f) != (size_t)text_size) goto write_error;
+    free(compact.words);
+    compact.words = NULL;
     
     // Write data segment
     if (data_size > 0) {
         if (fwrite(vm->data_seg, 1, data_size, f) != (size_t)data_size) goto write_error;
     }
     
-    fclose(f);
+    // Write FFI table (CALLF operands index it)
+    for (long long i = 0; i < ffi_count; i++) {
+        ForeignFunc *ff = &vm->compiler.ffi_table[i];
+        int name_len = (int)strlen(ff->name);
+        int info[4] = {ff->num_args, ff->returns_double, ff->is_variadic,
+                       ff->num_fixed_args};
+        if (fwrite(&name_len, sizeof(int), 1, f) != 1) goto write_error;
+        if (fwrite(ff->name, 1, name_len, f) != (size_t)name_len) goto write_error;
+        if (fwrite(info, sizeof(int), 4, f) != 4) goto write_error;
+        if (fwrite(&ff->double_arg_mask, sizeof(uint64_t), 1, f) != 1) goto write_error;
+    }
+    
+    // Write relocations
+    if (reloc_count > 0 &&
+        fwrite(relocs, sizeof(long long), reloc_count, f) != (size_t)reloc_count) goto write_error;
+    free(relocs);
     
     if (vm->debug_vm) {
-        printf("Saved bytecode to %s:\n", path);
-        printf("  Text size: %lld bytes (%lld instructions)\n", text_size, num_instructions);
+        printf("Saved bytecode:\n");
+        printf("  Text size: %lld bytes compact, %lld bytes decoded (%lld words)\n",
+               text_size, text_words * (long long)sizeof(long long), text_words);
         printf("  Data size: %lld bytes\n", data_size);
         printf("  Main offset: %lld\n", main_offset);
+        printf("  FFI functions: %lld, relocations: %lld\n", ffi_count, reloc_count);
     }
     
     return 0;
     
 write_error:
     fprintf(stderr, "error: failed to write bytecode: %s\n", strerror(errno));
-    if (text_copy) free(text_copy);
-    fclose(f);
+    free(compact.words);
+    free(relocs);
+    return -1;
+}
+
+int cc_save_bytecode(JCC *vm, const char *path) {
+    if (!vm || !path) {
+        fprintf(stderr, "error: invalid arguments to cc_save_bytecode\n");
+        return -1;
+    }
+    
+    if (!vm->text_seg || !vm->data_seg) {
+        fprintf(stderr, "error: no bytecode to save (compile first)\n");
+        return -1;
+    }
+    
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "error: failed to open %s for writing: %s\n", path, strerror(errno));
+        return -1;
+    }
+    
+    int result = write_bytecode(vm, f);
+    if (fclose(f) != 0 && result == 0) {
+        fprintf(stderr, "error: failed to write bytecode: %s\n", strerror(errno));
+        result = -1;
+    }
+    if (result == 0 && vm->debug_vm)
+        printf("Bytecode written to %s\n", path);
+    return result;
+}
+
+// Rebuild the FFI table in the order the CALLF operands were compiled
+// against. Functions are resolved by name among the ones registered on vm
+// (cc_load_stdlib, cc_register_cfunc), then through the dynamic loader.
+static int read_ffi_table(JCC *vm, const char **cursor, const char *end,
+                          int count) {
+    ForeignFunc *table = calloc(count ? count : 1, sizeof(ForeignFunc));
+    if (!table) {
+        fprintf(stderr, "error: failed to allocate FFI table\n");
+        return -1;
+    }
+#ifndef _WIN32
+    void *self = dlopen(NULL, RTLD_LAZY);
+#endif
+
+    int n = 0;
+    for (; n < count; n++) {
+        int name_len, info[4];
+        uint64_t mask;
+        if (*cursor + sizeof(int) > end)
+            goto truncated;
+        memcpy(&name_len, *cursor, sizeof(int));
+        *cursor += sizeof(int);
+        if (name_len < 0 || (size_t)(end - *cursor) <
+                                 name_len + sizeof(info) + sizeof(uint64_t))
+            goto truncated;
+
+        ForeignFunc *ff = &table[n];
+        if (!(ff->name = malloc(name_len + 1))) {
+            fprintf(stderr, "error: failed to allocate FFI table\n");
+            goto fail;
+        }
+        memcpy(ff->name, *cursor, name_len);
+        ff->name[name_len] = '\0';
+        *cursor += name_len;
+        memcpy(info, *cursor, sizeof(info));
+        *cursor += sizeof(info);
+        memcpy(&mask, *cursor, sizeof(uint64_t));
+        *cursor += sizeof(uint64_t);
+
+        ff->num_args = info[0];
+        ff->returns_double = info[1];
+        ff->is_variadic = info[2];
+        ff->num_fixed_args = info[3];
+        ff->double_arg_mask = mask;
+        for (int i = 0; i < vm->compiler.ffi_count; i++) {
+            if (strcmp(vm->compiler.ffi_table[i].name, ff->name) == 0) {
+                ff->func_ptr = vm->compiler.ffi_table[i].func_ptr;
+                break;
+            }
+        }
+#ifndef _WIN32
+        if (!ff->func_ptr && self)
+            ff->func_ptr = dlsym(self, ff->name);
+#endif
+        if (!ff->func_ptr)
+            fprintf(stderr, "warning: failed to resolve symbol '%s'\n", ff->name);
+    }
+
+    for (int i = 0; i < vm->compiler.ffi_count; i++) {
+        free(vm->compiler.ffi_table[i].name);
+#ifdef JCC_HAS_FFI
+        free(vm->compiler.ffi_table[i].arg_types);
+#endif
+    }
+    free(vm->compiler.ffi_table);
+    vm->compiler.ffi_table = table;
+    vm->compiler.ffi_count = count;
+    vm->compiler.ffi_capacity = count ? count : 1;
+#ifndef _WIN32
+    if (self)
+        dlclose(self);
+#endif
+    return 0;
+
+truncated:
+    fprintf(stderr, "error: unexpected end of bytecode data\n");
+fail:
+    for (int i = 0; i <= n && i < count; i++)
+        free(table[i].name);
+    free(table);
+#ifndef _WIN32
+    if (self)
+        dlclose(self);
+#endif
     return -1;
 }
 
@@ -274,10 +500,13 @@ static int load_bytecode(JCC *vm, const char *data, size_t size) {
     }
     cursor += 4;
     
-    // Read version - only accept version 1
+    // Read version - opcode numbers and the header change between versions
     READ_AND_INCR(version, int);
-    if (version != 1) {
-        fprintf(stderr, "error: unsupported bytecode version %d (expected 1)\n", version);
+    if (version != JCC_BYTECODE_VERSION) {
+        fprintf(stderr,
+                "error: unsupported bytecode version %d (expected %d); "
+                "recompile it from source\n",
+                version, JCC_BYTECODE_VERSION);
         return -1;
     }
 
@@ -286,11 +515,24 @@ static int load_bytecode(JCC *vm, const char *data, size_t size) {
     vm->flags = flags;
 
     // Read sizes
+    READ_AND_INCR(text_words, long long);
     READ_AND_INCR(text_size, long long);
     READ_AND_INCR(data_size, long long);
     READ_AND_INCR(main_offset, long long);
+    READ_AND_INCR(ffi_count, long long);
+    READ_AND_INCR(reloc_count, long long);
+    READ_AND_INCR(opcodes, uint64_t);
+    if (opcodes != opcode_table_hash()) {
+        fprintf(stderr, "error: bytecode was saved by a jcc with a different "
+                        "instruction set; recompile it from source\n");
+        return -1;
+    }
     
-    if (text_size < 0 || data_size < 0 || cursor + text_size + data_size > end) {
+    if (text_words < 1 || text_words > vm->poolsize || text_size < 0 ||
+        text_size % sizeof(uint32_t) != 0 || data_size < 0 ||
+        data_size > vm->poolsize || cursor + text_size + data_size > end ||
+        ffi_count < 0 || ffi_count > INT_MAX || reloc_count < 0 ||
+        reloc_count > text_words) {
         fprintf(stderr, "error: invalid bytecode sizes\n");
         return -1;
     }
@@ -305,9 +547,21 @@ static int load_bytecode(JCC *vm, const char *data, size_t size) {
         return -1;
     }
     
-    // Copy text segment
-    memcpy(vm->text_seg, cursor, text_size);
+    // Decode text segment (copied out first: the file data may be unaligned)
+    uint32_t *compact = malloc(text_size ? text_size : 1);
+    if (!compact) {
+        fprintf(stderr, "error: failed to allocate compact text buffer\n");
+        return -1;
+    }
+    memcpy(compact, cursor, text_size);
     cursor += text_size;
+    long long decoded = compact_decode(compact, text_size / sizeof(uint32_t),
+                                       vm->text_seg, text_words);
+    free(compact);
+    if (decoded != text_words) {
+        fprintf(stderr, "error: invalid bytecode text segment\n");
+        return -1;
+    }
     
     // Copy data segment
     if (data_size > 0) {
@@ -315,60 +569,63 @@ static int load_bytecode(JCC *vm, const char *data, size_t size) {
         cursor += data_size;
     }
     
-    // Convert relative offsets back to absolute addresses
-    long long num_instructions = text_size / sizeof(long long);
-    
-    // Mark operand positions
-    char *is_operand = calloc(num_instructions, 1);
-    if (!is_operand) {
-        fprintf(stderr, "error: failed to allocate operand map\n");
+    if (read_ffi_table(vm, &cursor, end, (int)ffi_count) != 0)
+        return -1;
+    if (cursor + reloc_count * sizeof(long long) > end) {
+        fprintf(stderr, "error: unexpected end of bytecode data\n");
         return -1;
     }
-    // Note: text_seg[0] is metadata (main entry offset), skip it
-    is_operand[0] = 1;  // Mark position 0 as "operand" to skip it
-    for (long long i = 1; i < num_instructions; i++) {
-        if (is_operand[i]) continue;
-        int op = vm->text_seg[i];
-        int operand_count = get_opcode_operand_count(op);
-        for (int j = 1; j <= operand_count && i + j < num_instructions; j++) {
-            is_operand[i + j] = 1;
+    for (long long i = 0; i < reloc_count; i++) {
+        long long reloc;
+        memcpy(&reloc, cursor, sizeof(long long));
+        cursor += sizeof(long long);
+        long long at = reloc >> 1;
+        if (at < 1 || at >= text_words) {
+            fprintf(stderr, "error: invalid bytecode relocation\n");
+            return -1;
         }
+        if ((reloc & 1) == RELOC_TEXT)
+            vm->text_seg[at] = (long long)(vm->text_seg + vm->text_seg[at]);
+        else
+            vm->text_seg[at] = (long long)(vm->data_seg + vm->text_seg[at]);
     }
     
-    // Convert offsets to addresses
-    for (long long i = 0; i < num_instructions; i++) {
-        if (is_operand[i]) continue;
-        
-        int op = vm->text_seg[i];
-        if (opcode_has_address(op)) {
-            int addr_idx = get_address_operand_index(op);
-            if (addr_idx >= 0 && i + 1 + addr_idx < num_instructions) {
-                long long offset = vm->text_seg[i + 1 + addr_idx];
-                // Convert offset to absolute address
-                if (offset >= 0 && offset < num_instructions) {
-                    long long addr = (long long)(vm->text_seg + offset);
-                    vm->text_seg[i + 1 + addr_idx] = addr;
-                    if (vm->debug_vm) {
-                        printf("Load: Converting offset at [%lld+%d]: %lld -> 0x%llx\n",
-                               i, addr_idx + 1, offset, addr);
-                    }
+    // Convert word indices back to absolute addresses.
+    // Note: text_seg[0] is metadata (main entry offset), skip it
+    for (long long i = 1; i < text_words;) {
+        long long op = vm->text_seg[i];
+        int len = (op >= 0 && op < NUM_OPS) ? vm_insn_size((int)op) : 1;
+        int addr_idx = (op >= 0 && op < NUM_OPS) ? vm_target_operand((int)op) : 0;
+        if (addr_idx && i + addr_idx < text_words) {
+            long long offset = vm->text_seg[i + addr_idx];
+            // Convert offset to absolute address
+            if (offset >= 0 && offset < text_words) {
+                long long addr = (long long)(vm->text_seg + offset);
+                vm->text_seg[i + addr_idx] = addr;
+                if (vm->debug_vm) {
+                    printf("Load: Converting offset at [%lld+%d]: %lld -> 0x%llx\n",
+                           i, addr_idx, offset, addr);
                 }
             }
         }
+        i += len;
     }
-    free(is_operand);
     
     // Set up pointers
-    vm->text_ptr = vm->text_seg + (text_size / sizeof(long long)) - 1;
+    vm->text_ptr = vm->text_seg + text_words - 1;
     vm->data_ptr = vm->data_seg + data_size;
     vm->heap_ptr = vm->heap_seg;
     vm->heap_end = vm->heap_seg + vm->poolsize;
     vm->free_list = NULL;
     vm->text_seg[0] = main_offset;  // Restore main offset
+
+    if (vm_predecode(vm) != 0)
+        return -1;
     
     if (vm->debug_vm) {
         printf("Loaded bytecode:\n");
-        printf("  Text size: %lld bytes (%lld instructions)\n", text_size, num_instructions);
+        printf("  Text size: %lld bytes compact, %lld bytes decoded (%lld words)\n",
+               text_size, text_words * (long long)sizeof(long long), text_words);
         printf("  Data size: %lld bytes\n", data_size);
         printf("  Main offset: %lld\n", main_offset);
     }
@@ -413,6 +670,208 @@ int cc_load_bytecode(JCC *vm, const char *path) {
     return result;
 }
 
+// ========== Executables ==========
+
+// Path of the running executable
+static int self_exe_path(char *buf, size_t size) {
+#if defined(_WIN32)
+    DWORD len = GetModuleFileNameA(NULL, buf, (DWORD)size);
+    return len > 0 && len < size ? 0 : -1;
+#elif defined(__APPLE__)
+    uint32_t len = (uint32_t)size;
+    return _NSGetExecutablePath(buf, &len) == 0 ? 0 : -1;
+#elif defined(__linux__)
+    ssize_t len = readlink("/proc/self/exe", buf, size - 1);
+    if (len <= 0)
+        return -1;
+    buf[len] = '\0';
+    return 0;
+#else
+    (void)buf;
+    (void)size;
+    return -1;
+#endif
+}
+
+// Find the bytecode image at the end of an executable. Sets *runtime_size to
+// the bytes before it (the whole file if there is none) and returns 1 if
+// there is one, 0 if not, -1 on error.
+static int find_image(FILE *f, long *runtime_size, long *image_size) {
+    if (fseek(f, 0, SEEK_END) != 0)
+        return -1;
+    long file_size = ftell(f);
+    if (file_size < 0)
+        return -1;
+    *runtime_size = file_size;
+    *image_size = 0;
+
+    char trailer[JCC_EXEC_TRAILER];
+    if (file_size < JCC_EXEC_TRAILER ||
+        fseek(f, file_size - JCC_EXEC_TRAILER, SEEK_SET) != 0 ||
+        fread(trailer, 1, JCC_EXEC_TRAILER, f) != JCC_EXEC_TRAILER ||
+        memcmp(trailer + 8, JCC_EXEC_MAGIC, 8) != 0)
+        return 0;
+
+    long long size;
+    memcpy(&size, trailer, sizeof(long long));
+    if (size <= 0 || size > file_size - JCC_EXEC_TRAILER)
+        return -1;
+    *image_size = (long)size;
+    *runtime_size = file_size - JCC_EXEC_TRAILER - *image_size;
+    return 1;
+}
+
+int cc_save_executable(JCC *vm, const char *path) {
+    if (!vm || !path) {
+        fprintf(stderr, "error: invalid arguments to cc_save_executable\n");
+        return -1;
+    }
+
+    if (!vm->text_seg || !vm->data_seg) {
+        fprintf(stderr, "error: no bytecode to save (compile first)\n");
+        return -1;
+    }
+
+    char self[4096];
+    if (self_exe_path(self, sizeof(self)) != 0) {
+        fprintf(stderr, "error: could not locate the running executable\n");
+        return -1;
+    }
+
+    FILE *in = fopen(self, "rb");
+    if (!in) {
+        fprintf(stderr, "error: failed to open %s: %s\n", self, strerror(errno));
+        return -1;
+    }
+    long runtime_size, image_size;
+    if (find_image(in, &runtime_size, &image_size) < 0 ||
+        fseek(in, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "error: failed to read %s\n", self);
+        fclose(in);
+        return -1;
+    }
+
+    FILE *f = fopen(path, "wb");
+    if (!f) {
+        fprintf(stderr, "error: failed to open %s for writing: %s\n", path, strerror(errno));
+        fclose(in);
+        return -1;
+    }
+
+    // Copy the runtime (without a program embedded in it)
+    char buf[65536];
+    for (long left = runtime_size; left > 0;) {
+        size_t chunk = left < (long)sizeof(buf) ? (size_t)left : sizeof(buf);
+        if (fread(buf, 1, chunk, in) != chunk) {
+            fprintf(stderr, "error: failed to read %s\n", self);
+            goto fail;
+        }
+        if (fwrite(buf, 1, chunk, f) != chunk)
+            goto write_error;
+        left -= chunk;
+    }
+    fclose(in);
+    in = NULL;
+
+    // Append the bytecode image and the trailer that points back to it
+    if (write_bytecode(vm, f) != 0)
+        goto fail;
+    long long size = ftell(f) - runtime_size;
+    if (fwrite(&size, sizeof(long long), 1, f) != 1) goto write_error;
+    if (fwrite(JCC_EXEC_MAGIC, 1, 8, f) != 8) goto write_error;
+
+    if (fclose(f) != 0) {
+        f = NULL;
+        goto write_error;
+    }
+#ifndef _WIN32
+    if (chmod(path, 0755) != 0) {
+        fprintf(stderr, "error: failed to make %s executable: %s\n", path, strerror(errno));
+        return -1;
+    }
+#endif
+
+    if (vm->debug_vm)
+        printf("Executable written to %s (%ld bytes runtime, %lld bytes bytecode)\n",
+               path, runtime_size, size);
+    return 0;
+
+write_error:
+    fprintf(stderr, "error: failed to write executable: %s\n", strerror(errno));
+fail:
+    if (in)
+        fclose(in);
+    if (f)
+        fclose(f);
+    remove(path);
+    return -1;
+}
+
+int cc_has_executable_image(const char *path) {
+    char self[4096];
+    if (!path) {
+        if (self_exe_path(self, sizeof(self)) != 0)
+            return 0;
+        path = self;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return 0;
+    long runtime_size, image_size;
+    int found = find_image(f, &runtime_size, &image_size);
+    fclose(f);
+    return found != 0;
+}
+
+int cc_load_executable(JCC *vm, const char *path) {
+    if (!vm) {
+        fprintf(stderr, "error: invalid arguments to cc_load_executable\n");
+        return -1;
+    }
+
+    char self[4096];
+    if (!path) {
+        if (self_exe_path(self, sizeof(self)) != 0)
+            return 1;
+        path = self;
+    }
+
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "error: failed to open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    long runtime_size, image_size;
+    int found = find_image(f, &runtime_size, &image_size);
+    if (found <= 0) {
+        if (found < 0)
+            fprintf(stderr, "error: invalid program embedded in %s\n", path);
+        fclose(f);
+        return found < 0 ? -1 : 1;
+    }
+
+    char *data = malloc(image_size);
+    if (!data) {
+        fprintf(stderr, "error: failed to allocate memory for bytecode\n");
+        fclose(f);
+        return -1;
+    }
+    if (fseek(f, runtime_size, SEEK_SET) != 0 ||
+        fread(data, 1, image_size, f) != (size_t)image_size) {
+        fprintf(stderr, "error: failed to read bytecode from %s\n", path);
+        free(data);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    int result = load_bytecode(vm, data, image_size);
+    free(data);
+    return result;
+}
+
 void cc_compile(JCC *vm, Obj *prog) {
     if (!vm) {
         error("VM instance is NULL");
@@ -477,7 +936,13 @@ void cc_compile(JCC *vm, Obj *prog) {
 
     // Store the merged program for variable lookup during codegen
     vm->compiler.globals = prog;
-    
+
+    // Run calls to pure functions with constant arguments
+    cc_consteval(vm, prog);
+
+    // Replace calls to small functions with their bodies
+    cc_inline(vm, prog);
+
     // Generate bytecode from AST using new register-based codegen
     gen(vm, prog);
 
@@ -485,4 +950,9 @@ void cc_compile(JCC *vm, Obj *prog) {
     if (vm->compiler.opt_level > 0) {
         cc_optimize(vm, vm->compiler.opt_level);
     }
+
+    // Translate the finished text segment into the pre-decoded stream
+    if (vm_predecode(vm) != 0) {
+        error("could not decode instruction stream");
+    }
 }
\ No newline at end of file
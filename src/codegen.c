@@ -20,10 +20,11 @@
 #include "./internal.h"
 #include "jcc.h"
 #include <ctype.h>
+#include <limits.h>
 
 // ========== FFI Helper ==========
 
-static int find_ffi_function(JCC *vm, const char *name) {
+int find_ffi_function(JCC *vm, const char *name) {
     if (!vm || !name)
         return -1;
 
@@ -132,68 +133,96 @@ static bool contains_funcall(Node *node) {
     return false;
 }
 
-#define MAX_LABELS 256
-#define MAX_LABEL_PATCHES 1024
-
-typedef struct {
-    char *name;
-    long long *address;
-} LabelDef;
-
-typedef struct {
-    char *name;
-    long long *patch_location;
-} LabelPatch;
-
-static LabelDef label_defs[MAX_LABELS];
-static int num_label_defs = 0;
-
-static LabelPatch label_patches[MAX_LABEL_PATCHES];
-static int num_label_patches = 0;
-
-static void reset_labels(void) {
-    num_label_defs = 0;
-    num_label_patches = 0;
+// Labels are per function: label_addrs maps each name to its address and
+// goto_patches holds the jumps to patch once the function is generated
+static void reset_labels(JCC *vm) {
+    free(vm->compiler.label_addrs.buckets);
+    vm->compiler.label_addrs = (HashMap){0};
+    vm->compiler.num_goto_patches = 0;
 }
 
 // Define a label at the current position
 static void define_label(JCC *vm, char *name) {
     if (!name)
         return;
-    if (num_label_defs >= MAX_LABELS) {
-        error("codegen: too many labels");
-    }
-    label_defs[num_label_defs].name = name;
-    label_defs[num_label_defs].address = vm->text_ptr + 1;
-    num_label_defs++;
+    // The first definition wins
+    if (!hashmap_get(&vm->compiler.label_addrs, name))
+        hashmap_put(&vm->compiler.label_addrs, name, vm->text_ptr + 1);
 }
 
 // Record a jump that needs to be patched later
-static void add_label_patch(char *name, long long *patch_location) {
+static void add_label_patch(JCC *vm, char *name, long long *patch_location) {
     if (!name)
         return;
-    if (num_label_patches >= MAX_LABEL_PATCHES) {
-        error("codegen: too many label patches");
+    Compiler *c = &vm->compiler;
+    if (c->num_goto_patches == c->goto_patches_cap) {
+        c->goto_patches_cap =
+            c->goto_patches_cap ? c->goto_patches_cap * 2 : 64;
+        c->goto_patches =
+            realloc(c->goto_patches, sizeof(GotoPatch) * c->goto_patches_cap);
+        if (!c->goto_patches)
+            error("out of memory");
     }
-    label_patches[num_label_patches].name = name;
-    label_patches[num_label_patches].patch_location = patch_location;
-    num_label_patches++;
+    c->goto_patches[c->num_goto_patches++] = (GotoPatch){name, patch_location};
 }
 
 // Patch all forward references to labels
-static void patch_labels(void) {
-    for (int i = 0; i < num_label_patches; i++) {
-        char *name = label_patches[i].name;
-        long long *patch = label_patches[i].patch_location;
-
-        // Find the label definition
-        for (int j = 0; j < num_label_defs; j++) {
-            if (strcmp(label_defs[j].name, name) == 0) {
-                *patch = (long long)label_defs[j].address;
-                break;
-            }
-        }
+static void patch_labels(JCC *vm) {
+    for (int i = 0; i < vm->compiler.num_goto_patches; i++) {
+        GotoPatch *p = &vm->compiler.goto_patches[i];
+        long long *address = hashmap_get(&vm->compiler.label_addrs, p->name);
+        if (address)
+            *p->location = (long long)address;
+    }
+}
+
+// Record a call (CALL operand) or function address (LI3 immediate) to patch
+// with the address of fn once every function has been generated
+static void add_func_patch(FuncPatch **patches, int *num, int *cap,
+                           long long *location, Obj *fn) {
+    if (*num == *cap) {
+        *cap = *cap ? *cap * 2 : 256;
+        *patches = realloc(*patches, sizeof(FuncPatch) * *cap);
+        if (!*patches)
+            error("out of memory");
     }
+    (*patches)[(*num)++] = (FuncPatch){location, fn};
+}
+
+static void add_call_patch(JCC *vm, long long *location, Obj *fn) {
+    add_func_patch(&vm->compiler.call_patches, &vm->compiler.num_call_patches,
+                   &vm->compiler.call_patches_cap, location, fn);
+}
+
+static void add_func_addr_patch(JCC *vm, long long *location, Obj *fn) {
+    add_func_patch(&vm->compiler.func_addr_patches,
+                   &vm->compiler.num_func_addr_patches,
+                   &vm->compiler.func_addr_patches_cap, location, fn);
+}
+
+// ========== Constant Operands ==========
+
+// Integer constant operand, looking through the integer casts the parser
+// wraps around literals. Truncates exactly like ND_CAST codegen does.
+static bool const_int_operand(Node *node, long long *val) {
+    if (node->kind == ND_NUM) {
+        if (is_flonum(node->ty))
+            return false;
+        *val = node->val;
+        return true;
+    }
+    if (node->kind != ND_CAST || is_flonum(node->ty) ||
+        node->ty->kind == TY_BOOL || !const_int_operand(node->lhs, val))
+        return false;
+
+    bool is_unsigned = node->ty->is_unsigned;
+    if (node->ty->kind == TY_CHAR)
+        *val = is_unsigned ? (long long)(unsigned char)*val : (signed char)*val;
+    else if (node->ty->kind == TY_SHORT)
+        *val = is_unsigned ? (long long)(unsigned short)*val : (short)*val;
+    else if (node->ty->kind == TY_INT)
+        *val = is_unsigned ? (long long)(unsigned int)*val : (int)*val;
+    return true;
 }
 
 // ========== Emit Helpers ==========
@@ -201,6 +230,9 @@ static void patch_labels(void) {
 static void emit(JCC *vm, int instruction) {
     if (!vm || !vm->text_ptr)
         error("codegen: text segment not initialized");
+    // Leave room for the operands the caller writes after the opcode
+    if (vm->text_ptr + 16 >= vm->text_seg + vm->poolsize)
+        error("codegen: program too large for the text segment");
     *++vm->text_ptr = instruction;
 }
 
@@ -324,6 +356,25 @@ static long long *emit_jnz3(JCC *vm, int rs) {
     return patch;
 }
 
+// Bxx: if (rs1 REL rs2) jump (returns patch location)
+static long long *emit_branch(JCC *vm, int op, int rs1, int rs2) {
+    emit(vm, op);
+    *++vm->text_ptr = ENCODE_RR(rs1, rs2);
+    long long *patch = ++vm->text_ptr;
+    *patch = 0;
+    return patch;
+}
+
+// BxxI: if (rs REL imm) jump (returns patch location)
+static long long *emit_branch_imm(JCC *vm, int op, int rs, long long imm) {
+    emit(vm, op);
+    *++vm->text_ptr = ENCODE_R(rs);
+    *++vm->text_ptr = imm;
+    long long *patch = ++vm->text_ptr;
+    *patch = 0;
+    return patch;
+}
+
 // PSH3: push register value onto stack
 static void emit_psh3(JCC *vm, int rs) {
     emit(vm, PSH3);
@@ -336,11 +387,733 @@ static void emit_pop3(JCC *vm, int rd) {
     *++vm->text_ptr = ENCODE_R(rd);
 }
 
+// ========== Register Promotion ==========
+//
+// Integer and pointer locals whose address is never taken live in the
+// callee-saved S registers instead of a bp[-n] slot, so a read is one MOV3
+// (or nothing, when the register is used as an operand directly) instead of
+// LEA3 + LDR. Live intervals are numbered by statement in source order and
+// stretched over every loop that touches them; a linear scan then hands out
+// REG_S0..REG_S7, giving a busy register to the more heavily used variable.
+// A function saves the registers it uses after ENT3 and restores them before
+// every LEV3, so a register only pays off when the variables in it are used
+// more than the four extra instructions per call cost.
+//
+// Leaf functions (no calls) never reuse the argument registers, so their
+// parameters stay in the A register they arrive in, and the A registers no
+// parameter needs take locals before any S register does, at no cost.
+// ENT3 only spills the parameters that still need their slot.
+//
+// The address of a global, or of a local array, struct or union, is the
+// same on every iteration of a loop. Each one used inside an outermost loop
+// competes for a register like a local does, with the loop as its interval;
+// when it gets one, the address is loaded before the loop and accesses use
+// the register instead of an LI3 or LEA3 each time.
+
+#define PROMOTE_REGS 8      // REG_S0..REG_S7
+#define PROMOTE_ARG_REGS 8  // REG_A0..REG_A7, in leaf functions
+#define PROMOTE_SAVE_COST 4 // Save + restore per register per call
+#define PROMOTE_PARAM_COST 1 // Moving a parameter out of its A register
+#define PROMOTE_HOIST_COST 1 // Loading a hoisted address before its loop
+
+typedef struct {
+    Obj *var;         // The local, or a stand-in for a hoisted address
+    Obj *base;        // Hoisted address: the variable it is the address of
+    Node *loop;       // Hoisted address: the loop it is loaded before
+    int start, end;   // Live interval in statement numbers (-1 = unused)
+    long long weight; // Reads and writes, x8 per enclosing loop
+    bool escapes;     // Address taken or otherwise stuck in memory
+    int reg;          // Index of the assigned register (-1 = stack):
+                      // S registers first, then A registers
+} PromoteCand;
+
+typedef struct {
+    HashMap index; // Obj * -> candidate index + 1
+    PromoteCand *cands;
+    int num_cands;
+    int cap_cands;
+    Obj *setjmp_fn;
+    int pos;          // Current statement number
+    int expr_depth;   // Statements inside expressions share one number
+    int loop_depth;
+    bool unstructured; // goto: intervals cover the whole function
+    bool has_call;     // Calls clobber the A registers
+    bool give_up;      // Something the analysis does not model
+    Node *hoist_loop;   // Outermost loop being walked
+    HashMap hoist_index; // Obj * -> index + 1 of its address in hoist_loop
+    int switch_depth;
+    int hoist_switch_depth; // switch_depth outside hoist_loop
+    bool hoist_entered; // A case label of an outer switch is in hoist_loop
+} PromoteState;
+
+// An address held in a register across a loop
+typedef struct Hoist {
+    Node *loop;
+    Obj *var;
+    int reg;
+    struct Hoist *next;
+} Hoist;
+
+// S registers used by the function being generated, saved at
+// bp[promote_save_offset - i]
+static int promote_num_saved = 0;
+static int promote_save_offset = 0;
+
+// Addresses hoisted out of the loops of the function being generated, and
+// the outermost loop whose code is being generated
+static Hoist *promote_hoists = NULL;
+static Node *hoist_loop = NULL;
+
+// Register holding the address of var in the current loop, 0 if none
+static int hoisted_reg(Obj *var) {
+    if (!hoist_loop)
+        return 0;
+    for (Hoist *h = promote_hoists; h; h = h->next) {
+        if (h->loop == hoist_loop && h->var == var)
+            return h->reg;
+    }
+    return 0;
+}
+
+static void free_hoists(void) {
+    while (promote_hoists) {
+        Hoist *next = promote_hoists->next;
+        free(promote_hoists);
+        promote_hoists = next;
+    }
+    hoist_loop = NULL;
+}
+
+// Does converting a value already truncated to from into to leave the
+// register unchanged? (ND_CAST only narrows to char, short, int and bool.)
+static bool is_value_cast(Type *to, Type *from) {
+    if (is_flonum(to) || is_flonum(from) || to->kind == TY_BOOL)
+        return false;
+    if (to->kind != TY_CHAR && to->kind != TY_SHORT && to->kind != TY_INT)
+        return true;
+    if (from->size < to->size)
+        return from->is_unsigned || !to->is_unsigned;
+    return from->size == to->size && from->is_unsigned == to->is_unsigned;
+}
+
+// S register holding node if it is a promoted local (possibly under casts
+// that do not change its value), 0 otherwise
+static int promoted_reg(Node *node) {
+    while (node->kind == ND_CAST && is_value_cast(node->ty, node->lhs->ty))
+        node = node->lhs;
+    if (node->kind != ND_VAR)
+        return 0;
+    // The value of an array is its address
+    if (!node->var->reg && node->ty->kind == TY_ARRAY)
+        return hoisted_reg(node->var);
+    return node->var->reg;
+}
+
+// Does evaluating node read register reg through a promoted local or a
+// hoisted address?
+static bool reads_promoted_reg(Node *node, int reg) {
+    if (!node)
+        return false;
+    if (node->kind == ND_VAR &&
+        (node->var->reg == reg || hoisted_reg(node->var) == reg))
+        return true;
+    if (reads_promoted_reg(node->lhs, reg) ||
+        reads_promoted_reg(node->rhs, reg) ||
+        reads_promoted_reg(node->cond, reg) ||
+        reads_promoted_reg(node->then, reg) ||
+        reads_promoted_reg(node->els, reg) ||
+        reads_promoted_reg(node->init, reg) ||
+        reads_promoted_reg(node->inc, reg))
+        return true;
+    for (Node *n = node->body; n; n = n->next) {
+        if (reads_promoted_reg(n, reg))
+            return true;
+    }
+    for (Node *n = node->args; n; n = n->next) {
+        if (reads_promoted_reg(n, reg))
+            return true;
+    }
+    return false;
+}
+
+// Can node be evaluated straight into reg although it reads reg through a
+// promoted local? Integer unary and binary ops and loads read all their
+// operands before writing the destination, so reg may be read by the left
+// operand (recursively) as long as the right one leaves it alone.
+static bool can_target_promoted(Node *node, int reg) {
+    if (!reads_promoted_reg(node, reg) || promoted_reg(node) == reg)
+        return true;
+    switch (node->kind) {
+    case ND_CAST:
+    case ND_NEG:
+    case ND_NOT:
+    case ND_BITNOT:
+        return !is_flonum(node->ty) && !is_flonum(node->lhs->ty) &&
+               can_target_promoted(node->lhs, reg);
+    case ND_DEREF:
+        // The address is read before the load writes the destination
+        return !is_flonum(node->ty) && can_target_promoted(node->lhs, reg);
+    case ND_MEMBER:
+        return !is_flonum(node->ty) && node->lhs->kind == ND_DEREF &&
+               can_target_promoted(node->lhs->lhs, reg);
+    case ND_ADD:
+    case ND_SUB:
+    case ND_MUL:
+    case ND_DIV:
+    case ND_MOD:
+    case ND_BITAND:
+    case ND_BITOR:
+    case ND_BITXOR:
+    case ND_SHL:
+    case ND_SHR:
+    case ND_EQ:
+    case ND_NE:
+    case ND_LT:
+    case ND_LE:
+        return !is_flonum(node->lhs->ty) &&
+               !reads_promoted_reg(node->rhs, reg) &&
+               can_target_promoted(node->lhs, reg);
+    default:
+        return false;
+    }
+}
+
+// Copy rs into rd, truncated to ty the way a store to a ty-sized slot and
+// the load back from it would
+static void emit_narrow(JCC *vm, Type *ty, int rd, int rs) {
+    int op = MOV3;
+    if (ty->kind == TY_CHAR)
+        op = ty->is_unsigned ? ZX1 : SX1;
+    else if (ty->kind == TY_SHORT)
+        op = ty->is_unsigned ? ZX2 : SX2;
+    else if (ty->kind == TY_INT || ty->kind == TY_ENUM)
+        op = ty->is_unsigned ? ZX4 : SX4;
+    if (op != MOV3 || rd != rs)
+        emit_rr(vm, op, rd, rs);
+}
+
+// Is the value of node already truncated to ty? ND_CAST to char/short/int
+// narrows, and so do constants that fit.
+static bool is_narrowed(Node *node, Type *ty) {
+    if (ty->kind != TY_CHAR && ty->kind != TY_SHORT && ty->kind != TY_INT)
+        return ty->kind != TY_ENUM;
+    long long val;
+    if (const_int_operand(node, &val)) {
+        switch (ty->kind) {
+        case TY_CHAR:
+            return val == (ty->is_unsigned ? (long long)(unsigned char)val
+                                           : (signed char)val);
+        case TY_SHORT:
+            return val == (ty->is_unsigned ? (long long)(unsigned short)val
+                                           : (short)val);
+        default:
+            return val == (ty->is_unsigned ? (long long)(unsigned int)val
+                                           : (int)val);
+        }
+    }
+    if (node->kind == ND_VAR)
+        return node->ty->kind == ty->kind &&
+               node->ty->is_unsigned == ty->is_unsigned;
+    return node->kind == ND_CAST && node->ty->kind == ty->kind &&
+           node->ty->is_unsigned == ty->is_unsigned &&
+           !is_flonum(node->lhs->ty);
+}
+
+static bool is_promotable_type(Type *ty) {
+    if (ty->is_volatile || ty->is_atomic)
+        return false;
+    switch (ty->kind) {
+    case TY_CHAR:
+    case TY_SHORT:
+    case TY_INT:
+    case TY_LONG:
+    case TY_ENUM:
+    case TY_BOOL:
+    case TY_PTR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static PromoteCand *promote_cand(PromoteState *st, Obj *var) {
+    if (!var || !var->is_local)
+        return NULL;
+    long long i = (long long)(intptr_t)hashmap_get_int(
+        &st->index, (long long)(intptr_t)var);
+    return i ? &st->cands[i - 1] : NULL;
+}
+
+static PromoteCand *promote_new_cand(PromoteState *st) {
+    if (st->num_cands == st->cap_cands) {
+        st->cap_cands = st->cap_cands ? st->cap_cands * 2 : 16;
+        st->cands = realloc(st->cands, st->cap_cands * sizeof(PromoteCand));
+        if (!st->cands)
+            error("out of memory");
+    }
+    PromoteCand *c = &st->cands[st->num_cands++];
+    memset(c, 0, sizeof(PromoteCand));
+    c->start = c->end = c->reg = -1;
+    return c;
+}
+
+static void promote_touch_cand(PromoteState *st, PromoteCand *c) {
+    if (c->start < 0)
+        c->start = st->pos;
+    c->end = st->pos;
+    long long weight = 1;
+    for (int i = 0; i < st->loop_depth && i < 3; i++)
+        weight *= 8;
+    c->weight += weight;
+}
+
+static void promote_touch(PromoteState *st, Obj *var) {
+    PromoteCand *c = promote_cand(st, var);
+    if (c)
+        promote_touch_cand(st, c);
+}
+
+// Can the address of var be kept in a register across a loop?
+static bool is_hoistable(Obj *var) {
+    if (!var->is_local)
+        return !var->is_function && !var->is_tls;
+    Type *ty = var->ty;
+    return (ty->kind == TY_ARRAY || ty->kind == TY_STRUCT ||
+            ty->kind == TY_UNION) &&
+           !var->is_param && !var->is_block_var && !var->is_captured;
+}
+
+// A use of the address of var inside the current outermost loop
+static void promote_touch_addr(PromoteState *st, Obj *var) {
+    if (!st->hoist_loop || !is_hoistable(var))
+        return;
+    long long i = (long long)(intptr_t)hashmap_get_int(
+        &st->hoist_index, (long long)(intptr_t)var);
+    if (!i) {
+        PromoteCand *c = promote_new_cand(st);
+        c->var = calloc(1, sizeof(Obj));
+        if (!c->var)
+            error("out of memory");
+        c->var->name = var->name;
+        c->var->ty = var->ty;
+        c->base = var;
+        c->loop = st->hoist_loop;
+        i = st->num_cands;
+        hashmap_put_int(&st->hoist_index, (long long)(intptr_t)var,
+                        (void *)(intptr_t)i);
+    }
+    promote_touch_cand(st, &st->cands[i - 1]);
+}
+
+static void promote_escape(PromoteState *st, Obj *var) {
+    PromoteCand *c = promote_cand(st, var);
+    if (c)
+        c->escapes = true;
+}
+
+static void promote_step(PromoteState *st) {
+    if (!st->expr_depth)
+        st->pos++;
+}
+
+static void promote_walk(PromoteState *st, Node *node);
+
+// Walk an lvalue that gen_addr computes the address of
+static void promote_walk_addr(PromoteState *st, Node *node) {
+    if (!node)
+        return;
+    switch (node->kind) {
+    case ND_VAR:
+        promote_escape(st, node->var);
+        promote_touch_addr(st, node->var);
+        return;
+    case ND_VLA_PTR:
+        promote_escape(st, node->var);
+        return;
+    case ND_MEMBER:
+        promote_walk_addr(st, node->lhs);
+        return;
+    case ND_COMMA:
+        promote_walk(st, node->lhs);
+        promote_walk_addr(st, node->rhs);
+        return;
+    default:
+        promote_walk(st, node);
+        return;
+    }
+}
+
+static void promote_walk_loop(PromoteState *st, Node *node) {
+    promote_walk(st, node->init);
+
+    promote_step(st);
+    int start = st->pos;
+    bool outermost = !st->hoist_loop;
+    if (outermost) {
+        st->hoist_loop = node;
+        st->hoist_switch_depth = st->switch_depth;
+        st->hoist_entered = false;
+    }
+    st->loop_depth++;
+    if (node->kind == ND_DO) {
+        promote_walk(st, node->then);
+        promote_step(st);
+        st->expr_depth++;
+        promote_walk(st, node->cond);
+        st->expr_depth--;
+    } else {
+        st->expr_depth++;
+        promote_walk(st, node->cond);
+        st->expr_depth--;
+        promote_walk(st, node->then);
+        promote_step(st);
+        st->expr_depth++;
+        promote_walk(st, node->inc);
+        st->expr_depth--;
+    }
+    st->loop_depth--;
+
+    // Anything touched in the loop stays live around the back edge
+    for (int i = 0; i < st->num_cands; i++) {
+        PromoteCand *c = &st->cands[i];
+        if (c->end >= start) {
+            if (c->start > start)
+                c->start = start;
+            c->end = st->pos;
+        }
+        // A case label inside the loop enters it without the addresses
+        if (outermost && c->loop == node && st->hoist_entered)
+            c->escapes = true;
+    }
+    if (outermost) {
+        free(st->hoist_index.buckets);
+        st->hoist_index = (HashMap){0};
+        st->hoist_loop = NULL;
+    }
+}
+
+static void promote_walk(PromoteState *st, Node *node) {
+    if (!node)
+        return;
+
+    switch (node->kind) {
+    case ND_VAR:
+        promote_touch(st, node->var);
+        promote_touch_addr(st, node->var);
+        return;
+    case ND_MEMZERO:
+        promote_touch(st, node->var);
+        return;
+    case ND_VLA_PTR:
+        promote_escape(st, node->var);
+        return;
+    case ND_ADDR:
+    case ND_MEMBER:
+        promote_walk_addr(st, node->lhs);
+        return;
+    case ND_ASSIGN:
+        promote_walk(st, node->rhs);
+        if (node->lhs->kind == ND_VAR) {
+            promote_touch(st, node->lhs->var);
+            promote_touch_addr(st, node->lhs->var);
+        } else {
+            promote_walk_addr(st, node->lhs);
+        }
+        return;
+    case ND_FOR:
+    case ND_DO:
+        promote_walk_loop(st, node);
+        return;
+    case ND_LABEL:
+    case ND_GOTO_EXPR:
+    case ND_LABEL_VAL:
+        st->unstructured = true;
+        break;
+    case ND_GOTO:
+        if (node->label)
+            st->unstructured = true;
+        break;
+    case ND_FUNCALL:
+        if (node->lhs->kind == ND_VAR && node->lhs->var == st->setjmp_fn)
+            st->give_up = true;
+        st->has_call = true;
+        break;
+    case ND_BLOCK_CALL:
+        st->has_call = true;
+        break;
+    case ND_SWITCH:
+        st->switch_depth++;
+        break;
+    case ND_CASE:
+        if (st->hoist_loop && st->switch_depth == st->hoist_switch_depth)
+            st->hoist_entered = true;
+        break;
+    case ND_ASM:
+    case ND_CAS:
+    case ND_EXCH:
+    case ND_FRAME_ADDR:
+    case ND_BLOCK_LITERAL:
+    case ND_MACRO_CALL:
+        st->give_up = true;
+        return;
+    default:
+        break;
+    }
+
+    bool is_stmt = node->kind == ND_BLOCK || node->kind == ND_EXPR_STMT ||
+                   node->kind == ND_RETURN || node->kind == ND_IF ||
+                   node->kind == ND_SWITCH || node->kind == ND_CASE ||
+                   node->kind == ND_GOTO || node->kind == ND_LABEL;
+    if (is_stmt) {
+        promote_step(st);
+    } else {
+        st->expr_depth++;
+    }
+
+    // Conditions are expressions; then/els/body are statements unless this
+    // node is an expression itself (?:, statement expressions)
+    if (is_stmt && node->cond)
+        st->expr_depth++;
+    promote_walk(st, node->cond);
+    if (is_stmt && node->cond)
+        st->expr_depth--;
+    if (is_stmt && (node->kind == ND_EXPR_STMT || node->kind == ND_RETURN))
+        st->expr_depth++;
+    promote_walk(st, node->lhs);
+    if (is_stmt && (node->kind == ND_EXPR_STMT || node->kind == ND_RETURN))
+        st->expr_depth--;
+    promote_walk(st, node->rhs);
+    promote_walk(st, node->then);
+    promote_walk(st, node->els);
+    for (Node *n = node->body; n; n = n->next)
+        promote_walk(st, n);
+    for (Node *n = node->args; n; n = n->next)
+        promote_walk(st, n);
+
+    if (node->kind == ND_SWITCH)
+        st->switch_depth--;
+    if (!is_stmt)
+        st->expr_depth--;
+}
+
+static void promote_free(PromoteState *st) {
+    for (int i = 0; i < st->num_cands; i++) {
+        if (st->cands[i].base)
+            free(st->cands[i].var);
+    }
+    free(st->index.buckets);
+    free(st->hoist_index.buckets);
+    free(st->cands);
+}
+
+// Can any local of fn live in a register?
+static bool promote_allowed(JCC *vm, Obj *fn) {
+    // The debugger and the stack checks look at locals in their slots
+    if (vm->flags &
+        (JCC_ENABLE_DEBUGGER | JCC_UNINIT_DETECTION | JCC_STACK_INSTR))
+        return false;
+    // Nested functions and blocks reach locals through frame pointers.
+    // Variadic functions need no check: va_start takes the frame address.
+    return !fn->is_nested && !fn->is_block && !fn->has_nested;
+}
+
+// A register parameter param of fn arrives in, 0 if it comes on the stack or
+// in a float register (ENT3 numbers integer and float parameters apart)
+static int param_arg_reg(Obj *fn, Obj *param) {
+    int index = 0, int_index = 0;
+    for (Obj *p = fn->params; p && p != param; p = p->next, index++) {
+        if (!is_flonum(p->ty))
+            int_index++;
+    }
+    if (index >= 8 || is_flonum(param->ty))
+        return 0;
+    return REG_A0 + int_index;
+}
+
+// Pick registers for the locals of fn. Sets var->reg on every promoted
+// local, stores the number of leading parameters ENT3 has to spill to their
+// slots in *param_slots and returns the number of S registers used (REG_S0
+// upwards).
+static int promote_locals(JCC *vm, Obj *fn, int *param_slots) {
+    bool is_variadic = fn->ty && fn->ty->is_variadic;
+    int num_params = 0;
+    for (Obj *var = fn->locals; var; var = var->next)
+        var->reg = 0;
+    for (Obj *var = fn->params; var; var = var->next) {
+        var->reg = 0;
+        num_params++;
+    }
+    *param_slots = is_variadic ? 8 : num_params;
+    if (!promote_allowed(vm, fn))
+        return 0;
+
+    PromoteState st = {0};
+    st.setjmp_fn = vm->compiler.builtin_setjmp;
+
+    bool leaf = !is_variadic;
+    for (Obj *var = fn->locals; var; var = var->next) {
+        // __block variables are allocated with MALC in the prologue
+        if (var->is_block_var)
+            leaf = false;
+        if (!is_promotable_type(var->ty) || var->is_block_var ||
+            var->is_captured || var == fn->va_area ||
+            var == fn->alloca_bottom || var == fn->sret)
+            continue;
+        PromoteCand *c = promote_new_cand(&st);
+        c->var = var;
+        c->start = c->end = var->is_param ? 0 : -1;
+        hashmap_put_int(&st.index, (long long)(intptr_t)var,
+                        (void *)(intptr_t)st.num_cands);
+    }
+
+    promote_walk(&st, fn->body);
+    leaf = leaf && !st.has_call;
+
+    int used = 0;
+    if (st.give_up || st.num_cands == 0) {
+        promote_free(&st);
+        return 0;
+    }
+
+    // Parameters of a leaf function stay in their argument registers and
+    // out of the scan
+    bool arg_busy[PROMOTE_ARG_REGS] = {0};
+    for (Obj *param = fn->params; leaf && param; param = param->next) {
+        PromoteCand *c = promote_cand(&st, param);
+        int arg = param_arg_reg(fn, param);
+        if (!c || c->escapes || !arg)
+            continue;
+        c->start = -1;
+        if (c->weight) {
+            param->reg = arg;
+            arg_busy[arg - REG_A0] = true;
+        }
+    }
+
+    // Linear scan in order of interval start
+    PromoteCand **order = calloc(st.num_cands, sizeof(PromoteCand *));
+    if (!order)
+        error("out of memory");
+    int n = 0;
+    for (int i = 0; i < st.num_cands; i++) {
+        PromoteCand *c = &st.cands[i];
+        if (c->escapes || c->start < 0 || !c->weight)
+            continue;
+        // goto may enter a loop without the addresses loaded before it
+        if (st.unstructured && c->base)
+            continue;
+        if (st.unstructured) {
+            c->start = 0;
+            c->end = st.pos;
+        }
+        int j = n++;
+        while (j > 0 && order[j - 1]->start > c->start) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = c;
+    }
+
+    // Registers 0-7 of the scan are S0-S7, 8-15 A0-A7. The free A registers
+    // of a leaf function cost nothing to use, so they are tried first.
+    int slots[PROMOTE_REGS + PROMOTE_ARG_REGS];
+    int num_slots = 0;
+    for (int a = 0; leaf && a < PROMOTE_ARG_REGS; a++) {
+        if (!arg_busy[a])
+            slots[num_slots++] = PROMOTE_REGS + a;
+    }
+    for (int r = 0; r < PROMOTE_REGS; r++)
+        slots[num_slots++] = r;
+
+    PromoteCand *active[PROMOTE_REGS + PROMOTE_ARG_REGS] = {0};
+    for (int i = 0; i < n; i++) {
+        PromoteCand *c = order[i];
+        int free_reg = -1, victim = -1;
+        for (int k = 0; k < num_slots; k++) {
+            int r = slots[k];
+            if (active[r] && active[r]->end < c->start)
+                active[r] = NULL;
+            if (!active[r]) {
+                if (free_reg < 0)
+                    free_reg = r;
+            } else if (victim < 0 || active[r]->weight < active[victim]->weight) {
+                victim = r;
+            }
+        }
+        if (free_reg < 0 && active[victim]->weight < c->weight) {
+            // Spill the lighter variable back to its slot
+            active[victim]->reg = -1;
+            free_reg = victim;
+        }
+        if (free_reg >= 0) {
+            c->reg = free_reg;
+            active[free_reg] = c;
+        }
+    }
+    free(order);
+
+    // Keep the S registers that save more than their save/restore costs and
+    // number them densely from REG_S0
+    long long benefit[PROMOTE_REGS] = {0};
+    for (int i = 0; i < st.num_cands; i++) {
+        PromoteCand *c = &st.cands[i];
+        if (c->reg >= 0 && c->reg < PROMOTE_REGS)
+            benefit[c->reg] += c->weight -
+                               (c->var->is_param ? PROMOTE_PARAM_COST : 0) -
+                               (c->base ? PROMOTE_HOIST_COST : 0);
+    }
+    int reg_map[PROMOTE_REGS + PROMOTE_ARG_REGS];
+    for (int r = 0; r < PROMOTE_REGS; r++)
+        reg_map[r] = benefit[r] > PROMOTE_SAVE_COST ? REG_S0 + used++ : 0;
+    for (int a = 0; a < PROMOTE_ARG_REGS; a++)
+        reg_map[PROMOTE_REGS + a] = REG_A0 + a;
+    for (int i = 0; i < st.num_cands; i++) {
+        PromoteCand *c = &st.cands[i];
+        if (c->reg >= 0)
+            c->var->reg = reg_map[c->reg];
+        if (c->base && c->var->reg) {
+            Hoist *h = calloc(1, sizeof(Hoist));
+            if (!h)
+                error("out of memory");
+            *h = (Hoist){c->loop, c->base, c->var->reg, promote_hoists};
+            promote_hoists = h;
+        }
+    }
+
+    // ENT3 spills the parameters up to the last one still read from its
+    // slot; unused ones and those loaded from their A register are not
+    if (!is_variadic) {
+        int index = 0;
+        *param_slots = 0;
+        for (Obj *param = fn->params; param; param = param->next) {
+            PromoteCand *c = promote_cand(&st, param);
+            index++;
+            if (param->reg && param_arg_reg(fn, param))
+                continue;
+            if (c && !c->escapes && !c->weight)
+                continue;
+            *param_slots = index;
+        }
+    }
+
+    promote_free(&st);
+    return used;
+}
+
+// Restore the caller's S registers; emitted before every LEV3
+static void emit_promote_restore(JCC *vm) {
+    for (int i = 0; i < promote_num_saved; i++) {
+        emit_lea3(vm, REG_T0, promote_save_offset - i);
+        emit_rr(vm, LDR_D, REG_S0 + i, REG_T0);
+    }
+}
+
 // ========== Forward Declarations ==========
 
 static void gen_expr(JCC *vm, Node *node, int dest_reg);
 static void gen_stmt(JCC *vm, Node *node);
 static void gen_addr(JCC *vm, Node *node, int dest_reg);
+static long long *gen_branch(JCC *vm, Node *cond, bool when_true);
 
 // ========== Nested Function Helpers ==========
 
@@ -387,25 +1160,79 @@ static int calculate_chain_depth(Obj *current_fn, Obj *owner_fn) {
     return depth;
 }
 
+// ========== Struct Returns ==========
+//
+// A call returning a struct or union passes the address of its result in
+// REG_SRET. The callee BCPYs the value there and returns the same address in
+// REG_A0. The destination is normally the call's ret_buffer slot in the
+// caller's frame; assigning the call to a variable or returning it points
+// REG_SRET at the final object instead, so the value is copied only once.
+
+// Call whose result goes to sret_dest (NULL: to the current function's own
+// destination), cleared once its REG_SRET is loaded
+static Node *sret_call = NULL;
+static Node *sret_dest = NULL;
+
+static bool is_struct_call(Node *node) {
+    return (node->kind == ND_FUNCALL || node->kind == ND_BLOCK_CALL) &&
+           node->ty &&
+           (node->ty->kind == TY_STRUCT || node->ty->kind == TY_UNION);
+}
+
+// Load the current function's result destination into rd
+static void emit_load_sret(JCC *vm, Node *node, int rd) {
+    Obj *fn = vm->compiler.current_fn;
+    if (!fn || !fn->sret)
+        error_tok(vm, node->tok, "codegen: struct return without a destination");
+    emit_lea3(vm, rd, fn->sret->offset);
+    emit_rr(vm, LDR_D, rd, rd);
+}
+
+// Point REG_SRET at the result of call; emitted right before CALL/CALLI
+static void emit_sret(JCC *vm, Node *call) {
+    if (call == sret_call) {
+        sret_call = NULL;
+        if (sret_dest)
+            gen_addr(vm, sret_dest, REG_SRET);
+        else
+            emit_load_sret(vm, call, REG_SRET);
+        return;
+    }
+    if (!call->ret_buffer)
+        error_tok(vm, call->tok, "codegen: struct call without a return buffer");
+    emit_lea3(vm, REG_SRET, call->ret_buffer->offset);
+}
+
+// Generate a struct-valued call whose result should land in dest (a
+// variable, or NULL for the current function's destination). Returns false
+// if the call could not take it (foreign functions) and the caller must
+// copy from the address left in dest_reg.
+static bool gen_call_into(JCC *vm, Node *call, Node *dest, int dest_reg) {
+    Node *saved_call = sret_call, *saved_dest = sret_dest;
+    sret_call = call;
+    sret_dest = dest;
+    gen_expr(vm, call, dest_reg);
+    bool taken = sret_call != call;
+    sret_call = saved_call;
+    sret_dest = saved_dest;
+    return taken;
+}
+
 // ========== Address Generation ==========
 
 // Generate address of an lvalue into dest_reg
 static void gen_addr(JCC *vm, Node *node, int dest_reg) {
     switch (node->kind) {
     case ND_VAR:
-        if (node->var->is_function) {
+        if (hoisted_reg(node->var)) {
+            if (dest_reg != hoisted_reg(node->var))
+                emit_mov3(vm, dest_reg, hoisted_reg(node->var));
+        } else if (node->var->is_function) {
             // Function address - emit placeholder and record patch
             emit_ri(vm, LI3, dest_reg, 0); // Placeholder
             long long *addr_loc = vm->text_ptr;
 
-            if (vm->compiler.num_func_addr_patches >= MAX_CALLS) {
-                error("too many function address references");
-            }
-            vm->compiler.func_addr_patches[vm->compiler.num_func_addr_patches]
-                .location = addr_loc;
-            vm->compiler.func_addr_patches[vm->compiler.num_func_addr_patches]
-                .function = node->var;
-            vm->compiler.num_func_addr_patches++;
+            add_func_addr_patch(vm, addr_loc, node->var);
         } else if (node->var->is_local) {
             // Check if this is a captured variable accessed from within a block
             Obj *current_fn = vm->compiler.current_fn;
@@ -503,13 +1330,19 @@ static void gen_addr(JCC *vm, Node *node, int dest_reg) {
         gen_expr(vm, node->lhs, dest_reg);
         return;
 
-    case ND_MEMBER:
+    case ND_MEMBER: {
         // Address of struct.member = &struct + member_offset
+        int base = node->lhs->kind == ND_VAR ? hoisted_reg(node->lhs->var) : 0;
+        if (base && node->member->offset != 0) {
+            emit_addi3(vm, dest_reg, base, node->member->offset);
+            return;
+        }
         gen_addr(vm, node->lhs, dest_reg);
         if (node->member->offset != 0) {
             emit_addi3(vm, dest_reg, dest_reg, node->member->offset);
         }
         return;
+    }
 
     case ND_COMMA:
         gen_expr(vm, node->lhs, REG_ZERO); // Discard result
@@ -528,6 +1361,16 @@ static void gen_addr(JCC *vm, Node *node, int dest_reg) {
         }
         return;
 
+    case ND_FUNCALL:
+    case ND_BLOCK_CALL:
+    case ND_ASSIGN:
+        // f().member: a struct-valued call or assignment evaluates to the
+        // address of its result
+        if (node->ty->kind == TY_STRUCT || node->ty->kind == TY_UNION) {
+            gen_expr(vm, node, dest_reg);
+            return;
+        }
+        // fallthrough
     default:
         error_tok(vm, node->tok, "not an lvalue");
     }
@@ -535,6 +1378,74 @@ static void gen_addr(JCC *vm, Node *node, int dest_reg) {
 
 // ========== Expression Generation ==========
 
+// Integer binary ops with a constant operand compile to one register-immediate
+// instruction (OPI3 rd, rs, imm) instead of LI3 into a temp plus OP3. The
+// constant may be on either side of a commutative op. Returns false when the
+// node has no immediate form.
+static bool gen_binary_imm(JCC *vm, Node *node, int dest_reg) {
+    bool commutes = node->kind == ND_ADD || node->kind == ND_MUL ||
+                    node->kind == ND_BITAND || node->kind == ND_BITOR ||
+                    node->kind == ND_BITXOR;
+    Node *x = node->lhs;
+    long long imm;
+    if (!const_int_operand(node->rhs, &imm)) {
+        if (!commutes || !const_int_operand(node->lhs, &imm))
+            return false;
+        x = node->rhs;
+    }
+
+    int op;
+    switch (node->kind) {
+    case ND_ADD:
+        op = ADDI3;
+        break;
+    case ND_SUB:
+        op = SUBI3;
+        break;
+    case ND_MUL:
+        op = MULI3;
+        break;
+    case ND_BITAND:
+        op = ANDI3;
+        break;
+    case ND_BITOR:
+        op = ORI3;
+        break;
+    case ND_BITXOR:
+        op = XORI3;
+        break;
+    case ND_SHL:
+        op = SHLI3;
+        break;
+    case ND_SHR:
+        op = SHRI3;
+        break;
+    case ND_LT:
+        if (node->lhs->ty->is_unsigned)
+            return false;
+        op = SLTI3;
+        break;
+    case ND_LE:
+        // x <= K is x < K + 1
+        if (node->lhs->ty->is_unsigned || imm == LLONG_MAX)
+            return false;
+        op = SLTI3;
+        imm++;
+        break;
+    default:
+        return false;
+    }
+
+    int rs = promoted_reg(x);
+    if (!rs) {
+        gen_expr(vm, x, dest_reg);
+        rs = dest_reg;
+    }
+    if (dest_reg != REG_ZERO)
+        emit_rri(vm, op, dest_reg, rs, imm);
+    return true;
+}
+
 // Generate code for expression, result in dest_reg (integer) or dest_freg
 // (float)
 static void gen_expr(JCC *vm, Node *node, int dest_reg) {
@@ -548,17 +1459,11 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
 
     case ND_NUM:
         if (is_flonum(node->ty)) {
-            // Float literal - store in data segment and load
-            long long offset = vm->data_ptr - vm->data_seg;
-            offset = (offset + 7) & ~7; // Align
-            vm->data_ptr = vm->data_seg + offset;
-            *(double *)vm->data_ptr = node->fval;
-            vm->data_ptr += sizeof(double);
-
-            int temp = alloc_temp_reg();
-            emit_li3(vm, temp, (long long)(vm->data_seg + offset));
-            emit_rr(vm, FLDR, dest_reg, temp);
-            free_temp_reg(temp);
+            // Float literal: FLI carries the double's bits in its immediate
+            double fval = node->fval;
+            long long bits;
+            memcpy(&bits, &fval, sizeof(bits));
+            emit_ri(vm, FLI, dest_reg, bits);
         } else {
             emit_li3(vm, dest_reg, node->val);
         }
@@ -572,20 +1477,22 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
             long long *addr_loc = vm->text_ptr; // Get the immediate slot
 
             // Record patch location for later resolution
-            if (vm->compiler.num_func_addr_patches >= MAX_CALLS) {
-                error("too many function address references");
-            }
-            vm->compiler.func_addr_patches[vm->compiler.num_func_addr_patches]
-                .location = addr_loc;
-            vm->compiler.func_addr_patches[vm->compiler.num_func_addr_patches]
-                .function = node->var;
-            vm->compiler.num_func_addr_patches++;
+            add_func_addr_patch(vm, addr_loc, node->var);
         } else {
             // For float types, FREG_A0-A7 have the same raw numbers as
             // REG_A0-A7 Using dest_reg for address calculation would clobber
             // integer regs Solution: use a temp register for address, then load
             // into dest_reg
-            if (is_flonum(node->ty)) {
+            if (node->var->reg) {
+                // Promoted local: the value is already in its S register
+                if (dest_reg != node->var->reg)
+                    emit_mov3(vm, dest_reg, node->var->reg);
+            } else if (hoisted_reg(node->var) && node->ty->kind != TY_ARRAY &&
+                       node->ty->kind != TY_STRUCT &&
+                       node->ty->kind != TY_UNION) {
+                // Load through the address hoisted out of the loop
+                emit_load(vm, node->ty, dest_reg, hoisted_reg(node->var));
+            } else if (is_flonum(node->ty)) {
                 int r_addr = alloc_temp_reg();
                 gen_addr(vm, node, r_addr);
                 emit_load(vm, node->ty, dest_reg, r_addr);
@@ -647,6 +1554,9 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
     case ND_NE:
     case ND_LT:
     case ND_LE: {
+        if (!is_flonum(node->lhs->ty) && gen_binary_imm(vm, node, dest_reg))
+            return;
+
         // Check if RHS contains a function call - if so, we need to save LHS
         // because function calls clobber caller-saved temp registers
         bool rhs_has_call = contains_funcall(node->rhs);
@@ -715,15 +1625,23 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
             }
             emit_frrr(vm, fop, dest_reg, dest_reg, r_rhs);
         } else {
-            // Integer operations
-            gen_expr(vm, node->lhs, dest_reg); // LHS goes directly to dest
+            // Integer operations. LHS goes directly to dest; promoted locals
+            // are used in their S registers without a copy.
+            int r_lhs = promoted_reg(node->lhs);
+            if (!r_lhs) {
+                gen_expr(vm, node->lhs, dest_reg);
+                r_lhs = dest_reg;
+            }
 
             // CRITICAL: LHS might contain a function call which resets temp
             // regs. Re-mark dest_reg as used so RHS calculation doesn't clobber
             // it.
             mark_temp_reg_used(dest_reg);
 
-            if (rhs_has_call) {
+            int r_rhs_val = promoted_reg(node->rhs);
+            if (r_rhs_val) {
+                // Nothing to evaluate
+            } else if (rhs_has_call && r_lhs == dest_reg) {
                 // Save LHS to stack before function call in RHS
                 emit_psh3(vm, dest_reg);
                 gen_expr(vm, node->rhs, r_rhs);
@@ -732,6 +1650,8 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
             } else {
                 gen_expr(vm, node->rhs, r_rhs);
             }
+            if (!r_rhs_val)
+                r_rhs_val = r_rhs;
 
             int op;
             switch (node->kind) {
@@ -780,7 +1700,7 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
             default:
                 error("unsupported int op");
             }
-            emit_rrr(vm, op, dest_reg, dest_reg, r_rhs);
+            emit_rrr(vm, op, dest_reg, r_lhs, r_rhs_val);
         }
 
         free_temp_reg(r_rhs);
@@ -792,31 +1712,56 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         // If RHS is a function call, it will clobber temp registers.
         // Computing LHS address after ensures we get a fresh temp reg.
 
-        // For struct/union assignments, we need memcpy (both LHS and RHS are
-        // addresses)
+        // For struct/union assignments, we need a block copy (both LHS and
+        // RHS are addresses)
         if (node->ty &&
             (node->ty->kind == TY_STRUCT || node->ty->kind == TY_UNION)) {
-            // Struct/union assignment: memcpy from RHS address to LHS address
             int r_src = alloc_temp_reg();
-            gen_expr(vm, node->rhs, r_src); // RHS is struct address
+            if (is_struct_call(node->rhs) && node->lhs->kind == ND_VAR) {
+                // The callee writes straight into the variable
+                if (gen_call_into(vm, node->rhs, node->lhs, r_src)) {
+                    if (dest_reg != REG_ZERO)
+                        emit_mov3(vm, dest_reg, r_src);
+                    free_temp_reg(r_src);
+                    return;
+                }
+            } else {
+                gen_expr(vm, node->rhs, r_src); // RHS is struct address
+            }
             mark_temp_reg_used(r_src);
 
             int r_dest = alloc_temp_reg();
             gen_addr(vm, node->lhs, r_dest); // LHS address
+            if (node->ty->size > 0)
+                emit_rri(vm, BCPY, r_dest, r_src, node->ty->size);
 
-            // MCPY: REG_A0=dest, REG_A1=src, REG_A2=size
-            emit_mov3(vm, REG_A0, r_dest);
-            emit_mov3(vm, REG_A1, r_src);
-            emit_li3(vm, REG_A2, node->ty->size);
-            emit(vm, MCPY);
-
+            // Assignment expression result is the destination address
+            if (dest_reg != REG_ZERO) {
+                emit_mov3(vm, dest_reg, r_dest);
+            }
             free_temp_reg(r_src);
             free_temp_reg(r_dest);
+            return;
+        }
 
-            // Assignment expression result is the destination address
-            if (dest_reg != REG_ZERO) {
-                emit_mov3(vm, dest_reg, REG_A0);
+        // Promoted local: evaluate straight into its S register unless the
+        // RHS still reads it
+        if (node->lhs->kind == ND_VAR && node->lhs->var->reg) {
+            Obj *var = node->lhs->var;
+            int r_val = var->reg;
+            if (!can_target_promoted(node->rhs, var->reg))
+                r_val = alloc_temp_reg();
+            gen_expr(vm, node->rhs, r_val);
+            if (is_narrowed(node->rhs, var->ty)) {
+                if (r_val != var->reg)
+                    emit_mov3(vm, var->reg, r_val);
+            } else {
+                emit_narrow(vm, var->ty, var->reg, r_val);
             }
+            if (r_val != var->reg)
+                free_temp_reg(r_val);
+            if (dest_reg != REG_ZERO)
+                emit_mov3(vm, dest_reg, var->reg);
             return;
         }
 
@@ -837,9 +1782,15 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         // called. We need to re-mark r_val as in-use before allocating r_addr!
         mark_temp_reg_used(r_val);
 
-        // Now compute LHS address (after any function calls in RHS are done)
+        // Now compute LHS address (after any function calls in RHS are done).
+        // A variable whose address is hoisted is stored through it directly.
         int r_addr = alloc_temp_reg();
-        gen_addr(vm, node->lhs, r_addr);
+        int r_store =
+            node->lhs->kind == ND_VAR ? hoisted_reg(node->lhs->var) : 0;
+        if (!r_store) {
+            gen_addr(vm, node->lhs, r_addr);
+            r_store = r_addr;
+        }
 
         // Handle Bitfields specially (Read-Modify-Write)
         if (node->lhs->kind == ND_MEMBER && node->lhs->member->is_bitfield) {
@@ -881,7 +1832,7 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
             free_temp_reg(r_container);
         } else {
             // Standard store
-            emit_store(vm, node->ty, r_val, r_addr);
+            emit_store(vm, node->ty, r_val, r_store);
         }
 
         free_temp_reg(r_addr);
@@ -900,10 +1851,7 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
 
     case ND_COND: {
         // Ternary: cond ? then : else
-        int r_cond = alloc_temp_reg();
-        gen_expr(vm, node->cond, r_cond);
-        long long *jz_else = emit_jz3(vm, r_cond);
-        free_temp_reg(r_cond);
+        long long *jz_else = gen_branch(vm, node->cond, false);
 
         gen_expr(vm, node->then, dest_reg);
         emit(vm, JMP);
@@ -965,8 +1913,16 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         }
         return;
 
-    case ND_CAST:
+    case ND_CAST: {
+        int reg = promoted_reg(node);
+        if (reg) {
+            if (dest_reg != reg)
+                emit_mov3(vm, dest_reg, reg);
+            return;
+        }
         gen_expr(vm, node->lhs, dest_reg);
+        if (dest_reg == REG_ZERO)
+            return;
         // Add type conversion if needed
         if (is_flonum(node->ty) && !is_flonum(node->lhs->ty)) {
             // int -> float
@@ -991,6 +1947,7 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
             }
         }
         return;
+    }
 
     case ND_FUNCALL: {
         // Check if this is a builtin alloca call (used for VLAs)
@@ -1358,23 +2315,20 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         // Call function
         if (node->lhs->kind == ND_VAR && node->lhs->var->is_function) {
             Obj *fn = node->lhs->var;
+            if (is_struct_call(node))
+                emit_sret(vm, node);
             emit(vm, CALL);
             long long *patch = ++vm->text_ptr;
             *patch = 0; // Will be patched later
 
             // Record call patch location for later resolution
-            if (vm->compiler.num_call_patches >= MAX_CALLS) {
-                error("too many function calls");
-            }
-            vm->compiler.call_patches[vm->compiler.num_call_patches].location =
-                patch;
-            vm->compiler.call_patches[vm->compiler.num_call_patches].function =
-                fn;
-            vm->compiler.num_call_patches++;
+            add_call_patch(vm, patch, fn);
         } else {
             // Indirect call - function pointer in register
             int r_fn = alloc_temp_reg();
             gen_expr(vm, node->lhs, r_fn);
+            if (is_struct_call(node))
+                emit_sret(vm, node);
             emit(vm, CALLI);
             *++vm->text_ptr = ENCODE_R(r_fn);
             free_temp_reg(r_fn);
@@ -1389,10 +2343,6 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         // Reset allocator so caller will recompute any addresses it needs
         reset_temp_regs();
 
-        // Note: With runtime return buffer rotation (RETBUF opcode), chained
-        // calls like f(g(), h()) automatically get different buffers for g()
-        // and h()'s results. No caller-side copy is needed.
-
         // Result in REG_A0/FREG_A0
         if (is_flonum(node->ty)) {
             if (dest_reg != FREG_A0) {
@@ -1498,7 +2448,8 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         // Get the address slot we just wrote to
         long long *label_addr_loc = vm->text_ptr;
         // Record patch location so it gets resolved when label is defined
-        add_label_patch(node->unique_label ? node->unique_label : node->label,
+        add_label_patch(vm,
+                        node->unique_label ? node->unique_label : node->label,
                         label_addr_loc);
         return;
 
@@ -1533,13 +2484,7 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         long long *invoke_addr_loc = vm->text_ptr;
 
         // Record patch for block function address
-        if (vm->compiler.num_func_addr_patches >= MAX_CALLS)
-            error("too many function address references");
-        vm->compiler.func_addr_patches[vm->compiler.num_func_addr_patches]
-            .location = invoke_addr_loc;
-        vm->compiler.func_addr_patches[vm->compiler.num_func_addr_patches]
-            .function = node->block_fn;
-        vm->compiler.num_func_addr_patches++;
+        add_func_addr_patch(vm, invoke_addr_loc, node->block_fn);
 
         // Store invoke pointer at descriptor[0]
         emit_rr(vm, STR_D, r_invoke, r_desc);
@@ -1622,6 +2567,8 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
         // Pass descriptor in A0 (for __static_link access to captures)
         emit_mov3(vm, REG_A0, r_desc);
         free_temp_reg(r_desc);
+        if (is_struct_call(node))
+            emit_sret(vm, node);
 
         // Indirect call via function pointer
         emit(vm, CALLI);
@@ -1648,8 +2595,350 @@ static void gen_expr(JCC *vm, Node *node, int dest_reg) {
     }
 }
 
+// ========== Conditional Branches ==========
+
+// Emit a branch taken when cond evaluates to when_true and return its patch
+// location. Integer comparisons compile to one compare-and-branch (with an
+// immediate operand when one side is constant) instead of SLT3/SEQ3/... into
+// a temp followed by JZ3/JNZ3.
+static long long *gen_branch(JCC *vm, Node *cond, bool when_true) {
+    if (cond->kind == ND_NOT && !is_flonum(cond->lhs->ty))
+        return gen_branch(vm, cond->lhs, !when_true);
+
+    bool is_compare = cond->kind == ND_EQ || cond->kind == ND_NE ||
+                      cond->kind == ND_LT || cond->kind == ND_LE;
+    if (!is_compare || is_flonum(cond->lhs->ty) ||
+        (contains_funcall(cond->lhs) && contains_funcall(cond->rhs))) {
+        int r_cond = alloc_temp_reg();
+        gen_expr(vm, cond, r_cond);
+        long long *patch = when_true ? emit_jnz3(vm, r_cond)
+                                     : emit_jz3(vm, r_cond);
+        free_temp_reg(r_cond);
+        return patch;
+    }
+
+    // Branch if x REL y, REL being one of BEQ/BNE/BLT/BGE
+    Node *x = cond->lhs, *y = cond->rhs;
+    int rel;
+    switch (cond->kind) {
+    case ND_EQ:
+        rel = when_true ? BEQ : BNE;
+        break;
+    case ND_NE:
+        rel = when_true ? BNE : BEQ;
+        break;
+    case ND_LT:
+        rel = when_true ? BLT : BGE;
+        break;
+    default:
+        // a <= b is b >= a, and !(a <= b) is b < a
+        rel = when_true ? BGE : BLT;
+        x = cond->rhs;
+        y = cond->lhs;
+        break;
+    }
+    bool is_unsigned = cond->lhs->ty->is_unsigned;
+
+    // Put a constant on the right: K < y is y >= K + 1, K >= y is y < K + 1
+    long long imm;
+    bool has_imm = const_int_operand(y, &imm);
+    if (!has_imm && const_int_operand(x, &imm)) {
+        long long limit = is_unsigned ? -1 : LLONG_MAX;
+        if (rel == BEQ || rel == BNE || imm != limit) {
+            if (rel == BLT || rel == BGE) {
+                rel = rel == BLT ? BGE : BLT;
+                imm++;
+            }
+            x = y;
+            has_imm = true;
+        }
+    }
+
+    if (is_unsigned && rel == BLT)
+        rel = BLTU;
+    else if (is_unsigned && rel == BGE)
+        rel = BGEU;
+
+    // Promoted locals are compared in their S registers
+    long long *patch;
+    if (has_imm) {
+        int r_x = alloc_temp_reg();
+        int s_x = promoted_reg(x);
+        if (!s_x) {
+            gen_expr(vm, x, r_x);
+            s_x = r_x;
+        }
+        patch = emit_branch_imm(vm, rel + (BEQI - BEQ), s_x, imm);
+        free_temp_reg(r_x);
+        return patch;
+    }
+
+    // Evaluate the side with a call first so it cannot clobber the other
+    // (the operands of a comparison are unsequenced)
+    bool swap = contains_funcall(y);
+    int r_x = alloc_temp_reg();
+    int r_y = alloc_temp_reg();
+    int s_x = promoted_reg(x), s_y = promoted_reg(y);
+    if (swap) {
+        if (!s_y)
+            gen_expr(vm, y, r_y);
+        mark_temp_reg_used(r_y);
+        mark_temp_reg_used(r_x);
+        if (!s_x)
+            gen_expr(vm, x, r_x);
+    } else {
+        if (!s_x)
+            gen_expr(vm, x, r_x);
+        mark_temp_reg_used(r_x);
+        mark_temp_reg_used(r_y);
+        if (!s_y)
+            gen_expr(vm, y, r_y);
+    }
+    patch = emit_branch(vm, rel, s_x ? s_x : r_x, s_y ? s_y : r_y);
+    free_temp_reg(r_x);
+    free_temp_reg(r_y);
+    return patch;
+}
+
+// ========== Switch Lowering ==========
+//
+// The cases of a switch (a GNU case range counts as one) are sorted by
+// value and grouped into clusters: a run of at least SWITCH_TABLE_MIN cases
+// that covers SWITCH_TABLE_DENSITY percent of its span becomes a JMPT jump
+// table, every other case is a cluster of its own. Dispatch is a binary
+// search over the clusters with compare-and-branch instructions, ending in
+// a jump table or a short chain of tests. Targets are patched once the
+// switch body has been generated.
+
+#define SWITCH_TABLE_MIN 4        // Fewest cases worth a jump table
+#define SWITCH_TABLE_MAX 4096     // Most jump table entries
+#define SWITCH_TABLE_DENSITY 40   // Percent of the span a table must cover
+#define SWITCH_CHAIN_MAX 3        // Clusters tested one after another
+
+typedef struct {
+    int lo, hi;      // Cases [lo, hi) of current_switch_cases
+    bool is_table;
+} SwitchCluster;
+
+typedef struct {
+    int index;            // Case index, or -1 for the default
+    long long *location;  // Target operand to patch
+} SwitchPatch;
+
+typedef struct {
+    SwitchCase *cases;
+    SwitchCluster *clusters;
+    int r_val;           // Register holding the controlling expression
+    bool is_unsigned;    // Compare values as unsigned
+    SwitchPatch *patches;
+    int num_patches, patches_cap;
+} SwitchGen;
+
+// A case value as the controlling expression holds it: its type is at
+// least as wide as int after promotion, and values are kept sign- or
+// zero-extended to 64 bits
+static long long switch_value(Type *ty, long long val) {
+    if (ty->size == 4 && ty->is_unsigned)
+        return (unsigned int)val;
+    return val;
+}
+
+static bool switch_unsigned(Type *ty) {
+    return ty->is_unsigned && ty->size >= 4;
+}
+
+static int switch_cmp(bool is_unsigned, long long a, long long b) {
+    if (is_unsigned)
+        return (unsigned long long)a < (unsigned long long)b   ? -1
+               : (unsigned long long)a > (unsigned long long)b ? 1
+                                                               : 0;
+    return a < b ? -1 : a > b ? 1 : 0;
+}
+
+static int switch_case_cmp_signed(const void *a, const void *b) {
+    return switch_cmp(false, ((SwitchCase *)a)->begin,
+                      ((SwitchCase *)b)->begin);
+}
+
+static int switch_case_cmp_unsigned(const void *a, const void *b) {
+    return switch_cmp(true, ((SwitchCase *)a)->begin,
+                      ((SwitchCase *)b)->begin);
+}
+
+// Number of values from cases[lo].begin to cases[hi - 1].end, saturated
+// past SWITCH_TABLE_MAX
+static unsigned long long switch_span(SwitchCase *cases, int lo, int hi) {
+    unsigned long long span =
+        (unsigned long long)cases[hi - 1].end - cases[lo].begin;
+    return span >= SWITCH_TABLE_MAX ? SWITCH_TABLE_MAX + 1 : span + 1;
+}
+
+// Split the sorted cases into clusters; returns the number of clusters
+static int switch_clusters(SwitchCase *cases, int n, SwitchCluster *out) {
+    // covered[i]: values matched by cases [0, i), saturated like the span
+    unsigned long long *covered = calloc(n + 1, sizeof(unsigned long long));
+    if (!covered)
+        error("out of memory");
+    for (int i = 0; i < n; i++)
+        covered[i + 1] = covered[i] + switch_span(cases, i, i + 1);
+
+    int count = 0;
+    for (int i = 0; i < n;) {
+        // The longest dense run from i (density is not monotonic, so keep
+        // looking until the span alone rules a table out)
+        int best = i + 1;
+        for (int j = i + 1; j <= n; j++) {
+            unsigned long long span = switch_span(cases, i, j);
+            if (span > SWITCH_TABLE_MAX)
+                break;
+            if (j - i >= SWITCH_TABLE_MIN &&
+                (covered[j] - covered[i]) * 100 >= span * SWITCH_TABLE_DENSITY)
+                best = j;
+        }
+        out[count++] = (SwitchCluster){i, best, best - i > 1};
+        i = best;
+    }
+    free(covered);
+    return count;
+}
+
+static void switch_patch(SwitchGen *sg, int index, long long *location) {
+    if (sg->num_patches == sg->patches_cap) {
+        sg->patches_cap = sg->patches_cap ? sg->patches_cap * 2 : 64;
+        sg->patches =
+            realloc(sg->patches, sizeof(SwitchPatch) * sg->patches_cap);
+        if (!sg->patches)
+            error("out of memory");
+    }
+    sg->patches[sg->num_patches++] = (SwitchPatch){index, location};
+}
+
+static void switch_jump(JCC *vm, SwitchGen *sg, int index) {
+    emit(vm, JMP);
+    long long *patch = ++vm->text_ptr;
+    *patch = 0;
+    switch_patch(sg, index, patch);
+}
+
+// Test for one case, jumping to it on a match
+static void switch_test(JCC *vm, SwitchGen *sg, int index) {
+    SwitchCase *c = &sg->cases[index];
+    if (c->begin == c->end) {
+        switch_patch(sg, index,
+                     emit_branch_imm(vm, BEQI, sg->r_val, c->begin));
+        return;
+    }
+    // begin <= val <= end as one unsigned compare of val - begin
+    int r_off = alloc_temp_reg();
+    emit_rri(vm, SUBI3, r_off, sg->r_val, c->begin);
+    switch_patch(sg, index,
+                 emit_branch_imm(vm, BLTUI, r_off,
+                                 (unsigned long long)c->end - c->begin + 1));
+    free_temp_reg(r_off);
+}
+
+// JMPT over the cases of a table cluster, falling through to the default
+static void switch_table(JCC *vm, SwitchGen *sg, SwitchCluster *cl) {
+    SwitchCase *cases = sg->cases;
+    long long min = cases[cl->lo].begin;
+    long long span = (long long)switch_span(cases, cl->lo, cl->hi);
+
+    int r_index = sg->r_val;
+    if (min != 0) {
+        r_index = alloc_temp_reg();
+        emit_rri(vm, SUBI3, r_index, sg->r_val, min);
+    }
+    emit(vm, JMPT);
+    *++vm->text_ptr = ENCODE_R(r_index);
+    *++vm->text_ptr = span;
+    long long *table = ++vm->text_ptr;
+    if (r_index != sg->r_val)
+        free_temp_reg(r_index);
+    switch_jump(vm, sg, -1);
+
+    *table = (long long)(vm->text_ptr + 1);
+    int index = cl->lo;
+    for (long long i = 0; i < span; i++) {
+        long long val = min + i;
+        while (switch_cmp(sg->is_unsigned, cases[index].end, val) < 0)
+            index++;
+        bool hit = switch_cmp(sg->is_unsigned, cases[index].begin, val) <= 0;
+        switch_jump(vm, sg, hit ? index : -1);
+    }
+}
+
+// Dispatch over clusters [lo, hi); every path ends in a jump
+static void switch_tree(JCC *vm, SwitchGen *sg, int lo, int hi) {
+    bool has_table = false;
+    for (int i = lo; i < hi; i++)
+        has_table |= sg->clusters[i].is_table;
+
+    if (hi - lo == 1 && has_table) {
+        switch_table(vm, sg, &sg->clusters[lo]);
+        return;
+    }
+    if (hi - lo <= SWITCH_CHAIN_MAX && !has_table) {
+        for (int i = lo; i < hi; i++)
+            switch_test(vm, sg, sg->clusters[i].lo);
+        switch_jump(vm, sg, -1);
+        return;
+    }
+
+    // Values below the middle cluster go left
+    int mid = lo + (hi - lo) / 2;
+    long long pivot = sg->cases[sg->clusters[mid].lo].begin;
+    long long *left =
+        emit_branch_imm(vm, sg->is_unsigned ? BLTUI : BLTI, sg->r_val, pivot);
+    switch_tree(vm, sg, mid, hi);
+    *left = (long long)(vm->text_ptr + 1);
+    switch_tree(vm, sg, lo, mid);
+}
+
 // ========== Statement Generation ==========
 
+// Load the addresses hoisted out of loop into their registers, unless an
+// enclosing loop is generating (they belong to the outermost one). Returns
+// the loop to restore hoist_loop to afterwards.
+static Node *begin_hoists(JCC *vm, Node *loop) {
+    Node *outer = hoist_loop;
+    if (outer)
+        return outer;
+    for (Hoist *h = promote_hoists; h; h = h->next) {
+        if (h->loop != loop)
+            continue;
+        if (h->var->is_local)
+            emit_lea3(vm, h->reg, h->var->offset);
+        else
+            emit_li3(vm, h->reg, (long long)(vm->data_seg + h->var->offset));
+    }
+    hoist_loop = loop;
+    return NULL;
+}
+
+// Largest loop condition generated twice, in AST nodes
+#define LOOP_COND_COPY_NODES 16
+
+// Can a loop condition be generated both before the loop and after the
+// body? Statement expressions and blocks would define labels and code twice.
+static bool is_copyable_cond(Node *node, int *budget) {
+    if (!node)
+        return true;
+    if (--*budget < 0 || node->kind == ND_STMT_EXPR ||
+        node->kind == ND_BLOCK_LITERAL)
+        return false;
+    if (!is_copyable_cond(node->lhs, budget) ||
+        !is_copyable_cond(node->rhs, budget) ||
+        !is_copyable_cond(node->cond, budget) ||
+        !is_copyable_cond(node->then, budget) ||
+        !is_copyable_cond(node->els, budget))
+        return false;
+    for (Node *n = node->args; n; n = n->next) {
+        if (!is_copyable_cond(n, budget))
+            return false;
+    }
+    return true;
+}
+
 static void gen_stmt(JCC *vm, Node *node) {
     if (!node)
         return;
@@ -1669,47 +2958,59 @@ static void gen_stmt(JCC *vm, Node *node) {
     case ND_RETURN:
         reset_temp_regs();
         if (node->lhs) {
-            // If returning struct/union, copy to return buffer at runtime
+            // If returning struct/union, copy it to the caller's destination
+            // and return that address
             if (node->lhs->ty && (node->lhs->ty->kind == TY_STRUCT ||
                                   node->lhs->ty->kind == TY_UNION)) {
-                // Evaluate source (struct address) into a temp register first
+                // Evaluate source (struct address) into a temp register
+                // first. return f(...) hands our destination on to f.
                 int r_src = alloc_temp_reg();
-                gen_expr(vm, node->lhs, r_src);
-
-                // Get next buffer from rotating pool at runtime
-                // RETBUF puts the buffer address in REG_A0
-                emit(vm, RETBUF);
-                int r_dest = alloc_temp_reg();
-                emit_mov3(vm, r_dest, REG_A0); // Save buffer address
-
-                // MCPY uses registers: dest in REG_A0, src in REG_A1, count in
-                // REG_A2 REG_A0 already has dest from RETBUF, but we saved it
-                // to r_dest
-                emit_mov3(vm, REG_A1, r_src); // src = struct address
-                emit_li3(vm, REG_A2, node->lhs->ty->size); // count
-                emit_mov3(vm, REG_A0, r_dest); // dest = buffer address
-                emit(vm, MCPY);
-
-                // Return buffer address in REG_A0 (already there from r_dest)
-                emit_mov3(vm, REG_A0, r_dest);
-
+                if (is_struct_call(node->lhs) &&
+                    gen_call_into(vm, node->lhs, NULL, r_src)) {
+                    emit_mov3(vm, REG_A0, r_src);
+                } else {
+                    if (!is_struct_call(node->lhs))
+                        gen_expr(vm, node->lhs, r_src);
+                    mark_temp_reg_used(r_src);
+
+                    int r_dest = alloc_temp_reg();
+                    emit_load_sret(vm, node, r_dest);
+                    if (node->lhs->ty->size > 0)
+                        emit_rri(vm, BCPY, r_dest, r_src,
+                                 node->lhs->ty->size);
+                    emit_mov3(vm, REG_A0, r_dest);
+                    free_temp_reg(r_dest);
+                }
                 free_temp_reg(r_src);
-                free_temp_reg(r_dest);
             } else if (is_flonum(node->lhs->ty)) {
-                gen_expr(vm, node->lhs, FREG_A0);
+                // Integer operands converted on the way are evaluated into
+                // the integer register numbered like the float destination
+                if (reads_promoted_reg(node->lhs, REG_A0)) {
+                    int r_val = alloc_temp_reg();
+                    gen_expr(vm, node->lhs, r_val);
+                    emit_frr(vm, FNEG3, FREG_A0, r_val);
+                    emit_frr(vm, FNEG3, FREG_A0, FREG_A0);
+                    free_temp_reg(r_val);
+                } else {
+                    gen_expr(vm, node->lhs, FREG_A0);
+                }
+            } else if (!can_target_promoted(node->lhs, REG_A0)) {
+                // A parameter still needed lives in REG_A0
+                int r_val = alloc_temp_reg();
+                gen_expr(vm, node->lhs, r_val);
+                emit_mov3(vm, REG_A0, r_val);
+                free_temp_reg(r_val);
             } else {
                 gen_expr(vm, node->lhs, REG_A0);
             }
         }
+        emit_promote_restore(vm);
         emit(vm, LEV3);
         return;
 
     case ND_IF: {
         reset_temp_regs();
-        int r_cond = alloc_temp_reg();
-        gen_expr(vm, node->cond, r_cond);
-        long long *jz_else = emit_jz3(vm, r_cond);
-        free_temp_reg(r_cond);
+        long long *jz_else = gen_branch(vm, node->cond, false);
 
         gen_stmt(vm, node->then);
 
@@ -1730,19 +3031,29 @@ static void gen_stmt(JCC *vm, Node *node) {
         if (node->init) {
             gen_stmt(vm, node->init);
         }
-
-        long long *loop_start = vm->text_ptr + 1;
-
-        // Condition
-        long long *jz_end = NULL;
-        if (node->cond) {
+        Node *outer_loop = begin_hoists(vm, node);
+
+        // Rotated: the condition is tested after the body, so an iteration
+        // takes a single branch back to the top. A small condition is also
+        // tested once before entering; a larger one is jumped to instead.
+        Node *cond = node->cond;
+        long long val;
+        if (cond && const_int_operand(cond, &val) && val != 0)
+            cond = NULL;
+        long long *jz_end = NULL, *jmp_cond = NULL;
+        if (cond) {
             reset_temp_regs();
-            int r_cond = alloc_temp_reg();
-            gen_expr(vm, node->cond, r_cond);
-            jz_end = emit_jz3(vm, r_cond);
-            free_temp_reg(r_cond);
+            int budget = LOOP_COND_COPY_NODES;
+            if (is_copyable_cond(cond, &budget)) {
+                jz_end = gen_branch(vm, cond, false);
+            } else {
+                emit(vm, JMP);
+                jmp_cond = ++vm->text_ptr;
+            }
         }
 
+        long long *loop_start = vm->text_ptr + 1;
+
         // Body
         gen_stmt(vm, node->then);
 
@@ -1757,8 +3068,16 @@ static void gen_stmt(JCC *vm, Node *node) {
             gen_expr(vm, node->inc, REG_ZERO);
         }
 
-        // Jump back to start
-        emit_with_arg(vm, JMP, (long long)loop_start);
+        // Branch back to the start while the condition holds
+        if (cond) {
+            if (jmp_cond)
+                *jmp_cond = (long long)(vm->text_ptr + 1);
+            reset_temp_regs();
+            long long *jnz_start = gen_branch(vm, cond, true);
+            *jnz_start = (long long)loop_start;
+        } else {
+            emit_with_arg(vm, JMP, (long long)loop_start);
+        }
 
         // Define break label (jumps past loop)
         if (node->brk_label) {
@@ -1769,10 +3088,12 @@ static void gen_stmt(JCC *vm, Node *node) {
         if (jz_end) {
             *jz_end = (long long)(vm->text_ptr + 1);
         }
+        hoist_loop = outer_loop;
         return;
     }
 
     case ND_DO: {
+        Node *outer_loop = begin_hoists(vm, node);
         long long *loop_start = vm->text_ptr + 1;
 
         gen_stmt(vm, node->then);
@@ -1783,119 +3104,114 @@ static void gen_stmt(JCC *vm, Node *node) {
         }
 
         reset_temp_regs();
-        int r_cond = alloc_temp_reg();
-        gen_expr(vm, node->cond, r_cond);
-        long long *jnz_start = emit_jnz3(vm, r_cond);
+        long long *jnz_start = gen_branch(vm, node->cond, true);
         *jnz_start = (long long)loop_start;
-        free_temp_reg(r_cond);
 
         // Define break label (jumps past loop)
         if (node->brk_label) {
             define_label(vm, node->brk_label);
         }
+        hoist_loop = outer_loop;
         return;
     }
 
     case ND_SWITCH: {
-        // Simple switch implementation using linear search
-        // Evaluate switch expression
         reset_temp_regs();
-        int r_val = alloc_temp_reg();
-        gen_expr(vm, node->cond, r_val);
+        SwitchGen sg = {0};
+        sg.r_val = alloc_temp_reg();
+        gen_expr(vm, node->cond, sg.r_val);
 
-// Count cases and collect case nodes and patch addresses
-#define MAX_SWITCH_CASES 256
-        Node *case_nodes[MAX_SWITCH_CASES];
-        long long *case_patches[MAX_SWITCH_CASES];
+        Type *ty = node->cond->ty;
+        sg.is_unsigned = switch_unsigned(ty);
         int num_cases = 0;
-
-        // For each case, compare and emit jump (placeholder)
-        for (Node *n = node->case_next; n; n = n->case_next) {
-            if (num_cases >= MAX_SWITCH_CASES)
-                break;
-            case_nodes[num_cases] = n; // Store node pointer for matching
-
-            int r_case = alloc_temp_reg();
-            emit_li3(vm, r_case, n->begin);
-            emit_rrr(vm, SEQ3, r_case, r_val, r_case);
-            case_patches[num_cases] = emit_jnz3(vm, r_case);
-            free_temp_reg(r_case);
+        for (Node *n = node->case_next; n; n = n->case_next)
             num_cases++;
-        }
-
-        // Jump to default or end
-        long long *default_patch = NULL;
-        long long *end_patch = NULL;
-        emit(vm, JMP);
-        if (node->default_case) {
-            default_patch = ++vm->text_ptr;
+        sg.cases = calloc(num_cases + 1, sizeof(SwitchCase));
+        sg.clusters = calloc(num_cases + 1, sizeof(SwitchCluster));
+        if (!sg.cases || !sg.clusters)
+            error("out of memory");
+        int i = 0;
+        for (Node *n = node->case_next; n; n = n->case_next, i++)
+            sg.cases[i] = (SwitchCase){n, switch_value(ty, n->begin),
+                                       switch_value(ty, n->end), NULL};
+        qsort(sg.cases, num_cases, sizeof(SwitchCase),
+              sg.is_unsigned ? switch_case_cmp_unsigned
+                             : switch_case_cmp_signed);
+        for (i = 0; i < num_cases; i++) {
+            SwitchCase *c = &sg.cases[i];
+            if (switch_cmp(sg.is_unsigned, c->end, c->begin) < 0)
+                error_tok(vm, c->node->tok, "empty case range specified");
+            if (i > 0 && switch_cmp(sg.is_unsigned, c->begin, c[-1].end) <= 0)
+                error_tok(vm, c->node->tok, "duplicate case value");
+        }
+
+        // Dispatch, then the body with its case labels
+        if (num_cases == 0) {
+            switch_jump(vm, &sg, -1);
         } else {
-            end_patch = ++vm->text_ptr;
+            int num_clusters = switch_clusters(sg.cases, num_cases, sg.clusters);
+            switch_tree(vm, &sg, 0, num_clusters);
         }
+        free_temp_reg(sg.r_val);
 
-        // Generate switch body - it's a single block or statement
-        // When ND_CASE nodes are encountered during body generation,
-        // we need to patch their corresponding jumps
-        // Store current case info in compiler state for ND_CASE to use
-        Node *saved_case_nodes[MAX_SWITCH_CASES];
-        long long *saved_case_patches[MAX_SWITCH_CASES];
-        int saved_num_cases = vm->compiler.current_sparse_num;
-        for (int i = 0; i < num_cases; i++) {
-            saved_case_nodes[i] = vm->compiler.sparse_case_nodes[i];
-            saved_case_patches[i] = vm->compiler.sparse_jump_addrs[i];
-        }
-
-        // Set current switch state
-        vm->compiler.current_sparse_num = num_cases;
-        for (int i = 0; i < num_cases; i++) {
-            vm->compiler.sparse_case_nodes[i] = case_nodes[i];
-            vm->compiler.sparse_jump_addrs[i] = case_patches[i];
-        }
+        SwitchCase *saved_cases = vm->compiler.current_switch_cases;
+        int saved_num = vm->compiler.current_switch_num;
+        Type *saved_type = vm->compiler.current_switch_type;
         Node *saved_default = vm->compiler.current_switch_default;
-        long long *saved_default_patch = vm->compiler.current_default_patch;
+        long long *saved_default_addr = vm->compiler.current_default_addr;
+        vm->compiler.current_switch_cases = sg.cases;
+        vm->compiler.current_switch_num = num_cases;
+        vm->compiler.current_switch_type = ty;
         vm->compiler.current_switch_default = node->default_case;
-        vm->compiler.current_default_patch = default_patch;
+        vm->compiler.current_default_addr = NULL;
 
-        // Generate the switch body
         gen_stmt(vm, node->then);
 
-        // Restore previous switch state (for nested switches)
-        vm->compiler.current_sparse_num = saved_num_cases;
-        for (int i = 0; i < saved_num_cases; i++) {
-            vm->compiler.sparse_case_nodes[i] = saved_case_nodes[i];
-            vm->compiler.sparse_jump_addrs[i] = saved_case_patches[i];
-        }
-        vm->compiler.current_switch_default = saved_default;
-        vm->compiler.current_default_patch = saved_default_patch;
-
-        // Patch the break target (end of switch)
-        if (node->brk_label) {
+        // Without a default, unmatched values leave the switch
+        long long *default_addr = vm->compiler.current_default_addr;
+        if (node->brk_label)
             define_label(vm, node->brk_label);
-        }
-        if (end_patch) {
-            *end_patch = (long long)(vm->text_ptr + 1);
+        if (!default_addr)
+            default_addr = vm->text_ptr + 1;
+        for (i = 0; i < sg.num_patches; i++) {
+            SwitchPatch *p = &sg.patches[i];
+            long long *addr = p->index < 0 ? NULL : sg.cases[p->index].address;
+            *p->location = (long long)(addr ? addr : default_addr);
         }
 
-        free_temp_reg(r_val);
+        vm->compiler.current_switch_cases = saved_cases;
+        vm->compiler.current_switch_num = saved_num;
+        vm->compiler.current_switch_type = saved_type;
+        vm->compiler.current_switch_default = saved_default;
+        vm->compiler.current_default_addr = saved_default_addr;
+        free(sg.cases);
+        free(sg.clusters);
+        free(sg.patches);
         return;
     }
 
     case ND_CASE: {
-        // Case within switch - patch jump address and generate body
-        long long target = (long long)(vm->text_ptr + 1);
-
-        // Check if this is the default case
+        // Record where this case's code starts for the switch to patch
+        long long *addr = vm->text_ptr + 1;
         if (node == vm->compiler.current_switch_default) {
-            if (vm->compiler.current_default_patch) {
-                *vm->compiler.current_default_patch = target;
-            }
-        } else {
-            // Find this case in the sparse switch table and patch it
-            for (int i = 0; i < vm->compiler.current_sparse_num; i++) {
-                if (vm->compiler.sparse_case_nodes[i] == node) {
-                    *vm->compiler.sparse_jump_addrs[i] = target;
+            vm->compiler.current_default_addr = addr;
+        } else if (vm->compiler.current_switch_cases) {
+            Type *ty = vm->compiler.current_switch_type;
+            bool is_unsigned = switch_unsigned(ty);
+            long long val = switch_value(ty, node->begin);
+            int lo = 0, hi = vm->compiler.current_switch_num;
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                SwitchCase *c = &vm->compiler.current_switch_cases[mid];
+                int cmp = switch_cmp(is_unsigned, c->begin, val);
+                if (cmp == 0) {
+                    c->address = addr;
                     break;
                 }
+                if (cmp < 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
             }
         }
 
@@ -1911,13 +3227,13 @@ static void gen_stmt(JCC *vm, Node *node) {
             emit(vm, JMP);
             long long *patch = ++vm->text_ptr;
             *patch = 0; // Placeholder
-            add_label_patch(node->unique_label, patch);
+            add_label_patch(vm, node->unique_label, patch);
         } else if (node->label) {
             // Named goto - also needs patching
             emit(vm, JMP);
             long long *patch = ++vm->text_ptr;
             *patch = 0; // Placeholder
-            add_label_patch(node->label, patch);
+            add_label_patch(vm, node->label, patch);
         }
         return;
 
@@ -2069,6 +3385,33 @@ static int assign_stack_offsets(Obj *fn) {
 
 // ========== Function Generation ==========
 
+// Can fn do without a frame when its code never addresses one?
+static bool frameless_allowed(JCC *vm, Obj *fn) {
+    // The debugger and the stack checks look at frames, canaries and CFI
+    // are checked by LEV3
+    if (vm->flags & (JCC_ENABLE_DEBUGGER | JCC_UNINIT_DETECTION |
+                     JCC_STACK_INSTR | JCC_STACK_CANARIES | JCC_CFI))
+        return false;
+    return !fn->is_nested && !fn->is_block && !fn->has_nested;
+}
+
+// A function without LEA3 (all its values in registers) never uses bp, so
+// ENT3 skips the frame (ENT3_NO_FRAME) and every LEV3 becomes RET3, which
+// only pops the return address
+static void drop_unused_frame(JCC *vm, Obj *fn) {
+    long long *ent = vm->text_seg + fn->code_addr;
+    long long *end = vm->text_ptr + 1;
+    for (long long *pc = ent; pc < end; pc += vm_insn_size((int)*pc)) {
+        if (*pc == LEA3)
+            return;
+    }
+    ent[2] |= ENT3_NO_FRAME;
+    for (long long *pc = ent; pc < end; pc += vm_insn_size((int)*pc)) {
+        if (*pc == LEV3)
+            *pc = RET3;
+    }
+}
+
 void gen_function(JCC *vm, Obj *fn) {
     if (!fn->is_function || !fn->body)
         return;
@@ -2078,18 +3421,23 @@ void gen_function(JCC *vm, Obj *fn) {
     vm->compiler.current_fn = fn;
 
     // Reset label tracking for this function
-    reset_labels();
+    reset_labels(vm);
 
     // Count parameters first
     // Assign stack offsets early
     int stack_size = assign_stack_offsets(fn);
 
-    // Helper vars needed for ENT3 emission
-    int param_count = 0;
-    for (Obj *param = fn->params; param; param = param->next)
-        param_count++;
-    bool is_variadic = fn->ty && fn->ty->is_variadic;
-    int reg_param_count = is_variadic ? 8 : param_count;
+    // Put eligible scalar locals in registers and reserve slots to save the
+    // caller's S registers in
+    int reg_param_count;
+    free_hoists();
+    promote_num_saved = promote_locals(vm, fn, &reg_param_count);
+    promote_save_offset = -(stack_size + 1);
+    if (promote_num_saved > 0) {
+        stack_size += promote_num_saved;
+        if (stack_size % 2 != 0)
+            stack_size++;
+    }
 
     // Record function address (offset from text_seg start)
     fn->code_addr = (vm->text_ptr + 1 - vm->text_seg);
@@ -2104,13 +3452,38 @@ void gen_function(JCC *vm, Obj *fn) {
         }
     }
 
-    // Emit ENT3: [stack_size:32|param_count:32] [float_param_mask]
+    // Emit ENT3: [stack_size:32|param_count:32] [float_param_mask], where
+    // param_count is the number of leading parameters spilled to slots
     long long ent3_operand =
         ((long long)stack_size) | (((long long)reg_param_count) << 32);
     emit(vm, ENT3);
     *++vm->text_ptr = ent3_operand;
     *++vm->text_ptr = float_param_mask;
 
+    // Keep the caller's destination for struct/union results
+    if (fn->sret) {
+        emit_lea3(vm, REG_T0, fn->sret->offset);
+        emit_rr(vm, STR_D, REG_SRET, REG_T0);
+    }
+
+    // Save the caller's S registers, then move promoted parameters out of
+    // their argument registers (narrowed like a load from the slot would)
+    for (int i = 0; i < promote_num_saved; i++) {
+        emit_lea3(vm, REG_T0, promote_save_offset - i);
+        emit_rr(vm, STR_D, REG_S0 + i, REG_T0);
+    }
+    for (Obj *param = fn->params; param; param = param->next) {
+        if (!param->reg)
+            continue;
+        int arg = param_arg_reg(fn, param);
+        if (arg) {
+            emit_narrow(vm, param->ty, param->reg, arg);
+        } else {
+            emit_lea3(vm, REG_T0, param->offset);
+            emit_load(vm, param->ty, param->reg, REG_T0);
+        }
+    }
+
     // Allocate heap storage for __block variables
     // Each __block variable gets heap allocation of its type's size
     // The heap pointer is stored in the variable's stack slot
@@ -2132,13 +3505,19 @@ void gen_function(JCC *vm, Obj *fn) {
     gen_stmt(vm, fn->body);
 
     // Patch all forward jumps (break/continue/goto)
-    patch_labels();
+    patch_labels(vm);
 
     // Implicit return 0 from main
     if (strcmp(fn->name, "main") == 0) {
         emit_li3(vm, REG_A0, 0);
     }
+    emit_promote_restore(vm);
     emit(vm, LEV3);
+    promote_num_saved = 0;
+    free_hoists();
+
+    if (frameless_allowed(vm, fn))
+        drop_unused_frame(vm, fn);
 }
 
 // ========== Top-Level Code Generation ==========
@@ -2151,13 +3530,28 @@ void gen(JCC *vm, Obj *prog) {
     // Initialize text pointer - text_seg[0] is reserved for main entry point
     vm->text_ptr = vm->text_seg;
 
-    // Initialize global variables in data segment
+    // Initialize global variables in data segment. String literals are
+    // pooled by contents: a literal already laid out with the same bytes
+    // lends its storage instead of taking a copy.
+    HashMap literals = {0};
     for (Obj *var = prog; var; var = var->next) {
         if (!var->is_function) {
+            if (var->is_string_literal && var->init_data) {
+                Obj *same =
+                    hashmap_get2(&literals, var->init_data, var->ty->size);
+                if (same) {
+                    var->offset = same->offset;
+                    continue;
+                }
+                hashmap_put2(&literals, var->init_data, var->ty->size, var);
+            }
+
             // Align data pointer to 8-byte boundary
             long long offset = vm->data_ptr - vm->data_seg;
             offset = (offset + 7) & ~7;
             vm->data_ptr = vm->data_seg + offset;
+            if (offset + var->ty->size > vm->poolsize)
+                error("codegen: program too large for the data segment");
 
             // Store the offset in the variable
             var->offset = vm->data_ptr - vm->data_seg;
@@ -2170,19 +3564,7 @@ void gen(JCC *vm, Obj *prog) {
             vm->data_ptr += var->ty->size;
         }
     }
-
-    // Allocate return buffer pool for struct/union returns at end of data
-    // segment
-    for (int i = 0; i < RETURN_BUFFER_POOL_SIZE; i++) {
-        // Align to 8-byte boundary
-        long long offset = vm->data_ptr - vm->data_seg;
-        offset = (offset + 7) & ~7;
-        vm->data_ptr = vm->data_seg + offset;
-        vm->compiler.return_buffer_pool[i] = vm->data_ptr;
-        memset(vm->compiler.return_buffer_pool[i], 0,
-               vm->compiler.return_buffer_size);
-        vm->data_ptr += vm->compiler.return_buffer_size;
-    }
+    free(literals.buckets);
 
     // Pre-pass: Assign stack offsets for all functions
     // This is critical for nested functions, which are compiled before their
@@ -2201,20 +3583,20 @@ void gen(JCC *vm, Obj *prog) {
         }
     }
 
+    // Index the definitions by name so patching is linear in the number of
+    // patches; the first definition of a name wins
+    HashMap defs = {0};
+    for (Obj *fn = prog; fn; fn = fn->next) {
+        if (fn->is_function && fn->body && !hashmap_get(&defs, fn->name))
+            hashmap_put(&defs, fn->name, fn);
+    }
+
     // Second pass: Patch function call addresses
     for (int i = 0; i < vm->compiler.num_call_patches; i++) {
         char *fn_name = vm->compiler.call_patches[i].function->name;
         long long *loc = vm->compiler.call_patches[i].location;
 
-        // Find the function definition in the program list
-        Obj *fn_def = NULL;
-        for (Obj *fn = prog; fn; fn = fn->next) {
-            if (fn->is_function && fn->body && strcmp(fn->name, fn_name) == 0) {
-                fn_def = fn;
-                break;
-            }
-        }
-
+        Obj *fn_def = hashmap_get(&defs, fn_name);
         if (!fn_def) {
             // Check for FFI function
             int ffi_idx = find_ffi_function(vm, fn_name);
@@ -2235,19 +3617,13 @@ void gen(JCC *vm, Obj *prog) {
         char *fn_name = vm->compiler.func_addr_patches[i].function->name;
         long long *loc = vm->compiler.func_addr_patches[i].location;
 
-        Obj *fn_def = NULL;
-        for (Obj *fn = prog; fn; fn = fn->next) {
-            if (fn->is_function && fn->body && strcmp(fn->name, fn_name) == 0) {
-                fn_def = fn;
-                break;
-            }
-        }
-
+        Obj *fn_def = hashmap_get(&defs, fn_name);
         if (fn_def) {
             long long addr = (long long)(vm->text_seg + fn_def->code_addr);
             *loc = addr;
         }
     }
+    free(defs.buckets);
 
     // Find main function and store its address in text_seg[0]
     for (Obj *fn = prog; fn; fn = fn->next) {
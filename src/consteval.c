@@ -0,0 +1,469 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "jcc.h"
+#include "./internal.h"
+
+//
+// Compile-Time Evaluation
+//
+// Calls to pure functions whose arguments are all constants are run while
+// compiling and replaced with their result:
+//
+//   static unsigned crc(unsigned c) {       static const unsigned table[] = {
+//       for (int k = 0; k < 8; k++)             crc(0), crc(1), crc(2), ...
+//           c = c & 1 ? 0xEDB88320 ^ (c >> 1)   };
+//                     : c >> 1;
+//       return c;                           holds the finished values in its
+//   }                                       initializer
+//
+// The parser folds the calls it meets in constant expressions (initializers
+// of globals and static locals, array sizes, case labels, enumerators), so
+// tables like this one no longer have to be filled in by code at startup.
+// cc_consteval() then folds the remaining calls in function bodies, such as
+// `int n = pow2(10);`, before the inliner runs.
+//
+// A function is pure when its parameters and result are integers or floats,
+// it touches no variable but its own parameters and locals, and it calls
+// only pure functions. The sandbox does not check loads and stores, so
+// nothing that reaches memory through an address is allowed: no
+// dereferences (which includes array indexing and ->), no taking addresses
+// and no integer-to-pointer casts. Neither are asm, atomics, computed goto,
+// VLAs, variadic arguments, nested functions and blocks. So is recursion:
+// the VM stack has no overflow check, and without cycles the deepest chain
+// of frames is known and checked against the sandbox's stack.
+//
+// The functions run in a sandbox, a JCC instance of their own without
+// safety features whose segments hold nothing but those functions. Every
+// call gets an instruction budget, charged at backward branches and calls as
+// with cc_run_for(), and a call that runs out of it or faults (dividing by
+// zero, say) is left to run at runtime. A compilation stops evaluating once
+// CONSTEVAL_TOTAL_STEPS have been spent.
+//
+
+// Instructions a single call may run
+#define CONSTEVAL_STEPS (1LL << 20)
+// ... and all calls of a compilation together
+#define CONSTEVAL_TOTAL_STEPS (1LL << 26)
+// Most arguments passed in registers (REG_A0-A7, FREG_A0-A7)
+#define CONSTEVAL_MAX_PARAMS 8
+
+#define PURE_BUSY ((void *)1)
+#define PURE_NO ((void *)2)
+
+struct ConstEval {
+    JCC *sb;          // Sandbox, created on the first call that runs
+    HashMap defs;     // name -> definition (functions with a body)
+    HashMap purity;   // Obj * -> PURE_BUSY / PURE_NO
+    HashMap addrs;    // Obj * -> text offset in the sandbox (pure functions)
+    HashMap depth;    // Obj * -> stack words of its deepest call chain
+    int patched;      // Sandbox call patches resolved so far
+    long long steps;  // Instructions left for the compilation
+};
+
+static struct ConstEval *get_state(JCC *vm) {
+    if (!vm->compiler.consteval) {
+        vm->compiler.consteval = calloc(1, sizeof(struct ConstEval));
+        if (!vm->compiler.consteval)
+            error("out of memory");
+        vm->compiler.consteval->steps = CONSTEVAL_TOTAL_STEPS;
+    }
+    return vm->compiler.consteval;
+}
+
+// The definition a call to fn runs, if it has been parsed yet
+static Obj *find_def(JCC *vm, struct ConstEval *ce, Obj *fn) {
+    if (fn->body)
+        return fn;
+    Obj *def = hashmap_get(&ce->defs, fn->name);
+    if (def)
+        return def;
+    for (Obj *obj = vm->compiler.globals; obj; obj = obj->next) {
+        if (obj->is_function && obj->body && !strcmp(obj->name, fn->name)) {
+            hashmap_put(&ce->defs, obj->name, obj);
+            return obj;
+        }
+    }
+    return NULL;
+}
+
+static bool is_value_type(Type *ty) {
+    return is_integer(ty) || is_flonum(ty);
+}
+
+// ========== Sandbox ==========
+
+static JCC *get_sandbox(struct ConstEval *ce) {
+    if (ce->sb)
+        return ce->sb;
+    JCC *sb = calloc(1, sizeof(JCC));
+    if (!sb)
+        error("out of memory");
+    cc_init(sb, 0);
+    // A call that faults is left unfolded; there is nothing to report
+    sb->quiet_faults = 1;
+    sb->text_seg = calloc(sb->poolsize, sizeof(long long));
+    sb->data_seg = calloc(sb->poolsize, 1);
+    sb->stack_seg = calloc(sb->poolsize, sizeof(long long));
+    if (!sb->text_seg || !sb->data_seg || !sb->stack_seg)
+        error("could not malloc for the compile-time sandbox");
+    sb->old_text_seg = sb->text_seg;
+    sb->text_ptr = sb->text_seg;
+    sb->data_ptr = sb->data_seg;
+    ce->sb = sb;
+    return sb;
+}
+
+// Generate fn (whose callees are already there) into the sandbox and point
+// the calls made so far at their targets
+static bool compile(JCC *vm, struct ConstEval *ce, Obj *fn) {
+    JCC *sb = get_sandbox(ce);
+    if (sb->text_ptr - sb->text_seg > sb->poolsize / 2)
+        return false;
+    gen_function(sb, fn);
+    for (; ce->patched < sb->compiler.num_call_patches; ce->patched++) {
+        FuncPatch *p = &sb->compiler.call_patches[ce->patched];
+        Obj *callee = find_def(vm, ce, p->function);
+        long long off = (long long)hashmap_get_int(&ce->addrs, (long long)callee);
+        *p->location = (long long)(sb->text_seg + off);
+    }
+    hashmap_put_int(&ce->addrs, (long long)fn, (void *)fn->code_addr);
+    return true;
+}
+
+// Stack words a call to fn takes for itself: the return address, the saved
+// bp and the frame ENT3 allocates
+static long long frame_words(JCC *sb, Obj *fn) {
+    long long *pc = sb->text_seg + fn->code_addr;
+    return 2 + (pc[1] & 0xFFFFFFFF);
+}
+
+// ========== Purity ==========
+
+static bool is_pure(JCC *vm, struct ConstEval *ce, Obj *fn);
+
+typedef struct {
+    JCC *vm;
+    struct ConstEval *ce;
+    long long depth; // Deepest callee chain, in stack words
+} PureWalk;
+
+static bool pure_node(PureWalk *w, Node *node) {
+    if (!node)
+        return true;
+    if (node->atomic_addr || (node->ty && node->ty->kind == TY_VLA))
+        return false;
+
+    switch (node->kind) {
+    case ND_VAR:
+    case ND_MEMZERO:
+        // Its own locals only: globals, statics and functions are out of
+        // the sandbox's reach
+        return node->var->is_local && !node->var->is_captured &&
+               !node->var->is_block_var;
+    case ND_FUNCALL: {
+        if (node->lhs->kind != ND_VAR || !node->lhs->var->is_function)
+            return false;
+        Obj *callee = find_def(w->vm, w->ce, node->lhs->var);
+        if (!callee || !is_pure(w->vm, w->ce, callee))
+            return false;
+        long long d =
+            (long long)hashmap_get_int(&w->ce->depth, (long long)callee);
+        if (d > w->depth)
+            w->depth = d;
+        for (Node *arg = node->args; arg; arg = arg->next)
+            if (!pure_node(w, arg))
+                return false;
+        return true;
+    }
+    case ND_CAST:
+        // A pointer made from an integer could point anywhere
+        if (node->ty->kind == TY_PTR && is_integer(node->lhs->ty))
+            return false;
+        break;
+    case ND_MEMBER:
+        // Of a struct or union held in a local; through a pointer it is an
+        // ND_DEREF underneath, which is refused
+        break;
+    case ND_NULL_EXPR: case ND_ADD: case ND_SUB: case ND_MUL: case ND_DIV:
+    case ND_NEG: case ND_MOD: case ND_BITAND: case ND_BITOR: case ND_BITXOR:
+    case ND_SHL: case ND_SHR: case ND_EQ: case ND_NE: case ND_LT: case ND_LE:
+    case ND_ASSIGN: case ND_COND: case ND_COMMA: case ND_NOT: case ND_BITNOT:
+    case ND_LOGAND: case ND_LOGOR:
+    case ND_RETURN: case ND_IF: case ND_FOR: case ND_DO: case ND_SWITCH:
+    case ND_CASE: case ND_BLOCK: case ND_GOTO: case ND_LABEL:
+    case ND_EXPR_STMT: case ND_STMT_EXPR: case ND_NUM:
+        break;
+    default:
+        return false;
+    }
+
+    if (!pure_node(w, node->lhs) || !pure_node(w, node->rhs) ||
+        !pure_node(w, node->cond) || !pure_node(w, node->then) ||
+        !pure_node(w, node->els) || !pure_node(w, node->init) ||
+        !pure_node(w, node->inc))
+        return false;
+    for (Node *n = node->body; n; n = n->next)
+        if (!pure_node(w, n))
+            return false;
+    return true;
+}
+
+// Is fn pure? The first time it is, it is also generated into the sandbox.
+static bool is_pure(JCC *vm, struct ConstEval *ce, Obj *fn) {
+    if (hashmap_get_int(&ce->addrs, (long long)fn))
+        return true;
+    if (hashmap_get_int(&ce->purity, (long long)fn))
+        return false; // Known impure, or a cycle
+    hashmap_put_int(&ce->purity, (long long)fn, PURE_BUSY);
+
+    Type *ty = fn->ty;
+    bool pure = fn->body && ty->kind == TY_FUNC && !ty->is_variadic &&
+                !fn->is_nested && !fn->is_block && !fn->has_nested &&
+                is_value_type(ty->return_ty) && strcmp(fn->name, "main") &&
+                find_ffi_function(vm, fn->name) < 0;
+    int params = 0;
+    for (Obj *p = fn->params; pure && p; p = p->next)
+        pure = is_value_type(p->ty) && ++params <= CONSTEVAL_MAX_PARAMS;
+
+    PureWalk w = {vm, ce, 0};
+    pure = pure && pure_node(&w, fn->body) && compile(vm, ce, fn);
+    if (pure) {
+        // Every chain of calls has to fit on the sandbox's stack
+        long long depth = frame_words(ce->sb, fn) + w.depth;
+        if (depth > ce->sb->poolsize / 2) {
+            hashmap_delete_int(&ce->addrs, (long long)fn);
+            pure = false;
+        } else {
+            hashmap_put_int(&ce->depth, (long long)fn, (void *)depth);
+        }
+    }
+    if (pure)
+        hashmap_delete_int(&ce->purity, (long long)fn);
+    else
+        hashmap_put_int(&ce->purity, (long long)fn, PURE_NO);
+    return pure;
+}
+
+// ========== Evaluation ==========
+
+static long long narrow(long long val, Type *ty) {
+    if (ty->kind == TY_BOOL)
+        return val != 0;
+    if (ty->is_unsigned) {
+        switch (ty->size) {
+        case 1: return (uint8_t)val;
+        case 2: return (uint16_t)val;
+        case 4: return (uint32_t)val;
+        }
+    } else {
+        switch (ty->size) {
+        case 1: return (int8_t)val;
+        case 2: return (int16_t)val;
+        case 4: return (int32_t)val;
+        }
+    }
+    return val;
+}
+
+// The value of a constant argument (a number, converted or negated, or a
+// call that folds), as an integer or a double depending on its type
+static bool const_value(JCC *vm, Node *node, long long *ival, double *fval) {
+    switch (node->kind) {
+    case ND_NUM:
+        *ival = node->val;
+        *fval = node->fval;
+        return true;
+    case ND_FUNCALL:
+        return cc_fold_call(vm, node) && const_value(vm, node, ival, fval);
+    case ND_NEG:
+        if (!const_value(vm, node->lhs, ival, fval))
+            return false;
+        *ival = narrow(-*ival, node->ty);
+        *fval = -*fval;
+        return true;
+    case ND_CAST: {
+        Type *from = node->lhs->ty, *to = node->ty;
+        if (!is_value_type(from) || !is_value_type(to) ||
+            !const_value(vm, node->lhs, ival, fval))
+            return false;
+        if (is_flonum(to) && !is_flonum(from))
+            *fval = from->is_unsigned ? (double)(uint64_t)*ival : (double)*ival;
+        else if (!is_flonum(to) && is_flonum(from))
+            *ival = to->is_unsigned ? (long long)(uint64_t)*fval
+                                    : (long long)*fval;
+        if (to->kind == TY_FLOAT)
+            *fval = (float)*fval;
+        if (!is_flonum(to))
+            *ival = narrow(*ival, to);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+bool cc_fold_call(JCC *vm, Node *node) {
+    if (node->kind != ND_FUNCALL || node->lhs->kind != ND_VAR ||
+        !node->lhs->var->is_function)
+        return false;
+    struct ConstEval *ce = get_state(vm);
+    if (ce->steps <= 0)
+        return false;
+
+    // Arguments first: they are cheaper to check than the callee
+    long long ivals[CONSTEVAL_MAX_PARAMS];
+    double fvals[CONSTEVAL_MAX_PARAMS];
+    int nargs = 0;
+    for (Node *arg = node->args; arg; arg = arg->next) {
+        if (nargs == CONSTEVAL_MAX_PARAMS)
+            return false;
+        add_type(vm, arg);
+        if (!const_value(vm, arg, &ivals[nargs], &fvals[nargs]))
+            return false;
+        nargs++;
+    }
+    Obj *fn = find_def(vm, ce, node->lhs->var);
+    if (!fn || !is_pure(vm, ce, fn))
+        return false;
+
+    int params = 0;
+    for (Obj *p = fn->params; p; p = p->next)
+        params++;
+    if (params != nargs)
+        return false; // An unprototyped call
+
+    JCC *sb = ce->sb;
+    int ni = 0, nf = 0, i = 0;
+    for (Obj *p = fn->params; p; p = p->next, i++) {
+        if (is_flonum(p->ty))
+            sb->fregs[FREG_A0 + nf++] = fvals[i];
+        else
+            sb->regs[REG_A0 + ni++] = ivals[i];
+    }
+    sb->sp = sb->stack_seg + sb->poolsize;
+    sb->bp = sb->sp;
+    sb->initial_sp = sb->sp;
+    sb->initial_bp = sb->bp;
+    *--sb->sp = 0; // Return address: leave the loop
+    sb->pc = sb->text_seg + fn->code_addr;
+
+    long long steps = ce->steps < CONSTEVAL_STEPS ? ce->steps : CONSTEVAL_STEPS;
+    sb->budget_slice = steps;
+    sb->budget = steps;
+    vm_eval(sb);
+    ce->steps -= sb->budget > 0 ? steps - sb->budget : steps;
+    if (sb->pc)
+        return false; // Out of steps or faulted
+
+    Type *ty = node->ty;
+    Node *next = node->next;
+    *node = (Node){.kind = ND_NUM, .ty = ty, .tok = node->tok, .next = next};
+    if (is_flonum(ty)) {
+        double val = sb->fregs[FREG_A0];
+        node->fval = ty->kind == TY_FLOAT ? (float)val : val;
+    } else {
+        node->val = narrow(sb->regs[REG_A0], ty);
+    }
+    return true;
+}
+
+// Could the argument be constant once the calls in it are folded?
+static bool is_const_arg(Node *node) {
+    switch (node->kind) {
+    case ND_NUM:
+    case ND_FUNCALL:
+        return true;
+    case ND_NEG:
+    case ND_CAST:
+        return is_const_arg(node->lhs);
+    default:
+        return false;
+    }
+}
+
+// Walk the calls of a body: with run unset, generate the functions the
+// foldable ones call; with run set, fold them. The sandbox decodes its text
+// again whenever it has grown, so its functions are generated up front
+// rather than between runs.
+static void fold_node(JCC *vm, Node *node, bool run) {
+    if (!node)
+        return;
+    fold_node(vm, node->lhs, run);
+    fold_node(vm, node->rhs, run);
+    fold_node(vm, node->cond, run);
+    fold_node(vm, node->then, run);
+    fold_node(vm, node->els, run);
+    fold_node(vm, node->init, run);
+    fold_node(vm, node->inc, run);
+    for (Node *n = node->body; n; n = n->next)
+        fold_node(vm, n, run);
+    for (Node *n = node->args; n; n = n->next)
+        fold_node(vm, n, run);
+    if (node->kind != ND_FUNCALL || node->lhs->kind != ND_VAR ||
+        !node->lhs->var->is_function)
+        return;
+    if (run) {
+        cc_fold_call(vm, node);
+        return;
+    }
+    for (Node *arg = node->args; arg; arg = arg->next)
+        if (!is_const_arg(arg))
+            return;
+    struct ConstEval *ce = vm->compiler.consteval;
+    Obj *fn = find_def(vm, ce, node->lhs->var);
+    if (fn)
+        is_pure(vm, ce, fn);
+}
+
+static void free_state(JCC *vm) {
+    struct ConstEval *ce = vm->compiler.consteval;
+    if (!ce)
+        return;
+    if (ce->sb) {
+        cc_destroy(ce->sb);
+        free(ce->sb);
+    }
+    free(ce->defs.buckets);
+    free(ce->purity.buckets);
+    free(ce->addrs.buckets);
+    free(ce->depth.buckets);
+    free(ce);
+    vm->compiler.consteval = NULL;
+}
+
+void cc_consteval(JCC *vm, Obj *prog) {
+    // Under the debugger and the safety checks a call behaves differently
+    // from its run in the sandbox (stepping, overflow traps and the like)
+    if (!(vm->flags & (JCC_ALL_SAFETY | JCC_ENABLE_DEBUGGER))) {
+        // Purity found while parsing may have missed bodies parsed later
+        struct ConstEval *ce = get_state(vm);
+        free(ce->purity.buckets);
+        ce->purity = (HashMap){0};
+        for (int run = 0; run < 2; run++) {
+            for (Obj *fn = prog; fn; fn = fn->next) {
+                if (fn->is_function && fn->body)
+                    fold_node(vm, fn->body, run);
+            }
+        }
+    }
+    free_state(vm);
+}
+
+void cc_consteval_free(JCC *vm) { free_state(vm); }
@@ -78,6 +78,7 @@ int cc_add_breakpoint(JCC *vm, long long *pc) {
             vm->dbg.breakpoints[i].hit_count = 0;
             vm->dbg.breakpoints[i].condition = NULL;
             vm->dbg.num_breakpoints++;
+            vm_set_trap(vm, pc, 1);
 
             // Calculate offset from text_seg for display
             long long offset = (long long)pc - (long long)vm->text_seg;
@@ -100,6 +101,7 @@ void cc_remove_breakpoint(JCC *vm, int index) {
         return;
     }
 
+    vm_set_trap(vm, vm->dbg.breakpoints[index].pc, 0);
     vm->dbg.breakpoints[index].enabled = 0;
     vm->dbg.breakpoints[index].pc = NULL;
     vm->dbg.breakpoints[index].hit_count = 0;
@@ -179,7 +181,7 @@ void debugger_print_registers(JCC *vm) {
     printf("\n");
     printf("  bp:           %p\n", (void*)vm->bp);
     printf("  sp:           %p\n", (void*)vm->sp);
-    printf("  cycle:        %lld\n", vm->cycle);
+    printf("  hooked insns: %lld\n", vm->hooked);
     // Print first few general registers
     printf("  T0-T3:        %lld, %lld, %lld, %lld\n", 
            vm->regs[REG_T0], vm->regs[REG_T1], vm->regs[REG_T2], vm->regs[REG_T3]);
@@ -221,7 +223,8 @@ static int disassemble_instruction(long long *pc, long long *text_seg, long long
     
     int size = 1; // Default size (just opcode)
     
-    switch (op) {
+    // Superinstructions keep the operand layout of their first component
+    switch (vm_superop_base(op)) {
         // Multi-register opcodes (RRR format: 1 operand word with 3 registers)
         case ADD3:
         case SUB3:
@@ -264,10 +267,38 @@ static int disassemble_instruction(long long *pc, long long *text_seg, long long
             size = 3;
             break;
 
+        // Float immediate: the word is the double's bit pattern
+        case FLI:
+            if (pc + 2 < text_end) {
+                int rd = (int)(pc[1] & 0xFF);
+                double val;
+                memcpy(&val, &pc[2], sizeof(double));
+                printf(" f%d, %g", rd, val);
+            }
+            size = 3;
+            break;
+
+        // Register-immediate ALU opcodes (rd, rs, immediate)
+        case SUBI3:
+        case MULI3:
+        case ANDI3:
+        case ORI3:
+        case XORI3:
+        case SHLI3:
+        case SHRI3:
+        case SLTI3:
+        case BCPY:
+            if (pc + 2 < text_end) {
+                int rd = (int)(pc[1] & 0xFF);
+                int rs = (int)((pc[1] >> 8) & 0xFF);
+                printf(" r%d, r%d, %lld", rd, rs, pc[2]);
+            }
+            size = 3;
+            break;
+
         // Control flow with operand
         case JMP:
         case CALL:
-        case JMPT:
         case JMPI:
         case ADJ:
             if (pc + 1 < text_end) {
@@ -286,20 +317,53 @@ static int disassemble_instruction(long long *pc, long long *text_seg, long long
             size = 3;
             break;
 
+        // Compare-and-branch: two registers + target
+        case BEQ:
+        case BNE:
+        case BLT:
+        case BGE:
+        case BLTU:
+        case BGEU:
+            if (pc + 2 < text_end) {
+                int rs1 = (int)(pc[1] & 0xFF);
+                int rs2 = (int)((pc[1] >> 8) & 0xFF);
+                printf(" r%d, r%d, %lld", rs1, rs2, pc[2]);
+            }
+            size = 3;
+            break;
+
+        // Compare-and-branch and JMPT: register + immediate + target
+        case BEQI:
+        case BNEI:
+        case BLTI:
+        case BGEI:
+        case BLTUI:
+        case BGEUI:
+        case JMPT:
+            if (pc + 3 < text_end) {
+                int rs = (int)(pc[1] & 0xFF);
+                printf(" r%d, %lld, %lld", rs, pc[2], pc[3]);
+            }
+            size = 4;
+            break;
+
         // Register-based calling convention opcodes
         case ENT3:
             // ENT3 has 2 operands: [stack_size:32|param_count:32] [float_param_mask]
             if (pc + 2 < text_end) {
                 int stack_size = (int)(pc[1] & 0xFFFFFFFF);
                 int param_count = (int)((pc[1] >> 32) & 0xFFFFFFFF);
-                long long float_mask = pc[2];
+                long long float_mask = pc[2] & ~ENT3_NO_FRAME;
                 printf(" stack=%d, params=%d, floatmask=0x%llx", stack_size, param_count, float_mask);
+                if (pc[2] & ENT3_NO_FRAME)
+                    printf(", noframe");
             }
             size = 3;
             break;
 
         case LEV3:
-            // LEV3 has no operands
+        case RET3:
+            // LEV3 and RET3 have no operands
             size = 1;
             break;
 
@@ -439,6 +503,9 @@ static int disassemble_instruction(long long *pc, long long *text_seg, long long
     }
     
     printf("\n");
+    // Step over operand words this switch does not print (CALLF, CHKA3, ...)
+    if (op >= 0 && op < NUM_OPS)
+        size = vm_insn_size(op);
     return size;
 }
 
@@ -863,7 +930,7 @@ void cc_debug_repl(JCC *vm) {
     vm->dbg.debugger_attached = 0;
 }
 
-int debugger_run(JCC *vm, int argc, char **argv) {
+int debugger_run(JCC *vm) {
     // Find main function
     Obj *main_fn = NULL;
     for (Obj *obj = vm->compiler.globals; obj; obj = obj->next) {
@@ -885,35 +952,19 @@ int debugger_run(JCC *vm, int argc, char **argv) {
             (void*)vm->pc, (long long)(vm->pc - vm->text_seg));
     printf("Type 'help' for commands, 'c' to continue\n\n");
 
-    // Set PC to main (code_addr is an offset from text_seg)
+    // Set PC to main (code_addr is an offset from text_seg). cc_run() has
+    // already set up the stack, shadow stack and argument registers.
     vm->pc = vm->text_seg + main_fn->code_addr;
 
-    // Setup stack for main(argc, argv)
-    vm->sp = vm->stack_seg;
-    vm->bp = vm->stack_seg;
-    vm->initial_sp = vm->stack_seg;
-    vm->initial_bp = vm->stack_seg;
-
-    // Setup shadow stack for CFI if enabled
-    if (vm->flags & JCC_CFI) {
-        vm->shadow_sp = vm->shadow_stack;
-    }
-
-    // Push argv (pointer to array of strings)
-    *--vm->sp = (long long)argv;
-    // Push argc
-    *--vm->sp = argc;
-    // Push dummy return address (NULL to detect exit)
-    *--vm->sp = 0;
-
     printf("Starting debugger at main (PC: %p)\n", (void*)vm->pc);
     printf("Type 'help' for debugger commands\n\n");
 
     // Enter debugger at start
     cc_debug_repl(vm);
 
-    // Main execution loop with debugger support
-    // Call vm_eval which handles all the debugger hooks (breakpoints, stepping, etc.)
+    // Run until a breakpoint trap or stepping stops it again. The first
+    // instruction has already been stopped at.
+    vm->dbg.hooks_done = 1;
     return vm_eval(vm);
 }
 
@@ -84,7 +84,12 @@ static void rehash(HashMap *map) {
 
     for (int ii = 0; ii < map->capacity; ii++) {
         HashEntry *ent = &map->buckets[ii];
-        if (ent->key && ent->key != TOMBSTONE)
+        if (!ent->key || ent->key == TOMBSTONE)
+            continue;
+        // Integer keys must be rehashed with int_hash(), not fnv_hash()
+        if (ent->keylen == -1)
+            hashmap_put_int(&map2, (long long)ent->key, ent->val);
+        else
             hashmap_put2(&map2, ent->key, ent->keylen, ent->val);
     }
 
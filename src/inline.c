@@ -0,0 +1,607 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "jcc.h"
+#include "./internal.h"
+
+//
+// AST Inliner
+//
+// Runs on the linked program right before code generation and replaces
+// calls to small functions with a copy of the callee's body. Only bodies
+// that can be rewritten as a single expression are inlined:
+//
+//   int clamp(int v, int hi) {        clamp(x, 10)
+//       if (v > hi)              =>   x > 10 ? 10 : x
+//           return hi;
+//       return v;
+//   }
+//
+// Returns become the value of the expression, `if` becomes `?:` and
+// expression statements become comma operands, so the result never needs
+// labels, jumps out of an expression or a reset of the temporary registers.
+// Loops, switch, goto, asm and statement expressions keep the call.
+//
+// Each parameter becomes a fresh local of the caller, assigned its argument
+// before the body runs. A parameter the callee never assigns or takes the
+// address of is replaced by its argument directly when the argument is a
+// constant or a local of the caller whose address is never taken, since no
+// code in the callee can change either. The callee's own locals are copied
+// to fresh objects in the caller, so two inlined copies of the same body (or
+// a local of the caller with the same name) never share storage.
+//
+// Functions are processed callees first, so a body is measured after its own
+// calls are inlined. A call into a function that is still being processed
+// is a cycle in the call graph and is left alone, which stops recursion.
+// Static inline functions that no longer have a caller or an address taken
+// are not generated.
+//
+
+// Largest inlined expression, in AST nodes (parameter copies included)
+#define INLINE_BUDGET 24
+// ... for functions declared inline
+#define INLINE_BUDGET_HINT 64
+
+#define INLINE_BUSY ((void *)1)
+#define INLINE_DONE ((void *)2)
+
+typedef struct {
+    JCC *vm;
+    HashMap defs;     // name -> first definition, as codegen resolves calls
+    HashMap state;    // Obj * -> INLINE_BUSY / INLINE_DONE
+    Obj *caller;      // Function whose calls are being inlined
+    HashMap *escaped; // Locals of caller whose address is taken
+    int count;        // Calls inlined
+} Inliner;
+
+// One copy of a callee's body
+typedef struct {
+    Inliner *in;
+    Node *call;
+    HashMap vars;  // Callee local -> copy in the caller
+    HashMap subst; // Parameter -> argument it is replaced with
+    Obj *locals;   // Copies made so far, added to the caller on success
+    int size;
+    int budget;
+    bool failed;
+} Expansion;
+
+// Statements still to run after the current list ends
+typedef struct Cont {
+    Node *stmt;
+    struct Cont *next;
+} Cont;
+
+// ========== AST Helpers ==========
+
+static Node *new_node(Expansion *x, NodeKind kind, Type *ty) {
+    Node *node = arena_alloc(&x->in->vm->compiler.parser_arena, sizeof(Node));
+    memset(node, 0, sizeof(Node));
+    node->kind = kind;
+    node->tok = x->call->tok;
+    node->ty = ty;
+    return node;
+}
+
+static Node *new_comma(Expansion *x, Node *lhs, Node *rhs) {
+    if (!lhs || !rhs)
+        return NULL;
+    Node *node = new_node(x, ND_COMMA, rhs->ty);
+    node->lhs = lhs;
+    node->rhs = rhs;
+    return node;
+}
+
+static Node *dup_node(Expansion *x, Node *orig) {
+    Node *node = arena_alloc(&x->in->vm->compiler.parser_arena, sizeof(Node));
+    *node = *orig;
+    node->next = NULL;
+    return node;
+}
+
+// Call fn on node and everything below it
+static void walk(Node *node, void (*fn)(Node *, void *), void *ctx) {
+    if (!node)
+        return;
+    fn(node, ctx);
+    walk(node->lhs, fn, ctx);
+    walk(node->rhs, fn, ctx);
+    walk(node->cond, fn, ctx);
+    walk(node->then, fn, ctx);
+    walk(node->els, fn, ctx);
+    walk(node->init, fn, ctx);
+    walk(node->inc, fn, ctx);
+    walk(node->cas_addr, fn, ctx);
+    walk(node->cas_old, fn, ctx);
+    walk(node->cas_new, fn, ctx);
+    for (Node *n = node->body; n; n = n->next)
+        walk(n, fn, ctx);
+    for (Node *n = node->args; n; n = n->next)
+        walk(n, fn, ctx);
+}
+
+static bool is_scalar(Type *ty) {
+    return is_integer(ty) || is_flonum(ty) || ty->kind == TY_PTR;
+}
+
+// Scalars of the same kind, size and signedness need no conversion between
+// them
+static bool same_repr(Type *a, Type *b) {
+    return is_scalar(a) && a->kind == b->kind && a->size == b->size &&
+           a->is_unsigned == b->is_unsigned;
+}
+
+static Node *strip_casts(Node *node) {
+    while (node->kind == ND_CAST)
+        node = node->lhs;
+    return node;
+}
+
+// ========== Caller Analysis ==========
+
+static void note_escape(Node *node, void *ctx) {
+    if (node->kind == ND_ADDR && node->lhs->kind == ND_VAR)
+        hashmap_put_int(ctx, (long long)node->lhs->var, node->lhs->var);
+}
+
+// An argument that can be read wherever the parameter is used instead of
+// once before the body: a constant, or a scalar local of the caller that
+// nothing but the caller's own assignments can change
+static bool is_substitutable(Inliner *in, Node *arg) {
+    Node *node = strip_casts(arg);
+    if (node->kind == ND_NUM)
+        return true;
+    if (node->kind != ND_VAR)
+        return false;
+    Obj *var = node->var;
+    Type *ty = var->ty;
+    return var->is_local && !var->is_captured && !var->is_block_var &&
+           !ty->is_volatile && !ty->is_atomic && is_scalar(ty) &&
+           !hashmap_get_int(in->escaped, (long long)var);
+}
+
+// ========== Callee Analysis ==========
+
+typedef struct {
+    Obj *param;
+    int uses;
+    bool written;
+} ParamUse;
+
+static void note_param_use(Node *node, void *ctx) {
+    ParamUse *u = ctx;
+    if (node->kind == ND_VAR && node->var == u->param)
+        u->uses++;
+    if ((node->kind == ND_ASSIGN || node->kind == ND_ADDR) && node->lhs &&
+        node->lhs->kind == ND_VAR && node->lhs->var == u->param)
+        u->written = true;
+    if (node->kind == ND_MEMZERO && node->var == u->param)
+        u->written = true;
+}
+
+static bool has_return(Node *node) {
+    if (!node)
+        return false;
+    if (node->kind == ND_RETURN)
+        return true;
+    if (has_return(node->then) || has_return(node->els))
+        return true;
+    for (Node *n = node->body; n; n = n->next)
+        if (has_return(n))
+            return true;
+    return false;
+}
+
+static bool is_inlinable(Inliner *in, Obj *fn) {
+    Type *ty = fn->ty;
+    if (!fn->body || ty->kind != TY_FUNC || ty->is_variadic || fn->is_nested ||
+        fn->is_block || fn->has_nested || strcmp(fn->name, "main") == 0)
+        return false;
+    if (ty->return_ty->kind != TY_VOID && !is_scalar(ty->return_ty))
+        return false;
+    for (Obj *p = fn->params; p; p = p->next)
+        if (!is_scalar(p->ty))
+            return false;
+    // Registered with the FFI: codegen calls the native function
+    return find_ffi_function(in->vm, fn->name) < 0;
+}
+
+// ========== Expansion ==========
+
+static Obj *copy_local(Expansion *x, Obj *var) {
+    Obj *copy = hashmap_get_int(&x->vars, (long long)var);
+    if (copy)
+        return copy;
+    if (var->ty->kind == TY_VLA || var->is_block_var || var->is_captured) {
+        x->failed = true;
+        return NULL;
+    }
+    copy = arena_alloc(&x->in->vm->compiler.parser_arena, sizeof(Obj));
+    *copy = *var;
+    copy->is_param = false;
+    copy->reg = 0;
+    copy->offset = 0;
+    copy->next = x->locals;
+    x->locals = copy;
+    hashmap_put_int(&x->vars, (long long)var, copy);
+    return copy;
+}
+
+// An integer cast of an integer constant, such as an argument converted to
+// its parameter type, is the converted constant
+static Node *fold_cast(Node *node) {
+    Node *num = node->lhs;
+    if (node->kind != ND_CAST || num->kind != ND_NUM ||
+        !is_integer(num->ty) || !is_integer(node->ty))
+        return node;
+    int64_t val = num->val;
+    switch (node->ty->kind == TY_BOOL ? 0 : node->ty->size) {
+    case 0: val = val != 0; break;
+    case 1: val = node->ty->is_unsigned ? (uint8_t)val : (int8_t)val; break;
+    case 2: val = node->ty->is_unsigned ? (uint16_t)val : (int16_t)val; break;
+    case 4: val = node->ty->is_unsigned ? (uint32_t)val : (int32_t)val; break;
+    }
+    *num = (Node){.kind = ND_NUM, .ty = node->ty, .tok = num->tok, .val = val};
+    return num;
+}
+
+// Arguments are casts of a constant or a variable, see is_substitutable()
+static Node *copy_arg(Expansion *x, Node *arg) {
+    Node *node = dup_node(x, arg);
+    if (node->kind == ND_CAST) {
+        node->lhs = copy_arg(x, node->lhs);
+        node = fold_cast(node);
+    }
+    return node;
+}
+
+static Node *copy_expr(Expansion *x, Node *node) {
+    if (!node || x->failed)
+        return NULL;
+    if (++x->size > x->budget || node->atomic_addr ||
+        (node->ty && node->ty->kind == TY_VLA)) {
+        x->failed = true;
+        return NULL;
+    }
+
+    Node *copy;
+    switch (node->kind) {
+    case ND_VAR:
+    case ND_MEMZERO:
+        if (!node->var->is_local)
+            return dup_node(x, node);
+        if (node->kind == ND_VAR) {
+            Node *arg = hashmap_get_int(&x->subst, (long long)node->var);
+            if (arg)
+                return copy_arg(x, arg);
+        }
+        copy = dup_node(x, node);
+        copy->var = copy_local(x, node->var);
+        return x->failed ? NULL : copy;
+    case ND_NUM:
+    case ND_NULL_EXPR:
+        return dup_node(x, node);
+    case ND_FUNCALL: {
+        JCC *vm = x->in->vm;
+        // alloca() allocates in the caller's frame, setjmp() saves it
+        if (node->lhs->kind == ND_VAR &&
+            (node->lhs->var == vm->compiler.builtin_alloca ||
+             node->lhs->var == vm->compiler.builtin_setjmp)) {
+            x->failed = true;
+            return NULL;
+        }
+        copy = dup_node(x, node);
+        copy->lhs = copy_expr(x, node->lhs);
+        Node head = {0};
+        Node *cur = &head;
+        for (Node *arg = node->args; arg; arg = arg->next) {
+            cur = cur->next = copy_expr(x, arg);
+            if (!cur)
+                return NULL;
+        }
+        copy->args = head.next;
+        if (node->ret_buffer)
+            copy->ret_buffer = copy_local(x, node->ret_buffer);
+        return x->failed ? NULL : copy;
+    }
+    case ND_ADD: case ND_SUB: case ND_MUL: case ND_DIV: case ND_NEG:
+    case ND_MOD: case ND_BITAND: case ND_BITOR: case ND_BITXOR: case ND_SHL:
+    case ND_SHR: case ND_EQ: case ND_NE: case ND_LT: case ND_LE:
+    case ND_ASSIGN: case ND_COND: case ND_COMMA: case ND_MEMBER: case ND_ADDR:
+    case ND_DEREF: case ND_NOT: case ND_BITNOT: case ND_LOGAND: case ND_LOGOR:
+    case ND_CAST:
+        copy = dup_node(x, node);
+        copy->lhs = copy_expr(x, node->lhs);
+        copy->rhs = copy_expr(x, node->rhs);
+        copy->cond = copy_expr(x, node->cond);
+        copy->then = copy_expr(x, node->then);
+        copy->els = copy_expr(x, node->els);
+        return x->failed ? NULL : fold_cast(copy);
+    default:
+        x->failed = true;
+        return NULL;
+    }
+}
+
+// Expression form of the statements from stmt on, followed by those in k.
+// With value set the statements must end in a return on every path.
+static Node *copy_stmts(Expansion *x, Node *stmt, Cont *k, bool value) {
+    if (x->failed)
+        return NULL;
+    if (!stmt) {
+        if (k)
+            return copy_stmts(x, k->stmt, k->next, value);
+        if (value && x->call->ty->kind != TY_VOID) {
+            x->failed = true;
+            return NULL;
+        }
+        return new_node(x, ND_NULL_EXPR, ty_void);
+    }
+    if (++x->size > x->budget) {
+        x->failed = true;
+        return NULL;
+    }
+
+    switch (stmt->kind) {
+    case ND_RETURN:
+        if (!stmt->lhs)
+            return new_node(x, ND_NULL_EXPR, ty_void);
+        return copy_expr(x, stmt->lhs);
+    case ND_EXPR_STMT:
+        return new_comma(x, copy_expr(x, stmt->lhs),
+                         copy_stmts(x, stmt->next, k, value));
+    case ND_BLOCK: {
+        Cont rest = {stmt->next, k};
+        return copy_stmts(x, stmt->body, &rest, value);
+    }
+    case ND_IF: {
+        Node *node = new_node(x, ND_COND, ty_void);
+        node->cond = copy_expr(x, stmt->cond);
+        if (!has_return(stmt->then) && !has_return(stmt->els)) {
+            // Both branches fall through: run the rest once after them
+            node->then = copy_stmts(x, stmt->then, NULL, false);
+            node->els = stmt->els ? copy_stmts(x, stmt->els, NULL, false)
+                                  : new_node(x, ND_NULL_EXPR, ty_void);
+            return new_comma(x, node, copy_stmts(x, stmt->next, k, value));
+        }
+        // The rest runs on the paths that do not return, in either branch
+        Cont rest = {stmt->next, k};
+        node->then = copy_stmts(x, stmt->then, &rest, value);
+        node->els = stmt->els ? copy_stmts(x, stmt->els, &rest, value)
+                              : copy_stmts(x, stmt->next, k, value);
+        if (x->failed)
+            return NULL;
+        node->ty = node->then->ty;
+        return node;
+    }
+    default:
+        x->failed = true;
+        return NULL;
+    }
+}
+
+// (pre[0], ..., pre[n - 1], expr), skipping empty slots
+static Node *prepend(Expansion *x, Node **pre, int n, Node *expr) {
+    for (int i = n - 1; i >= 0; i--) {
+        if (pre[i]) {
+            pre[i]->next = NULL;
+            expr = new_comma(x, pre[i], expr);
+        }
+    }
+    return expr;
+}
+
+// Replace call with the body of callee. Returns false, leaving the call
+// alone, if the body does not fit the budget or has a statement without an
+// expression form.
+static bool inline_call(Inliner *in, Node *call, Obj *callee, int nparams) {
+    JCC *vm = in->vm;
+    Expansion x = {0};
+    x.in = in;
+    x.call = call;
+    x.budget = callee->is_inline ? INLINE_BUDGET_HINT : INLINE_BUDGET;
+
+    // Parameters: read the argument in place, or assign it to a copy first.
+    // pre[i] is what has to run before the body for parameter i.
+    Node **pre = calloc(nparams, sizeof(Node *));
+    if (!pre)
+        error("out of memory");
+    Node *arg = call->args;
+    int i = 0;
+    for (Obj *p = callee->params; p; p = p->next, arg = arg->next, i++) {
+        Node *val = arg;
+        if (!same_repr(arg->ty, p->ty))
+            val = new_cast(vm, arg, p->ty);
+        ParamUse use = {p, 0, false};
+        walk(callee->body, note_param_use, &use);
+        if (!use.written && is_substitutable(in, val)) {
+            hashmap_put_int(&x.subst, (long long)p, val);
+        } else if (!use.written && use.uses == 0) {
+            pre[i] = val; // Evaluated for its side effects only
+        } else {
+            pre[i] = new_node(&x, ND_ASSIGN, p->ty);
+            pre[i]->lhs = new_node(&x, ND_VAR, p->ty);
+            pre[i]->lhs->var = copy_local(&x, p);
+            pre[i]->rhs = val;
+            x.size += 2;
+        }
+    }
+
+    Node *expr = copy_stmts(&x, callee->body, NULL, true);
+    if (!x.failed)
+        expr = prepend(&x, pre, nparams, expr);
+    free(pre);
+    free(x.vars.buckets);
+    free(x.subst.buckets);
+    if (x.failed)
+        return false;
+
+    // The callee's locals now live in the caller's frame
+    Obj *last = x.locals;
+    while (last && last->next)
+        last = last->next;
+    if (last) {
+        last->next = in->caller->locals;
+        in->caller->locals = x.locals;
+    }
+
+    Node *next = call->next;
+    Type *ty = call->ty;
+    Token *tok = call->tok;
+    *call = *expr;
+    call->next = next;
+    call->ty = ty;
+    call->tok = tok;
+    in->count++;
+    return true;
+}
+
+// ========== Driver ==========
+
+static void process(Inliner *in, Obj *fn);
+
+static void try_inline(Inliner *in, Node *call) {
+    Node *fn_node = call->lhs;
+    if (fn_node->kind != ND_VAR || !fn_node->var->is_function)
+        return;
+    Obj *callee = hashmap_get(&in->defs, fn_node->var->name);
+    if (!callee || callee == in->caller || !is_inlinable(in, callee))
+        return;
+
+    // Arguments must line up with the parameters
+    int nargs = 0, nparams = 0;
+    for (Node *arg = call->args; arg; arg = arg->next)
+        nargs++;
+    for (Obj *p = callee->params; p; p = p->next)
+        nparams++;
+    if (nargs != nparams)
+        return;
+    Type *ret_ty = callee->ty->return_ty;
+    if (ret_ty->kind == TY_VOID ? call->ty->kind != TY_VOID
+                                : !same_repr(call->ty, ret_ty))
+        return;
+
+    void *state = hashmap_get_int(&in->state, (long long)callee);
+    if (!state) {
+        process(in, callee);
+        state = hashmap_get_int(&in->state, (long long)callee);
+    }
+    // Still being processed: the call closes a cycle
+    if (state != INLINE_DONE)
+        return;
+    inline_call(in, call, callee, nparams);
+}
+
+static void inline_node(Inliner *in, Node *node) {
+    if (!node)
+        return;
+    inline_node(in, node->lhs);
+    inline_node(in, node->rhs);
+    inline_node(in, node->cond);
+    inline_node(in, node->then);
+    inline_node(in, node->els);
+    inline_node(in, node->init);
+    inline_node(in, node->inc);
+    inline_node(in, node->cas_addr);
+    inline_node(in, node->cas_old);
+    inline_node(in, node->cas_new);
+    for (Node *n = node->body; n; n = n->next)
+        inline_node(in, n);
+    for (Node *n = node->args; n; n = n->next)
+        inline_node(in, n);
+    if (node->kind == ND_FUNCALL)
+        try_inline(in, node);
+}
+
+static void process(Inliner *in, Obj *fn) {
+    hashmap_put_int(&in->state, (long long)fn, INLINE_BUSY);
+    // Nested functions and blocks reach the locals of their parents through
+    // frame pointers, so their frames keep their layout
+    if (!fn->is_nested && !fn->is_block && !fn->has_nested) {
+        Obj *caller = in->caller;
+        HashMap *escaped = in->escaped;
+        HashMap fn_escaped = {0};
+        walk(fn->body, note_escape, &fn_escaped);
+        in->caller = fn;
+        in->escaped = &fn_escaped;
+        inline_node(in, fn->body);
+        in->caller = caller;
+        in->escaped = escaped;
+        free(fn_escaped.buckets);
+    }
+    hashmap_put_int(&in->state, (long long)fn, INLINE_DONE);
+}
+
+static void note_reference(Node *node, void *ctx) {
+    if (node->kind == ND_VAR && node->var->is_function)
+        hashmap_put(ctx, node->var->name, node->var);
+}
+
+// Drop static inline functions nothing refers to any more. Every other
+// function is a root, as is a static inline function named outside of a
+// function body (parse.c sets is_root).
+static void drop_dead_functions(Obj *prog) {
+    HashMap live = {0};
+    for (Obj *fn = prog; fn; fn = fn->next) {
+        if (!fn->is_function || !fn->body)
+            continue;
+        fn->is_live = fn->is_root || !(fn->is_static && fn->is_inline);
+        if (fn->is_live)
+            walk(fn->body, note_reference, &live);
+    }
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (Obj *fn = prog; fn; fn = fn->next) {
+            if (fn->is_function && fn->body && !fn->is_live &&
+                hashmap_get(&live, fn->name)) {
+                fn->is_live = true;
+                walk(fn->body, note_reference, &live);
+                changed = true;
+            }
+        }
+    }
+    for (Obj *fn = prog; fn; fn = fn->next)
+        if (fn->is_function && fn->body && !fn->is_live)
+            fn->body = NULL;
+    free(live.buckets);
+}
+
+void cc_inline(JCC *vm, Obj *prog) {
+    // The debugger and the stack checks look at each call's own frame
+    if (vm->flags &
+        (JCC_ENABLE_DEBUGGER | JCC_UNINIT_DETECTION | JCC_STACK_INSTR))
+        return;
+
+    Inliner in = {0};
+    in.vm = vm;
+    for (Obj *fn = prog; fn; fn = fn->next) {
+        if (fn->is_function && fn->body && !hashmap_get(&in.defs, fn->name))
+            hashmap_put(&in.defs, fn->name, fn);
+    }
+    for (Obj *fn = prog; fn; fn = fn->next) {
+        if (fn->is_function && fn->body &&
+            !hashmap_get_int(&in.state, (long long)fn))
+            process(&in, fn);
+    }
+    if (in.count)
+        drop_dead_functions(prog);
+
+    free(in.defs.buckets);
+    free(in.state.buckets);
+}
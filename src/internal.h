@@ -51,7 +51,8 @@
 //   0     - Zero register (writes discarded)
 //   1     - Return address
 //   2     - Stack pointer (unused - we have vm->sp)
-//   3-4   - Reserved
+//   3     - Struct return destination (set by the caller before CALL)
+//   4     - Reserved
 //   5-9   - Temporaries T0-T4 (caller-saved)
 //   10-17 - Arguments/Return A0-A7 (caller-saved)
 //   18-25 - Saved S0-S7 (callee-saved, preserved across calls)
@@ -60,6 +61,7 @@
 #define REG_ZERO 0 // Always zero (writes discarded)
 #define REG_RA 1   // Return address
 #define REG_SP 2   // Stack pointer (unused for now - we have vm->sp)
+#define REG_SRET 3 // Where a struct/union-returning callee copies its result
 #define REG_T0 5   // Temporary (caller-saved)
 #define REG_T1 6   // Temporary
 #define REG_T2 7   // Temporary
@@ -100,6 +102,10 @@
 #define FREG_A6 16 // Float argument
 #define FREG_A7 17 // Float argument
 
+// ENT3 flag in the float_param_mask operand: the function never uses its
+// frame, so ENT3 does not open one and it returns with RET3
+#define ENT3_NO_FRAME (1LL << 32)
+
 // Instruction encoding macros for new opcodes
 // RRR format: [OPCODE] [rd:8|rs1:8|rs2:8|unused:40]
 #define ENCODE_RRR(rd, rs1, rs2)                                               \
@@ -126,6 +132,27 @@
         rd = (operands) & 0xFF;                                                \
     } while (0)
 
+// Number of opcodes in OPS_X
+enum {
+#define X(NAME) +1
+    NUM_OPS = 0 OPS_X
+#undef X
+};
+
+// Pre-decoded instruction record. vm_predecode() translates text_seg into an
+// array of these so the dispatch loop never re-extracts operands. Jump and
+// call targets are stored in imm as VMInsn pointers.
+typedef struct VMInsn {
+    void *handler;          // Label of the opcode in the bound dispatch loop
+    unsigned char op;       // Opcode (NUM_OPS for an invalid word)
+    unsigned char rd;       // Destination (or sole) register
+    unsigned char rs1;      // First source register
+    unsigned char rs2;      // Second source register
+    unsigned int text_off;  // Word offset of the instruction in text_seg
+    long long imm;          // Unpacked immediate or remapped target
+    long long cmp_imm;      // Constant operand of BEQI..BGEUI
+} VMInsn;
+
 void strarray_push(StringArray *arr, char *s);
 char *format(char *fmt, ...) __attribute__((format(printf, 1, 2)));
 Token *preprocess(JCC *vm, Token *tok);
@@ -287,16 +314,90 @@ void codegen(JCC *vm, Obj *prog);
 // codegen.c
 //
 
+int find_ffi_function(JCC *vm, const char *name);
 void gen_function(JCC *vm, Obj *fn);
 void gen(JCC *vm, Obj *prog);
 // Note: gen_expr is now static in codegen.c with signature:
 // static void gen_expr(JCC *vm, Node *node, int dest_reg);
 
+//
+// bytecode.c
+//
+
+uint64_t opcode_table_hash(void);
+
 //
 // vm.c
 //
 
 int vm_eval(JCC *vm);
+int vm_predecode(JCC *vm);
+int vm_insn_size(int op);
+int vm_target_operand(int op);
+int vm_superop_base(int op);
+int vm_save_ngram_profile(JCC *vm);
+void vm_set_trap(JCC *vm, long long *pc, int enable);
+int vm_call(JCC *vm, long long addr);
+
+//
+// jit.c
+//
+
+// Returned by native code that stopped on a runtime error
+#define JIT_ERROR (-1LL)
+
+// Default tiering thresholds (--jit-threshold, --osr-threshold): calls
+// before a function is compiled, and loop iterations before the function
+// running the loop is
+#define JIT_CALL_THRESHOLD 100
+#define JIT_LOOP_THRESHOLD 1000
+
+// Default size limit of the --jit-cache directory (--jit-cache-size)
+#define JIT_CACHE_LIMIT (64LL << 20)
+
+typedef struct JITState JITState;
+
+int jit_init(JCC *vm);
+int jit_counted(JCC *vm, VMInsn *insn);
+int jit_hot(JCC *vm, VMInsn *insn);
+void *jit_entry(JCC *vm, VMInsn *insn);
+long long jit_enter(JCC *vm, VMInsn *insn);
+void jit_free(JCC *vm);
+
+//
+// perf.c
+//
+
+// Profiler outputs (JCC.perf)
+#define PERF_MAP 1          // /tmp/perf-<pid>.map (--perf-map)
+#define PERF_JITDUMP 2      // /tmp/jit-<pid>.dump (--perf-jitdump)
+#define PERF_TRAMPOLINES 4  // Trampolines for interpreted functions (--perf-trampolines)
+
+// Trampoline calls nested on the host stack; deeper calls are interpreted
+// in the loop of the last one
+#define PERF_MAX_DEPTH 1024
+
+typedef struct PerfState PerfState;
+
+void perf_code_load(JCC *vm, VMInsn *fn, const char *kind, const void *code,
+                    size_t size);
+int perf_trampoline(JCC *vm, VMInsn *insn);
+int perf_enter(JCC *vm, VMInsn *insn);
+void perf_free(JCC *vm);
+
+//
+// consteval.c
+//
+
+bool cc_fold_call(JCC *vm, Node *node);
+void cc_consteval(JCC *vm, Obj *prog);
+void cc_consteval_free(JCC *vm);
+
+//
+// inline.c
+//
+
+void cc_inline(JCC *vm, Obj *prog);
 
 //
 // optimize.c
@@ -317,7 +418,7 @@ int debugger_check_watchpoint(JCC *vm, void *addr, int size, int access_type);
 void debugger_print_registers(JCC *vm);
 void debugger_print_stack(JCC *vm, int count);
 void debugger_disassemble_current(JCC *vm);
-int debugger_run(JCC *vm, int argc, char **argv);
+int debugger_run(JCC *vm);
 
 //
 // serialize.c
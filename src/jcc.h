@@ -47,6 +47,8 @@
 #include <ffi.h>
 #endif
 
+#include "superops.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -56,12 +58,11 @@ extern "C" {
     X(JMP)   /* Unconditional jump */                                          \
     X(CALL)  /* Call function (direct) */                                      \
     X(CALLI) /* Call function (indirect via register) */                       \
-    X(JMPT)  /* Jump table */                                                  \
+    X(JMPT)  /* Jump table: index rs into count JMP records */                 \
     X(JMPI)  /* Indirect jump */                                               \
     /* VM memory operations (self-contained, no system calls) */               \
     X(MALC)                                                                    \
     X(MFRE)                                                                    \
-    X(MCPY)                                                                    \
     X(REALC)                                                                   \
     X(CALC)                                                                    \
     /* Type conversion instructions (in-register) */                           \
@@ -114,13 +115,35 @@ extern "C" {
     X(NOT3)  /* rd = !rs (logical not) */                                      \
     X(BNOT3) /* rd = ~rs (bitwise not) */                                      \
     X(ADDI3) /* rd = rs1 + immediate */                                        \
+    X(SUBI3) /* rd = rs1 - immediate */                                        \
+    X(MULI3) /* rd = rs1 * immediate */                                        \
+    X(ANDI3) /* rd = rs1 & immediate */                                        \
+    X(ORI3)  /* rd = rs1 | immediate */                                        \
+    X(XORI3) /* rd = rs1 ^ immediate */                                        \
+    X(SHLI3) /* rd = rs1 << immediate */                                       \
+    X(SHRI3) /* rd = rs1 >> immediate */                                       \
+    X(SLTI3) /* rd = rs1 < immediate */                                        \
     X(LEA3)  /* rd = bp + immediate (local variable address) */                \
     /* Register-based control flow */                                          \
     X(JZ3)  /* if (regs[rs] == 0) pc = target */                               \
     X(JNZ3) /* if (regs[rs] != 0) pc = target */                               \
+    /* Compare-and-branch (register-register, then register-immediate) */      \
+    X(BEQ)   /* if (regs[rs1] == regs[rs2]) pc = target */                     \
+    X(BNE)   /* if (regs[rs1] != regs[rs2]) pc = target */                     \
+    X(BLT)   /* if (regs[rs1] < regs[rs2]) pc = target */                      \
+    X(BGE)   /* if (regs[rs1] >= regs[rs2]) pc = target */                     \
+    X(BLTU)  /* unsigned BLT */                                                \
+    X(BGEU)  /* unsigned BGE */                                                \
+    X(BEQI)  /* if (regs[rs] == immediate) pc = target */                      \
+    X(BNEI)  /* if (regs[rs] != immediate) pc = target */                      \
+    X(BLTI)  /* if (regs[rs] < immediate) pc = target */                       \
+    X(BGEI)  /* if (regs[rs] >= immediate) pc = target */                      \
+    X(BLTUI) /* unsigned BLTI */                                               \
+    X(BGEUI) /* unsigned BGEI */                                               \
     /* Register-based function frame */                                        \
     X(ENT3) /* Enter function: stack_size|param_count */                       \
     X(LEV3) /* Leave function: return value in REG_A0 */                       \
+    X(RET3) /* Leave a function without a frame (ENT3_NO_FRAME) */             \
     X(ADJ)  /* Adjust stack pointer */                                         \
     X(PSH3) /* Push regs[rs] onto stack: *--sp = regs[rs] */                   \
     X(POP3) /* Pop from stack into regs[rd]: rd = *sp++ */                     \
@@ -133,9 +156,11 @@ extern "C" {
     X(STR_H) /* *(short*)regs[rs] = regs[rd] (store halfword) */               \
     X(STR_W) /* *(int*)regs[rs] = regs[rd] (store word) */                     \
     X(STR_D) /* *(long long*)regs[rs] = regs[rd] (store dword) */              \
+    X(BCPY)  /* memmove(regs[rd], regs[rs], immediate) (struct copy) */        \
     /* Floating-point register operations */                                   \
     X(FLDR)  /* fregs[rd] = *(double*)regs[rs] */                              \
     X(FSTR)  /* *(double*)regs[rs] = fregs[rd] */                              \
+    X(FLI)   /* fregs[rd] = immediate (bit pattern of a double) */             \
     X(FADD3) /* fregs[rd] = fregs[rs1] + fregs[rs2] */                         \
     X(FSUB3) /* fregs[rd] = fregs[rs1] - fregs[rs2] */                         \
     X(FMUL3) /* fregs[rd] = fregs[rs1] * fregs[rs2] */                         \
@@ -156,8 +181,14 @@ extern "C" {
     X(CHKP3) /* Check pointer validity: regs[rs] */                            \
     X(CHKA3) /* Check alignment: regs[rs], immediate alignment */              \
     X(CHKT3) /* Check type: regs[rs], immediate TypeKind */                    \
-    /* Struct return buffer support */                                         \
-    X(RETBUF) /* Get next return buffer: REG_A0 = rotating pool buffer */
+    /* Debugger */                                                             \
+    X(BRK) /* Breakpoint trap, swapped over a decoded instruction's handler */ \
+    /* Native code */                                                          \
+    X(JITENT) /* Enter a function compiled by --jit (swapped in like BRK) */   \
+    X(JITCNT) /* Count calls/iterations towards compiling with --jit */        \
+    X(PERFENT) /* Enter a function through its --perf-trampolines stub */      \
+    /* Superinstructions generated from profiles (see superops.h) */           \
+    SUPEROPS_X
 
 /*!
  @enum JCC_OP
@@ -208,6 +239,7 @@ typedef enum {
     JCC_STACK_INSTR_ERRORS =
         (1 << 19), // 0x00080000 - Stack instrumentation errors
     JCC_ENABLE_DEBUGGER = (1 << 20), // 0x00100000 - Interactive debugger
+    JCC_JIT = (1 << 21),             // 0x00200000 - Native x86-64 code (--jit)
 
     // Convenience flag combinations
     JCC_POINTER_SANITIZER =
@@ -237,6 +269,22 @@ typedef enum {
                           JCC_DANGLING_DETECT | JCC_MEMORY_TAGGING),
 } JCCFlags;
 
+/*!
+ @enum JCCRunStatus
+ @abstract Result of a bounded run with cc_run_for() or cc_resume().
+ @constant JCC_RUN_FINISHED main() returned; its exit code is reported
+           through the exit_code parameter.
+ @constant JCC_RUN_EXHAUSTED The instruction budget ran out. All VM state is
+           intact and cc_resume() continues where execution stopped.
+ @constant JCC_RUN_ERROR Execution stopped with a runtime error, or there
+           was nothing to run.
+*/
+typedef enum {
+    JCC_RUN_FINISHED = 0,
+    JCC_RUN_EXHAUSTED = 1,
+    JCC_RUN_ERROR = -1,
+} JCCRunStatus;
+
 /*!
  @struct HashEntry
  @abstract Simple key/value bucket used by the project's HashMap.
@@ -638,6 +686,8 @@ struct Node {
  @field is_local True for local (stack) variables; false for globals.
  @field offset For local variables: stack offset. For globals/functions
                some fields (like code_addr) are used instead.
+ @field reg For local variables promoted by codegen: the S register that
+            holds the value instead of the stack slot (0 if none).
  @field is_function True when this Obj represents a function.
  @field code_addr For functions compiled to VM bytecode: start address
                  in the text segment.
@@ -655,6 +705,7 @@ struct Obj {
     bool is_param;    // true if this is a function parameter
     bool is_captured; // true if accessed by a nested function (for optimization
                       // hints)
+    int reg;          // S register holding a promoted local (0 = stack slot)
 
     // Global variable or function
     bool is_function;
@@ -665,6 +716,7 @@ struct Obj {
     // Global variable
     bool is_tentative;
     bool is_tls;
+    bool is_string_literal; // Read-only; identical literals share storage
     char *init_data;
     Relocation *rel;
     Node *init_expr; // For constexpr: AST of initializer expression
@@ -676,12 +728,14 @@ struct Obj {
     Obj *locals;
     Obj *va_area;
     Obj *alloca_bottom;
+    Obj *sret; // Struct/union return: caller's destination (from REG_SRET)
     int stack_size;
 
     // Nested function support (GNU C extension)
     struct Obj *parent_fn; // Enclosing function (NULL if top-level)
     bool is_nested;        // True if defined inside another function
     int nesting_depth;     // 0 = top-level, 1 = one level deep, etc.
+    bool has_nested;       // True if a nested function or block is inside
 
     // Block support (Apple blocks extension)
     bool is_block;            // True if this is a block's synthetic function
@@ -781,30 +835,42 @@ typedef struct Scope {
     // the other is for struct/union/enum tags.
     VarScopeNode *vars; // Linked list of variables/typedefs (not HashMap)
     TagScopeNode *tags; // Linked list of tags (not HashMap)
+    HashMap index;      // File scope only: name -> newest node in vars
 } Scope;
 
-/*!
- @struct LabelEntry
- @abstract Tracks labels used for goto and labeled statements and their
-           defined addresses in the generated text segment.
-*/
-typedef struct LabelEntry {
-    char *name;         // Label name (for named labels)
-    char *unique_label; // Unique label identifier (for break/continue)
-    long long *address; // Address in text segment where label is defined
-} LabelEntry;
-
 /*!
  @struct GotoPatch
- @abstract Records a forward jump (JMP) that must be patched once the
-           destination label is defined.
+ @abstract Records a jump (JMP) or label address (&&label) that must be
+           patched once the destination label is defined.
 */
 typedef struct GotoPatch {
     char *name;          // Label name to jump to
-    char *unique_label;  // Or unique label identifier
-    long long *location; // Location of JMP instruction's address operand
+    long long *location; // Location of the address operand
 } GotoPatch;
 
+/*!
+ @struct FuncPatch
+ @abstract Records a call or function address whose target is resolved once
+           every function has been generated.
+*/
+typedef struct FuncPatch {
+    long long *location; // Location of the address operand
+    Obj *function;       // Function whose address to use
+} FuncPatch;
+
+/*!
+ @struct SwitchCase
+ @abstract One case of the switch statement being generated: the values it
+           matches, as the controlling expression holds them, and the
+           address of its code once generated.
+*/
+typedef struct SwitchCase {
+    Node *node;         // ND_CASE node
+    long long begin;    // First value matched
+    long long end;      // Last value matched (begin unless a case range)
+    long long *address; // Address of the case's code (NULL until generated)
+} SwitchCase;
+
 typedef struct JCC JCC;
 
 /*!
@@ -1136,6 +1202,7 @@ typedef struct Debugger {
     long long *step_over_return_addr; // Return address for step over
     long long *step_out_bp;           // Base pointer for step out
     int debugger_attached;            // Debugger REPL is active
+    int hooks_done; // Hooks already ran for vm->pc: resume without stopping
 
     // Source mapping (bytecode ↔ source lines)
     SourceMap *source_map;   // Array of PC to source location mappings
@@ -1154,20 +1221,6 @@ typedef struct Debugger {
     int num_watchpoints;
 } Debugger;
 
-#ifndef MAX_CALLS
-#define MAX_CALLS 1024
-#endif
-
-#ifndef MAX_LABELS
-#define MAX_LABELS 256
-#endif
-
-#ifndef MAX_SPARSE_CASES
-#define MAX_SPARSE_CASES 256
-#endif
-
-#define RETURN_BUFFER_POOL_SIZE 8
-
 /*!
  @struct Compiler
  @abstract Encapsulates all compiler frontend state: preprocessor, parser, and
@@ -1220,6 +1273,7 @@ typedef struct Compiler {
     Obj *builtin_alloca;   // Builtin alloca function
     Obj *builtin_setjmp;   // Builtin setjmp function
     Obj *builtin_longjmp;  // Builtin longjmp function
+    struct ConstEval *consteval; // Sandbox for compile-time calls (consteval.c)
 
     // Arena allocator for parser frontend (tokens, AST, preprocessor state)
     Arena parser_arena; // Fast bump-pointer allocator
@@ -1237,36 +1291,27 @@ typedef struct Compiler {
     int label_counter; // For generating unique labels
     int local_offset;  // Current local variable offset
 
-    struct {
-        long long *location; // Location in text segment to patch
-        Obj *function;       // Function to call
-    } call_patches[MAX_CALLS];
+    // Calls and function addresses, patched once all functions are generated
+    FuncPatch *call_patches;
     int num_call_patches;
-
-    // Function address patches for function pointers
-    struct {
-        long long *location; // Location of IMM operand to patch
-        Obj *function;       // Function whose address to use
-    } func_addr_patches[MAX_CALLS];
+    int call_patches_cap;
+    FuncPatch *func_addr_patches;
     int num_func_addr_patches;
+    int func_addr_patches_cap;
 
-    LabelEntry label_table[MAX_LABELS];
-    int num_labels;
-    GotoPatch goto_patches[MAX_LABELS];
+    // Labels of the function being generated (name -> address) and the jumps
+    // waiting for them
+    HashMap label_addrs;
+    GotoPatch *goto_patches;
     int num_goto_patches;
+    int goto_patches_cap;
 
-    // Switch statement code generation (for dense switches)
-    long long *current_switch_table;  // Jump table being filled
-    long current_switch_min;          // Minimum case value
-    long current_switch_size;         // Jump table size
+    // Switch statement code generation
+    SwitchCase *current_switch_cases; // Cases sorted by value
+    int current_switch_num;           // Number of current_switch_cases
+    Type *current_switch_type;        // Type of the controlling expression
     Node *current_switch_default;     // Default case node
-    long long *current_default_patch; // Patch location for default case jump
-
-    // Switch statement code generation (for sparse switches)
-    long long *current_sparse_case_table;           // Array of jump addresses
-    int current_sparse_num;                         // Number of case entries
-    Node *sparse_case_nodes[MAX_SPARSE_CASES];      // Case nodes
-    long long *sparse_jump_addrs[MAX_SPARSE_CASES]; // Jump address pointers
+    long long *current_default_addr;  // Address of the default case's code
 
     // Inline assembly callback
     JCCAsmCallback asm_callback; // User-provided callback for asm statements
@@ -1280,11 +1325,6 @@ typedef struct Compiler {
     // Current function being compiled (for VLA cleanup)
     Obj *current_codegen_fn;
 
-    // Struct/union return buffer pool (copy-before-return approach)
-    char *return_buffer_pool[RETURN_BUFFER_POOL_SIZE]; // Pool of return buffers
-    int return_buffer_index; // Current buffer index (rotates 0-7)
-    int return_buffer_size;  // Size of each buffer (1024 bytes)
-
     // Linked programs for extern offset propagation
     Obj **link_progs;    // Array of original program lists
     int link_prog_count; // Number of programs
@@ -1314,7 +1354,11 @@ struct JCC {
     long long *pc;      // Program counter
     long long *bp;      // Base pointer (frame pointer)
     long long *sp;      // Stack pointer
-    long long cycle;    // Instruction cycle counter
+    long long hooked;   // Instructions run through the instrumented loop
+                        // (debugger stops and steps, --debug tracing,
+                        // n-gram profiling); not every instruction run
+    long long budget;   // Instructions left before the run is preempted
+    long long budget_slice; // Budget granted by cc_run_for()/cc_resume()
 
     // Exit detection (for returning from main)
     long long *initial_sp; // Initial stack pointer (for exit detection)
@@ -1330,6 +1374,33 @@ struct JCC {
     char *heap_seg;          // Heap segment (for VM malloc/free)
     char *heap_ptr;          // Current allocation pointer (bump allocator)
     char *heap_end;          // End of heap segment
+
+    // Pre-decoded instruction stream (built from text_seg by vm_predecode)
+    struct VMInsn *insns;        // One decoded record per instruction
+    struct VMInsn **insn_at;     // text_seg word offset -> record (or NULL)
+    long long insn_count;        // Number of records (excluding sentinel)
+    long long *insn_text_seg;    // text_seg the records were decoded from
+    long long insn_text_size;    // Number of text words covered by insn_at
+    int insn_variant;            // Dispatch loop the handlers are bound to
+    struct JITState *jit;        // Native code for the records (jit.c)
+    int jit_threshold;           // Calls before --jit compiles a function
+    int osr_threshold;           // Loop iterations before it compiles one
+    int jit_tier;                // Last tier: 1 stencils, 2 native code
+    char *jit_cache_dir;         // Tier 2 code cache (--jit-cache, NULL = off)
+    long long jit_cache_limit;   // Bytes the cache directory may hold
+    long long jit_cache_hits;    // Functions installed from the cache
+    long long jit_cache_misses;  // Functions translated and cached
+    long long jit_cache_evictions; // Cache files removed to fit the limit
+    int perf;                    // PERF_* profiler outputs (perf.c), 0 = off
+    struct PerfState *perf_state; // Open outputs and trampolines
+    struct VMInsn *perf_entry;   // ENT3 a trampoline is entering
+    int perf_depth;              // Trampoline calls in progress
+
+    // Opcode n-gram profiling (--ngram-profile)
+    char *ngram_profile;         // File the counts are merged into (NULL = off)
+    HashMap ngram_counts;        // Packed opcode n-gram -> execution count
+    struct VMInsn *ngram_prev;   // Record executed before the current one
+    int ngram_hist[2];           // Last two opcodes of the straight-line run
     FreeBlock *free_list;    // Head of free blocks list (for memory reuse)
 
     // Segregated free lists for optimized allocation
@@ -1364,6 +1435,7 @@ struct JCC {
     // Configuration
     int poolsize; // Size of memory segments (bytes)
     int debug_vm; // Enable debug output during execution
+    int quiet_faults; // Fail on runtime errors without printing a report
 
     // Runtime flags (bitwise combination of JCCFlags)
     uint32_t flags; // JCCFlags bitfield for all safety and runtime features
@@ -1384,11 +1456,6 @@ struct JCC {
     ScopeVarList *scope_vars;      // Array of per-scope variable lists
     int scope_vars_capacity;       // Capacity of scope_vars array
 
-    // Struct return buffer runtime state (runtime rotation for clean chained
-    // calls)
-    int runtime_return_buffer_index; // Runtime rotating index for return
-                                     // buffers
-
     // Debugger state (enable via JCC_ENABLE_DEBUGGER flag)
     Debugger dbg;
 
@@ -1777,6 +1844,38 @@ void cc_compile(JCC *vm, Obj *prog);
 */
 int cc_run(JCC *vm, int argc, char **argv);
 
+/*!
+ @function cc_run_for
+ @abstract Start the compiled program with an instruction budget.
+ @discussion Runs like cc_run() but stops once roughly max_instructions
+             instructions have executed, so a host can time-slice several
+             programs. The budget is charged and checked only where
+             execution can repeat: a backward branch charges the length of
+             the loop body it closes and a call charges one. Straight-line
+             code between those points may run past the budget.
+             The debugger REPL is not started.
+ @param vm The JCC instance containing compiled bytecode.
+ @param argc Argument count to pass to the program's main().
+ @param argv Argument vector (NUL-terminated array of strings).
+ @param max_instructions Budget for this slice and each cc_resume().
+ @param exit_code Receives main()'s exit code on JCC_RUN_FINISHED (may be
+        NULL).
+ @return A JCCRunStatus.
+*/
+int cc_run_for(JCC *vm, int argc, char **argv, long long max_instructions,
+               int *exit_code);
+
+/*!
+ @function cc_resume
+ @abstract Continue a program preempted by cc_run_for() or cc_resume().
+ @discussion Grants a fresh budget of the size given to cc_run_for().
+ @param vm The JCC instance whose last run returned JCC_RUN_EXHAUSTED.
+ @param exit_code Receives main()'s exit code on JCC_RUN_FINISHED (may be
+        NULL).
+ @return A JCCRunStatus; JCC_RUN_ERROR if there is nothing to resume.
+*/
+int cc_resume(JCC *vm, int *exit_code);
+
 /*!
  @function cc_print_tokens
  @abstract Print a token stream to stdout (useful for debugging the
@@ -1848,6 +1947,45 @@ int cc_save_bytecode(JCC *vm, const char *path);
 */
 int cc_load_bytecode(JCC *vm, const char *path);
 
+/*!
+ @function cc_save_executable
+ @abstract Bundle compiled bytecode with the jcc runtime into an executable.
+ @discussion Writes a copy of the running jcc executable with the bytecode
+             image appended. When started, the executable finds the image
+             (see cc_load_executable()), resolves the foreign functions the
+             program calls by name and runs it with its own arguments; on
+             x86-64 it runs with --jit. The program is still compiled to
+             bytecode and run by the VM, not lowered to native code ahead
+             of time.
+ @param vm The JCC instance containing compiled bytecode.
+ @param path Output file path (made executable).
+ @return 0 on success, -1 on error.
+*/
+int cc_save_executable(JCC *vm, const char *path);
+
+/*!
+ @function cc_load_executable
+ @abstract Load the bytecode embedded in an executable.
+ @discussion Loads bytecode appended by cc_save_executable(). Foreign
+             functions are resolved against the ones registered on vm, so
+             call cc_load_stdlib() first.
+ @param vm The JCC instance to load bytecode into.
+ @param path Executable path, or NULL for the running executable.
+ @return 0 on success, 1 if the file has no embedded bytecode, -1 on error.
+*/
+int cc_load_executable(JCC *vm, const char *path);
+
+/*!
+ @function cc_has_executable_image
+ @abstract Check whether an executable has bytecode embedded in it.
+ @discussion Only reads the trailer written by cc_save_executable(), so it is
+             cheap enough to call before setting up a JCC instance.
+ @param path Executable path, or NULL for the running executable.
+ @return 1 if the file ends with an embedded image (valid or not), 0 if not
+         or if it cannot be read.
+*/
+int cc_has_executable_image(const char *path);
+
 /*!
  @function cc_add_breakpoint
  @abstract Add a breakpoint at a specific program counter address.
@@ -0,0 +1,1961 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "jcc.h"
+#include "./internal.h"
+
+//
+// Native Code Generator (--jit)
+//
+// Translates functions of the pre-decoded instruction stream into x86-64
+// machine code. A function is the run of records from an ENT3 to the record
+// before the next ENT3; it can be compiled only if every opcode in it is
+// supported and all of its branches stay inside it. Everything else keeps
+// running in the interpreter.
+//
+// Compilation is tiered. Every function starts out interpreted, with JITCNT
+// swapped over its ENT3 and its loop headers (targets of backward branches)
+// to count calls and iterations. When a count reaches vm->jit_threshold
+// (calls) or vm->osr_threshold (iterations), jit_hot() compiles the whole
+// function and the counters become JITENT native entries. A loop header is
+// an entry like the ENT3: a loop that got hot keeps running natively from
+// its next iteration (on-stack replacement), since native code works on the
+// interpreter's own frame.
+//
+// The first compile is cheap: tier 1 pastes together machine code stencils
+// that stencils.py generated from the opcode bodies of the dispatch loop
+// (see "Stencil Tier"). Its entries and loop headers count again, and a
+// function that gets as hot a second time is translated by tier 2, the code
+// generator below, unless vm->jit_tier is 1. Only tier 2 is used when the
+// stencils cannot be (stencils.h out of date, or an opcode without one).
+//
+// Native code works on the same VM state as the dispatch loop:
+//
+//   - VM registers T0-T4 and A0-A3 live in host registers (see host_reg);
+//     the rest stay in vm->regs. Float registers stay in vm->fregs.
+//   - r12 and r13 hold the VM sp and bp, r15 the JCC. rax, rcx and rdx are
+//     scratch.
+//   - A call pushes the VM return address on the VM stack exactly like CALL,
+//     then makes a host call. LEV3 pops the frame and returns the VM return
+//     address in rax, so a function entered from the interpreter (op_JITENT)
+//     tells the loop where to continue. JIT_ERROR (-1) means it stopped on a
+//     runtime error with vm->pc at the faulting instruction.
+//   - Calls to functions that were not compiled by tier 2, and CALLI, go
+//     through jit_call(), which runs the callee as stencils or back in the
+//     interpreter. A function that may be compiled later is called through
+//     its start[] slot, so callers pick it up once it is. Out-of-line opcodes
+//     call their ops.c handler, and CALLF calls the foreign function
+//     directly when its arguments fit in SysV argument registers.
+//
+// Around any call into C, host registers are written back to vm->regs and
+// vm->sp/bp and reloaded afterwards. Only the unchecked loop (variant 0)
+// binds native entries, so no safety group, debugger or budget is active.
+//
+
+#if defined(__x86_64__) && !defined(_WIN32)
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+
+extern int op_MALC_fn(JCC *vm);
+extern int op_MFRE_fn(JCC *vm);
+extern int op_REALC_fn(JCC *vm);
+extern int op_CALC_fn(JCC *vm);
+extern int op_CALLF_fn(JCC *vm);
+
+// C functions native code calls, by index (see jit_helpers)
+#define JIT_HELPERS_X                                                          \
+    X(jit_call) X(jit_fault) X(jit_op_BCPY) X(op_MALC_fn) X(op_MFRE_fn)      \
+    X(op_REALC_fn) X(op_CALC_fn) X(op_CALLF_fn)
+
+enum {
+#define X(NAME) HELPER_##NAME,
+    JIT_HELPERS_X
+#undef X
+};
+
+// Address space reserved for native code; pages are committed as written
+#define JIT_CODE_SIZE (64 << 20)
+
+// Largest BCPY copied inline rather than through memmove. C only lets the
+// two sides of a struct assignment overlap exactly, so the unrolled copy
+// need not order its moves.
+#define JIT_BCPY_INLINE 64
+
+struct JITState {
+    unsigned char *code;  // Executable mapping (stub, then the functions)
+    size_t size;          // Bytes mapped
+    size_t used;          // Bytes written
+    int error_tail;       // Offset of the shared error tail (see gen_stub)
+    long long *func;      // Record index -> first record of its function
+    long long *end;       // First record -> one past its function's last
+                          // record, 0 if the function cannot be translated
+    void **start;         // First record -> native function (NULL if not yet)
+    void **entry;         // Record index -> native code for the record
+    void **stencil;       // Record index -> stencil code for the record
+    unsigned *count;      // Record index -> calls or iterations counted, or
+                          // visits left until tier 2 in stencil code
+    unsigned char *point; // Record index -> 1 function entry, 2 loop header
+    int stencils;         // Tier 1 can be used (see jit_init)
+};
+
+// Host registers
+enum {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15,
+};
+
+#define HSP R12  // VM stack pointer
+#define HBP R13  // VM base pointer
+#define HVM R15  // JCC *
+
+// Condition codes for Jcc/SETcc
+enum {
+    CC_B = 2, CC_AE = 3, CC_E = 4, CC_NE = 5, CC_A = 7,
+    CC_P = 10, CC_NP = 11, CC_L = 12, CC_GE = 13,
+};
+
+// Host register holding a VM register, or -1 if it stays in vm->regs
+static int host_reg(int r) {
+    switch (r) {
+        case REG_T0: return RBX;
+        case REG_T1: return RBP;
+        case REG_T2: return R14;
+        case REG_T3: return RSI;
+        case REG_T4: return RDI;
+        case REG_A0: return R8;
+        case REG_A1: return R9;
+        case REG_A2: return R10;
+        case REG_A3: return R11;
+        default: return -1;
+    }
+}
+
+#define REG_OFF(R) ((int)offsetof(JCC, regs) + (R) * 8)
+#define FREG_OFF(R) ((int)offsetof(JCC, fregs) + (R) * 8)
+
+// ========== Code Buffer ==========
+
+typedef struct {
+    int at;      // Offset of the rel32 to patch
+    int target;  // Record index
+} JitFixup;
+
+// Addresses in native code are left as zero and filled in by jit_relocate()
+// from a relocation, so the same code can be installed again by a later run
+// (see "Code Cache")
+enum {
+    REL_TEXT,    // imm64: text_seg + addend words
+    REL_DATA,    // imm64: data_seg + addend bytes
+    REL_INSN,    // imm64: &vm->insns[addend]
+    REL_START,   // imm64: &jit->start[addend]
+    REL_HELPER,  // imm64: jit_helpers[addend]
+    REL_FFI,     // imm64: the foreign function ffi_table[addend]
+    REL_TAIL,    // rel32: the shared error tail
+    REL_CALL,    // rel32: native code of the function at record addend
+};
+
+typedef struct {
+    int at;            // Offset of the imm64 or rel32
+    int kind;          // REL_*
+    long long addend;
+} JitReloc;
+
+// A JMPT's table of rel32 offsets, emitted after the function
+typedef struct {
+    int at;           // Offset of the LEA's rel32 that addresses the table
+    long long first;  // Record index of the first JMP record
+    int count;
+} JitTable;
+
+// A fault found by a check in native code (e.g. division by zero)
+typedef struct {
+    int at;           // Offset of the Jcc rel32 that jumps to the fault stub
+    VMInsn *insn;     // Faulting record
+    int spill;        // Host registers still hold live VM registers
+} JitFault;
+
+typedef struct {
+    unsigned char *buf;
+    int len, cap;
+    int base;         // Offset of buf[0] in the code mapping
+    long long func;   // First record of the function being translated
+    JitReloc *relocs;
+    int nrelocs, relocs_cap;
+    // Per function
+    int *label;       // Record index - start -> native offset
+    JitFixup *jumps;
+    int njumps, jumps_cap;
+    JitFault *faults;
+    int nfaults, faults_cap;
+    JitTable *tables;
+    int ntables, tables_cap;
+} JitBuf;
+
+#define GROW(ARR, N, CAP)                                                      \
+    do {                                                                       \
+        if ((N) >= (CAP)) {                                                    \
+            (CAP) = (CAP) ? (CAP) * 2 : 64;                                    \
+            (ARR) = realloc((ARR), sizeof(*(ARR)) * (CAP));                    \
+        }                                                                      \
+    } while (0)
+
+static void emit(JitBuf *b, int byte) {
+    GROW(b->buf, b->len, b->cap);
+    b->buf[b->len++] = (unsigned char)byte;
+}
+
+static void emit32(JitBuf *b, long long v) {
+    for (int i = 0; i < 4; i++)
+        emit(b, (int)(v >> (i * 8)) & 0xFF);
+}
+
+static void emit64(JitBuf *b, long long v) {
+    emit32(b, v);
+    emit32(b, v >> 32);
+}
+
+static void patch32(JitBuf *b, int at, int v) {
+    memcpy(b->buf + at, &v, 4);
+}
+
+static int fits32(long long v) {
+    return v >= INT32_MIN && v <= INT32_MAX;
+}
+
+static void add_reloc(JitBuf *b, int at, int kind, long long addend) {
+    GROW(b->relocs, b->nrelocs, b->relocs_cap);
+    b->relocs[b->nrelocs++] = (JitReloc){at, kind, addend};
+}
+
+// ========== Instruction Encoding ==========
+
+// Prefix, REX and opcode of a ModRM instruction. op is one opcode byte or
+// 0x0Fxx. byte_reg forces a REX so registers 4-7 name spl..dil, not ah..bh.
+static void enc_op(JitBuf *b, int pfx, int w, int op, int reg, int rm,
+                   int byte_reg) {
+    if (pfx)
+        emit(b, pfx);
+    int rex = 0x40 | (w << 3) | ((reg >> 3) << 2) | (rm >> 3);
+    if (rex != 0x40 || (byte_reg && ((reg & ~3) == 4 || (rm & ~3) == 4)))
+        emit(b, rex);
+    if (op > 0xFF)
+        emit(b, op >> 8);
+    emit(b, op & 0xFF);
+}
+
+// op reg, rm (register operands)
+static void x_rr(JitBuf *b, int pfx, int w, int op, int reg, int rm) {
+    enc_op(b, pfx, w, op, reg, rm, 0);
+    emit(b, 0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+// op reg, [base + disp]
+static void x_rm(JitBuf *b, int pfx, int w, int op, int reg, int base,
+                 int disp, int byte_reg) {
+    enc_op(b, pfx, w, op, reg, base, byte_reg);
+    int mod = (disp >= -128 && disp <= 127) ? 0x40 : 0x80;
+    emit(b, mod | ((reg & 7) << 3) | (base & 7));
+    if ((base & 7) == RSP)
+        emit(b, 0x24);  // SIB: no index
+    if (mod == 0x40)
+        emit(b, disp & 0xFF);
+    else
+        emit32(b, disp);
+}
+
+static void mov_rr(JitBuf *b, int dst, int src) {
+    if (dst != src)
+        x_rr(b, 0, 1, 0x89, src, dst);
+}
+
+static void mov_load(JitBuf *b, int dst, int base, int disp) {
+    x_rm(b, 0, 1, 0x8B, dst, base, disp, 0);
+}
+
+static void mov_store(JitBuf *b, int base, int disp, int src) {
+    x_rm(b, 0, 1, 0x89, src, base, disp, 0);
+}
+
+static void mov_imm(JitBuf *b, int dst, long long imm) {
+    if (imm >= 0 && imm <= UINT32_MAX) {
+        // mov r32, imm32 zero-extends
+        if (dst >= 8)
+            emit(b, 0x41);
+        emit(b, 0xB8 + (dst & 7));
+        emit32(b, imm);
+    } else if (fits32(imm)) {
+        x_rr(b, 0, 1, 0xC7, 0, dst);
+        emit32(b, imm);
+    } else {
+        emit(b, 0x48 | (dst >> 3));
+        emit(b, 0xB8 + (dst & 7));
+        emit64(b, imm);
+    }
+}
+
+// Group-1 ALU with an immediate: /0 add, /1 or, /4 and, /5 sub, /6 xor,
+// /7 cmp. Wide immediates go through rdx.
+static void alu_imm(JitBuf *b, int ext, int dst, long long imm) {
+    static const int rr_op[8] = {0x01, 0x09, 0, 0, 0x21, 0x29, 0x31, 0x39};
+    if (!fits32(imm)) {
+        mov_imm(b, RDX, imm);
+        x_rr(b, 0, 1, rr_op[ext], RDX, dst);
+    } else if (imm >= -128 && imm <= 127) {
+        x_rr(b, 0, 1, 0x83, ext, dst);
+        emit(b, (int)imm & 0xFF);
+    } else {
+        x_rr(b, 0, 1, 0x81, ext, dst);
+        emit32(b, imm);
+    }
+}
+
+// setcc into al or cl
+static void setcc(JitBuf *b, int cc, int dst) {
+    x_rr(b, 0, 0, 0x0F90 | cc, 0, dst);
+}
+
+// movzx eax, al
+static void zext_al(JitBuf *b) {
+    x_rr(b, 0, 0, 0x0FB6, RAX, RAX);
+}
+
+// movabs dst, address (relocated)
+static void mov_addr(JitBuf *b, int dst, int kind, long long addend) {
+    emit(b, 0x48 | (dst >> 3));
+    emit(b, 0xB8 + (dst & 7));
+    emit64(b, 0);
+    add_reloc(b, b->len - 8, kind, addend);
+}
+
+// Call a helper (rax is clobbered)
+static void call_helper(JitBuf *b, int helper) {
+    mov_addr(b, RAX, REL_HELPER, helper);
+    x_rr(b, 0, 0, 0xFF, 2, RAX);
+}
+
+// Jcc/JMP/CALL with a rel32 to patch later; returns the rel32's offset
+static int jcc32(JitBuf *b, int cc) {
+    emit(b, 0x0F);
+    emit(b, 0x80 | cc);
+    emit32(b, 0);
+    return b->len - 4;
+}
+
+static int jmp32(JitBuf *b) {
+    emit(b, 0xE9);
+    emit32(b, 0);
+    return b->len - 4;
+}
+
+// ========== VM Registers ==========
+
+// Load VM register r into host register h
+static void load_reg(JitBuf *b, int h, int r) {
+    int m = host_reg(r);
+    if (m >= 0)
+        mov_rr(b, h, m);
+    else
+        mov_load(b, h, HVM, REG_OFF(r));
+}
+
+// Host register holding VM register r, loading it into scratch if needed
+static int use_reg(JitBuf *b, int r, int scratch) {
+    int m = host_reg(r);
+    if (m >= 0)
+        return m;
+    mov_load(b, scratch, HVM, REG_OFF(r));
+    return scratch;
+}
+
+// Store host register h to VM register r. Guarded stores follow the
+// interpreter's "if (RD != REG_ZERO)".
+static void store_reg(JitBuf *b, int r, int h, int guarded) {
+    if (guarded && r == REG_ZERO)
+        return;
+    int m = host_reg(r);
+    if (m >= 0)
+        mov_rr(b, m, h);
+    else
+        mov_store(b, HVM, REG_OFF(r), h);
+}
+
+// Publish host-resident VM state to the JCC, or pick it up again
+static void spill(JitBuf *b) {
+    for (int r = 0; r < NUM_REGS; r++) {
+        if (host_reg(r) >= 0)
+            mov_store(b, HVM, REG_OFF(r), host_reg(r));
+    }
+    mov_store(b, HVM, (int)offsetof(JCC, sp), HSP);
+    mov_store(b, HVM, (int)offsetof(JCC, bp), HBP);
+}
+
+static void reload(JitBuf *b) {
+    for (int r = 0; r < NUM_REGS; r++) {
+        if (host_reg(r) >= 0)
+            mov_load(b, host_reg(r), HVM, REG_OFF(r));
+    }
+    mov_load(b, HSP, HVM, (int)offsetof(JCC, sp));
+    mov_load(b, HBP, HVM, (int)offsetof(JCC, bp));
+}
+
+// vm->pc = text_seg + off
+static void set_pc(JitBuf *b, long long off) {
+    mov_addr(b, RAX, REL_TEXT, off);
+    mov_store(b, HVM, (int)offsetof(JCC, pc), RAX);
+}
+
+// Jump to the fault stub for insn if the condition holds
+static void fault_if(JitBuf *b, int cc, VMInsn *insn, int spill_regs) {
+    GROW(b->faults, b->nfaults, b->faults_cap);
+    b->faults[b->nfaults++] = (JitFault){jcc32(b, cc), insn, spill_regs};
+}
+
+// ========== Runtime Helpers ==========
+
+// Called from a fault stub: point vm->pc at the faulting instruction and
+// report checks that native code makes inline, like the dispatch loop does
+static void jit_fault(JCC *vm, VMInsn *insn) {
+    vm->pc = vm->text_seg + insn->text_off;
+    if (vm->quiet_faults)
+        return;
+    switch (vm_superop_base(insn->op)) {
+        case DIV3:
+        case MOD3: {
+            long long a = vm->regs[insn->rs1], b = vm->regs[insn->rs2];
+            int is_div = vm_superop_base(insn->op) == DIV3;
+            if (b == 0) {
+                printf(is_div ? "\n========== DIVISION BY ZERO ==========\n"
+                              : "\n========== MODULO BY ZERO ==========\n");
+                printf(is_div ? "Attempted division by zero\n"
+                              : "Attempted modulo by zero\n");
+                printf(is_div ? "Operands: %lld / 0\n" : "Operands: %lld %% 0\n",
+                       a);
+            } else {
+                printf("\n========== INTEGER OVERFLOW ==========\n");
+                printf("Division overflow detected\n");
+                printf("Operands: %lld / %lld\n", a, b);
+                printf(
+                    "Result would overflow (LLONG_MIN / -1 = LLONG_MAX + 1)\n");
+            }
+            printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
+                   (long long)insn->text_off);
+            printf("======================================\n");
+            break;
+        }
+        case FDIV3:
+            printf("\n========== DIVISION BY ZERO ==========\n");
+            printf("Floating-point division by zero detected!\n");
+            printf("PC offset: %lld\n", (long long)insn->text_off);
+            printf("======================================\n");
+            break;
+        default:
+            // Out-of-line handlers report their own errors
+            break;
+    }
+}
+
+// Call the function at text address addr from native or stencil code, in
+// the best tier it has reached. Like vm_call(), it pushes a zero return
+// address and returns -1 with vm->pc at the fault if the callee failed.
+static int jit_call(JCC *vm, long long addr) {
+    JITState *jit = vm->jit;
+    unsigned long long off =
+        (unsigned long long)((long long *)addr - vm->text_seg);
+    if (off < (unsigned long long)vm->insn_text_size && vm->insn_at[off]) {
+        VMInsn *callee = vm->insn_at[off];
+        long long i = callee - vm->insns;
+        if (jit->func[i] == i && jit_entry(vm, callee)) {
+            *--vm->sp = 0;
+            return jit_enter(vm, callee) == JIT_ERROR ? -1 : 0;
+        }
+    }
+    return vm_call(vm, addr);
+}
+
+// BCPY too large to unroll; vm->pc points at its operands
+static int jit_op_BCPY(JCC *vm) {
+    int rd, rs1, rs2;
+    DECODE_RRR(vm->pc[0], rd, rs1, rs2);
+    (void)rs2;
+    memmove((void *)vm->regs[rd], (void *)vm->regs[rs1], (size_t)vm->pc[1]);
+    return 0;
+}
+
+static void *const jit_helpers[] = {
+#define X(NAME) (void *)NAME,
+    JIT_HELPERS_X
+#undef X
+};
+
+// ========== Translation ==========
+
+// Can every record in [start, end) be translated?
+static int jit_supported(JCC *vm, long long start, long long end) {
+    int last = vm_superop_base(vm->insns[end - 1].op);
+    if (last != LEV3 && last != RET3 && last != JMP)
+        return 0;
+    for (long long i = start; i < end; i++) {
+        VMInsn *insn = &vm->insns[i];
+        int op = vm_superop_base(insn->op);
+        switch (op) {
+            case JMPI: case SETJMP: case LONGJMP: case BRK:
+            case JITENT: case JITCNT: case PERFENT:
+                return 0;
+            default:
+                if (op >= NUM_OPS)
+                    return 0;
+                break;
+        }
+        if (vm_target_operand(op) && op != CALL) {
+            // Only ENT3 may open the frame, so nothing jumps back to it
+            long long t = (VMInsn *)insn->imm - vm->insns;
+            if (t <= start || t >= end)
+                return 0;
+            if (op == JMPT && t + insn->cmp_imm > end)
+                return 0;
+        }
+    }
+    return 1;
+}
+
+// Native CALLF: SysV call with the arguments loaded from vm->regs/fregs.
+// Returns 0 if the call needs the libffi path instead.
+static int gen_callf(JCC *vm, JitBuf *b, VMInsn *insn) {
+    long long *pc = vm->text_seg + insn->text_off;
+    long long idx = pc[1], nargs = pc[2];
+    unsigned long long mask = (unsigned long long)pc[3];
+    if (idx < 0 || idx >= vm->compiler.ffi_count || nargs > 8)
+        return 0;
+    ForeignFunc *ff = &vm->compiler.ffi_table[idx];
+    if (!ff->func_ptr)
+        return 0;
+
+    static const int int_args[6] = {RDI, RSI, RDX, RCX, R8, R9};
+    int ni = 0, nf = 0;
+    for (int i = 0; i < nargs; i++) {
+        if (mask & (1ULL << i))
+            nf++;
+        else if (++ni > 6)
+            return 0;
+    }
+
+    spill(b);
+    ni = nf = 0;
+    for (int i = 0; i < nargs; i++) {
+        if (mask & (1ULL << i))  // movsd xmmN, [fregs]
+            x_rm(b, 0xF2, 0, 0x0F10, nf++, HVM, FREG_OFF(FREG_A0 + i), 0);
+        else
+            mov_load(b, int_args[ni++], HVM, REG_OFF(REG_A0 + i));
+    }
+    // al = number of vector registers, for variadic callees
+    mov_addr(b, R11, REL_FFI, idx);
+    mov_imm(b, RAX, nf);
+    x_rr(b, 0, 0, 0xFF, 2, R11);
+    if (ff->returns_double)
+        x_rm(b, 0xF2, 0, 0x0F11, 0, HVM, FREG_OFF(FREG_A0), 0);
+    else
+        mov_store(b, HVM, REG_OFF(REG_A0), RAX);
+    reload(b);
+    return 1;
+}
+
+// Call an out-of-line handler (int fn(JCC *)) that reads its operands
+// through vm->pc, like CALL_OP in the dispatch loop
+static void gen_call_op(JitBuf *b, VMInsn *insn, int helper) {
+    spill(b);
+    set_pc(b, insn->text_off + 1);
+    mov_rr(b, RDI, HVM);
+    call_helper(b, helper);
+    x_rr(b, 0, 0, 0x85, RAX, RAX);  // test eax, eax
+    fault_if(b, CC_NE, insn, 0);
+    reload(b);
+}
+
+static void gen_binary(JitBuf *b, VMInsn *insn, int op) {
+    load_reg(b, RAX, insn->rs1);
+    int src = use_reg(b, insn->rs2, RCX);
+    x_rr(b, 0, 1, op, src, RAX);
+    store_reg(b, insn->rd, RAX, 1);
+}
+
+static void gen_compare(JitBuf *b, VMInsn *insn, int cc) {
+    int a = use_reg(b, insn->rs1, RAX);
+    int c = use_reg(b, insn->rs2, RCX);
+    x_rr(b, 0, 1, 0x39, c, a);  // cmp a, c
+    setcc(b, cc, RAX);
+    zext_al(b);
+    store_reg(b, insn->rd, RAX, 1);
+}
+
+static void gen_branch(JitBuf *b, long long target, int cc) {
+    GROW(b->jumps, b->njumps, b->jumps_cap);
+    int at = cc < 0 ? jmp32(b) : jcc32(b, cc);
+    b->jumps[b->njumps++] = (JitFixup){at, (int)target};
+}
+
+// Float compare into regs[RD]. swap compares rs2 against rs1, so "<" and
+// "<=" become "above" tests that are false for unordered operands.
+static void gen_fcompare(JitBuf *b, VMInsn *insn, int swap, int cc) {
+    int x = swap ? insn->rs2 : insn->rs1, y = swap ? insn->rs1 : insn->rs2;
+    x_rm(b, 0xF2, 0, 0x0F10, 0, HVM, FREG_OFF(x), 0);  // movsd xmm0, x
+    x_rm(b, 0x66, 0, 0x0F2E, 0, HVM, FREG_OFF(y), 0);  // ucomisd xmm0, y
+    setcc(b, cc, RAX);
+    if (cc == CC_E || cc == CC_NE) {
+        // Unordered sets ZF too: == needs PF clear, != accepts PF set
+        setcc(b, cc == CC_E ? CC_NP : CC_P, RCX);
+        x_rr(b, 0, 0, cc == CC_E ? 0x20 : 0x08, RCX, RAX);  // and/or al, cl
+    }
+    zext_al(b);
+    store_reg(b, insn->rd, RAX, 0);
+}
+
+static void gen_farith(JitBuf *b, VMInsn *insn, int op) {
+    x_rm(b, 0xF2, 0, 0x0F10, 0, HVM, FREG_OFF(insn->rs1), 0);
+    x_rm(b, 0xF2, 0, op, 0, HVM, FREG_OFF(insn->rs2), 0);
+    x_rm(b, 0xF2, 0, 0x0F11, 0, HVM, FREG_OFF(insn->rd), 0);
+}
+
+// REL_DATA or REL_TEXT if an LI3 immediate is the address of a global, a
+// string literal or a function, else -1
+static int imm_reloc(JCC *vm, long long imm, long long *addend) {
+    unsigned long long data = (unsigned long long)(imm - (long long)vm->data_seg);
+    unsigned long long text = (unsigned long long)(imm - (long long)vm->text_seg);
+    if (data <= (unsigned long long)(vm->data_ptr - vm->data_seg)) {
+        *addend = (long long)data;
+        return REL_DATA;
+    }
+    if (text < (unsigned long long)vm->insn_text_size * 8 && text % 8 == 0) {
+        *addend = (long long)(text / 8);
+        return REL_TEXT;
+    }
+    return -1;
+}
+
+static void gen_li(JCC *vm, JitBuf *b, int dst, long long imm) {
+    long long addend;
+    int kind = imm_reloc(vm, imm, &addend);
+    if (kind < 0)
+        mov_imm(b, dst, imm);
+    else
+        mov_addr(b, dst, kind, addend);
+}
+
+// Call the function at callee through jit_call()
+static void gen_vm_call(JitBuf *b, VMInsn *insn, VMInsn *callee) {
+    spill(b);
+    set_pc(b, insn->text_off);
+    mov_rr(b, RDI, HVM);
+    mov_addr(b, RSI, REL_TEXT, callee->text_off);
+    call_helper(b, HELPER_jit_call);
+    x_rr(b, 0, 0, 0x85, RAX, RAX);
+    fault_if(b, CC_NE, NULL, 0);
+    reload(b);
+}
+
+// Translate one record
+static void gen_insn(JCC *vm, JitBuf *b, VMInsn *insn) {
+    int rd = insn->rd, rs1 = insn->rs1, rs2 = insn->rs2;
+    long long imm = insn->imm;
+
+    // The loop evaluates these only "if (RD != REG_ZERO)", so a discarded
+    // result skips the whole instruction (including LDR's load)
+    switch (vm_superop_base(insn->op)) {
+        case ADD3: case SUB3: case MUL3: case AND3: case OR3: case XOR3:
+        case SHL3: case SHR3: case SEQ3: case SNE3: case SLT3: case SGE3:
+        case SGT3: case SLE3: case LI3: case MOV3: case NEG3: case NOT3:
+        case BNOT3: case ADDI3: case SUBI3: case MULI3: case ANDI3: case ORI3:
+        case XORI3: case SHLI3: case SHRI3: case SLTI3: case LEA3:
+        case LDR_B: case LDR_H: case LDR_W: case LDR_D: case F2I3: case FR2R:
+            if (rd == REG_ZERO)
+                return;
+            break;
+        default:
+            break;
+    }
+
+    switch (vm_superop_base(insn->op)) {
+        // ========== Arithmetic and Bitwise ==========
+
+        case ADD3: gen_binary(b, insn, 0x01); break;
+        case SUB3: gen_binary(b, insn, 0x29); break;
+        case AND3: gen_binary(b, insn, 0x21); break;
+        case OR3:  gen_binary(b, insn, 0x09); break;
+        case XOR3: gen_binary(b, insn, 0x31); break;
+
+        case MUL3:
+            load_reg(b, RAX, rs1);
+            x_rr(b, 0, 1, 0x0FAF, RAX, use_reg(b, rs2, RCX));
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case DIV3:
+        case MOD3: {
+            int is_div = vm_superop_base(insn->op) == DIV3;
+            load_reg(b, RCX, rs2);
+            load_reg(b, RAX, rs1);
+            x_rr(b, 0, 1, 0x85, RCX, RCX);
+            fault_if(b, CC_E, insn, 1);
+            // LLONG_MIN / -1 is an overflow; LLONG_MIN % -1 is 0 (idiv
+            // would trap on both)
+            alu_imm(b, 7, RCX, -1);
+            emit(b, 0x75);  // jne .do_div
+            int skip = b->len;
+            emit(b, 0);
+            mov_imm(b, RDX, LLONG_MIN);
+            x_rr(b, 0, 1, 0x39, RDX, RAX);
+            if (is_div) {
+                fault_if(b, CC_E, insn, 1);
+            } else {
+                emit(b, 0x75);  // jne .do_div
+                int skip2 = b->len;
+                emit(b, 0);
+                x_rr(b, 0, 0, 0x31, RDX, RDX);
+                emit(b, 0xEB);  // jmp .store
+                int done = b->len;
+                emit(b, 0);
+                b->buf[skip2] = (unsigned char)(b->len - skip2 - 1);
+                b->buf[skip] = (unsigned char)(b->len - skip - 1);
+                emit(b, 0x48); emit(b, 0x99);  // cqo
+                x_rr(b, 0, 1, 0xF7, 7, RCX);  // idiv rcx
+                b->buf[done] = (unsigned char)(b->len - done - 1);
+                store_reg(b, rd, RDX, 1);
+                break;
+            }
+            b->buf[skip] = (unsigned char)(b->len - skip - 1);
+            emit(b, 0x48); emit(b, 0x99);  // cqo
+            x_rr(b, 0, 1, 0xF7, 7, RCX);  // idiv rcx
+            store_reg(b, rd, RAX, 1);
+            break;
+        }
+
+        case SHL3:
+        case SHR3:
+            load_reg(b, RCX, rs2);
+            load_reg(b, RAX, rs1);
+            x_rr(b, 0, 1, 0xD3, vm_superop_base(insn->op) == SHL3 ? 4 : 7,
+                 RAX);
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        // ========== Comparisons ==========
+
+        case SEQ3: gen_compare(b, insn, CC_E); break;
+        case SNE3: gen_compare(b, insn, CC_NE); break;
+        case SLT3: gen_compare(b, insn, CC_L); break;
+        case SGE3: gen_compare(b, insn, CC_GE); break;
+        case SGT3: gen_compare(b, insn, 0xF); break;
+        case SLE3: gen_compare(b, insn, 0xE); break;
+
+        // ========== Data Movement ==========
+
+        case LI3:
+            if (rd != REG_ZERO && host_reg(rd) >= 0) {
+                gen_li(vm, b, host_reg(rd), imm);
+            } else {
+                gen_li(vm, b, RAX, imm);
+                store_reg(b, rd, RAX, 1);
+            }
+            break;
+
+        case MOV3:
+            if (rd != REG_ZERO && host_reg(rd) >= 0) {
+                load_reg(b, host_reg(rd), rs1);
+            } else {
+                load_reg(b, RAX, rs1);
+                store_reg(b, rd, RAX, 1);
+            }
+            break;
+
+        case NEG3:
+        case BNOT3:
+            load_reg(b, RAX, rs1);
+            x_rr(b, 0, 1, 0xF7, vm_superop_base(insn->op) == NEG3 ? 3 : 2,
+                 RAX);
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case NOT3: {
+            int a = use_reg(b, rs1, RCX);
+            x_rr(b, 0, 1, 0x85, a, a);
+            setcc(b, CC_E, RAX);
+            zext_al(b);
+            store_reg(b, rd, RAX, 1);
+            break;
+        }
+
+        case ADDI3: case SUBI3: case ANDI3: case ORI3: case XORI3: {
+            static const int ext[] = {
+                [ADDI3 - ADDI3] = 0, [SUBI3 - ADDI3] = 5, [ANDI3 - ADDI3] = 4,
+                [ORI3 - ADDI3] = 1,  [XORI3 - ADDI3] = 6,
+            };
+            load_reg(b, RAX, rs1);
+            alu_imm(b, ext[vm_superop_base(insn->op) - ADDI3], RAX, imm);
+            store_reg(b, rd, RAX, 1);
+            break;
+        }
+
+        case MULI3:
+            load_reg(b, RAX, rs1);
+            if (fits32(imm)) {
+                x_rr(b, 0, 1, 0x69, RAX, RAX);  // imul rax, rax, imm32
+                emit32(b, imm);
+            } else {
+                mov_imm(b, RCX, imm);
+                x_rr(b, 0, 1, 0x0FAF, RAX, RCX);
+            }
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case SHLI3:
+        case SHRI3:
+            load_reg(b, RAX, rs1);
+            x_rr(b, 0, 1, 0xC1, vm_superop_base(insn->op) == SHLI3 ? 4 : 7,
+                 RAX);
+            emit(b, (int)(imm & 63));
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case SLTI3:
+            load_reg(b, RAX, rs1);
+            alu_imm(b, 7, RAX, imm);
+            setcc(b, CC_L, RAX);
+            zext_al(b);
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case LEA3:
+            x_rm(b, 0, 1, 0x8D, RAX, HBP, (int)(imm * 8), 0);
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        // ========== Branches ==========
+
+        case JMP:
+            gen_branch(b, (VMInsn *)imm - vm->insns, -1);
+            break;
+
+        case JZ3:
+        case JNZ3: {
+            int r = use_reg(b, rd, RAX);
+            x_rr(b, 0, 1, 0x85, r, r);
+            gen_branch(b, (VMInsn *)imm - vm->insns,
+                       vm_superop_base(insn->op) == JZ3 ? CC_E : CC_NE);
+            break;
+        }
+
+        case BEQ: case BNE: case BLT: case BGE: case BLTU: case BGEU: {
+            static const int cc[] = {CC_E, CC_NE, CC_L, CC_GE, CC_B, CC_AE};
+            int a = use_reg(b, rd, RAX);
+            x_rr(b, 0, 1, 0x39, use_reg(b, rs1, RCX), a);
+            gen_branch(b, (VMInsn *)imm - vm->insns,
+                       cc[vm_superop_base(insn->op) - BEQ]);
+            break;
+        }
+
+        case BEQI: case BNEI: case BLTI: case BGEI: case BLTUI: case BGEUI: {
+            static const int cc[] = {CC_E, CC_NE, CC_L, CC_GE, CC_B, CC_AE};
+            alu_imm(b, 7, use_reg(b, rd, RAX), insn->cmp_imm);
+            gen_branch(b, (VMInsn *)imm - vm->insns,
+                       cc[vm_superop_base(insn->op) - BEQI]);
+            break;
+        }
+
+        case JMPT: {
+            // Out of range falls through; otherwise continue at the native
+            // code of JMP record rd of the table
+            load_reg(b, RAX, rd);
+            alu_imm(b, 7, RAX, insn->cmp_imm);
+            gen_branch(b, insn + 1 - vm->insns, CC_AE);
+            emit(b, 0x48);  // lea rcx, [rip + table]
+            emit(b, 0x8D);
+            emit(b, 0x0D);
+            emit32(b, 0);
+            GROW(b->tables, b->ntables, b->tables_cap);
+            b->tables[b->ntables++] = (JitTable){
+                b->len - 4, (VMInsn *)imm - vm->insns, (int)insn->cmp_imm};
+            emit(b, 0x48);  // movsxd rax, dword [rcx + rax*4]
+            emit(b, 0x63);
+            emit(b, 0x04);
+            emit(b, 0x81);
+            x_rr(b, 0, 1, 0x01, RCX, RAX);  // add rax, rcx
+            x_rr(b, 0, 0, 0xFF, 4, RAX);    // jmp rax
+            break;
+        }
+
+        // ========== Calling Convention ==========
+
+        case ENT3: {
+            // Save bp, open the frame and copy the register arguments.
+            // A function without a frame (rs2) has nothing to do.
+            if (rs2)
+                break;
+            alu_imm(b, 5, HSP, 8);
+            mov_store(b, HSP, 0, HBP);
+            mov_rr(b, HBP, HSP);
+            alu_imm(b, 5, HSP, imm * 8);
+            int int_idx = 0, float_idx = 0;
+            for (int i = 0; i < rd; i++) {
+                int disp = -8 * (i + 1);
+                if (rs1 & (1 << i)) {
+                    mov_load(b, RAX, HVM, FREG_OFF(FREG_A0 + float_idx++));
+                    mov_store(b, HBP, disp, RAX);
+                } else {
+                    mov_store(b, HBP, disp,
+                              use_reg(b, REG_A0 + int_idx++, RAX));
+                }
+            }
+            break;
+        }
+
+        case LEV3:
+            // Pop the frame and hand the VM return address back in rax
+            mov_rr(b, HSP, HBP);
+            mov_load(b, HBP, HSP, 0);
+            mov_load(b, RAX, HSP, 8);
+            alu_imm(b, 0, HSP, 16);
+            alu_imm(b, 0, RSP, 8);
+            emit(b, 0xC3);
+            break;
+
+        case RET3:
+            // As LEV3, with only the return address to pop
+            mov_load(b, RAX, HSP, 0);
+            alu_imm(b, 0, HSP, 8);
+            alu_imm(b, 0, RSP, 8);
+            emit(b, 0xC3);
+            break;
+
+        case CALL: {
+            JITState *jit = vm->jit;
+            VMInsn *callee = (VMInsn *)imm;
+            long long target = callee - vm->insns;
+            if (!jit->end[target]) {
+                // The callee never gets past the interpreter
+                gen_vm_call(b, insn, callee);
+                break;
+            }
+            // A callee that is not compiled yet is called through its
+            // start[] slot, and interpreted while the slot is empty
+            int direct = jit->start[target] || target == b->func;
+            int interp = 0;
+            if (!direct) {
+                mov_addr(b, RAX, REL_START, target);
+                mov_load(b, RAX, RAX, 0);
+                x_rr(b, 0, 1, 0x85, RAX, RAX);
+                interp = jcc32(b, CC_E);
+            }
+            // Push the VM return address, then call the native code
+            alu_imm(b, 5, HSP, 8);
+            mov_addr(b, RDX, REL_TEXT, insn[1].text_off);
+            mov_store(b, HSP, 0, RDX);
+            if (direct) {
+                emit(b, 0xE8);
+                emit32(b, 0);
+                add_reloc(b, b->len - 4, REL_CALL, target);
+            } else {
+                x_rr(b, 0, 0, 0xFF, 2, RAX);  // call rax
+            }
+            alu_imm(b, 7, RAX, JIT_ERROR);
+            fault_if(b, CC_E, NULL, 0);
+            if (!direct) {
+                int done = jmp32(b);
+                patch32(b, interp, b->len - (interp + 4));
+                gen_vm_call(b, insn, callee);
+                patch32(b, done, b->len - (done + 4));
+            }
+            break;
+        }
+
+        case CALLI:
+            spill(b);
+            mov_load(b, RSI, HVM, REG_OFF(rd));
+            set_pc(b, insn->text_off);
+            mov_rr(b, RDI, HVM);
+            call_helper(b, HELPER_jit_call);
+            x_rr(b, 0, 0, 0x85, RAX, RAX);
+            fault_if(b, CC_NE, NULL, 0);
+            reload(b);
+            break;
+
+        case ADJ:
+            alu_imm(b, 0, HSP, imm * 8);
+            break;
+
+        case PSH3: {
+            int r = use_reg(b, rd, RAX);
+            alu_imm(b, 5, HSP, 8);
+            mov_store(b, HSP, 0, r);
+            break;
+        }
+
+        case POP3:
+            mov_load(b, RAX, HSP, 0);
+            alu_imm(b, 0, HSP, 8);
+            store_reg(b, rd, RAX, 0);
+            break;
+
+        // ========== Loads and Stores ==========
+
+        case LDR_B: case LDR_H: case LDR_W: case LDR_D: {
+            static const int op[] = {0x0FBE, 0x0FBF, 0x63, 0x8B};
+            int a = use_reg(b, rs1, RAX);
+            x_rm(b, 0, 1, op[vm_superop_base(insn->op) - LDR_B], RAX, a, 0, 0);
+            store_reg(b, rd, RAX, 1);
+            break;
+        }
+
+        case STR_B: case STR_H: case STR_W: case STR_D: {
+            int size = vm_superop_base(insn->op) - STR_B;
+            int a = use_reg(b, rs1, RAX);
+            int v = use_reg(b, rd, RCX);
+            x_rm(b, size == 1 ? 0x66 : 0, size == 3, size == 0 ? 0x88 : 0x89,
+                 v, a, 0, size == 0);
+            break;
+        }
+
+        case BCPY: {
+            // Unrolled through RDX: 8-byte moves, then a 4/2/1-byte tail
+            if (imm > JIT_BCPY_INLINE) {
+                gen_call_op(b, insn, HELPER_jit_op_BCPY);
+                break;
+            }
+            int d = use_reg(b, rd, RAX);
+            int s = use_reg(b, rs1, RCX);
+            int off = 0;
+            for (; off + 8 <= imm; off += 8) {
+                mov_load(b, RDX, s, off);
+                mov_store(b, d, off, RDX);
+            }
+            if (imm - off >= 4) {
+                x_rm(b, 0, 0, 0x8B, RDX, s, off, 0);
+                x_rm(b, 0, 0, 0x89, RDX, d, off, 0);
+                off += 4;
+            }
+            if (imm - off >= 2) {
+                x_rm(b, 0x66, 0, 0x8B, RDX, s, off, 0);
+                x_rm(b, 0x66, 0, 0x89, RDX, d, off, 0);
+                off += 2;
+            }
+            if (imm - off >= 1) {
+                x_rm(b, 0, 0, 0x8A, RDX, s, off, 1);
+                x_rm(b, 0, 0, 0x88, RDX, d, off, 1);
+            }
+            break;
+        }
+
+        case FLDR:
+            mov_load(b, RAX, use_reg(b, rs1, RAX), 0);
+            mov_store(b, HVM, FREG_OFF(rd), RAX);
+            break;
+
+        case FLI:
+            mov_imm(b, RAX, imm);
+            mov_store(b, HVM, FREG_OFF(rd), RAX);
+            break;
+
+        case FSTR:
+            mov_load(b, RCX, HVM, FREG_OFF(rd));
+            mov_store(b, use_reg(b, rs1, RAX), 0, RCX);
+            break;
+
+        // ========== Floating Point ==========
+
+        case FADD3: gen_farith(b, insn, 0x0F58); break;
+        case FSUB3: gen_farith(b, insn, 0x0F5C); break;
+        case FMUL3: gen_farith(b, insn, 0x0F59); break;
+
+        case FDIV3:
+            // Fault if the divisor compares equal to 0.0 (NaN does not)
+            x_rm(b, 0xF2, 0, 0x0F10, 1, HVM, FREG_OFF(rs2), 0);
+            x_rr(b, 0x66, 0, 0x0F57, 2, 2);  // xorpd xmm2, xmm2
+            x_rr(b, 0x66, 0, 0x0F2E, 1, 2);  // ucomisd xmm1, xmm2
+            emit(b, 0x7A);                   // jp .ok
+            emit(b, 6);
+            fault_if(b, CC_E, insn, 1);
+            x_rm(b, 0xF2, 0, 0x0F10, 0, HVM, FREG_OFF(rs1), 0);
+            x_rr(b, 0xF2, 0, 0x0F5E, 0, 1);  // divsd xmm0, xmm1
+            x_rm(b, 0xF2, 0, 0x0F11, 0, HVM, FREG_OFF(rd), 0);
+            break;
+
+        case FNEG3:
+            mov_load(b, RAX, HVM, FREG_OFF(rs1));
+            x_rr(b, 0, 1, 0x0FBA, 7, RAX);  // btc rax, 63
+            emit(b, 63);
+            mov_store(b, HVM, FREG_OFF(rd), RAX);
+            break;
+
+        case FEQ3: gen_fcompare(b, insn, 0, CC_E); break;
+        case FNE3: gen_fcompare(b, insn, 0, CC_NE); break;
+        case FLT3: gen_fcompare(b, insn, 1, CC_A); break;
+        case FLE3: gen_fcompare(b, insn, 1, CC_AE); break;
+        case FGT3: gen_fcompare(b, insn, 0, CC_A); break;
+        case FGE3: gen_fcompare(b, insn, 0, CC_AE); break;
+
+        case I2F3:
+            x_rr(b, 0xF2, 1, 0x0F2A, 0, use_reg(b, rs1, RAX));  // cvtsi2sd
+            x_rm(b, 0xF2, 0, 0x0F11, 0, HVM, FREG_OFF(rd), 0);
+            break;
+
+        case F2I3:
+            x_rm(b, 0xF2, 1, 0x0F2C, RAX, HVM, FREG_OFF(rs1), 0);  // cvttsd2si
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case FR2R:
+            mov_load(b, RAX, HVM, FREG_OFF(rs1));
+            store_reg(b, rd, RAX, 1);
+            break;
+
+        case R2FR:
+            mov_store(b, HVM, FREG_OFF(rd), use_reg(b, rs1, RAX));
+            break;
+
+        // ========== Type Conversion ==========
+
+        case SX1: case SX2: case SX4: case ZX1: case ZX2: case ZX4: {
+            static const int op[] = {0x0FBE, 0x0FBF, 0x63, 0x0FB6, 0x0FB7,
+                                     0x8B};
+            int k = vm_superop_base(insn->op) - SX1;
+            int a = use_reg(b, rs1, RAX);
+            // Sign extensions are 64-bit; zero extensions write a 32-bit
+            // register, which clears the upper half
+            enc_op(b, 0, k < 3, op[k], RAX, a, k == 3);
+            emit(b, 0xC0 | (a & 7));
+            store_reg(b, rd, RAX, 0);
+            break;
+        }
+
+        // ========== Out-of-line Opcodes ==========
+
+        case MALC:  gen_call_op(b, insn, HELPER_op_MALC_fn);  break;
+        case MFRE:  gen_call_op(b, insn, HELPER_op_MFRE_fn);  break;
+        case REALC: gen_call_op(b, insn, HELPER_op_REALC_fn); break;
+        case CALC:  gen_call_op(b, insn, HELPER_op_CALC_fn);  break;
+
+        case CALLF:
+            if (!gen_callf(vm, b, insn))
+                gen_call_op(b, insn, HELPER_op_CALLF_fn);
+            break;
+
+        // Pointer checks only run in the checked loops; legacy
+        // instrumentation opcodes are stubs
+        default:
+            break;
+    }
+}
+
+// Translate the function at records [start, end) and resolve its branches.
+// Addresses, calls and faults are left to jit_relocate(). b->label[] gives
+// the offset of every record.
+static void jit_function(JCC *vm, JitBuf *b, long long start, long long end) {
+    b->label = realloc(b->label, sizeof(int) * (end - start));
+    b->njumps = b->nfaults = b->ntables = 0;
+
+    // Keep the host stack 16-byte aligned for calls into C
+    alu_imm(b, 5, RSP, 8);
+    for (long long i = start; i < end; i++) {
+        b->label[i - start] = b->len;
+        gen_insn(vm, b, &vm->insns[i]);
+    }
+
+    for (int i = 0; i < b->njumps; i++) {
+        JitFixup *f = &b->jumps[i];
+        patch32(b, f->at, b->label[f->target - start] - (f->at + 4));
+    }
+
+    // Fault stubs: report, then leave through the shared error tail
+    for (int i = 0; i < b->nfaults; i++) {
+        JitFault *f = &b->faults[i];
+        if (!f->insn) {
+            // The callee or helper already left vm->pc at the fault
+            add_reloc(b, f->at, REL_TAIL, 0);
+            continue;
+        }
+        patch32(b, f->at, b->len - (f->at + 4));
+        if (f->spill)
+            spill(b);
+        mov_rr(b, RDI, HVM);
+        mov_addr(b, RSI, REL_INSN, f->insn - vm->insns);
+        call_helper(b, HELPER_jit_fault);
+        add_reloc(b, jmp32(b), REL_TAIL, 0);
+    }
+
+    // Jump tables: offsets of the JMP records' code from the table
+    for (int i = 0; i < b->ntables; i++) {
+        JitTable *t = &b->tables[i];
+        int table = b->len;
+        patch32(b, t->at, table - (t->at + 4));
+        for (int k = 0; k < t->count; k++)
+            emit32(b, b->label[t->first + k - start] - table);
+    }
+}
+
+// Shared code at the start of the mapping:
+//
+//   long long enter(JCC *vm, void *code)
+//       Save the host callee-saved registers, load the VM state, run code
+//       (the native code of any record) and publish the VM state again
+//       unless it failed. code is reached through a thunk that sets up the
+//       frame a native function has after its first instruction.
+//
+//   error tail
+//       Return JIT_ERROR from a native function.
+static int gen_stub(JitBuf *b) {
+    static const int saved[] = {RBX, RBP, R12, R13, R14, R15};
+    for (int i = 0; i < 6; i++) {
+        if (saved[i] >= 8)
+            emit(b, 0x41);
+        emit(b, 0x50 + (saved[i] & 7));
+    }
+    alu_imm(b, 5, RSP, 8);
+    mov_rr(b, HVM, RDI);
+    mov_rr(b, RAX, RSI);
+    reload(b);
+    emit(b, 0xE8);  // call .thunk
+    emit32(b, 0);
+    int thunk = b->len - 4;
+    alu_imm(b, 7, RAX, JIT_ERROR);
+    emit(b, 0x74);  // je .out
+    int skip = b->len;
+    emit(b, 0);
+    spill(b);
+    b->buf[skip] = (unsigned char)(b->len - skip - 1);
+    alu_imm(b, 0, RSP, 8);
+    for (int i = 5; i >= 0; i--) {
+        if (saved[i] >= 8)
+            emit(b, 0x41);
+        emit(b, 0x58 + (saved[i] & 7));
+    }
+    emit(b, 0xC3);
+
+    // .thunk: sub rsp, 8; jmp rax
+    patch32(b, thunk, b->len - (thunk + 4));
+    alu_imm(b, 5, RSP, 8);
+    x_rr(b, 0, 0, 0xFF, 4, RAX);
+
+    int tail = b->len;
+    mov_imm(b, RAX, JIT_ERROR);
+    alu_imm(b, 0, RSP, 8);
+    emit(b, 0xC3);
+    return tail;
+}
+
+// Append b to the code mapping. Only the pages being written are made
+// writable, and only while they are.
+static int jit_install(JITState *jit, JitBuf *b) {
+    if (jit->used + b->len > jit->size)
+        return -1;
+    size_t from = jit->used & ~(size_t)4095;
+    size_t to = (jit->used + b->len + 4095) & ~(size_t)4095;
+    if (mprotect(jit->code + from, to - from, PROT_READ | PROT_WRITE) != 0)
+        return -1;
+    memcpy(jit->code + jit->used, b->buf, b->len);
+    mprotect(jit->code + from, to - from, PROT_READ | PROT_EXEC);
+    jit->used = (jit->used + b->len + 15) & ~(size_t)15;
+    return 0;
+}
+
+// Fill in the addresses of b for the code mapping at offset b->base
+static void jit_relocate(JCC *vm, JitBuf *b) {
+    JITState *jit = vm->jit;
+    unsigned char *code = jit->code + b->base;
+    for (int i = 0; i < b->nrelocs; i++) {
+        JitReloc *r = &b->relocs[i];
+        void *value = NULL;
+        switch (r->kind) {
+            case REL_TEXT: value = vm->text_seg + r->addend; break;
+            case REL_DATA: value = vm->data_seg + r->addend; break;
+            case REL_INSN: value = &vm->insns[r->addend]; break;
+            case REL_START: value = &jit->start[r->addend]; break;
+            case REL_HELPER: value = jit_helpers[r->addend]; break;
+            case REL_FFI:
+                value = vm->compiler.ffi_table[r->addend].func_ptr;
+                break;
+            case REL_TAIL: {
+                unsigned char *tail = jit->code + jit->error_tail;
+                patch32(b, r->at, (int)(tail - (code + r->at + 4)));
+                continue;
+            }
+            case REL_CALL: {
+                // Direct calls go to functions compiled before this one, or
+                // to itself
+                unsigned char *target =
+                    r->addend == b->func ? code : jit->start[r->addend];
+                patch32(b, r->at, (int)(target - (code + r->at + 4)));
+                continue;
+            }
+        }
+        memcpy(b->buf + r->at, &value, 8);
+    }
+}
+
+// ========== Code Cache ==========
+//
+// With vm->jit_cache_dir set (--jit-cache), tier 2 code is also written to
+// a file per function, and later runs install it from there instead of
+// translating the function again. The file is named after a hash of the
+// function's key: the code generator (JIT_CACHE_VERSION, the opcode table
+// and the layout of the structures native code reads), vm->flags, and the
+// function's records
+// with every address made relative (targets as record indices, LI3
+// addresses as offsets), together with what else decides its code (how
+// each call is made, which foreign functions resolved). The key is stored
+// in the file too, so a hash collision is a miss.
+//
+//   Magic: JIT_CACHE_MAGIC (8 bytes)
+//   Counts: key words, code bytes, labels, relocations (4 bytes each)
+//   Key, code (relocations left zero), labels, relocations
+//
+// A hit is mapped and checked, then relocated like freshly translated code
+// (see jit_relocate). Hits refresh the file's modification time, and once
+// the directory holds more than vm->jit_cache_limit bytes the least
+// recently used files are removed.
+
+#define JIT_CACHE_MAGIC "JCCJIT1\0"
+
+// Bump whenever tier 2 emits different code for the same records
+#define JIT_CACHE_VERSION 1
+
+typedef struct {
+    long long *words;
+    int len, cap;
+} JitKey;
+
+static void key_push(JitKey *k, long long word) {
+    GROW(k->words, k->len, k->cap);
+    k->words[k->len++] = word;
+}
+
+static JitKey cache_key(JCC *vm, long long f) {
+    JITState *jit = vm->jit;
+    JitKey k = {0};
+    // Cached code only matches a code generator emitting the same code
+    key_push(&k, JIT_CACHE_VERSION);
+    key_push(&k, (long long)opcode_table_hash());
+    key_push(&k, sizeof(JCC));
+    key_push(&k, sizeof(VMInsn));
+    key_push(&k, offsetof(JCC, sp) | offsetof(JCC, bp) << 16 |
+                     (long long)offsetof(JCC, pc) << 32);
+    key_push(&k, offsetof(JCC, regs) | offsetof(JCC, fregs) << 16);
+    key_push(&k, vm->flags);
+    key_push(&k, f);
+    key_push(&k, jit->end[f] - f);
+    key_push(&k, vm->insns[f].text_off);
+
+    for (long long i = f; i < jit->end[f]; i++) {
+        VMInsn *insn = &vm->insns[i];
+        int op = vm_superop_base(insn->op);
+        long long imm = insn->imm, addend, tag = 0;
+        int kind;
+        if (vm_target_operand(op)) {
+            long long t = (VMInsn *)imm - vm->insns;
+            imm = t;
+            tag = 1;
+            if (op == CALL)
+                tag |= (jit->end[t] != 0) << 1 |
+                       (jit->start[t] || t == f) << 2;
+        } else if (op == LI3 && (kind = imm_reloc(vm, imm, &addend)) >= 0) {
+            tag = 8 + kind;
+            imm = addend;
+        }
+        key_push(&k, insn->op | insn->rd << 8 | insn->rs1 << 16 |
+                         (long long)insn->rs2 << 24 |
+                         (long long)(insn->text_off - vm->insns[f].text_off)
+                             << 32);
+        key_push(&k, imm);
+        key_push(&k, insn->cmp_imm);
+        key_push(&k, tag);
+        if (op == CALLF) {
+            long long *pc = vm->text_seg + insn->text_off;
+            int resolved = pc[1] >= 0 && pc[1] < vm->compiler.ffi_count &&
+                           vm->compiler.ffi_table[pc[1]].func_ptr;
+            key_push(&k, pc[1]);
+            key_push(&k, pc[2]);
+            key_push(&k, pc[3]);
+            key_push(&k, resolved);
+        }
+    }
+    return k;
+}
+
+static char *cache_path(JCC *vm, JitKey *k) {
+    unsigned long long hash = 14695981039346656037ULL;
+    const unsigned char *p = (const unsigned char *)k->words;
+    for (size_t i = 0; i < k->len * sizeof(long long); i++)
+        hash = (hash ^ p[i]) * 1099511628211ULL;
+    return format("%s/%016llx.jit", vm->jit_cache_dir, hash);
+}
+
+// Can relocation r be applied to the code of function f?
+static int reloc_valid(JCC *vm, JitReloc *r, long long f, int code_len) {
+    JITState *jit = vm->jit;
+    int width = r->kind == REL_TAIL || r->kind == REL_CALL ? 4 : 8;
+    if (r->at < 0 || r->at > code_len - width || r->addend < 0)
+        return 0;
+    switch (r->kind) {
+        case REL_TEXT: return r->addend < vm->insn_text_size;
+        case REL_DATA: return r->addend <= vm->data_ptr - vm->data_seg;
+        case REL_INSN:
+        case REL_START: return r->addend < vm->insn_count;
+        case REL_HELPER:
+            return r->addend < (long long)(sizeof(jit_helpers) /
+                                           sizeof(jit_helpers[0]));
+        case REL_FFI:
+            return r->addend < vm->compiler.ffi_count &&
+                   vm->compiler.ffi_table[r->addend].func_ptr;
+        case REL_TAIL: return 1;
+        case REL_CALL:
+            return r->addend == f ||
+                   (r->addend < vm->insn_count && jit->start[r->addend]);
+        default: return 0;
+    }
+}
+
+// Read the cached code of b->func into b. Returns 0 on a hit.
+static int cache_load(JCC *vm, JitBuf *b, JitKey *k) {
+    long long nlabels = vm->jit->end[b->func] - b->func;
+    char *path = cache_path(vm, k);
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < 24) {
+        if (fd >= 0)
+            close(fd);
+        free(path);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    unsigned char *file = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED) {
+        free(path);
+        return -1;
+    }
+
+    int counts[4];
+    memcpy(counts, file + 8, sizeof(counts));
+    size_t key_size = k->len * sizeof(long long);
+    size_t need = 24 + key_size + (size_t)counts[1] +
+                  (size_t)nlabels * sizeof(int) +
+                  (size_t)counts[3] * sizeof(JitReloc);
+    int ok = memcmp(file, JIT_CACHE_MAGIC, 8) == 0 && counts[0] == k->len &&
+             counts[1] > 0 && counts[2] == nlabels && counts[3] >= 0 &&
+             need == size && memcmp(file + 24, k->words, key_size) == 0;
+    if (ok) {
+        const unsigned char *at = file + 24 + key_size;
+        b->len = b->cap = counts[1];
+        b->nrelocs = b->relocs_cap = counts[3];
+        b->buf = malloc(b->len);
+        b->label = malloc(nlabels * sizeof(int));
+        b->relocs = malloc((b->nrelocs ? b->nrelocs : 1) * sizeof(JitReloc));
+        ok = b->buf && b->label && b->relocs;
+        if (ok) {
+            memcpy(b->buf, at, b->len);
+            at += b->len;
+            memcpy(b->label, at, nlabels * sizeof(int));
+            at += nlabels * sizeof(int);
+            memcpy(b->relocs, at, b->nrelocs * sizeof(JitReloc));
+        }
+        for (int i = 0; ok && i < b->nrelocs; i++)
+            ok = reloc_valid(vm, &b->relocs[i], b->func, b->len);
+        for (long long i = 0; ok && i < nlabels; i++)
+            ok = b->label[i] >= 0 && b->label[i] < b->len;
+    }
+    munmap(file, size);
+    if (ok)
+        utimes(path, NULL);  // Recently used
+    free(path);
+    if (!ok) {
+        free(b->buf);
+        free(b->label);
+        free(b->relocs);
+        *b = (JitBuf){.base = b->base, .func = b->func};
+        return -1;
+    }
+    return 0;
+}
+
+typedef struct {
+    char *path;
+    off_t size;
+    time_t used;
+} CacheFile;
+
+static int cache_file_cmp(const void *a, const void *b) {
+    time_t x = ((const CacheFile *)a)->used, y = ((const CacheFile *)b)->used;
+    return (x > y) - (x < y);
+}
+
+// Remove the least recently used files until the cache fits its limit
+static void cache_evict(JCC *vm) {
+    DIR *dir = opendir(vm->jit_cache_dir);
+    if (!dir)
+        return;
+    CacheFile *files = NULL;
+    int n = 0, cap = 0;
+    long long total = 0;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        size_t len = strlen(entry->d_name);
+        if (len < 4 || strcmp(entry->d_name + len - 4, ".jit") != 0)
+            continue;
+        char *path = format("%s/%s", vm->jit_cache_dir, entry->d_name);
+        struct stat st;
+        if (stat(path, &st) != 0) {
+            free(path);
+            continue;
+        }
+        GROW(files, n, cap);
+        files[n++] = (CacheFile){path, st.st_size, st.st_mtime};
+        total += st.st_size;
+    }
+    closedir(dir);
+
+    if (total > vm->jit_cache_limit) {
+        qsort(files, n, sizeof(CacheFile), cache_file_cmp);
+        for (int i = 0; i < n && total > vm->jit_cache_limit; i++) {
+            if (unlink(files[i].path) == 0) {
+                total -= files[i].size;
+                vm->jit_cache_evictions++;
+            }
+        }
+    }
+    for (int i = 0; i < n; i++)
+        free(files[i].path);
+    free(files);
+}
+
+// Write the code just translated for b->func (before relocation)
+static void cache_store(JCC *vm, JitBuf *b, JitKey *k) {
+    long long nlabels = vm->jit->end[b->func] - b->func;
+    mkdir(vm->jit_cache_dir, 0755);
+    char *path = cache_path(vm, k);
+    // Written under a temporary name, so concurrent runs never see half a
+    // file
+    char *tmp = format("%s.%d", path, (int)getpid());
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        free(tmp);
+        free(path);
+        return;
+    }
+    int counts[4] = {k->len, b->len, (int)nlabels, b->nrelocs};
+    int ok = fwrite(JIT_CACHE_MAGIC, 1, 8, f) == 8 &&
+             fwrite(counts, sizeof(int), 4, f) == 4 &&
+             fwrite(k->words, sizeof(long long), k->len, f) == (size_t)k->len &&
+             fwrite(b->buf, 1, b->len, f) == (size_t)b->len &&
+             fwrite(b->label, sizeof(int), nlabels, f) == (size_t)nlabels &&
+             fwrite(b->relocs, sizeof(JitReloc), b->nrelocs, f) ==
+                 (size_t)b->nrelocs;
+    ok = fclose(f) == 0 && ok && rename(tmp, path) == 0;
+    if (!ok)
+        unlink(tmp);
+    free(tmp);
+    free(path);
+    if (ok)
+        cache_evict(vm);
+}
+
+// Compile the function whose first record is f, or only install its code
+// from the cache if cached_only is set
+static int jit_translate(JCC *vm, long long f, int cached_only) {
+    JITState *jit = vm->jit;
+    long long end = jit->end[f];
+    JitBuf b = {0};
+    b.base = (int)jit->used;
+    b.func = f;
+
+    JitKey key = {0};
+    int hit = 0;
+    if (vm->jit_cache_dir) {
+        key = cache_key(vm, f);
+        hit = cache_load(vm, &b, &key) == 0;
+    }
+    if (!hit && cached_only) {
+        free(key.words);
+        return -1;
+    }
+    if (hit) {
+        vm->jit_cache_hits++;
+    } else {
+        jit_function(vm, &b, f, end);
+        if (vm->jit_cache_dir) {
+            vm->jit_cache_misses++;
+            cache_store(vm, &b, &key);
+        }
+    }
+    free(key.words);
+
+    jit_relocate(vm, &b);
+    unsigned char *code = jit->code + b.base;
+    int ok = jit_install(jit, &b) == 0;
+    if (ok) {
+        for (long long i = f; i < end; i++)
+            jit->entry[i] = code + b.label[i - f];
+        jit->start[f] = code;
+        perf_code_load(vm, &vm->insns[f], "jit", code, b.len);
+    }
+    free(b.buf);
+    free(b.relocs);
+    free(b.label);
+    free(b.jumps);
+    free(b.faults);
+    free(b.tables);
+    return ok ? 0 : -1;
+}
+
+// ========== Stencil Tier ==========
+//
+// A stencil is the machine code of one opcode, compiled by stencils.py from
+// src/stencils/stencils.c with the same opcode bodies (vm_body.h) as the
+// unchecked dispatch loop. Stencil code keeps the VM state in memory and
+// passes sp and bp along: every stencil is a function
+//
+//     long long stencil(JCC *vm, long long *sp, long long *bp)
+//
+// that ends in a tail call to the next one, so a function's stencils can be
+// entered at any record and return what its LEV3 returns, like tier 2 code.
+// Copies are laid out in record order, and a copy that ends in a jump to
+// the next record loses the jump (Stencil.trim). Unless tier 2 is disabled,
+// function entries and loop headers get a JITCNT stencil in front that
+// counts down count[] and then calls jit_promote().
+
+#include "stencils.h"
+
+typedef long long StencilFn(JCC *vm, long long *sp, long long *bp);
+
+static long long jit_promote(JCC *vm, VMInsn *insn);
+
+// Addresses for HOLE_SYMBOL + k
+static void *const stencil_symbols[] = {
+#define X(NAME) (void *)NAME,
+    STENCIL_SYMBOLS_X
+#undef X
+};
+
+// Copy size bytes of the stencil s to buf, for insn, and fill in its holes.
+// addr is where buf goes in the mapping, code where the function starts;
+// label[] holds the offsets of the function's records from code.
+static void put_stencil(JCC *vm, const Stencil *s, int size, VMInsn *insn,
+                        unsigned char *buf, unsigned char *addr,
+                        unsigned char *code, const size_t *label) {
+    JITState *jit = vm->jit;
+    long long i = insn - vm->insns;
+    memcpy(buf, s->code, size);
+    for (int h = 0; h < s->nholes; h++) {
+        const StencilHole *hole = &s->holes[h];
+        if (hole->offset >= size)
+            continue;  // In the trimmed jump
+        long long v;
+        switch (hole->kind) {
+            case HOLE_CONTINUE: v = (long long)(addr + size); break;
+            case HOLE_TARGET: {
+                long long t = (VMInsn *)insn->imm - vm->insns;
+                v = (long long)(code + label[t - jit->func[i]]);
+                break;
+            }
+            case HOLE_RD: v = insn->rd; break;
+            case HOLE_RS1: v = insn->rs1; break;
+            case HOLE_RS2: v = insn->rs2; break;
+            case HOLE_IMM: v = insn->imm; break;
+            case HOLE_CMP_IMM: v = insn->cmp_imm; break;
+            case HOLE_PC: v = (long long)(vm->text_seg + insn->text_off); break;
+            case HOLE_CALLEE:
+                v = (long long)(vm->text_seg + ((VMInsn *)insn->imm)->text_off);
+                break;
+            case HOLE_COUNTER: v = (long long)&jit->count[i]; break;
+            case HOLE_INSN: v = (long long)insn; break;
+            case HOLE_DATA: v = (long long)stencil_data; break;
+            default:
+                v = (long long)stencil_symbols[hole->kind - HOLE_SYMBOL];
+                break;
+        }
+        v += hole->addend;
+        memcpy(buf + hole->offset, &v, sizeof(v));
+    }
+}
+
+// Compile the function whose first record is f from stencils
+static int jit_stencil(JCC *vm, long long f) {
+    JITState *jit = vm->jit;
+    long long end = jit->end[f];
+    const Stencil *prefix = &stencils[JITCNT];
+    int counted = vm->jit_tier >= 2;
+    int prefix_size = prefix->size - prefix->trim;
+    if (!jit->stencils)
+        return -1;
+
+    size_t *label = malloc(sizeof(size_t) * (end - f));
+    if (!label)
+        return -1;
+    size_t len = 0;
+    for (long long i = f; i < end; i++) {
+        const Stencil *s = &stencils[vm_superop_base(vm->insns[i].op)];
+        if (!s->code) {
+            free(label);
+            return -1;
+        }
+        label[i - f] = len;
+        if (counted && jit->point[i])
+            len += prefix_size;
+        len += s->size - (i + 1 < end ? s->trim : 0);
+    }
+
+    JitBuf b = {0};
+    b.buf = malloc(len);
+    b.len = (int)len;
+    unsigned char *code = jit->code + jit->used;
+    for (long long i = f; b.buf && i < end; i++) {
+        VMInsn *insn = &vm->insns[i];
+        const Stencil *s = &stencils[vm_superop_base(insn->op)];
+        size_t at = label[i - f];
+        if (counted && jit->point[i]) {
+            put_stencil(vm, prefix, prefix_size, insn, b.buf + at, code + at,
+                        code, label);
+            at += prefix_size;
+        }
+        put_stencil(vm, s, s->size - (i + 1 < end ? s->trim : 0), insn,
+                    b.buf + at, code + at, code, label);
+    }
+
+    int ok = b.buf && jit_install(jit, &b) == 0;
+    if (ok) {
+        for (long long i = f; i < end; i++) {
+            jit->stencil[i] = code + label[i - f];
+            if (jit->point[i]) {
+                int threshold = jit->point[i] == 1 ? vm->jit_threshold
+                                                   : vm->osr_threshold;
+                jit->count[i] = threshold > 0 ? (unsigned)threshold : 1;
+            }
+        }
+        perf_code_load(vm, &vm->insns[f], "stencils", code, len);
+    }
+    free(b.buf);
+    free(label);
+    return ok ? 0 : -1;
+}
+
+// Called by the JITCNT stencil in front of insn once it has counted down:
+// move the function on to tier 2 and continue there from insn. vm->sp and
+// vm->bp are current.
+static long long jit_promote(JCC *vm, VMInsn *insn) {
+    JITState *jit = vm->jit;
+    long long i = insn - vm->insns;
+    long long f = jit->func[i];
+    int ok = jit->start[f] || jit_translate(vm, f, 0) == 0;
+    // Once translated, the other counters hand over on their next visit;
+    // otherwise (out of code space) they stop
+    for (long long k = f; k < jit->end[f]; k++)
+        if (jit->point[k])
+            jit->count[k] = ok ? 1 : UINT_MAX;
+    if (ok)
+        return jit_enter(vm, insn);
+    return ((StencilFn *)jit->stencil[i])(vm, vm->sp, vm->bp);
+}
+
+int jit_init(JCC *vm) {
+    jit_free(vm);
+    long long n = vm->insn_count;
+    JITState *jit = calloc(1, sizeof(JITState));
+    if (!jit)
+        return -1;
+    jit->func = calloc(n + 1, sizeof(long long));
+    jit->end = calloc(n + 1, sizeof(long long));
+    jit->start = calloc(n + 1, sizeof(void *));
+    jit->entry = calloc(n + 1, sizeof(void *));
+    jit->stencil = calloc(n + 1, sizeof(void *));
+    jit->count = calloc(n + 1, sizeof(unsigned));
+    jit->point = calloc(n + 1, 1);
+    jit->size = JIT_CODE_SIZE;
+    jit->code = mmap(NULL, jit->size, PROT_READ | PROT_EXEC,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    vm->jit = jit;
+    if (jit->code == MAP_FAILED) {
+        jit->code = NULL;
+        jit_free(vm);
+        return -1;
+    }
+    if (!jit->func || !jit->end || !jit->start || !jit->entry ||
+        !jit->stencil || !jit->count || !jit->point) {
+        jit_free(vm);
+        return -1;
+    }
+
+    // Stencils are compiled against the structures of one build of jcc
+    jit->stencils = sizeof(VMInsn) == STENCIL_INSN_SIZE;
+#define X(FIELD, OFFSET) jit->stencils &= offsetof(JCC, FIELD) == OFFSET;
+    STENCIL_FIELDS_X
+#undef X
+    if (!jit->stencils)
+        fprintf(stderr, "warning: src/stencils.h does not match this build "
+                        "(run make stencils); --jit skips tier 1\n");
+
+    JitBuf b = {0};
+    jit->error_tail = gen_stub(&b);
+    int ok = jit_install(jit, &b) == 0;
+    if (ok)
+        perf_code_load(vm, NULL, "jcc_jit_enter", jit->code, b.len);
+    free(b.buf);
+    if (!ok) {
+        jit_free(vm);
+        return -1;
+    }
+
+    // Programs using setjmp/longjmp keep their frames in the interpreter:
+    // a longjmp cannot unwind native frames
+    int translatable = 1;
+    for (long long i = 0; i < n; i++) {
+        int op = vm_superop_base(vm->insns[i].op);
+        if (op == SETJMP || op == LONGJMP)
+            translatable = 0;
+    }
+
+    // Find functions, and mark the entries and loop headers of the ones
+    // that can be translated
+    for (long long i = 0; i < n;) {
+        long long j = i + 1;
+        while (j < n && vm_superop_base(vm->insns[j].op) != ENT3)
+            j++;
+        for (long long k = i; k < j; k++)
+            jit->func[k] = i;
+        if (translatable && vm_superop_base(vm->insns[i].op) == ENT3 &&
+            jit_supported(vm, i, j)) {
+            jit->end[i] = j;
+            jit->point[i] = 1;
+            for (long long k = i; k < j; k++) {
+                int op = vm_superop_base(vm->insns[k].op);
+                if (!vm_target_operand(op) || op == CALL)
+                    continue;
+                long long t = (VMInsn *)vm->insns[k].imm - vm->insns;
+                if (t <= k)
+                    jit->point[t] = 2;
+            }
+        }
+        i = j;
+    }
+    return 0;
+}
+
+int jit_counted(JCC *vm, VMInsn *insn) {
+    if (!vm->jit)
+        return 0;
+    long long i = insn - vm->insns;
+    return vm->jit->point[i] && vm->jit->end[vm->jit->func[i]];
+}
+
+int jit_hot(JCC *vm, VMInsn *insn) {
+    JITState *jit = vm->jit;
+    long long i = insn - vm->insns;
+    long long f = jit->func[i];
+    if (jit->start[f] || jit->stencil[f])
+        return 1;
+    if (!jit->end[f])
+        return -1;
+    unsigned threshold = (unsigned)(jit->point[i] == 1 ? vm->jit_threshold
+                                                       : vm->osr_threshold);
+    if (++jit->count[i] < threshold)
+        return 0;
+    // Code cached by an earlier run goes straight to tier 2
+    if (vm->jit_tier == 2 && jit_translate(vm, f, 1) == 0)
+        return 1;
+    if (jit_stencil(vm, f) != 0 && jit_translate(vm, f, 0) != 0) {
+        // Out of code space: the function stays interpreted
+        jit->end[f] = 0;
+        return -1;
+    }
+    return 1;
+}
+
+void *jit_entry(JCC *vm, VMInsn *insn) {
+    if (!vm->jit)
+        return NULL;
+    long long i = insn - vm->insns;
+    return vm->jit->entry[i] ? vm->jit->entry[i] : vm->jit->stencil[i];
+}
+
+long long jit_enter(JCC *vm, VMInsn *insn) {
+    long long i = insn - vm->insns;
+    if (!vm->jit->entry[i]) {
+        // Stencil code takes the VM state as arguments
+        StencilFn *fn = (StencilFn *)vm->jit->stencil[i];
+        return fn(vm, vm->sp, vm->bp);
+    }
+    long long (*enter)(JCC *, void *) =
+        (long long (*)(JCC *, void *))vm->jit->code;
+    return enter(vm, vm->jit->entry[i]);
+}
+
+void jit_free(JCC *vm) {
+    JITState *jit = vm->jit;
+    if (!jit)
+        return;
+    if (jit->code)
+        munmap(jit->code, jit->size);
+    free(jit->func);
+    free(jit->end);
+    free(jit->start);
+    free(jit->entry);
+    free(jit->stencil);
+    free(jit->count);
+    free(jit->point);
+    free(jit);
+    vm->jit = NULL;
+}
+
+#else
+
+// Native code generation targets x86-64 only; elsewhere --jit interprets
+
+int jit_init(JCC *vm) {
+    (void)vm;
+    return -1;
+}
+
+int jit_counted(JCC *vm, VMInsn *insn) {
+    (void)vm;
+    (void)insn;
+    return 0;
+}
+
+int jit_hot(JCC *vm, VMInsn *insn) {
+    (void)vm;
+    (void)insn;
+    return -1;
+}
+
+void *jit_entry(JCC *vm, VMInsn *insn) {
+    (void)vm;
+    (void)insn;
+    return NULL;
+}
+
+long long jit_enter(JCC *vm, VMInsn *insn) {
+    (void)vm;
+    (void)insn;
+    return JIT_ERROR;
+}
+
+void jit_free(JCC *vm) {
+    (void)vm;
+}
+
+#endif
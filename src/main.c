@@ -20,6 +20,7 @@
 #include "./internal.h"
 #include "jcc.h"
 #include <getopt.h>
+#include <limits.h>
 
 static void usage(const char *argv0, int exit_code) {
     printf("JCC: JIT C Compiler\n");
@@ -42,6 +43,8 @@ static void usage(const char *argv0, int exit_code) {
     printf("\t-X/--no-preprocess  Disable preprocessing step\n");
     printf("\t-S/--no-stdlib      Do not link standard library\n");
     printf("\t-o/--out <file>     Dump bytecode to <file> (no execution)\n");
+    printf("\t   --bundle         With -o, write a copy of jcc with the "
+           "bytecode appended\n");
     printf("\t-d/--disassemble    Disassemble bytecode to stdout\n");
     printf("\t-v/--verbose        Enable debug logging\n");
     printf("\t-g/--debug          Enable interactive debugger\n");
@@ -103,6 +106,38 @@ static void usage(const char *argv0, int exit_code) {
     printf("\t                             -O2: Constant folding + peephole\n");
     printf("\t                             -O3: All optimizations (including "
            "dead code elimination)\n");
+    printf("\t   --ngram-profile=FILE      Count executed opcode pairs and "
+           "triples into FILE\n");
+    printf("\t                             (input for superops.py)\n");
+    printf("\t   --jit                     Compile hot functions to native x86-64 "
+           "code\n");
+    printf("\t   --jit-threshold=N         Calls before a function is compiled "
+           "(default: %d)\n", JIT_CALL_THRESHOLD);
+    printf("\t   --osr-threshold=N         Loop iterations before the running "
+           "function is\n");
+    printf("\t                             compiled (default: %d)\n",
+           JIT_LOOP_THRESHOLD);
+    printf("\t   --jit-tier=N              Last tier hot code moves to: "
+           "1=stencils,\n");
+    printf("\t                             2=optimized native code "
+           "(default)\n");
+    printf("\t   --jit-cache=DIR           Keep native code in DIR for later "
+           "runs\n");
+    printf("\t   --jit-cache-size=SIZE     Size limit of the --jit-cache "
+           "directory\n");
+    printf("\t                             (e.g., 256MB, default: %lldMB)\n",
+           JIT_CACHE_LIMIT >> 20);
+    printf("\t   --jit-cache-stats         Report --jit-cache hits and misses "
+           "at exit\n");
+    printf("\nProfiling (Linux perf):\n");
+    printf("\t   --perf-map                Name --jit code in "
+           "/tmp/perf-<pid>.map\n");
+    printf("\t   --perf-jitdump            Write --jit code to "
+           "/tmp/jit-<pid>.dump (perf inject)\n");
+    printf("\t   --perf-trampolines        Call interpreted functions through "
+           "native\n");
+    printf("\t                             trampolines (name them with "
+           "--perf-map)\n");
     printf("\nExample:\n");
     printf("\t%s -o hello hello.c\n", argv0);
     printf("\t%s -I ./include -D DEBUG -o prog prog.c\n", argv0);
@@ -218,6 +253,61 @@ static size_t parse_size(const char *str, const char *flag_name) {
     return (size_t)(value * multiplier);
 }
 
+static void print_jit_cache_stats(JCC *vm) {
+    fprintf(stderr,
+            "JIT cache: %lld hits, %lld misses, %lld evicted (%s)\n",
+            vm->jit_cache_hits, vm->jit_cache_misses, vm->jit_cache_evictions,
+            vm->jit_cache_dir ? vm->jit_cache_dir : "disabled");
+}
+
+// PERF_* outputs named in a comma-separated list ("map,jitdump,trampolines")
+static int parse_perf(const char *list) {
+    int perf = 0;
+    while (*list) {
+        size_t len = strcspn(list, ",");
+        if (len == 3 && strncmp(list, "map", 3) == 0)
+            perf |= PERF_MAP;
+        else if (len == 7 && strncmp(list, "jitdump", 7) == 0)
+            perf |= PERF_JITDUMP;
+        else if (len == 11 && strncmp(list, "trampolines", 11) == 0)
+            perf |= PERF_TRAMPOLINES;
+        list += len + (list[len] == ',');
+    }
+    return perf;
+}
+
+// Executables written by --bundle are this binary with a program appended;
+// they run it and pass every argument through instead of parsing options.
+// JCC_JIT_CACHE names a --jit-cache directory for them, and JCC_PERF the
+// profiler outputs to write (like --perf-map, --perf-jitdump and
+// --perf-trampolines).
+static int run_embedded(int argc, const char *argv[], int *exit_code) {
+    // Most runs are plain jcc: only set up a VM when there is a program
+    if (!cc_has_executable_image(NULL))
+        return 0;
+
+    JCC vm;
+    cc_init(&vm, 0);
+    cc_load_stdlib(&vm);
+    int loaded = cc_load_executable(&vm, NULL);
+    if (loaded == 0) {
+#if defined(__x86_64__) && !defined(_WIN32)
+        vm.flags |= JCC_JIT;
+#endif
+        const char *cache = getenv("JCC_JIT_CACHE");
+        if (cache && *cache)
+            vm.jit_cache_dir = strdup(cache);
+        const char *perf = getenv("JCC_PERF");
+        if (perf)
+            vm.perf = parse_perf(perf);
+        *exit_code = cc_run(&vm, argc, (char **)argv);
+    } else if (loaded < 0) {
+        *exit_code = 1;
+    }
+    cc_destroy(&vm);
+    return loaded <= 0;
+}
+
 int main(int argc, const char *argv[]) {
     int exit_code = 0;
     const char **input_files = NULL;
@@ -252,6 +342,18 @@ int main(int argc, const char *argv[]) {
     size_t embed_limit = 0;     // --embed-limit (0 = use default)
     int embed_hard_error = 0;   // --embed-hard-limit
     int opt_level = 0; // -O0/-O1/-O2/-O3 (default: 0 = no optimization)
+    char *ngram_profile = NULL; // --ngram-profile
+    int jit_threshold = -1;     // --jit-threshold (-1 = use default)
+    int osr_threshold = -1;     // --osr-threshold (-1 = use default)
+    int jit_tier = -1;          // --jit-tier (-1 = use default)
+    int bundle = 0;             // --bundle
+    char *jit_cache = NULL;     // --jit-cache
+    size_t jit_cache_size = 0;  // --jit-cache-size (0 = use default)
+    int jit_cache_stats = 0;    // --jit-cache-stats
+    int perf = 0;               // --perf-map/--perf-jitdump/--perf-trampolines
+
+    if (run_embedded(argc, argv, &exit_code))
+        return exit_code;
 
     if (argc <= 1)
         usage(argv[0], 1);
@@ -302,6 +404,18 @@ int main(int argc, const char *argv[]) {
         {"embed-limit", required_argument, 0, 1014},
         {"embed-hard-limit", no_argument, 0, 1015},
         {"optimize", optional_argument, 0, 1016},
+        {"ngram-profile", required_argument, 0, 1017},
+        {"jit", no_argument, 0, 1018},
+        {"jit-threshold", required_argument, 0, 1019},
+        {"osr-threshold", required_argument, 0, 1020},
+        {"jit-tier", required_argument, 0, 1021},
+        {"bundle", no_argument, 0, 1022},
+        {"jit-cache", required_argument, 0, 1023},
+        {"jit-cache-size", required_argument, 0, 1024},
+        {"jit-cache-stats", no_argument, 0, 1025},
+        {"perf-map", no_argument, 0, 1026},
+        {"perf-jitdump", no_argument, 0, 1027},
+        {"perf-trampolines", no_argument, 0, 1028},
         {0, 0, 0, 0}};
 
     const char *optstring = "0123haI:D:U:o:dvgbftzOskpliPEMXSjFTVC";
@@ -508,6 +622,57 @@ int main(int argc, const char *argv[]) {
                 usage(argv[0], 1);
             }
             break;
+        case 1017: // --ngram-profile
+            free(ngram_profile);
+            ngram_profile = strdup(optarg);
+            break;
+        case 1018: // --jit
+            flags |= JCC_JIT;
+            break;
+        case 1019: // --jit-threshold
+        case 1020: { // --osr-threshold
+            char *end;
+            long n = strtol(optarg, &end, 10);
+            if (*optarg == '\0' || *end != '\0' || n < 0 || n > INT_MAX) {
+                fprintf(stderr, "error: --%s must be a non-negative integer\n",
+                        opt == 1019 ? "jit-threshold" : "osr-threshold");
+                usage(argv[0], 1);
+            }
+            if (opt == 1019)
+                jit_threshold = (int)n;
+            else
+                osr_threshold = (int)n;
+            break;
+        }
+        case 1021: // --jit-tier
+            if (strcmp(optarg, "1") != 0 && strcmp(optarg, "2") != 0) {
+                fprintf(stderr, "error: --jit-tier must be 1 or 2\n");
+                usage(argv[0], 1);
+            }
+            jit_tier = atoi(optarg);
+            break;
+        case 1022: // --bundle
+            bundle = 1;
+            break;
+        case 1023: // --jit-cache
+            free(jit_cache);
+            jit_cache = strdup(optarg);
+            break;
+        case 1024: // --jit-cache-size
+            jit_cache_size = parse_size(optarg, "--jit-cache-size");
+            break;
+        case 1025: // --jit-cache-stats
+            jit_cache_stats = 1;
+            break;
+        case 1026: // --perf-map
+            perf |= PERF_MAP;
+            break;
+        case 1027: // --perf-jitdump
+            perf |= PERF_JITDUMP;
+            break;
+        case 1028: // --perf-trampolines
+            perf |= PERF_TRAMPOLINES;
+            break;
         case '?':
             if (optopt)
                 fprintf(stderr, "error: option -%c requires an argument\n",
@@ -542,6 +707,10 @@ int main(int argc, const char *argv[]) {
         fprintf(stderr, "error: no input files\n");
         usage((char *)argv[0], 1);
     }
+    if (bundle && !out_file) {
+        fprintf(stderr, "error: --bundle requires -o <file>\n");
+        usage((char *)argv[0], 1);
+    }
 
     // If the only input file is "-", read stdin into a temporary file and
     // replace it
@@ -575,6 +744,16 @@ int main(int argc, const char *argv[]) {
 
     JCC vm;
     cc_init(&vm, flags);
+    if (jit_threshold >= 0)
+        vm.jit_threshold = jit_threshold;
+    if (osr_threshold >= 0)
+        vm.osr_threshold = osr_threshold;
+    if (jit_tier >= 0)
+        vm.jit_tier = jit_tier;
+    vm.jit_cache_dir = jit_cache;  // Freed by cc_destroy()
+    if (jit_cache_size > 0)
+        vm.jit_cache_limit = (long long)jit_cache_size;
+    vm.perf = perf;
 
     if (verbose)
         vm.debug_vm = 1;
@@ -585,7 +764,10 @@ int main(int argc, const char *argv[]) {
         const char *input_file = input_files[0];
         size_t len = strlen(input_file);
         if (len > 4 && strcmp(input_file + len - 4, ".jbc") == 0) {
-            // Load bytecode file
+            // Load bytecode file (foreign functions resolve against the
+            // standard library)
+            if (!skip_stdlib)
+                cc_load_stdlib(&vm);
             if (cc_load_bytecode(&vm, input_file) != 0) {
                 fprintf(stderr, "error: failed to load bytecode from %s\n",
                         input_file);
@@ -599,7 +781,11 @@ int main(int argc, const char *argv[]) {
             }
 
             // Run the loaded bytecode
+            vm.ngram_profile = ngram_profile;
             exit_code = cc_run(&vm, argc, (char **)argv);
+            vm_save_ngram_profile(&vm);
+            if (jit_cache_stats)
+                print_jit_cache_stats(&vm);
             goto BAIL;
         }
     }
@@ -804,6 +990,18 @@ int main(int argc, const char *argv[]) {
         goto BAIL;
     }
 
+    if (out_file && bundle) {
+        // Save the bytecode bundled with this binary and exit
+        if (cc_save_executable(&vm, out_file) != 0) {
+            fprintf(stderr, "error: failed to save executable to %s\n",
+                    out_file);
+            exit_code = 1;
+            goto BAIL;
+        }
+        printf("Executable saved to %s\n", out_file);
+        goto BAIL;
+    }
+
     if (out_file) {
         // Save bytecode to file and exit
         if (cc_save_bytecode(&vm, out_file) != 0) {
@@ -816,7 +1014,11 @@ int main(int argc, const char *argv[]) {
     }
 
     // Run the program
+    vm.ngram_profile = ngram_profile;
     exit_code = cc_run(&vm, argc, (char **)argv);
+    vm_save_ngram_profile(&vm);
+    if (jit_cache_stats)
+        print_jit_cache_stats(&vm);
 
 BAIL:
     cc_destroy(&vm);
@@ -829,6 +1031,7 @@ BAIL:
     }
     if (out_file)
         free(out_file);
+    free(ngram_profile);
     if (inc_paths) {
         for (int i = 0; i < inc_paths_count; i++)
             free((void *)inc_paths[i]);
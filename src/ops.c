@@ -18,6 +18,13 @@
 */
 
 /*
+ * Out-of-line opcode handlers.
+ *
+ * The hot opcodes live directly inside the threaded dispatch loop in vm.c.
+ * This file holds the bulky, rarely executed handlers (runtime safety checks,
+ * the VM heap allocator and the FFI trampoline) that the loop calls into.
+ * Each returns 0 to continue execution or -1 to abort.
+ *
  * Instruction encoding:
  *   RRR format: [OPCODE] [rd:8|rs1:8|rs2:8|unused:40]
  *   RI format:  [OPCODE] [rd:8|unused:56] [immediate:64]
@@ -27,832 +34,6 @@
 #include "jcc.h"
 #include <limits.h>
 
-// ========== Arithmetic Operations ==========
-
-int op_ADD3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long a = vm->regs[rs1];
-    long long b = vm->regs[rs2];
-
-    // Check for signed addition overflow (only if overflow checks enabled)
-    if (vm->flags & JCC_OVERFLOW_CHECKS) {
-        if ((b > 0 && a > LLONG_MAX - b) || (b < 0 && a < LLONG_MIN - b)) {
-            printf("\n========== INTEGER OVERFLOW ==========\n");
-            printf("Addition overflow detected\n");
-            printf("Operands: %lld + %lld\n", a, b);
-            printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-                   (long long)(vm->pc - vm->text_seg));
-            printf("======================================\n");
-            return -1;
-        }
-    }
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = a + b;
-    return 0;
-}
-
-int op_SUB3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long a = vm->regs[rs1];
-    long long b = vm->regs[rs2];
-
-    // Check for signed subtraction overflow (only if overflow checks enabled)
-    if (vm->flags & JCC_OVERFLOW_CHECKS) {
-        if ((b < 0 && a > LLONG_MAX + b) || (b > 0 && a < LLONG_MIN + b)) {
-            printf("\n========== INTEGER OVERFLOW ==========\n");
-            printf("Subtraction overflow detected\n");
-            printf("Operands: %lld - %lld\n", a, b);
-            printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-                   (long long)(vm->pc - vm->text_seg));
-            printf("======================================\n");
-            return -1;
-        }
-    }
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = a - b;
-    return 0;
-}
-
-int op_MUL3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long a = vm->regs[rs1];
-    long long b = vm->regs[rs2];
-
-    // Check for signed multiplication overflow (only if overflow checks
-    // enabled)
-    if ((vm->flags & JCC_OVERFLOW_CHECKS) && a != 0 && b != 0) {
-        if (a == LLONG_MIN || b == LLONG_MIN) {
-            // LLONG_MIN * anything except 0, 1, -1 overflows
-            if ((a == LLONG_MIN && (b != 0 && b != 1 && b != -1)) ||
-                (b == LLONG_MIN && (a != 0 && a != 1 && a != -1))) {
-                printf("\n========== INTEGER OVERFLOW ==========\n");
-                printf("Multiplication overflow detected\n");
-                printf("Operands: %lld * %lld\n", a, b);
-                printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-                       (long long)(vm->pc - vm->text_seg));
-                printf("======================================\n");
-                return -1;
-            }
-        } else {
-            long long result = a * b;
-            if (result / a != b) {
-                printf("\n========== INTEGER OVERFLOW ==========\n");
-                printf("Multiplication overflow detected\n");
-                printf("Operands: %lld * %lld\n", a, b);
-                printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-                       (long long)(vm->pc - vm->text_seg));
-                printf("======================================\n");
-                return -1;
-            }
-        }
-    }
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = a * b;
-    return 0;
-}
-
-int op_DIV3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long a = vm->regs[rs1];
-    long long b = vm->regs[rs2];
-
-    // Check for division by zero
-    if (b == 0) {
-        printf("\n========== DIVISION BY ZERO ==========\n");
-        printf("Attempted division by zero\n");
-        printf("Operands: %lld / 0\n", a);
-        printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-               (long long)(vm->pc - vm->text_seg));
-        printf("======================================\n");
-        return -1;
-    }
-
-    // Check for signed division overflow (LLONG_MIN / -1)
-    if (a == LLONG_MIN && b == -1) {
-        printf("\n========== INTEGER OVERFLOW ==========\n");
-        printf("Division overflow detected\n");
-        printf("Operands: %lld / %lld\n", a, b);
-        printf("Result would overflow (LLONG_MIN / -1 = LLONG_MAX + 1)\n");
-        printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-               (long long)(vm->pc - vm->text_seg));
-        printf("======================================\n");
-        return -1;
-    }
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = a / b;
-    return 0;
-}
-
-int op_MOD3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long a = vm->regs[rs1];
-    long long b = vm->regs[rs2];
-
-    // Check for modulo by zero
-    if (b == 0) {
-        printf("\n========== MODULO BY ZERO ==========\n");
-        printf("Attempted modulo by zero\n");
-        printf("Operands: %lld %% 0\n", a);
-        printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-               (long long)(vm->pc - vm->text_seg));
-        printf("======================================\n");
-        return -1;
-    }
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = a % b;
-    return 0;
-}
-
-// ========== Bitwise Operations ==========
-
-int op_AND3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = vm->regs[rs1] & vm->regs[rs2];
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_OR3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = vm->regs[rs1] | vm->regs[rs2];
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_XOR3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = vm->regs[rs1] ^ vm->regs[rs2];
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SHL3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = vm->regs[rs1] << vm->regs[rs2];
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SHR3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = vm->regs[rs1] >> vm->regs[rs2];
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-// ========== Comparison Operations ==========
-
-int op_SEQ3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = (vm->regs[rs1] == vm->regs[rs2]) ? 1 : 0;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SNE3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = (vm->regs[rs1] != vm->regs[rs2]) ? 1 : 0;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SLT3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = (vm->regs[rs1] < vm->regs[rs2]) ? 1 : 0;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SGE3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = (vm->regs[rs1] >= vm->regs[rs2]) ? 1 : 0;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SGT3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = (vm->regs[rs1] > vm->regs[rs2]) ? 1 : 0;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-int op_SLE3_fn(JCC *vm) {
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    long long result = (vm->regs[rs1] <= vm->regs[rs2]) ? 1 : 0;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = result;
-    return 0;
-}
-
-// ========== Data Movement ==========
-
-int op_LI3_fn(JCC *vm) {
-    // Load immediate: [LI3] [rd:8] [immediate:64]
-    long long operands = *vm->pc++;
-    int rd;
-    DECODE_R(operands, rd);
-    long long imm = *vm->pc++;
-    if (rd != REG_ZERO)
-        vm->regs[rd] = imm;
-    return 0;
-}
-
-int op_MOV3_fn(JCC *vm) {
-    // Move register: [MOV3] [rd:8|rs1:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-    (void)rs2; // Unused
-    if (rd != REG_ZERO)
-        vm->regs[rd] = vm->regs[rs1];
-    return 0;
-}
-
-// ========== Register-Based Calling Convention ==========
-
-int op_ENT3_fn(JCC *vm) {
-    // Enter function: [ENT3] [stack_size:32|param_count:32] [float_param_mask]
-    // Creates new stack frame and copies REG_A0-REG_An and FREG_A0-FREG_An to
-    // parameter slots
-    long long operands = *vm->pc++;
-    int stack_size = (int)(operands & 0xFFFFFFFF);
-    int param_count = (int)((operands >> 32) & 0xFFFFFFFF);
-    long long float_param_mask =
-        *vm->pc++; // Second operand: which params are floats
-
-    // Save old base pointer
-    *--vm->sp = (long long)vm->bp;
-    vm->bp = vm->sp;
-
-    // If stack canaries are enabled, write canary after old bp
-    if (vm->flags & JCC_STACK_CANARIES) {
-        *--vm->sp = vm->stack_canary;
-    }
-
-    // Allocate space for local variables AND parameters
-    // Parameters are now stored at negative offsets like locals
-    vm->sp = vm->sp - stack_size;
-
-    // Copy register arguments to their stack slots
-    // Parameters are at bp[-1], bp[-2], ... bp[-param_count]
-    // Map: REG_Ai/FREG_Ai -> bp[-i-1] depending on float_param_mask
-    // We need separate int and float register indices
-    int int_reg_idx = 0;
-    int float_reg_idx = 0;
-    for (int i = 0; i < param_count && i < 8; i++) {
-        long long *param_slot = vm->bp - 1 - i;
-        if (vm->flags & JCC_STACK_CANARIES) {
-            param_slot--; // Account for canary slot
-        }
-
-        if (float_param_mask & (1LL << i)) {
-            // Float parameter - copy from fregs[]
-            // Store double bits as long long
-            union {
-                double d;
-                long long ll;
-            } conv;
-            conv.d = vm->fregs[FREG_A0 + float_reg_idx];
-            *param_slot = conv.ll;
-            float_reg_idx++;
-        } else {
-            // Integer parameter - copy from regs[]
-            *param_slot = vm->regs[REG_A0 + int_reg_idx];
-            int_reg_idx++;
-        }
-    }
-
-    // Stack overflow checking (for stack instrumentation)
-    if (vm->flags & JCC_STACK_INSTR) {
-        long long stack_used = (char *)vm->initial_sp - (char *)vm->sp;
-        if (stack_used >
-            (long long)(vm->poolsize * sizeof(long long) * 3 / 4)) {
-            if (vm->flags & JCC_STACK_INSTR_ERRORS) {
-                printf("\n===========================================\n");
-                printf("STACK OVERFLOW: Stack usage exceeded 75%% threshold\n");
-                printf("  Stack used: %lld bytes\n", stack_used);
-                printf("  Stack size: %lld bytes\n",
-                       (long long)(vm->poolsize * sizeof(long long)));
-                printf("===========================================\n");
-                return -1;
-            } else if (vm->debug_vm) {
-                printf("WARNING: Stack usage %lld bytes exceeds threshold\n",
-                       stack_used);
-            }
-        }
-    }
-
-    return 0;
-}
-
-int op_LEV3_fn(JCC *vm) {
-    // Leave function: return value already in REG_A0/FREG_A0, restore frame
-    // (Caller placed return value in REG_A0 before LEV3)
-
-    // Restore stack pointer to base pointer
-    vm->sp = vm->bp;
-
-    // If stack canaries are enabled, check canary
-    if (vm->flags & JCC_STACK_CANARIES) {
-        long long canary = vm->sp[-1];
-        if (canary != vm->stack_canary) {
-            printf("\n========== STACK OVERFLOW DETECTED ==========\n");
-            printf("Stack canary corrupted!\n");
-            printf("Expected: 0x%llx\n", vm->stack_canary);
-            printf("Found:    0x%llx\n", canary);
-            printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
-                   (long long)(vm->pc - vm->text_seg));
-            printf("This indicates a stack buffer overflow.\n");
-            printf("=============================================\n");
-            return -1;
-        }
-    }
-
-    // Restore old base pointer
-    vm->bp = (long long *)*vm->sp++;
-
-    // Get return address
-    long long ret_addr = *vm->sp++;
-
-    // CFI validation
-    if (vm->flags & JCC_CFI) {
-        long long shadow_ret_addr = *vm->shadow_sp++;
-        if (shadow_ret_addr != ret_addr) {
-            printf("\n========== CFI VIOLATION ==========\n");
-            printf("Control flow integrity violation detected!\n");
-            printf("Expected return address: 0x%llx\n", shadow_ret_addr);
-            printf("Actual return address:   0x%llx\n", ret_addr);
-            printf("Current PC offset:       %lld\n",
-                   (long long)(vm->pc - vm->text_seg));
-            printf("This indicates a ROP attack or stack corruption.\n");
-            printf("====================================\n");
-            return -1;
-        }
-    }
-
-    // Check if returning from main (ret_addr == 0)
-    if (ret_addr == 0) {
-        vm->pc = NULL; // Signal end of execution
-        return 0;
-    }
-
-    vm->pc = (long long *)ret_addr;
-    return 0;
-}
-
-// ========== 3-Register Floating-Point Arithmetic ==========
-
-// ========== 3-Register Floating-Point Arithmetic ==========
-
-int op_FADD3_fn(JCC *vm) {
-    // fregs[rd] = fregs[rs1] + fregs[rs2]
-    // Format: [FADD3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->fregs[rd] = vm->fregs[rs1] + vm->fregs[rs2];
-    return 0;
-}
-
-int op_FSUB3_fn(JCC *vm) {
-    // fregs[rd] = fregs[rs1] - fregs[rs2]
-    // Format: [FSUB3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->fregs[rd] = vm->fregs[rs1] - vm->fregs[rs2];
-    return 0;
-}
-
-int op_FMUL3_fn(JCC *vm) {
-    // fregs[rd] = fregs[rs1] * fregs[rs2]
-    // Format: [FMUL3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->fregs[rd] = vm->fregs[rs1] * vm->fregs[rs2];
-    return 0;
-}
-
-int op_FDIV3_fn(JCC *vm) {
-    // fregs[rd] = fregs[rs1] / fregs[rs2]
-    // Format: [FDIV3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    // Division by zero check
-    if (vm->fregs[rs2] == 0.0) {
-        printf("\n========== DIVISION BY ZERO ==========\n");
-        printf("Floating-point division by zero detected!\n");
-        printf("PC offset: %lld\n", (long long)(vm->pc - vm->text_seg - 1));
-        printf("======================================\n");
-        return -1;
-    }
-
-    vm->fregs[rd] = vm->fregs[rs1] / vm->fregs[rs2];
-    return 0;
-}
-
-int op_FNEG3_fn(JCC *vm) {
-    // fregs[rd] = -fregs[rs1]
-    // Format: [FNEG3] [rd:8|rs1:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs1;
-    DECODE_RR(operands, rd, rs1);
-
-    vm->fregs[rd] = -vm->fregs[rs1];
-    return 0;
-}
-
-// ========== 3-Register Floating-Point Comparisons ==========
-
-int op_FEQ3_fn(JCC *vm) {
-    // regs[rd] = (fregs[rs1] == fregs[rs2])
-    // Format: [FEQ3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->regs[rd] = (vm->fregs[rs1] == vm->fregs[rs2]);
-    return 0;
-}
-
-int op_FNE3_fn(JCC *vm) {
-    // regs[rd] = (fregs[rs1] != fregs[rs2])
-    // Format: [FNE3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->regs[rd] = (vm->fregs[rs1] != vm->fregs[rs2]);
-    return 0;
-}
-
-int op_FLT3_fn(JCC *vm) {
-    // regs[rd] = (fregs[rs1] < fregs[rs2])
-    // Format: [FLT3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->regs[rd] = (vm->fregs[rs1] < vm->fregs[rs2]);
-    return 0;
-}
-
-int op_FLE3_fn(JCC *vm) {
-    // regs[rd] = (fregs[rs1] <= fregs[rs2])
-    // Format: [FLE3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->regs[rd] = (vm->fregs[rs1] <= vm->fregs[rs2]);
-    return 0;
-}
-
-int op_FGT3_fn(JCC *vm) {
-    // regs[rd] = (fregs[rs1] > fregs[rs2])
-    // Format: [FGT3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->regs[rd] = (vm->fregs[rs1] > vm->fregs[rs2]);
-    return 0;
-}
-
-int op_FGE3_fn(JCC *vm) {
-    // regs[rd] = (fregs[rs1] >= fregs[rs2])
-    // Format: [FGE3] [rd:8|rs1:8|rs2:8|unused:40]
-    long long operands = *vm->pc++;
-    int rd, rs1, rs2;
-    DECODE_RRR(operands, rd, rs1, rs2);
-
-    vm->regs[rd] = (vm->fregs[rs1] >= vm->fregs[rs2]);
-    return 0;
-}
-
-// ========== Internal Operations ==========
-
-int op_ADDI3_fn(JCC *vm) {
-    // Add immediate: regs[rd] = regs[rs1] + immediate
-    // Format: [ADDI3] [rd:8|rs1:8|unused:48] [immediate:64]
-    // Used for struct offset calculations: struct_addr + offset
-    long long operands = *vm->pc++;
-    int rd, rs1;
-    DECODE_RR(operands, rd, rs1);
-    long long imm = *vm->pc++;
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = vm->regs[rs1] + imm;
-    return 0;
-}
-
-int op_NEG3_fn(JCC *vm) {
-    // Integer negation: regs[rd] = -regs[rs1]
-    // Format: [NEG3] [rd:8|rs1:8|unused:48]
-    // Replaces PUSH/-1/MUL pattern for ND_NEG
-    long long operands = *vm->pc++;
-    int rd, rs1;
-    DECODE_RR(operands, rd, rs1);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = -vm->regs[rs1];
-    return 0;
-}
-
-// ========== Register-Based Load/Store ==========
-
-int op_LDR_B_fn(JCC *vm) {
-    // Load byte (sign-extend): regs[rd] = *(char*)regs[rs]
-    // Format: [LDR_B] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = *(char *)vm->regs[rs];
-    return 0;
-}
-
-int op_LDR_H_fn(JCC *vm) {
-    // Load halfword (sign-extend): regs[rd] = *(short*)regs[rs]
-    // Format: [LDR_H] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = *(short *)vm->regs[rs];
-    return 0;
-}
-
-int op_LDR_W_fn(JCC *vm) {
-    // Load word (sign-extend): regs[rd] = *(int*)regs[rs]
-    // Format: [LDR_W] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = *(int *)vm->regs[rs];
-    return 0;
-}
-
-int op_LDR_D_fn(JCC *vm) {
-    // Load dword: regs[rd] = *(long long*)regs[rs]
-    // Format: [LDR_D] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = *(long long *)vm->regs[rs];
-    return 0;
-}
-
-int op_STR_B_fn(JCC *vm) {
-    // Store byte: *(char*)regs[rs] = regs[rd]
-    // Format: [STR_B] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    *(char *)vm->regs[rs] = (char)vm->regs[rd];
-    return 0;
-}
-
-int op_STR_H_fn(JCC *vm) {
-    // Store halfword: *(short*)regs[rs] = regs[rd]
-    // Format: [STR_H] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    *(short *)vm->regs[rs] = (short)vm->regs[rd];
-    return 0;
-}
-
-int op_STR_W_fn(JCC *vm) {
-    // Store word: *(int*)regs[rs] = regs[rd]
-    // Format: [STR_W] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    *(int *)vm->regs[rs] = (int)vm->regs[rd];
-    return 0;
-}
-
-int op_STR_D_fn(JCC *vm) {
-    // Store dword: *(long long*)regs[rs] = regs[rd]
-    // Format: [STR_D] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    *(long long *)vm->regs[rs] = vm->regs[rd];
-    return 0;
-}
-
-int op_FLDR_fn(JCC *vm) {
-    // Float load: fregs[rd] = *(double*)regs[rs]
-    // Format: [FLDR] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    vm->fregs[rd] = *(double *)vm->regs[rs];
-    return 0;
-}
-
-int op_FSTR_fn(JCC *vm) {
-    // Float store: *(double*)regs[rs] = fregs[rd]
-    // Format: [FSTR] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    *(double *)vm->regs[rs] = vm->fregs[rd];
-    return 0;
-}
-
-// ========== Phase 1: New Register-Based Opcodes ==========
-
-int op_LEA3_fn(JCC *vm) {
-    // Load effective address: regs[rd] = bp + immediate
-    // Format: [LEA3] [rd:8|unused:56] [immediate:64]
-    long long operands = *vm->pc++;
-    int rd;
-    DECODE_R(operands, rd);
-    long long offset = *vm->pc++;
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = (long long)(vm->bp + offset);
-    return 0;
-}
-
-int op_I2F3_fn(JCC *vm) {
-    // Int to float: fregs[rd] = (double)regs[rs]
-    // Format: [I2F3] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    vm->fregs[rd] = (double)vm->regs[rs];
-    return 0;
-}
-
-int op_F2I3_fn(JCC *vm) {
-    // Float to int: regs[rd] = (long long)fregs[rs]
-    // Format: [F2I3] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = (long long)vm->fregs[rs];
-    return 0;
-}
-
-int op_FR2R_fn(JCC *vm) {
-    // Float register to integer register (bit-pattern transfer, no conversion)
-    // Format: [FR2R] [rd:8|rs:8|unused:48]
-    // Copies the raw IEEE 754 bits of the double to an integer register
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO) {
-        union {
-            double d;
-            long long ll;
-        } conv;
-        conv.d = vm->fregs[rs];
-        vm->regs[rd] = conv.ll;
-    }
-    return 0;
-}
-
-int op_R2FR_fn(JCC *vm) {
-    // Integer register to float register (bit-pattern transfer, no conversion)
-    // Format: [R2FR] [rd:8|rs:8|unused:48]
-    // Copies the raw bits from integer register to a double (reverse of FR2R)
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    union {
-        double d;
-        long long ll;
-    } conv;
-    conv.ll = vm->regs[rs];
-    vm->fregs[rd] = conv.d;
-    return 0;
-}
-
-int op_JZ3_fn(JCC *vm) {
-    // Branch if zero: if (regs[rs] == 0) pc = target
-    // Format: [JZ3] [rs:8|unused:56] [target:64]
-    long long operands = *vm->pc++;
-    int rs;
-    DECODE_R(operands, rs);
-    long long target = *vm->pc++;
-
-    if (vm->regs[rs] == 0)
-        vm->pc = (long long *)target;
-    return 0;
-}
-
-int op_JNZ3_fn(JCC *vm) {
-    // Branch if non-zero: if (regs[rs] != 0) pc = target
-    // Format: [JNZ3] [rs:8|unused:56] [target:64]
-    long long operands = *vm->pc++;
-    int rs;
-    DECODE_R(operands, rs);
-    long long target = *vm->pc++;
-
-    if (vm->regs[rs] != 0)
-        vm->pc = (long long *)target;
-    return 0;
-}
-
-int op_NOT3_fn(JCC *vm) {
-    // Logical not: regs[rd] = !regs[rs]
-    // Format: [NOT3] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = !vm->regs[rs];
-    return 0;
-}
-
-int op_BNOT3_fn(JCC *vm) {
-    // Bitwise not: regs[rd] = ~regs[rs]
-    // Format: [BNOT3] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-
-    if (rd != REG_ZERO)
-        vm->regs[rd] = ~vm->regs[rs];
-    return 0;
-}
-
 // ========== Register-Based Safety Opcodes ==========
 
 int op_CHKP3_fn(JCC *vm) {
@@ -996,144 +177,6 @@ int op_CHKT3_fn(JCC *vm) {
     return 0;
 }
 
-// ========== Control Flow Opcodes ==========
-
-int op_JMP_fn(JCC *vm) {
-    vm->pc = (long long *)*vm->pc;
-    return 0;
-}
-
-int op_CALL_fn(JCC *vm) {
-    // Call subroutine: push return address to main stack and shadow stack
-    long long target = *vm->pc; // Target address is operand at current pc
-    long long ret_addr = (long long)(vm->pc + 1); // Return after operand
-
-    *--vm->sp = ret_addr;
-    if (vm->flags & JCC_CFI) {
-        *--vm->shadow_sp = ret_addr; // Also push to shadow stack for CFI
-    }
-    vm->pc = (long long *)target;
-    return 0;
-}
-
-int op_CALLI_fn(JCC *vm) {
-    // Call indirect: function address in register (read from operand)
-    long long operands = *vm->pc++;
-    int rs = (int)(operands & 0xFF);
-    long long ret_addr = (long long)vm->pc;
-    *--vm->sp = ret_addr;
-    if (vm->flags & JCC_CFI) {
-        *--vm->shadow_sp = ret_addr;
-    }
-    vm->pc = (long long *)vm->regs[rs];
-    return 0;
-}
-
-int op_JMPT_fn(JCC *vm) {
-    // Jump table: index in REG_A0, *pc contains jump table base address
-    long long *jump_table = (long long *)*vm->pc;
-    long long target = jump_table[vm->regs[REG_A0]];
-    vm->pc = (long long *)target;
-    return 0;
-}
-
-int op_JMPI_fn(JCC *vm) {
-    // Jump indirect - address in register specified by operand
-    // Format: [JMPI] [rs:8|unused:56]
-    long long operands = *vm->pc++;
-    int rs;
-    DECODE_R(operands, rs);
-    vm->pc = (long long *)vm->regs[rs];
-    return 0;
-}
-
-int op_ADJ_fn(JCC *vm) {
-    vm->sp = vm->sp + *vm->pc++;
-    return 0;
-}
-
-int op_PSH3_fn(JCC *vm) {
-    // Push register value onto stack: *--sp = regs[rs]
-    // Format: [PSH3] [rs:8|unused:56]
-    long long operands = *vm->pc++;
-    int rs;
-    DECODE_R(operands, rs);
-    *--vm->sp = vm->regs[rs];
-    return 0;
-}
-
-int op_POP3_fn(JCC *vm) {
-    // Pop from stack into register: regs[rd] = *sp++
-    // Format: [POP3] [rd:8|unused:56]
-    long long operands = *vm->pc++;
-    int rd;
-    DECODE_R(operands, rd);
-    vm->regs[rd] = *vm->sp++;
-    return 0;
-}
-
-// ========== Type Conversion Opcodes ==========
-
-int op_SX1_fn(JCC *vm) {
-    // Sign extend 1 byte to 8 bytes: regs[rd] = (long long)(char)regs[rs]
-    // Format: [SX1] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-    vm->regs[rd] = (long long)(char)vm->regs[rs];
-    return 0;
-}
-
-int op_SX2_fn(JCC *vm) {
-    // Sign extend 2 bytes to 8 bytes: regs[rd] = (long long)(short)regs[rs]
-    // Format: [SX2] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-    vm->regs[rd] = (long long)(short)vm->regs[rs];
-    return 0;
-}
-
-int op_SX4_fn(JCC *vm) {
-    // Sign extend 4 bytes to 8 bytes: regs[rd] = (long long)(int)regs[rs]
-    // Format: [SX4] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-    vm->regs[rd] = (long long)(int)vm->regs[rs];
-    return 0;
-}
-
-int op_ZX1_fn(JCC *vm) {
-    // Zero extend 1 byte to 8 bytes: regs[rd] = (long long)(unsigned
-    // char)regs[rs] Format: [ZX1] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-    vm->regs[rd] = (long long)(unsigned char)vm->regs[rs];
-    return 0;
-}
-
-int op_ZX2_fn(JCC *vm) {
-    // Zero extend 2 bytes to 8 bytes: regs[rd] = (long long)(unsigned
-    // short)regs[rs] Format: [ZX2] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-    vm->regs[rd] = (long long)(unsigned short)vm->regs[rs];
-    return 0;
-}
-
-int op_ZX4_fn(JCC *vm) {
-    // Zero extend 4 bytes to 8 bytes: regs[rd] = (long long)(unsigned
-    // int)regs[rs] Format: [ZX4] [rd:8|rs:8|unused:48]
-    long long operands = *vm->pc++;
-    int rd, rs;
-    DECODE_RR(operands, rd, rs);
-    vm->regs[rd] = (long long)(unsigned int)vm->regs[rs];
-    return 0;
-}
-
 // ========== Memory Allocation Opcodes ==========
 
 int op_MALC_fn(JCC *vm) {
@@ -1208,15 +251,6 @@ int op_MFRE_fn(JCC *vm) {
     return 0;
 }
 
-int op_MCPY_fn(JCC *vm) {
-    // memcpy: dest in REG_A0, src in REG_A1, count in REG_A2
-    void *dest = (void *)vm->regs[REG_A0];
-    void *src = (void *)vm->regs[REG_A1];
-    size_t count = (size_t)vm->regs[REG_A2];
-    memcpy(dest, src, count);
-    return 0;
-}
-
 int op_REALC_fn(JCC *vm) {
     // realloc: ptr in REG_A0, new_size in REG_A1, return in REG_A0
     void *ptr = (void *)vm->regs[REG_A0];
@@ -1276,96 +310,6 @@ int op_CALC_fn(JCC *vm) {
     return 0;
 }
 
-// ========== Safety Opcodes ==========
-
-int op_CHKB_fn(JCC *vm) {
-    // Check array bounds (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_CHKI_fn(JCC *vm) {
-    // Check initialization (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_MARKI_fn(JCC *vm) {
-    // Mark as initialized (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_MARKA_fn(JCC *vm) {
-    // Mark address (stub for now)
-    vm->pc += 3; // Skip 3 operands
-    return 0;
-}
-
-int op_CHKPA_fn(JCC *vm) {
-    // Check pointer arithmetic (stub for now)
-    return 0;
-}
-
-int op_MARKP_fn(JCC *vm) {
-    // Mark provenance (stub for now)
-    vm->pc += 3; // Skip 3 operands
-    return 0;
-}
-
-int op_SCOPEIN_fn(JCC *vm) {
-    // Enter scope (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_SCOPEOUT_fn(JCC *vm) {
-    // Exit scope (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_CHKL_fn(JCC *vm) {
-    // Check liveness (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_MARKR_fn(JCC *vm) {
-    // Mark read (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-int op_MARKW_fn(JCC *vm) {
-    // Mark write (stub for now)
-    vm->pc++; // Skip operand
-    return 0;
-}
-
-// ========== Setjmp/Longjmp ==========
-
-int op_SETJMP_fn(JCC *vm) {
-    // setjmp: jmp_buf address in REG_A0, return 0 in REG_A0
-    long long *jmp_buf = (long long *)vm->regs[REG_A0];
-    jmp_buf[0] = (long long)vm->pc;
-    jmp_buf[1] = (long long)vm->sp;
-    jmp_buf[2] = (long long)vm->bp;
-    vm->regs[REG_A0] = 0; // setjmp returns 0 on direct call
-    return 0;
-}
-
-int op_LONGJMP_fn(JCC *vm) {
-    // longjmp: jmp_buf address in REG_A0, value in REG_A1
-    long long *jmp_buf = (long long *)vm->regs[REG_A0];
-    long long val = vm->regs[REG_A1];
-    vm->pc = (long long *)jmp_buf[0];
-    vm->sp = (long long *)jmp_buf[1];
-    vm->bp = (long long *)jmp_buf[2];
-    vm->regs[REG_A0] = val ? val : 1; // Return value (never 0)
-    return 0;
-}
-
 // ========== FFI ==========
 
 int op_CALLF_fn(JCC *vm) {
@@ -1861,18 +805,6 @@ int op_CALLF_fn(JCC *vm) {
     return 0;
 }
 
-// ========== Struct Return Buffer Support ==========
-
-int op_RETBUF_fn(JCC *vm) {
-    // Get next return buffer from rotating pool at runtime
-    // This ensures chained struct-returning calls (e.g., f(g(), h()))
-    // get different buffers automatically
-    int idx = vm->runtime_return_buffer_index;
-    vm->runtime_return_buffer_index = (idx + 1) % RETURN_BUFFER_POOL_SIZE;
-    vm->regs[REG_A0] = (long long)vm->compiler.return_buffer_pool[idx];
-    return 0;
-}
-
 // ========== Random Canary Generation ==========
 
 long long generate_random_canary(void) {
@@ -33,6 +33,8 @@
 //   -O2: Standard - constant folding + peephole
 //   -O3: Aggressive - all passes including dead code elimination
 //
+// Every level >= 1 finishes by fusing superinstructions.
+//
 
 // ========== Helper Functions ==========
 
@@ -41,40 +43,9 @@ static int get_opcode(long long *pc) {
     return (int)*pc;
 }
 
-// Check if opcode is a 2-word instruction (op + operand)
-static bool is_2word_op(int op) {
-    // Most register ops have operands encoded in the second word
-    switch (op) {
-        case JMP:
-        case CALL:
-        case JMPT:
-        case JMPI:
-            return true;
-        default:
-            // Check for register-based ops (all 3-reg/2-reg/1-reg ops have operand word)
-            return op >= ADD3;  // All new register ops are >= ADD3
-    }
-}
-
-// Check if opcode uses an immediate value (3-word: op + operand + imm)
-static bool is_3word_op(int op) {
-    switch (op) {
-        case LI3:    // rd + imm
-        case LEA3:   // rd + imm
-        case ADDI3:  // rd, rs + imm
-        case JZ3:    // rs + target
-        case JNZ3:   // rs + target
-            return true;
-        default:
-            return false;
-    }
-}
-
 // Get instruction size in words
 static int get_instr_size(int op) {
-    if (is_3word_op(op)) return 3;
-    if (is_2word_op(op)) return 2;
-    return 1;
+    return vm_insn_size(op);
 }
 
 // ========== Pass 1: Constant Folding ==========
@@ -271,15 +242,37 @@ static void opt_constant_fold(JCC *vm) {
                 break;
             }
 
-            case ADDI3: {
-                // ADDI3 rd, rs, imm - if rs is const, result is const
+            case ADDI3:
+            case SUBI3:
+            case MULI3:
+            case ANDI3:
+            case ORI3:
+            case XORI3:
+            case SHLI3:
+            case SHRI3:
+            case SLTI3: {
+                // OPI3 rd, rs, imm - if rs is const, result is const
                 int rd = pc[1] & 0xFF;
                 int rs = (pc[1] >> 8) & 0xFF;
                 long long imm = pc[2];
                 if (rd < MAX_TRACKED_REGS && rd != 0) {
                     if (rs < MAX_TRACKED_REGS && state.is_const[rs]) {
+                        long long a = state.value[rs];
+                        long long result = 0;
+                        switch (op) {
+                            case ADDI3: result = a + imm; break;
+                            case SUBI3: result = a - imm; break;
+                            case MULI3: result = a * imm; break;
+                            case ANDI3: result = a & imm; break;
+                            case ORI3:  result = a | imm; break;
+                            case XORI3: result = a ^ imm; break;
+                            case SHLI3: result = a << imm; break;
+                            case SHRI3: result = a >> imm; break;
+                            case SLTI3: result = (a < imm) ? 1 : 0; break;
+                        }
                         state.is_const[rd] = true;
-                        state.value[rd] = state.value[rs] + imm;
+                        state.value[rd] = result;
+                        folded_count++;
                     } else {
                         state.is_const[rd] = false;
                     }
@@ -291,12 +284,25 @@ static void opt_constant_fold(JCC *vm) {
             case JMP:
             case JZ3:
             case JNZ3:
+            case BEQ:
+            case BNE:
+            case BLT:
+            case BGE:
+            case BLTU:
+            case BGEU:
+            case BEQI:
+            case BNEI:
+            case BLTI:
+            case BGEI:
+            case BLTUI:
+            case BGEUI:
             case JMPT:
             case JMPI:
             case CALL:
             case CALLI:
             case ENT3:
             case LEV3:
+            case RET3:
                 reset_reg_state(&state);
                 break;
 
@@ -341,7 +347,7 @@ static void opt_constant_fold(JCC *vm) {
 // 1. MOV3 ra, ra -> NOP (self-move)
 // 2. LI3 rx, A; LI3 rx, B -> LI3 rx, B (overwritten load)
 // 3. PSH3 rx; POP3 rx -> NOP (push/pop same register)
-// 4. JMP to next instruction -> NOP
+// 4. JMP/JZ3/JNZ3/Bxx to next instruction -> NOP
 //
 
 // Mark an instruction as NOP (for later removal or skipping)
@@ -427,17 +433,24 @@ static void opt_peephole(JCC *vm) {
         pc += size;
     }
 
-    // Pattern 4: JMP to next instruction -> NOP
+    // Pattern 4: JMP or conditional branch to next instruction -> NOP
     for (long long *pc = start; pc < end; ) {
         int op = get_opcode(pc);
         int size = get_instr_size(op);
+        int target_idx = vm_target_operand(op);
 
-        if (op == JMP) {
-            long long target = pc[1];
+        if (target_idx && op != CALL && op != JMPT) {
+            long long target = pc[target_idx];
             long long *next = pc + size;
             if (target == (long long)next) {
-                // Jump to the very next instruction - useless
-                nop_2word(pc);
+                // Jump to the very next instruction - useless whether or
+                // not it is taken (compares have no side effects)
+                if (size == 3) {
+                    nop_3word(pc);
+                } else {
+                    nop_2word(pc);
+                    if (size == 4) nop_2word(pc + 2);
+                }
                 opt_count++;
             }
         }
@@ -521,6 +534,70 @@ static void opt_dead_code(JCC *vm) {
     }
 }
 
+// ========== Pass 4: Superinstructions ==========
+//
+// Fuse frequent straight-line sequences (see superops.h, generated by
+// superops.py from --ngram-profile runs) into one dispatch.
+//
+// Only the opcode word of the first component is rewritten. Its operands and
+// the remaining component instructions stay where they are, so no address
+// moves and a jump into the middle of a sequence still lands on a valid
+// instruction. The fused handler runs every component back to back.
+//
+
+typedef struct {
+    int op;        // Fused opcode
+    int len;       // Number of components
+    int parts[3];  // Component opcodes, in execution order
+} Superop;
+
+static const Superop superops[] = {
+#define S2(NAME, A, B) {NAME, 2, {A, B}},
+#define S3(NAME, A, B, C) {NAME, 3, {A, B, C}},
+    SUPEROPS_DEF
+#undef S2
+#undef S3
+    {-1, 0, {0}},
+};
+
+static void opt_superinstructions(JCC *vm) {
+    if (!vm || !vm->text_seg || !vm->text_ptr) {
+        return;
+    }
+
+    long long *start = vm->text_seg + 1;  // Skip entry point
+    long long *end = vm->text_ptr;
+    int fused_count = 0;
+
+    for (long long *pc = start; pc < end; ) {
+        int op = get_opcode(pc);
+        int size = get_instr_size(op);
+
+        // Entries are ordered longest and most frequent first
+        for (const Superop *s = superops; s->op >= 0; s++) {
+            if (s->parts[0] != op) continue;
+            long long *next = pc + size;
+            int k = 1;
+            while (k < s->len && next <= end &&
+                   get_opcode(next) == s->parts[k]) {
+                next += get_instr_size(s->parts[k]);
+                k++;
+            }
+            if (k == s->len && next <= end + 1) {
+                pc[0] = s->op;
+                size = next - pc;
+                fused_count++;
+                break;
+            }
+        }
+        pc += size;
+    }
+
+    if (vm->debug_vm && fused_count > 0) {
+        printf("[opt] superinstructions: fused %d sequences\n", fused_count);
+    }
+}
+
 // ========== Main Entry Point ==========
 
 void cc_optimize(JCC *vm, int level) {
@@ -542,4 +619,7 @@ void cc_optimize(JCC *vm, int level) {
     if (level >= 3) {
         opt_dead_code(vm);
     }
+
+    // Runs last, on the final instruction sequence of every level
+    opt_superinstructions(vm);
 }
@@ -191,6 +191,9 @@ static void leave_scope(JCC *vm) {
 // Find a variable by name.
 static VarScope *find_var(JCC *vm, Token *tok) {
     for (Scope *sc = vm->compiler.scope; sc; sc = sc->next) {
+        // The file scope can hold thousands of names, so it is indexed
+        if (!sc->next)
+            return hashmap_get2(&sc->index, tok->loc, tok->len);
         // Linear search through linked list (typically 1-10 entries per scope)
         for (VarScopeNode *node = sc->vars; node; node = node->next) {
             if (node->name_len == tok->len &&
@@ -302,6 +305,8 @@ static VarScope *push_scope(JCC *vm, char *name, int name_len) {
     // Insert at head of linked list
     node->next = vm->compiler.scope->vars;
     vm->compiler.scope->vars = node;
+    if (!vm->compiler.scope->next)
+        hashmap_put2(&vm->compiler.scope->index, name, name_len, node);
     // Return pointer to VarScope fields within the node
     return (VarScope *)node;
 }
@@ -402,6 +407,7 @@ static Obj *new_anon_gvar(JCC *vm, Type *ty) {
 static Obj *new_string_literal(JCC *vm, char *p, Type *ty) {
     Obj *var = new_anon_gvar(vm, ty);
     var->init_data = p;
+    var->is_string_literal = true;
     return var;
 }
 
@@ -2106,8 +2112,8 @@ static Node *stmt(JCC *vm, Token **rest, Token *tok) {
         }
 
         Node *node = new_node(vm, ND_CASE, tok);
-        int begin = const_expr(vm, &tok, tok->next);
-        int end;
+        long begin = const_expr(vm, &tok, tok->next);
+        long end;
 
         if (equal(tok, "...")) {
             // [GNU] Case ranges, e.g. "case 1 ... 5:"
@@ -2466,6 +2472,12 @@ static int64_t eval2(JCC *vm, Node *node, char ***label) {
         return 0;
     case ND_NUM:
         return node->val;
+    case ND_FUNCALL:
+        // A call to a pure function is run and replaced by its result
+        if (cc_fold_call(vm, node))
+            return node->val;
+        error_tok(vm, node->tok, "not a compile-time constant");
+        return 0;
     default:
         error_tok(vm, node->tok, "not a compile-time constant");
         return 0;
@@ -2522,6 +2534,8 @@ static bool is_const_expr(JCC *vm, Node *node) {
         return is_const_expr(vm, node->lhs);
     case ND_NUM:
         return true;
+    case ND_FUNCALL:
+        return cc_fold_call(vm, node);
     default:
         return false;
     }
@@ -2563,6 +2577,11 @@ static double eval_double(JCC *vm, Node *node) {
         return eval(vm, node->lhs);
     case ND_NUM:
         return node->fval;
+    case ND_FUNCALL:
+        if (cc_fold_call(vm, node))
+            return node->fval;
+        error_tok(vm, node->tok, "not a compile-time constant");
+        return 0;
     default:
         error_tok(vm, node->tok, "not a compile-time constant");
         return 0;
@@ -2670,6 +2689,12 @@ static Node *to_assign(JCC *vm, Node *binary) {
         return node;
     }
 
+    // A plain variable can be named twice: `A op= B` is `A = A op B`, which
+    // keeps A's address from being taken
+    if (binary->lhs->kind == ND_VAR)
+        return new_binary(vm, ND_ASSIGN,
+                          new_var_node(vm, binary->lhs->var, tok), binary, tok);
+
     // Convert `A op= B` to ``tmp = &A, *tmp = *tmp op B`.
     Obj *var = new_lvar(vm, "", 0, pointer_to(vm, binary->lhs->ty));
 
@@ -3270,6 +3295,8 @@ static Node *block_literal(JCC *vm, Token **rest, Token *tok) {
     block_fn->is_nested =
         true; // Treat blocks like nested functions for codegen
     block_fn->nesting_depth = outer_fn ? outer_fn->nesting_depth + 1 : 1;
+    if (outer_fn)
+        outer_fn->has_nested = true;
 
     // Set up block function context
     vm->compiler.current_fn = block_fn;
@@ -3310,6 +3337,8 @@ static Node *block_literal(JCC *vm, Token **rest, Token *tok) {
     new_lvar(vm, "__static_link", 13, pointer_to(vm, ty_void));
 
     block_fn->params = vm->compiler.locals;
+    if (return_ty->kind == TY_STRUCT || return_ty->kind == TY_UNION)
+        block_fn->sret = new_lvar(vm, "", 0, pointer_to(vm, return_ty));
     block_fn->alloca_bottom =
         new_lvar(vm, "__alloca_size__", 15, pointer_to(vm, ty_char));
 
@@ -3864,6 +3893,8 @@ static Node *postfix(JCC *vm, Token **rest, Token *tok) {
                 call->lhs = node;
                 call->args = head.next;
                 call->ty = node->ty->return_ty ? node->ty->return_ty : ty_void;
+                if (call->ty->kind == TY_STRUCT || call->ty->kind == TY_UNION)
+                    call->ret_buffer = new_lvar(vm, "", 0, call->ty);
                 node = call;
             } else {
                 node = funcall(vm, &tok, tok->next, node);
@@ -4362,16 +4393,9 @@ static Obj *find_func(JCC *vm, char *name, int name_len) {
     while (sc->next)
         sc = sc->next;
 
-    // Linear search through linked list
-    for (VarScopeNode *node = sc->vars; node; node = node->next) {
-        if (node->name_len == name_len &&
-            strncmp(node->name, name, name_len) == 0) {
-            VarScope *sc2 = (VarScope *)node;
-            if (sc2->var && sc2->var->is_function)
-                return sc2->var;
-            return NULL;
-        }
-    }
+    VarScope *sc2 = hashmap_get2(&sc->index, name, name_len);
+    if (sc2 && sc2->var && sc2->var->is_function)
+        return sc2->var;
     return NULL;
 }
 
@@ -4431,6 +4455,7 @@ static Token *function(JCC *vm, Token *tok, Type *basety, VarAttr *attr) {
         fn->parent_fn = parent_fn;
         fn->is_nested = true;
         fn->nesting_depth = vm->compiler.fn_nesting_depth + 1;
+        parent_fn->has_nested = true;
         // Nested functions are implicitly static (not visible outside)
         fn->is_static = true;
     } else {
@@ -4462,15 +4487,14 @@ static Token *function(JCC *vm, Token *tok, Type *basety, VarAttr *attr) {
         new_lvar(vm, "__static_link", 13, pointer_to(vm, ty_void));
     }
 
-    // Note: Struct/union returns are handled via return_buffer in codegen.c
-    // The hidden parameter approach was incomplete (caller never provided it),
-    // so it has been removed to fix variadic functions with struct returns.
-    // Type *rty = ty->return_ty;
-    // if ((rty->kind == TY_STRUCT || rty->kind == TY_UNION) && rty->size > 16)
-    //     new_lvar(vm, "", pointer_to(rty));
-
     fn->params = vm->compiler.locals;
 
+    // Struct/union results are copied to an address the caller passes in
+    // REG_SRET; the prologue keeps it in this hidden local
+    Type *rty = ty->return_ty;
+    if (rty->kind == TY_STRUCT || rty->kind == TY_UNION)
+        fn->sret = new_lvar(vm, "", 0, pointer_to(vm, rty));
+
     if (ty->is_variadic)
         fn->va_area =
             new_lvar(vm, "__va_area__", 11, array_of(vm, ty_char, 136));
@@ -4482,12 +4506,12 @@ static Token *function(JCC *vm, Token *tok, Type *basety, VarAttr *attr) {
     // [https://www.sigbus.info/n1570#6.4.2.2p1] "__func__" is
     // automatically defined as a local variable containing the
     // current function name.
-    push_scope(vm, "__func__", 8)->var = new_string_literal(
+    Obj *func_name = new_string_literal(
         vm, fn->name, array_of(vm, ty_char, strlen(fn->name) + 1));
+    push_scope(vm, "__func__", 8)->var = func_name;
 
-    // [GNU] __FUNCTION__ is yet another name of __func__.
-    push_scope(vm, "__FUNCTION__", 12)->var = new_string_literal(
-        vm, fn->name, array_of(vm, ty_char, strlen(fn->name) + 1));
+    // [GNU] __FUNCTION__ is yet another name of __func__ (the same array).
+    push_scope(vm, "__FUNCTION__", 12)->var = func_name;
 
     fn->body = compound_stmt(vm, &tok, tok);
     fn->locals = vm->compiler.locals;
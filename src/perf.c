@@ -0,0 +1,413 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "jcc.h"
+#include "./internal.h"
+
+//
+// Profiler Support (--perf-map, --perf-jitdump, --perf-trampolines)
+//
+// Linux perf resolves samples in anonymous executable memory through
+// /tmp/perf-<pid>.map, a text file with one "start size name" line per
+// piece of code, and through /tmp/jit-<pid>.dump, the jitdump format that
+// `perf inject --jit` turns into one ELF image per function (code included,
+// so `perf annotate` works). Every function --jit installs is written to
+// the outputs enabled in vm->perf, named after the C function it came from
+// (the name and code_addr the code generator recorded for it) and the tier
+// that compiled it. Loaded bytecode has no names; its functions are called
+// jcc_fn_<text offset>.
+//
+// Interpreted functions have no code of their own, so all of their samples
+// land in the dispatch loop. With PERF_TRAMPOLINES, PERFENT is swapped over
+// every ENT3 that --jit does not count: it runs the function in a nested
+// dispatch loop, called through a native trampoline made for the function
+// and listed like compiled code in the map or dump, if either is enabled
+// (trampolines alone write no files). A profiler walking the host stack (perf
+// record -g) finds the trampoline, and so the function, under every sample
+// taken while it runs. Each guest call then costs a host call and a loop
+// frame, so past PERF_MAX_DEPTH nested calls a function runs in its
+// caller's loop and its samples go to the caller. Programs using
+// setjmp/longjmp get no trampolines: a longjmp cannot unwind nested loops.
+//
+
+#if defined(__linux__)
+
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+
+// jitdump file format (tools/perf/Documentation/jitdump-specification.txt)
+#define JITDUMP_MAGIC 0x4A695444
+#define JITDUMP_VERSION 1
+#define JIT_CODE_LOAD 0
+
+#if defined(__x86_64__)
+#define JITDUMP_MACHINE 62  // EM_X86_64
+#else
+#define JITDUMP_MACHINE 0
+#endif
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t total_size;  // Size of this header
+    uint32_t elf_mach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+} JitDumpHeader;
+
+typedef struct {
+    uint32_t id;          // JIT_CODE_LOAD
+    uint32_t total_size;  // Record size, name and code included
+    uint64_t timestamp;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t code_addr;
+    uint64_t code_size;
+    uint64_t code_index;
+    // Followed by the NUL-terminated name and the code
+} JitCodeLoad;
+
+typedef struct {
+    long long text_off;  // Word offset of the function's ENT3
+    const char *name;
+} PerfSymbol;
+
+struct PerfState {
+    FILE *map;                  // /tmp/perf-<pid>.map, NULL if not written
+    FILE *dump;                 // /tmp/jit-<pid>.dump, NULL if not written
+    void *marker;               // Executable mapping of the dump (perf_open)
+    size_t marker_size;
+    uint64_t code_index;        // Code load records written
+    PerfSymbol *symbols;        // Functions by text offset
+    int nsymbols;
+    unsigned char *tramp_code;  // Trampolines (make_trampolines)
+    size_t tramp_size;
+    void **tramp;               // Record index -> trampoline, NULL if none
+    VMInsn *tramp_insns;        // Stream the trampolines were made for
+};
+
+static uint64_t perf_timestamp(void) {
+    // perf record -k mono samples the same clock
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int symbol_cmp(const void *a, const void *b) {
+    long long x = ((const PerfSymbol *)a)->text_off;
+    long long y = ((const PerfSymbol *)b)->text_off;
+    return (x > y) - (x < y);
+}
+
+// Name the function whose ENT3 is insn
+static void function_name(PerfState *st, VMInsn *insn, char *buf,
+                          size_t size) {
+    PerfSymbol key = {insn->text_off, NULL};
+    PerfSymbol *sym = st->nsymbols
+                          ? bsearch(&key, st->symbols, st->nsymbols,
+                                    sizeof(PerfSymbol), symbol_cmp)
+                          : NULL;
+    if (sym)
+        snprintf(buf, size, "%s", sym->name);
+    else
+        snprintf(buf, size, "jcc_fn_%u", (unsigned)insn->text_off);
+}
+
+// Open the outputs vm->perf asks for on first use. Any that cannot be
+// opened is dropped from vm->perf with a warning.
+static PerfState *perf_open(JCC *vm) {
+    if (vm->perf_state)
+        return vm->perf_state;
+    PerfState *st = calloc(1, sizeof(PerfState));
+    if (!st) {
+        vm->perf = 0;
+        return NULL;
+    }
+    vm->perf_state = st;
+
+    int count = 0;
+    for (Obj *fn = vm->compiler.globals; fn; fn = fn->next)
+        if (fn->is_function && fn->body)
+            count++;
+    st->symbols = count ? malloc(sizeof(PerfSymbol) * count) : NULL;
+    for (Obj *fn = vm->compiler.globals; st->symbols && fn; fn = fn->next) {
+        if (fn->is_function && fn->body) {
+            st->symbols[st->nsymbols].text_off = fn->code_addr;
+            st->symbols[st->nsymbols++].name = fn->name;
+        }
+    }
+    if (st->nsymbols)
+        qsort(st->symbols, st->nsymbols, sizeof(PerfSymbol), symbol_cmp);
+
+    char path[64];
+    if (vm->perf & PERF_MAP) {
+        snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+        st->map = fopen(path, "w");
+        if (!st->map) {
+            fprintf(stderr, "warning: could not create %s\n", path);
+            vm->perf &= ~PERF_MAP;
+        }
+    }
+
+    if (vm->perf & PERF_JITDUMP) {
+        snprintf(path, sizeof(path), "/tmp/jit-%d.dump", (int)getpid());
+        st->dump = fopen(path, "w+");
+        JitDumpHeader h = {JITDUMP_MAGIC,   JITDUMP_VERSION,  sizeof(h),
+                           JITDUMP_MACHINE, 0, (uint32_t)getpid(),
+                           perf_timestamp(), 0};
+        if (st->dump && fwrite(&h, sizeof(h), 1, st->dump) == 1 &&
+            fflush(st->dump) == 0) {
+            // perf finds the dump through an executable mapping of it
+            st->marker_size = (size_t)sysconf(_SC_PAGESIZE);
+            st->marker = mmap(NULL, st->marker_size, PROT_READ | PROT_EXEC,
+                              MAP_PRIVATE, fileno(st->dump), 0);
+            if (st->marker == MAP_FAILED)
+                st->marker = NULL;
+        }
+        if (!st->marker) {
+            fprintf(stderr, "warning: could not create %s\n", path);
+            if (st->dump)
+                fclose(st->dump);
+            st->dump = NULL;
+            vm->perf &= ~PERF_JITDUMP;
+        }
+    }
+    return st;
+}
+
+void perf_code_load(JCC *vm, VMInsn *fn, const char *kind, const void *code,
+                    size_t size) {
+    PerfState *st;
+    if (!vm->perf || !(st = perf_open(vm)))
+        return;
+
+    char name[256];
+    if (fn) {
+        char base[224];
+        function_name(st, fn, base, sizeof(base));
+        snprintf(name, sizeof(name), "%s [%s]", base, kind);
+    } else {
+        snprintf(name, sizeof(name), "%s", kind);
+    }
+
+    if (st->map) {
+        fprintf(st->map, "%lx %lx %s\n", (unsigned long)(uintptr_t)code,
+                (unsigned long)size, name);
+        fflush(st->map);
+    }
+
+    if (st->dump) {
+        size_t name_len = strlen(name) + 1;
+        JitCodeLoad r = {JIT_CODE_LOAD,
+                         (uint32_t)(sizeof(r) + name_len + size),
+                         perf_timestamp(),
+                         (uint32_t)getpid(),
+                         (uint32_t)getpid(),  // The VM runs on the main thread
+                         (uint64_t)(uintptr_t)code,
+                         (uint64_t)(uintptr_t)code,
+                         size,
+                         st->code_index++};
+        fwrite(&r, sizeof(r), 1, st->dump);
+        fwrite(name, 1, name_len, st->dump);
+        fwrite(code, 1, size, st->dump);
+        fflush(st->dump);
+    }
+}
+
+#if defined(__x86_64__)
+
+// Bytes per trampoline; each is
+//
+//     push rbp; mov rbp, rsp
+//     movabs rax, perf_run; call rax
+//     pop rbp; ret
+//
+// so frame pointer unwinding sees it like any other host function
+#define TRAMPOLINE_CODE 18
+#define TRAMPOLINE_SIZE 32
+
+// Called through the trampoline of the function whose ENT3 is insn: run it
+// in the loop bound to the stream. Its return address was already popped,
+// so vm_call's zero return address ends the nested loop at its LEV3.
+static int perf_run(JCC *vm, VMInsn *insn) {
+    vm->perf_entry = insn;
+    vm->perf_depth++;
+    int ret = vm_call(vm, (long long)(vm->text_seg + insn->text_off));
+    vm->perf_depth--;
+    return ret;
+}
+
+// Make a trampoline for every ENT3 of the current stream
+static int make_trampolines(JCC *vm, PerfState *st) {
+    if (st->tramp_code)
+        munmap(st->tramp_code, st->tramp_size);
+    free(st->tramp);
+    st->tramp_code = NULL;
+    st->tramp = NULL;
+    st->tramp_insns = vm->insns;
+
+    long long count = 0;
+    for (long long i = 0; i < vm->insn_count; i++) {
+        int op = vm_superop_base(vm->insns[i].op);
+        if (op == SETJMP || op == LONGJMP) {
+            fprintf(stderr, "warning: --perf-trampolines does not support "
+                            "setjmp/longjmp, interpreting without them\n");
+            vm->perf &= ~PERF_TRAMPOLINES;
+            return -1;
+        }
+        if (op == ENT3)
+            count++;
+    }
+    if (!count)
+        return -1;
+
+    st->tramp_size = ((size_t)count * TRAMPOLINE_SIZE + 4095) & ~(size_t)4095;
+    st->tramp_code = mmap(NULL, st->tramp_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    st->tramp = calloc(vm->insn_count + 1, sizeof(void *));
+    if (st->tramp_code == MAP_FAILED || !st->tramp) {
+        if (st->tramp_code == MAP_FAILED)
+            st->tramp_code = NULL;
+        fprintf(stderr, "warning: could not allocate --perf-trampolines\n");
+        vm->perf &= ~PERF_TRAMPOLINES;
+        return -1;
+    }
+
+    unsigned char *p = st->tramp_code;
+    void *target = (void *)perf_run;
+    for (long long i = 0; i < vm->insn_count; i++) {
+        if (vm_superop_base(vm->insns[i].op) != ENT3)
+            continue;
+        static const unsigned char head[] = {0x55, 0x48, 0x89, 0xE5, 0x48,
+                                             0xB8};
+        static const unsigned char tail[] = {0xFF, 0xD0, 0x5D, 0xC3};
+        memset(p, 0xCC, TRAMPOLINE_SIZE);
+        memcpy(p, head, sizeof(head));
+        memcpy(p + sizeof(head), &target, 8);
+        memcpy(p + sizeof(head) + 8, tail, sizeof(tail));
+        st->tramp[i] = p;
+        p += TRAMPOLINE_SIZE;
+    }
+    if (mprotect(st->tramp_code, st->tramp_size, PROT_READ | PROT_EXEC) != 0) {
+        fprintf(stderr, "warning: could not allocate --perf-trampolines\n");
+        vm->perf &= ~PERF_TRAMPOLINES;
+        return -1;
+    }
+
+    for (long long i = 0; i < vm->insn_count; i++)
+        if (st->tramp[i])
+            perf_code_load(vm, &vm->insns[i], "interp", st->tramp[i],
+                           TRAMPOLINE_CODE);
+    return 0;
+}
+
+int perf_trampoline(JCC *vm, VMInsn *insn) {
+    if (!(vm->perf & PERF_TRAMPOLINES))
+        return 0;
+    PerfState *st = perf_open(vm);
+    if (!st)
+        return 0;
+    if (st->tramp_insns != vm->insns && make_trampolines(vm, st) != 0)
+        return 0;
+    return (vm->perf & PERF_TRAMPOLINES) && st->tramp &&
+           st->tramp[insn - vm->insns] != NULL;
+}
+
+int perf_enter(JCC *vm, VMInsn *insn) {
+    int (*tramp)(JCC *, VMInsn *) = (int (*)(JCC *, VMInsn *))
+        vm->perf_state->tramp[insn - vm->insns];
+    return tramp(vm, insn);
+}
+
+#else
+
+int perf_trampoline(JCC *vm, VMInsn *insn) {
+    (void)insn;
+    if (vm->perf & PERF_TRAMPOLINES) {
+        fprintf(stderr, "warning: --perf-trampolines is not supported on "
+                        "this platform\n");
+        vm->perf &= ~PERF_TRAMPOLINES;
+    }
+    return 0;
+}
+
+int perf_enter(JCC *vm, VMInsn *insn) {
+    (void)vm;
+    (void)insn;
+    return -1;
+}
+
+#endif
+
+void perf_free(JCC *vm) {
+    PerfState *st = vm->perf_state;
+    if (!st)
+        return;
+    // The map and the dump stay behind for perf report
+    if (st->map)
+        fclose(st->map);
+    if (st->marker)
+        munmap(st->marker, st->marker_size);
+    if (st->dump)
+        fclose(st->dump);
+    if (st->tramp_code)
+        munmap(st->tramp_code, st->tramp_size);
+    free(st->tramp);
+    free(st->symbols);
+    free(st);
+    vm->perf_state = NULL;
+}
+
+#else
+
+// perf is Linux-only
+
+void perf_code_load(JCC *vm, VMInsn *fn, const char *kind, const void *code,
+                    size_t size) {
+    (void)fn;
+    (void)kind;
+    (void)code;
+    (void)size;
+    if (vm->perf) {
+        fprintf(stderr, "warning: --perf-map, --perf-jitdump and "
+                        "--perf-trampolines need Linux\n");
+        vm->perf = 0;
+    }
+}
+
+int perf_trampoline(JCC *vm, VMInsn *insn) {
+    perf_code_load(vm, insn, NULL, NULL, 0);
+    return 0;
+}
+
+int perf_enter(JCC *vm, VMInsn *insn) {
+    (void)vm;
+    (void)insn;
+    return -1;
+}
+
+void perf_free(JCC *vm) {
+    (void)vm;
+}
+
+#endif
@@ -707,6 +707,8 @@ Obj *ast_function(JCC *vm, const char *name, Type *return_type) {
     sc->var = fn;
     sc->next = vm->compiler.scope->vars;
     vm->compiler.scope->vars = sc;
+    if (!vm->compiler.scope->next)
+        hashmap_put2(&vm->compiler.scope->index, sc->name, sc->name_len, sc);
 
     return fn;
 }
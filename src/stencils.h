@@ -0,0 +1,1631 @@
+/* Auto-generated by stencils.py - DO NOT EDIT */
+/* Source: src/stencils/stencils.c, 107 stencils */
+
+// Layout the stencils were compiled against: the size of VMInsn and the
+// offset of every JCC field they access
+#define STENCIL_INSN_SIZE 32
+#define STENCIL_FIELDS_X \
+    X(bp, 520) \
+    X(debug_vm, 1044) \
+    X(flags, 1052) \
+    X(fregs, 256) \
+    X(initial_sp, 560) \
+    X(pc, 512) \
+    X(poolsize, 1040) \
+    X(quiet_faults, 1048) \
+    X(regs, 0) \
+    X(sp, 528) \
+    X(stack_canary, 1056) \
+    X(text_seg, 576)
+
+// What goes into a hole: a value of the instruction, an address in
+// stencil_data, or the address of entry kind - HOLE_SYMBOL of STENCIL_SYMBOLS_X
+enum {
+    HOLE_CONTINUE,
+    HOLE_TARGET,
+    HOLE_RD,
+    HOLE_RS1,
+    HOLE_RS2,
+    HOLE_IMM,
+    HOLE_CMP_IMM,
+    HOLE_PC,
+    HOLE_CALLEE,
+    HOLE_COUNTER,
+    HOLE_INSN,
+    HOLE_DATA,
+    HOLE_SYMBOL,
+};
+
+#define STENCIL_SYMBOLS_X \
+    X(puts) \
+    X(printf) \
+    X(memmove) \
+    X(op_MALC_fn) \
+    X(op_MFRE_fn) \
+    X(op_REALC_fn) \
+    X(op_CALC_fn) \
+    X(op_CALLF_fn) \
+    X(jit_call) \
+    X(jit_promote)
+
+typedef struct {
+    int offset;         // Byte offset of the 64-bit field in code
+    int kind;           // HOLE_*
+    long long addend;   // Added to the value
+} StencilHole;
+
+typedef struct {
+    const unsigned char *code;
+    int size;           // Bytes of code
+    int trim;           // Bytes of a trailing jump to HOLE_CONTINUE, 0 if none
+    const StencilHole *holes;
+    int nholes;
+} Stencil;
+
+static const unsigned char stencil_data[] __attribute__((aligned(16))) = {
+    0x0a, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x20,
+    0x44, 0x49, 0x56, 0x49, 0x53, 0x49, 0x4f, 0x4e, 0x20, 0x42, 0x59, 0x20,
+    0x5a, 0x45, 0x52, 0x4f, 0x20, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x3d, 0x3d, 0x00, 0x50, 0x43, 0x3a, 0x20, 0x20, 0x20, 0x20, 0x20,
+    0x20, 0x20, 0x30, 0x78, 0x25, 0x6c, 0x6c, 0x78, 0x20, 0x28, 0x6f, 0x66,
+    0x66, 0x73, 0x65, 0x74, 0x3a, 0x20, 0x25, 0x6c, 0x6c, 0x64, 0x29, 0x0a,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x00, 0x00,
+    0x0a, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x20,
+    0x49, 0x4e, 0x54, 0x45, 0x47, 0x45, 0x52, 0x20, 0x4f, 0x56, 0x45, 0x52,
+    0x46, 0x4c, 0x4f, 0x57, 0x20, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x3d, 0x3d, 0x00, 0x52, 0x65, 0x73, 0x75, 0x6c, 0x74, 0x20, 0x77,
+    0x6f, 0x75, 0x6c, 0x64, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x66, 0x6c, 0x6f,
+    0x77, 0x20, 0x28, 0x4c, 0x4c, 0x4f, 0x4e, 0x47, 0x5f, 0x4d, 0x49, 0x4e,
+    0x20, 0x2f, 0x20, 0x2d, 0x31, 0x20, 0x3d, 0x20, 0x4c, 0x4c, 0x4f, 0x4e,
+    0x47, 0x5f, 0x4d, 0x41, 0x58, 0x20, 0x2b, 0x20, 0x31, 0x29, 0x00, 0x41,
+    0x74, 0x74, 0x65, 0x6d, 0x70, 0x74, 0x65, 0x64, 0x20, 0x64, 0x69, 0x76,
+    0x69, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x62, 0x79, 0x20, 0x7a, 0x65, 0x72,
+    0x6f, 0x00, 0x4f, 0x70, 0x65, 0x72, 0x61, 0x6e, 0x64, 0x73, 0x3a, 0x20,
+    0x25, 0x6c, 0x6c, 0x64, 0x20, 0x2f, 0x20, 0x30, 0x0a, 0x00, 0x44, 0x69,
+    0x76, 0x69, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x6f, 0x76, 0x65, 0x72, 0x66,
+    0x6c, 0x6f, 0x77, 0x20, 0x64, 0x65, 0x74, 0x65, 0x63, 0x74, 0x65, 0x64,
+    0x00, 0x4f, 0x70, 0x65, 0x72, 0x61, 0x6e, 0x64, 0x73, 0x3a, 0x20, 0x25,
+    0x6c, 0x6c, 0x64, 0x20, 0x2f, 0x20, 0x25, 0x6c, 0x6c, 0x64, 0x0a, 0x00,
+    0x0a, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x20,
+    0x4d, 0x4f, 0x44, 0x55, 0x4c, 0x4f, 0x20, 0x42, 0x59, 0x20, 0x5a, 0x45,
+    0x52, 0x4f, 0x20, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d, 0x3d,
+    0x3d, 0x00, 0x41, 0x74, 0x74, 0x65, 0x6d, 0x70, 0x74, 0x65, 0x64, 0x20,
+    0x6d, 0x6f, 0x64, 0x75, 0x6c, 0x6f, 0x20, 0x62, 0x79, 0x20, 0x7a, 0x65,
+    0x72, 0x6f, 0x00, 0x4f, 0x70, 0x65, 0x72, 0x61, 0x6e, 0x64, 0x73, 0x3a,
+    0x20, 0x25, 0x6c, 0x6c, 0x64, 0x20, 0x25, 0x25, 0x20, 0x30, 0x0a, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x46, 0x6c, 0x6f, 0x61, 0x74, 0x69, 0x6e, 0x67,
+    0x2d, 0x70, 0x6f, 0x69, 0x6e, 0x74, 0x20, 0x64, 0x69, 0x76, 0x69, 0x73,
+    0x69, 0x6f, 0x6e, 0x20, 0x62, 0x79, 0x20, 0x7a, 0x65, 0x72, 0x6f, 0x20,
+    0x64, 0x65, 0x74, 0x65, 0x63, 0x74, 0x65, 0x64, 0x21, 0x00, 0x50, 0x43,
+    0x20, 0x6f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x3a, 0x20, 0x25, 0x6c, 0x6c,
+    0x64, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const unsigned char stencil_code_ADD3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0c, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x03, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ADD3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {49, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SUB3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0c, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x2b, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SUB3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {49, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MUL3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0d, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x0f, 0xaf, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MUL3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {50, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_DIV3[] = {
+    0x41, 0x57, 0x41, 0x56, 0x41, 0x55, 0x49, 0x89, 0xf5, 0x41, 0x54, 0x49,
+    0x89, 0xd4, 0x55, 0x53, 0x48, 0x89, 0xfb, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83, 0xec, 0x08, 0x48, 0x8b, 0x2c,
+    0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48,
+    0x8b, 0x0c, 0xc7, 0x48, 0x85, 0xc9, 0x0f, 0x84, 0x9c, 0x00, 0x00, 0x00,
+    0x49, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x4c, 0x39,
+    0xf5, 0x75, 0x06, 0x48, 0x83, 0xf9, 0xff, 0x74, 0x3f, 0x48, 0xbe, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xf6, 0x74, 0x0c,
+    0x48, 0x89, 0xe8, 0x48, 0x99, 0x48, 0xf7, 0xf9, 0x48, 0x89, 0x04, 0xf3,
+    0x48, 0x83, 0xc4, 0x08, 0x4c, 0x89, 0xe2, 0x4c, 0x89, 0xee, 0x48, 0x89,
+    0xdf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5b,
+    0x5d, 0x41, 0x5c, 0x41, 0x5d, 0x41, 0x5e, 0x41, 0x5f, 0xff, 0xe0, 0x90,
+    0x8b, 0xbf, 0x18, 0x04, 0x00, 0x00, 0x85, 0xff, 0x0f, 0x84, 0xf9, 0x00,
+    0x00, 0x00, 0x4c, 0x89, 0xab, 0x10, 0x02, 0x00, 0x00, 0x4c, 0x89, 0xa3,
+    0x08, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0x83, 0x00, 0x02, 0x00, 0x00, 0x48, 0x83, 0xc4,
+    0x08, 0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x5b, 0x5d, 0x41, 0x5c,
+    0x41, 0x5d, 0x41, 0x5e, 0x41, 0x5f, 0xc3, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x44, 0x8b, 0xb7, 0x18, 0x04, 0x00, 0x00, 0x45, 0x85, 0xf6, 0x75, 0xba,
+    0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xbf,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd7, 0x44,
+    0x8b, 0x9b, 0x18, 0x04, 0x00, 0x00, 0x45, 0x85, 0xdb, 0x75, 0x97, 0x48,
+    0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd7,
+    0x44, 0x8b, 0x93, 0x18, 0x04, 0x00, 0x00, 0x45, 0x85, 0xd2, 0x0f, 0x85,
+    0x7a, 0xff, 0xff, 0xff, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0xee, 0x31, 0xc0, 0x48, 0xbd, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xd5, 0x44, 0x8b, 0x8b, 0x18, 0x04,
+    0x00, 0x00, 0x45, 0x85, 0xc9, 0x0f, 0x85, 0x4f, 0xff, 0xff, 0xff, 0x48,
+    0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xbf, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0xf2, 0x31, 0xc0,
+    0x48, 0x2b, 0x93, 0x40, 0x02, 0x00, 0x00, 0x48, 0xc1, 0xfa, 0x03, 0xff,
+    0xd5, 0x44, 0x8b, 0x83, 0x18, 0x04, 0x00, 0x00, 0x45, 0x85, 0xc0, 0x0f,
+    0x85, 0x19, 0xff, 0xff, 0xff, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x41, 0xff, 0xd7, 0xe9, 0x07, 0xff, 0xff, 0xff, 0x48,
+    0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xbf, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd7, 0x8b, 0xb3,
+    0x18, 0x04, 0x00, 0x00, 0x85, 0xf6, 0x0f, 0x85, 0xe2, 0xfe, 0xff, 0xff,
+    0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff,
+    0xd7, 0x8b, 0x8b, 0x18, 0x04, 0x00, 0x00, 0x85, 0xc9, 0x0f, 0x85, 0xc7,
+    0xfe, 0xff, 0xff, 0x48, 0xc7, 0xc2, 0xff, 0xff, 0xff, 0xff, 0x4c, 0x89,
+    0xf6, 0x31, 0xc0, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x48, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xd5, 0x8b, 0x93, 0x18, 0x04, 0x00, 0x00, 0x85, 0xd2, 0x0f, 0x85, 0x97,
+    0xfe, 0xff, 0xff, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x41, 0xff, 0xd7, 0x8b, 0x83, 0x18, 0x04, 0x00, 0x00, 0x85, 0xc0,
+    0x0f, 0x84, 0x2d, 0xff, 0xff, 0xff, 0xe9, 0x77, 0xfe, 0xff, 0xff,
+};
+static const StencilHole stencil_holes_DIV3[] = {
+    {21, HOLE_RS1, 0},
+    {39, HOLE_RS2, 0},
+    {83, HOLE_RD, 0},
+    {123, HOLE_CONTINUE, 0},
+    {174, HOLE_PC, 0},
+    {230, HOLE_DATA, 0},
+    {240, HOLE_SYMBOL + 0, 0},
+    {265, HOLE_DATA, 215},
+    {294, HOLE_DATA, 242},
+    {309, HOLE_SYMBOL + 1, 0},
+    {337, HOLE_PC, 0},
+    {347, HOLE_DATA, 40},
+    {391, HOLE_DATA, 80},
+    {409, HOLE_DATA, 120},
+    {419, HOLE_SYMBOL + 0, 0},
+    {446, HOLE_DATA, 262},
+    {485, HOLE_DATA, 289},
+    {495, HOLE_SYMBOL + 1, 0},
+    {521, HOLE_DATA, 160},
+};
+static const unsigned char stencil_code_MOD3[] = {
+    0x41, 0x56, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x41, 0x55, 0x49, 0x89, 0xf5, 0x41, 0x54, 0x49, 0x89, 0xd4, 0x55, 0x53,
+    0x48, 0x8b, 0x2c, 0xc7, 0x48, 0x89, 0xfb, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x0c, 0xc7, 0x48, 0x85, 0xc9,
+    0x74, 0x3e, 0x48, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x85, 0xf6, 0x74, 0x0c, 0x48, 0x89, 0xe8, 0x48, 0x99, 0x48, 0xf7,
+    0xf9, 0x48, 0x89, 0x14, 0xf7, 0x4c, 0x89, 0xe2, 0x4c, 0x89, 0xee, 0x48,
+    0x89, 0xdf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0x41, 0x5e, 0xff, 0xe0, 0x66, 0x0f,
+    0x1f, 0x44, 0x00, 0x00, 0x8b, 0xbf, 0x18, 0x04, 0x00, 0x00, 0x85, 0xff,
+    0x74, 0x2f, 0x4c, 0x89, 0xab, 0x10, 0x02, 0x00, 0x00, 0x4c, 0x89, 0xa3,
+    0x08, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0x83, 0x00, 0x02, 0x00, 0x00, 0x48, 0xc7, 0xc0,
+    0xff, 0xff, 0xff, 0xff, 0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0x41, 0x5e,
+    0xc3, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49,
+    0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd6,
+    0x8b, 0xb3, 0x18, 0x04, 0x00, 0x00, 0x85, 0xf6, 0x75, 0xb0, 0x48, 0xbf,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd6, 0x8b,
+    0x8b, 0x18, 0x04, 0x00, 0x00, 0x85, 0xc9, 0x75, 0x99, 0x48, 0xbf, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0xee, 0x31, 0xc0,
+    0x48, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xd5,
+    0x8b, 0x93, 0x18, 0x04, 0x00, 0x00, 0x85, 0xd2, 0x0f, 0x85, 0x70, 0xff,
+    0xff, 0xff, 0x48, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89,
+    0xf2, 0x31, 0xc0, 0x48, 0x2b, 0x93, 0x40, 0x02, 0x00, 0x00, 0x48, 0xc1,
+    0xfa, 0x03, 0xff, 0xd5, 0x8b, 0x83, 0x18, 0x04, 0x00, 0x00, 0x85, 0xc0,
+    0x0f, 0x85, 0x3c, 0xff, 0xff, 0xff, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd6, 0xe9, 0x2a, 0xff, 0xff, 0xff,
+};
+static const StencilHole stencil_holes_MOD3[] = {
+    {4, HOLE_RS1, 0},
+    {33, HOLE_RS2, 0},
+    {52, HOLE_RD, 0},
+    {88, HOLE_CONTINUE, 0},
+    {138, HOLE_PC, 0},
+    {171, HOLE_DATA, 312},
+    {181, HOLE_SYMBOL + 0, 0},
+    {204, HOLE_DATA, 350},
+    {227, HOLE_DATA, 375},
+    {242, HOLE_SYMBOL + 1, 0},
+    {268, HOLE_PC, 0},
+    {278, HOLE_DATA, 40},
+    {320, HOLE_DATA, 80},
+};
+static const unsigned char stencil_code_AND3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0c, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x23, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_AND3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {49, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_OR3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0c, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x0b, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_OR3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {49, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_XOR3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0c, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x33, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_XOR3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {49, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SHL3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0f, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4e, 0x8b, 0x04, 0xc7, 0x49, 0xd3, 0xe0, 0x4c, 0x89,
+    0x04, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SHL3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {52, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SHR3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0f, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4e, 0x8b, 0x04, 0xc7, 0x49, 0xd3, 0xf8, 0x4c, 0x89,
+    0x04, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SHR3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {52, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SEQ3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x12, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x39, 0x0c, 0xc7, 0x0f, 0x94, 0xc1, 0x0f, 0xb6,
+    0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SEQ3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {55, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SNE3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x12, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x39, 0x0c, 0xc7, 0x0f, 0x95, 0xc1, 0x0f, 0xb6,
+    0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SNE3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {55, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SLT3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x12, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x39, 0x0c, 0xc7, 0x0f, 0x9c, 0xc1, 0x0f, 0xb6,
+    0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SLT3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {55, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SGE3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x12, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x39, 0x0c, 0xc7, 0x0f, 0x9d, 0xc1, 0x0f, 0xb6,
+    0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SGE3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {55, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SGT3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x12, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x39, 0x0c, 0xc7, 0x0f, 0x9f, 0xc1, 0x0f, 0xb6,
+    0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SGT3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {55, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SLE3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x12, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4a, 0x39, 0x0c, 0xc7, 0x0f, 0x9e, 0xc1, 0x0f, 0xb6,
+    0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SLE3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {22, HOLE_RD, 0},
+    {55, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LI3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85,
+    0xc0, 0x74, 0x0e, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_LI3[] = {
+    {2, HOLE_RD, 0},
+    {17, HOLE_IMM, 0},
+    {31, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MOV3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x08, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MOV3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {35, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_NEG3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0b, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0xf7, 0xd9, 0x48, 0x89, 0x0c, 0xc7,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_NEG3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {38, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_NOT3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0f, 0x48, 0x83, 0x3c, 0xcf, 0x00, 0x0f, 0x94, 0xc1, 0x0f, 0xb6, 0xc9,
+    0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_NOT3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {42, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_BNOT3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0b, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0xf7, 0xd1, 0x48, 0x89, 0x0c, 0xc7,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BNOT3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {38, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ADDI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x08, 0x4a,
+    0x03, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ADDI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_IMM, 0},
+    {22, HOLE_RD, 0},
+    {45, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SUBI3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x0b, 0x48,
+    0x8b, 0x0c, 0xcf, 0x4c, 0x29, 0xc1, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SUBI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_IMM, 0},
+    {22, HOLE_RD, 0},
+    {48, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MULI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74, 0x09, 0x4a,
+    0x0f, 0xaf, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MULI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_IMM, 0},
+    {22, HOLE_RD, 0},
+    {46, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ANDI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x12, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a,
+    0x23, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ANDI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {27, HOLE_IMM, 0},
+    {45, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ORI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x12, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a,
+    0x0b, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ORI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {27, HOLE_IMM, 0},
+    {45, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_XORI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x12, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a,
+    0x33, 0x0c, 0xc7, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_XORI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {27, HOLE_IMM, 0},
+    {45, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SHLI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x15, 0x4e, 0x8b, 0x04, 0xc7, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x49, 0xd3, 0xe0, 0x4c, 0x89, 0x04, 0xc7, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SHLI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {31, HOLE_IMM, 0},
+    {48, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SHRI3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x15, 0x4e, 0x8b, 0x04, 0xc7, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x49, 0xd3, 0xf8, 0x4c, 0x89, 0x04, 0xc7, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SHRI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {31, HOLE_IMM, 0},
+    {48, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SLTI3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x18, 0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4c,
+    0x39, 0x04, 0xcf, 0x0f, 0x9c, 0xc1, 0x0f, 0xb6, 0xc9, 0x48, 0x89, 0x0c,
+    0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0,
+};
+static const StencilHole stencil_holes_SLTI3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {27, HOLE_IMM, 0},
+    {51, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LEA3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85,
+    0xc0, 0x74, 0x12, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x48, 0x8d, 0x0c, 0xca, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_LEA3[] = {
+    {2, HOLE_RD, 0},
+    {17, HOLE_IMM, 0},
+    {35, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ENT3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85,
+    0xc0, 0x74, 0x11, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xe0, 0x0f, 0x1f, 0x44, 0x00, 0x00, 0x4c, 0x8d, 0x56, 0xf8,
+    0x48, 0x89, 0x56, 0xf8, 0x48, 0x83, 0xee, 0x10, 0x4d, 0x89, 0xd3, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xc1, 0xe0,
+    0x03, 0x49, 0x29, 0xc3, 0x49, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x4d, 0x85, 0xc9, 0x0f, 0x8e, 0x7d, 0x00, 0x00, 0x00, 0x55,
+    0x31, 0xc9, 0x45, 0x31, 0xc0, 0x31, 0xd2, 0x53, 0xbb, 0x01, 0x00, 0x00,
+    0x00, 0x48, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xeb,
+    0x22, 0x0f, 0x1f, 0x00, 0x48, 0x63, 0xc2, 0x48, 0x83, 0xc1, 0x01, 0x83,
+    0xc2, 0x01, 0x48, 0x83, 0xee, 0x08, 0x48, 0x8b, 0x84, 0xc7, 0x50, 0x01,
+    0x00, 0x00, 0x48, 0x89, 0x46, 0x08, 0x49, 0x39, 0xc9, 0x7e, 0x2a, 0x89,
+    0xd8, 0xd3, 0xe0, 0x48, 0x98, 0x48, 0x85, 0xe8, 0x75, 0xd6, 0x41, 0x8d,
+    0x40, 0x0a, 0x48, 0x83, 0xc1, 0x01, 0x41, 0x83, 0xc0, 0x01, 0x48, 0x83,
+    0xee, 0x08, 0x48, 0x98, 0x48, 0x8b, 0x04, 0xc7, 0x48, 0x89, 0x46, 0x08,
+    0x49, 0x39, 0xc9, 0x7f, 0xd6, 0x5b, 0x4c, 0x89, 0xd2, 0x4c, 0x89, 0xde,
+    0x5d, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0, 0x0f, 0x1f, 0x00, 0x4c, 0x89, 0xd2, 0x4c, 0x89, 0xde, 0xe9, 0x34,
+    0xff, 0xff, 0xff,
+};
+static const StencilHole stencil_holes_ENT3[] = {
+    {2, HOLE_RS2, 0},
+    {17, HOLE_CONTINUE, 0},
+    {49, HOLE_IMM, 0},
+    {66, HOLE_RD, 0},
+    {99, HOLE_RS1, 0},
+    {195, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ADJ[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8d,
+    0x34, 0xc6, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ADJ[] = {
+    {2, HOLE_IMM, 0},
+    {16, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_PSH3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b,
+    0x04, 0xc7, 0x48, 0x83, 0xee, 0x08, 0x48, 0x89, 0x06, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_PSH3[] = {
+    {2, HOLE_RD, 0},
+    {23, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_POP3[] = {
+    0x48, 0x8b, 0x0e, 0x48, 0x83, 0xc6, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_POP3[] = {
+    {9, HOLE_RD, 0},
+    {23, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LDR_B[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0c, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0x0f, 0xbe, 0x09, 0x48, 0x89, 0x0c,
+    0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0,
+};
+static const StencilHole stencil_holes_LDR_B[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {39, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LDR_H[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0c, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0x0f, 0xbf, 0x09, 0x48, 0x89, 0x0c,
+    0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0,
+};
+static const StencilHole stencil_holes_LDR_H[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {39, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LDR_W[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0b, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0x63, 0x09, 0x48, 0x89, 0x0c, 0xc7,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_LDR_W[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {38, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LDR_D[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85, 0xc0, 0x74,
+    0x0b, 0x48, 0x8b, 0x0c, 0xcf, 0x48, 0x8b, 0x09, 0x48, 0x89, 0x0c, 0xc7,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_LDR_D[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {38, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_STR_B[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x0c, 0xcf,
+    0x48, 0x8b, 0x04, 0xc7, 0x88, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_STR_B[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {32, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_STR_H[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x0c, 0xcf,
+    0x48, 0x8b, 0x04, 0xc7, 0x66, 0x89, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_STR_H[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {33, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_STR_W[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x0c, 0xcf,
+    0x48, 0x8b, 0x04, 0xc7, 0x89, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_STR_W[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {32, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_STR_D[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x0c, 0xcf,
+    0x48, 0x8b, 0x04, 0xc7, 0x48, 0x89, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_STR_D[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {33, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_BCPY[] = {
+    0x41, 0x54, 0x49, 0x89, 0xd4, 0x55, 0x48, 0x89, 0xf5, 0x53, 0x48, 0x89,
+    0xfb, 0x48, 0xba, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48,
+    0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x34, 0xcf, 0x48,
+    0x8b, 0x3c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xd0, 0x4c, 0x89, 0xe2, 0x48, 0x89, 0xee, 0x48, 0x89, 0xdf,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d,
+    0x41, 0x5c, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BCPY[] = {
+    {15, HOLE_IMM, 0},
+    {25, HOLE_RS1, 0},
+    {35, HOLE_RD, 0},
+    {53, HOLE_SYMBOL + 2, 0},
+    {74, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FLDR[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b,
+    0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xf2, 0x0f, 0x10, 0x01, 0xf2, 0x0f, 0x11, 0x84, 0xc7, 0x00, 0x01, 0x00,
+    0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0,
+};
+static const StencilHole stencil_holes_FLDR[] = {
+    {2, HOLE_RS1, 0},
+    {16, HOLE_RD, 0},
+    {39, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FSTR[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f, 0x10, 0x84,
+    0xcf, 0x00, 0x01, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7, 0xf2, 0x0f, 0x11,
+    0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0,
+};
+static const StencilHole stencil_holes_FSTR[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {39, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FLI[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0x8c, 0xc7,
+    0x00, 0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FLI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_IMM, 0},
+    {30, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FADD3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10,
+    0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0xf2, 0x0f, 0x58, 0x84, 0xcf, 0x00,
+    0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xf2, 0x0f, 0x11, 0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FADD3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {41, HOLE_RD, 0},
+    {60, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FSUB3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10,
+    0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0xf2, 0x0f, 0x5c, 0x84, 0xcf, 0x00,
+    0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xf2, 0x0f, 0x11, 0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FSUB3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {41, HOLE_RD, 0},
+    {60, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FMUL3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10,
+    0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0xf2, 0x0f, 0x59, 0x84, 0xcf, 0x00,
+    0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xf2, 0x0f, 0x11, 0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FMUL3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {41, HOLE_RD, 0},
+    {60, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FDIV3[] = {
+    0x41, 0x54, 0x66, 0x0f, 0xef, 0xc0, 0x55, 0x48, 0x89, 0xf5, 0x53, 0x48,
+    0x89, 0xfb, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x83, 0xec, 0x10, 0x66, 0x0f, 0x2e, 0x84, 0xc7, 0x00, 0x01, 0x00,
+    0x00, 0x7a, 0x02, 0x74, 0x57, 0x48, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xf2, 0x0f, 0x10, 0x84, 0xf3, 0x00, 0x01, 0x00, 0x00, 0x48, 0x89,
+    0xdf, 0x48, 0x89, 0xee, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xf2, 0x0f, 0x5e, 0x84, 0xcb, 0x00, 0x01, 0x00, 0x00, 0xf2,
+    0x0f, 0x11, 0x84, 0xc3, 0x00, 0x01, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x10,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d,
+    0x41, 0x5c, 0xff, 0xe0, 0x0f, 0x1f, 0x40, 0x00, 0x8b, 0xb7, 0x18, 0x04,
+    0x00, 0x00, 0x85, 0xf6, 0x74, 0x2f, 0x48, 0x89, 0xab, 0x10, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0x93, 0x08, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0x83, 0x00, 0x02, 0x00,
+    0x00, 0x48, 0x83, 0xc4, 0x10, 0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff,
+    0x5b, 0x5d, 0x41, 0x5c, 0xc3, 0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x48, 0x89, 0x54, 0x24, 0x08, 0x49, 0xbc, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd4, 0x8b, 0x8b, 0x18,
+    0x04, 0x00, 0x00, 0x48, 0x8b, 0x54, 0x24, 0x08, 0x85, 0xc9, 0x75, 0xa6,
+    0x48, 0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff,
+    0xd4, 0x8b, 0x93, 0x18, 0x04, 0x00, 0x00, 0x85, 0xd2, 0x48, 0x8b, 0x54,
+    0x24, 0x08, 0x75, 0x8a, 0x48, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x2b, 0xb3, 0x40, 0x02, 0x00, 0x00, 0x31, 0xc0, 0x48,
+    0xbf, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xc1, 0xfe, 0x03, 0xff,
+    0xd1, 0x8b, 0x83, 0x18, 0x04, 0x00, 0x00, 0x48, 0x8b, 0x54, 0x24, 0x08,
+    0x85, 0xc0, 0x0f, 0x85, 0x4a, 0xff, 0xff, 0xff, 0x48, 0xbf, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0xff, 0xd4, 0x48, 0x8b, 0x54,
+    0x24, 0x08, 0xe9, 0x33, 0xff, 0xff, 0xff,
+};
+static const StencilHole stencil_holes_FDIV3[] = {
+    {16, HOLE_RS2, 0},
+    {43, HOLE_RS1, 0},
+    {53, HOLE_RD, 0},
+    {78, HOLE_RS2, 0},
+    {110, HOLE_CONTINUE, 0},
+    {154, HOLE_PC, 0},
+    {187, HOLE_DATA, 0},
+    {202, HOLE_SYMBOL + 0, 0},
+    {230, HOLE_DATA, 400},
+    {258, HOLE_PC, 0},
+    {277, HOLE_DATA, 442},
+    {287, HOLE_SYMBOL + 1, 0},
+    {322, HOLE_DATA, 80},
+};
+static const unsigned char stencil_code_FNEG3[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f,
+    0x10, 0x84, 0xcf, 0x00, 0x01, 0x00, 0x00, 0x48, 0xb9, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0x0f, 0x57, 0x01, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f, 0x11, 0x84, 0xc7,
+    0x00, 0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FNEG3[] = {
+    {2, HOLE_RS1, 0},
+    {21, HOLE_DATA, 464},
+    {35, HOLE_RD, 0},
+    {54, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FEQ3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10,
+    0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x41, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0x0f,
+    0x2e, 0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x0f, 0x9b, 0xc0, 0x0f, 0xb6,
+    0xc0, 0x49, 0x0f, 0x45, 0xc0, 0x48, 0x89, 0x04, 0xcf, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FEQ3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {38, HOLE_RD, 0},
+    {71, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FNE3[] = {
+    0x49, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10,
+    0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x41, 0xb8, 0x01, 0x00, 0x00, 0x00,
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x66, 0x0f,
+    0x2e, 0x84, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x0f, 0x9a, 0xc0, 0x0f, 0xb6,
+    0xc0, 0x49, 0x0f, 0x45, 0xc0, 0x48, 0x89, 0x04, 0xcf, 0x48, 0xb8, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FNE3[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RS2, 0},
+    {38, HOLE_RD, 0},
+    {71, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FLT3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10, 0x84, 0xc7,
+    0x00, 0x01, 0x00, 0x00, 0x66, 0x0f, 0x2f, 0x84, 0xcf, 0x00, 0x01, 0x00,
+    0x00, 0x0f, 0x97, 0xc1, 0x0f, 0xb6, 0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FLT3[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {22, HOLE_RS2, 0},
+    {61, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FLE3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10, 0x84, 0xc7,
+    0x00, 0x01, 0x00, 0x00, 0x66, 0x0f, 0x2f, 0x84, 0xcf, 0x00, 0x01, 0x00,
+    0x00, 0x0f, 0x93, 0xc1, 0x0f, 0xb6, 0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FLE3[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {22, HOLE_RS2, 0},
+    {61, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FGT3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10, 0x84, 0xc7,
+    0x00, 0x01, 0x00, 0x00, 0x66, 0x0f, 0x2f, 0x84, 0xcf, 0x00, 0x01, 0x00,
+    0x00, 0x0f, 0x97, 0xc1, 0x0f, 0xb6, 0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FGT3[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {22, HOLE_RS2, 0},
+    {61, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FGE3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x49, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x42, 0x0f, 0x10, 0x84, 0xc7,
+    0x00, 0x01, 0x00, 0x00, 0x66, 0x0f, 0x2f, 0x84, 0xcf, 0x00, 0x01, 0x00,
+    0x00, 0x0f, 0x93, 0xc1, 0x0f, 0xb6, 0xc9, 0x48, 0x89, 0x0c, 0xc7, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_FGE3[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_RS1, 0},
+    {22, HOLE_RS2, 0},
+    {61, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_I2F3[] = {
+    0x66, 0x0f, 0xef, 0xc0, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xf2, 0x48, 0x0f, 0x2a, 0x04, 0xcf, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x0f, 0x11, 0x84, 0xc7, 0x00,
+    0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_I2F3[] = {
+    {6, HOLE_RS1, 0},
+    {22, HOLE_RD, 0},
+    {41, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_F2I3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85,
+    0xc0, 0x74, 0x18, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xf2, 0x48, 0x0f, 0x2c, 0x8c, 0xcf, 0x00, 0x01, 0x00, 0x00, 0x48,
+    0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_F2I3[] = {
+    {2, HOLE_RD, 0},
+    {17, HOLE_RS1, 0},
+    {41, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_FR2R[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x85,
+    0xc0, 0x74, 0x16, 0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x48, 0x8b, 0x8c, 0xcf, 0x00, 0x01, 0x00, 0x00, 0x48, 0x89, 0x0c,
+    0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff,
+    0xe0,
+};
+static const StencilHole stencil_holes_FR2R[] = {
+    {2, HOLE_RD, 0},
+    {17, HOLE_RS1, 0},
+    {39, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_R2FR[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b,
+    0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x89, 0x8c, 0xc7, 0x00, 0x01, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_R2FR[] = {
+    {2, HOLE_RS1, 0},
+    {16, HOLE_RD, 0},
+    {34, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SX1[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x0f,
+    0xbe, 0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SX1[] = {
+    {2, HOLE_RS1, 0},
+    {17, HOLE_RD, 0},
+    {31, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SX2[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x0f,
+    0xbf, 0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SX2[] = {
+    {2, HOLE_RS1, 0},
+    {17, HOLE_RD, 0},
+    {31, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SX4[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x63,
+    0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SX4[] = {
+    {2, HOLE_RS1, 0},
+    {16, HOLE_RD, 0},
+    {30, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ZX1[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xb6,
+    0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ZX1[] = {
+    {2, HOLE_RS1, 0},
+    {16, HOLE_RD, 0},
+    {30, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ZX2[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0f, 0xb7,
+    0x0c, 0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ZX2[] = {
+    {2, HOLE_RS1, 0},
+    {16, HOLE_RD, 0},
+    {30, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_ZX4[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x8b, 0x0c,
+    0xcf, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48,
+    0x89, 0x0c, 0xc7, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_ZX4[] = {
+    {2, HOLE_RS1, 0},
+    {15, HOLE_RD, 0},
+    {29, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_JZ3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83,
+    0x3c, 0xc7, 0x00, 0x74, 0x0f, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0, 0x0f, 0x1f, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_JZ3[] = {
+    {2, HOLE_RD, 0},
+    {19, HOLE_CONTINUE, 0},
+    {34, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_JNZ3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x83,
+    0x3c, 0xc7, 0x00, 0x75, 0x0f, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0xff, 0xe0, 0x0f, 0x1f, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_JNZ3[] = {
+    {2, HOLE_RD, 0},
+    {19, HOLE_CONTINUE, 0},
+    {34, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BEQ[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7,
+    0x48, 0x39, 0x04, 0xcf, 0x74, 0x12, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0, 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BEQ[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {32, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BNE[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7,
+    0x48, 0x39, 0x04, 0xcf, 0x74, 0x12, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0, 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BNE[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {32, HOLE_TARGET, 0},
+    {50, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_BLT[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7,
+    0x48, 0x39, 0x04, 0xcf, 0x7c, 0x12, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0, 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BLT[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {32, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BGE[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7,
+    0x48, 0x39, 0x04, 0xcf, 0x7d, 0x12, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0, 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BGE[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {32, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BLTU[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7,
+    0x48, 0x39, 0x04, 0xcf, 0x72, 0x12, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0, 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BLTU[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {32, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BGEU[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb9,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x04, 0xc7,
+    0x48, 0x39, 0x04, 0xcf, 0x73, 0x12, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0xff, 0xe0, 0x66, 0x0f, 0x1f, 0x44, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BGEU[] = {
+    {2, HOLE_RS1, 0},
+    {12, HOLE_RD, 0},
+    {32, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BEQI[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0x04, 0xcf,
+    0x74, 0x16, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BEQI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_CMP_IMM, 0},
+    {28, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BNEI[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0x04, 0xcf,
+    0x74, 0x16, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BNEI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_CMP_IMM, 0},
+    {28, HOLE_TARGET, 0},
+    {50, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_BLTI[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0x04, 0xcf,
+    0x7c, 0x16, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BLTI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_CMP_IMM, 0},
+    {28, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BGEI[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0x04, 0xcf,
+    0x7d, 0x16, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BGEI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_CMP_IMM, 0},
+    {28, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BLTUI[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0x04, 0xcf,
+    0x72, 0x16, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BLTUI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_CMP_IMM, 0},
+    {28, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_BGEUI[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x39, 0x04, 0xcf,
+    0x73, 0x16, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0xff, 0xe0, 0x66, 0x2e, 0x0f, 0x1f, 0x84, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_BGEUI[] = {
+    {2, HOLE_RD, 0},
+    {12, HOLE_CMP_IMM, 0},
+    {28, HOLE_CONTINUE, 0},
+    {50, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_JMP[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_JMP[] = {
+    {2, HOLE_TARGET, 0},
+};
+static const unsigned char stencil_code_MALC[] = {
+    0x41, 0x55, 0x41, 0x54, 0x49, 0x89, 0xf4, 0x55, 0x48, 0x89, 0xd5, 0x53,
+    0x48, 0x89, 0xfb, 0x49, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x8d, 0x45, 0x08, 0x48, 0x83, 0xec, 0x08, 0x48, 0x89, 0x87,
+    0x00, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x97,
+    0x08, 0x02, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0, 0x75, 0x2a, 0x48, 0x8b,
+    0x93, 0x08, 0x02, 0x00, 0x00, 0x48, 0x89, 0xdf, 0x48, 0x8b, 0xb3, 0x10,
+    0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xff,
+    0xe0, 0x0f, 0x1f, 0x00, 0x4c, 0x89, 0xab, 0x00, 0x02, 0x00, 0x00, 0x48,
+    0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x4c, 0x89, 0xa3, 0x10, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0xab, 0x08, 0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08,
+    0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xc3,
+};
+static const StencilHole stencil_holes_MALC[] = {
+    {17, HOLE_PC, 0},
+    {42, HOLE_SYMBOL + 3, 0},
+    {93, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MFRE[] = {
+    0x41, 0x55, 0x41, 0x54, 0x49, 0x89, 0xf4, 0x55, 0x48, 0x89, 0xd5, 0x53,
+    0x48, 0x89, 0xfb, 0x49, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x8d, 0x45, 0x08, 0x48, 0x83, 0xec, 0x08, 0x48, 0x89, 0x87,
+    0x00, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x97,
+    0x08, 0x02, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0, 0x75, 0x2a, 0x48, 0x8b,
+    0x93, 0x08, 0x02, 0x00, 0x00, 0x48, 0x89, 0xdf, 0x48, 0x8b, 0xb3, 0x10,
+    0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xff,
+    0xe0, 0x0f, 0x1f, 0x00, 0x4c, 0x89, 0xab, 0x00, 0x02, 0x00, 0x00, 0x48,
+    0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x4c, 0x89, 0xa3, 0x10, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0xab, 0x08, 0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08,
+    0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xc3,
+};
+static const StencilHole stencil_holes_MFRE[] = {
+    {17, HOLE_PC, 0},
+    {42, HOLE_SYMBOL + 4, 0},
+    {93, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_REALC[] = {
+    0x41, 0x55, 0x41, 0x54, 0x49, 0x89, 0xf4, 0x55, 0x48, 0x89, 0xd5, 0x53,
+    0x48, 0x89, 0xfb, 0x49, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x8d, 0x45, 0x08, 0x48, 0x83, 0xec, 0x08, 0x48, 0x89, 0x87,
+    0x00, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x97,
+    0x08, 0x02, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0, 0x75, 0x2a, 0x48, 0x8b,
+    0x93, 0x08, 0x02, 0x00, 0x00, 0x48, 0x89, 0xdf, 0x48, 0x8b, 0xb3, 0x10,
+    0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xff,
+    0xe0, 0x0f, 0x1f, 0x00, 0x4c, 0x89, 0xab, 0x00, 0x02, 0x00, 0x00, 0x48,
+    0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x4c, 0x89, 0xa3, 0x10, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0xab, 0x08, 0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08,
+    0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xc3,
+};
+static const StencilHole stencil_holes_REALC[] = {
+    {17, HOLE_PC, 0},
+    {42, HOLE_SYMBOL + 5, 0},
+    {93, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CALC[] = {
+    0x41, 0x55, 0x41, 0x54, 0x49, 0x89, 0xf4, 0x55, 0x48, 0x89, 0xd5, 0x53,
+    0x48, 0x89, 0xfb, 0x49, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x8d, 0x45, 0x08, 0x48, 0x83, 0xec, 0x08, 0x48, 0x89, 0x87,
+    0x00, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x97,
+    0x08, 0x02, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0, 0x75, 0x2a, 0x48, 0x8b,
+    0x93, 0x08, 0x02, 0x00, 0x00, 0x48, 0x89, 0xdf, 0x48, 0x8b, 0xb3, 0x10,
+    0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xff,
+    0xe0, 0x0f, 0x1f, 0x00, 0x4c, 0x89, 0xab, 0x00, 0x02, 0x00, 0x00, 0x48,
+    0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x4c, 0x89, 0xa3, 0x10, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0xab, 0x08, 0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08,
+    0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xc3,
+};
+static const StencilHole stencil_holes_CALC[] = {
+    {17, HOLE_PC, 0},
+    {42, HOLE_SYMBOL + 6, 0},
+    {93, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CALLF[] = {
+    0x41, 0x55, 0x41, 0x54, 0x49, 0x89, 0xf4, 0x55, 0x48, 0x89, 0xd5, 0x53,
+    0x48, 0x89, 0xfb, 0x49, 0xbd, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x49, 0x8d, 0x45, 0x08, 0x48, 0x83, 0xec, 0x08, 0x48, 0x89, 0x87,
+    0x00, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x97,
+    0x08, 0x02, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0, 0x75, 0x2a, 0x48, 0x8b,
+    0x93, 0x08, 0x02, 0x00, 0x00, 0x48, 0x89, 0xdf, 0x48, 0x8b, 0xb3, 0x10,
+    0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xff,
+    0xe0, 0x0f, 0x1f, 0x00, 0x4c, 0x89, 0xab, 0x00, 0x02, 0x00, 0x00, 0x48,
+    0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x4c, 0x89, 0xa3, 0x10, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0xab, 0x08, 0x02, 0x00, 0x00, 0x48, 0x83, 0xc4, 0x08,
+    0x5b, 0x5d, 0x41, 0x5c, 0x41, 0x5d, 0xc3,
+};
+static const StencilHole stencil_holes_CALLF[] = {
+    {17, HOLE_PC, 0},
+    {42, HOLE_SYMBOL + 7, 0},
+    {93, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKP3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKP3[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKA3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKA3[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKT3[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKT3[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKB[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKB[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKI[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKI[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MARKI[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MARKI[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SCOPEIN[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SCOPEIN[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_SCOPEOUT[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_SCOPEOUT[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKL[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKL[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MARKR[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MARKR[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MARKW[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MARKW[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MARKA[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MARKA[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_MARKP[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_MARKP[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CHKPA[] = {
+    0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_CHKPA[] = {
+    {2, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_LEV3[] = {
+    0xf3, 0x0f, 0x7e, 0x02, 0x48, 0x8d, 0x4a, 0x10, 0x48, 0x8b, 0x42, 0x08,
+    0x66, 0x48, 0x0f, 0x6e, 0xc9, 0x66, 0x0f, 0x6c, 0xc1, 0x0f, 0x11, 0x87,
+    0x08, 0x02, 0x00, 0x00, 0xc3,
+};
+static const unsigned char stencil_code_RET3[] = {
+    0x48, 0x8b, 0x06, 0x48, 0x83, 0xc6, 0x08, 0x48, 0x89, 0x97, 0x08, 0x02,
+    0x00, 0x00, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0xc3,
+};
+static const unsigned char stencil_code_CALL[] = {
+    0x41, 0x54, 0x49, 0x89, 0xd4, 0x55, 0x48, 0x89, 0xf5, 0x53, 0x48, 0x89,
+    0xfb, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48,
+    0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x87, 0x00, 0x02, 0x00,
+    0x00, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48,
+    0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0x97,
+    0x08, 0x02, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0, 0x75, 0x1a, 0x4c, 0x89,
+    0xe2, 0x48, 0x89, 0xee, 0x48, 0x89, 0xdf, 0x48, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41, 0x5c, 0xff, 0xe0, 0x90,
+    0x5b, 0x48, 0xc7, 0xc0, 0xff, 0xff, 0xff, 0xff, 0x5d, 0x41, 0x5c, 0xc3,
+};
+static const StencilHole stencil_holes_CALL[] = {
+    {15, HOLE_PC, 0},
+    {39, HOLE_SYMBOL + 8, 0},
+    {49, HOLE_CALLEE, 0},
+    {81, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_CALLI[] = {
+    0x41, 0x54, 0x49, 0x89, 0xd4, 0x55, 0x48, 0x89, 0xf5, 0x53, 0x48, 0x89,
+    0xfb, 0x48, 0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48,
+    0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0x89, 0x87, 0x00, 0x02, 0x00,
+    0x00, 0x48, 0x89, 0x97, 0x08, 0x02, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x8b, 0x34, 0xc7, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xd0, 0x85, 0xc0,
+    0x75, 0x1e, 0x4c, 0x89, 0xe2, 0x48, 0x89, 0xee, 0x48, 0x89, 0xdf, 0x48,
+    0xb8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x5b, 0x5d, 0x41,
+    0x5c, 0xff, 0xe0, 0x0f, 0x1f, 0x44, 0x00, 0x00, 0x5b, 0x48, 0xc7, 0xc0,
+    0xff, 0xff, 0xff, 0xff, 0x5d, 0x41, 0x5c, 0xc3,
+};
+static const StencilHole stencil_holes_CALLI[] = {
+    {15, HOLE_PC, 0},
+    {46, HOLE_RD, 0},
+    {60, HOLE_SYMBOL + 8, 0},
+    {85, HOLE_CONTINUE, 0},
+};
+static const unsigned char stencil_code_JITCNT[] = {
+    0x48, 0xb9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x83, 0x29,
+    0x01, 0x75, 0x29, 0x48, 0x89, 0xb7, 0x10, 0x02, 0x00, 0x00, 0x48, 0xb8,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x48, 0x89, 0x97, 0x08,
+    0x02, 0x00, 0x00, 0x48, 0xbe, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0xff, 0xe0, 0x0f, 0x1f, 0x44, 0x00, 0x00, 0x48, 0xb8, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xe0,
+};
+static const StencilHole stencil_holes_JITCNT[] = {
+    {2, HOLE_COUNTER, 0},
+    {24, HOLE_SYMBOL + 9, 0},
+    {41, HOLE_INSN, 0},
+    {58, HOLE_CONTINUE, 0},
+};
+
+static const Stencil stencils[NUM_OPS] = {
+    [ADD3] = {stencil_code_ADD3, 59, 12, stencil_holes_ADD3, 4},
+    [SUB3] = {stencil_code_SUB3, 59, 12, stencil_holes_SUB3, 4},
+    [MUL3] = {stencil_code_MUL3, 60, 12, stencil_holes_MUL3, 4},
+    [DIV3] = {stencil_code_DIV3, 551, 0, stencil_holes_DIV3, 19},
+    [MOD3] = {stencil_code_MOD3, 336, 0, stencil_holes_MOD3, 13},
+    [AND3] = {stencil_code_AND3, 59, 12, stencil_holes_AND3, 4},
+    [OR3] = {stencil_code_OR3, 59, 12, stencil_holes_OR3, 4},
+    [XOR3] = {stencil_code_XOR3, 59, 12, stencil_holes_XOR3, 4},
+    [SHL3] = {stencil_code_SHL3, 62, 12, stencil_holes_SHL3, 4},
+    [SHR3] = {stencil_code_SHR3, 62, 12, stencil_holes_SHR3, 4},
+    [SEQ3] = {stencil_code_SEQ3, 65, 12, stencil_holes_SEQ3, 4},
+    [SNE3] = {stencil_code_SNE3, 65, 12, stencil_holes_SNE3, 4},
+    [SLT3] = {stencil_code_SLT3, 65, 12, stencil_holes_SLT3, 4},
+    [SGE3] = {stencil_code_SGE3, 65, 12, stencil_holes_SGE3, 4},
+    [SGT3] = {stencil_code_SGT3, 65, 12, stencil_holes_SGT3, 4},
+    [SLE3] = {stencil_code_SLE3, 65, 12, stencil_holes_SLE3, 4},
+    [LI3] = {stencil_code_LI3, 41, 12, stencil_holes_LI3, 3},
+    [MOV3] = {stencil_code_MOV3, 45, 12, stencil_holes_MOV3, 3},
+    [NEG3] = {stencil_code_NEG3, 48, 12, stencil_holes_NEG3, 3},
+    [NOT3] = {stencil_code_NOT3, 52, 12, stencil_holes_NOT3, 3},
+    [BNOT3] = {stencil_code_BNOT3, 48, 12, stencil_holes_BNOT3, 3},
+    [ADDI3] = {stencil_code_ADDI3, 55, 12, stencil_holes_ADDI3, 4},
+    [SUBI3] = {stencil_code_SUBI3, 58, 12, stencil_holes_SUBI3, 4},
+    [MULI3] = {stencil_code_MULI3, 56, 12, stencil_holes_MULI3, 4},
+    [ANDI3] = {stencil_code_ANDI3, 55, 12, stencil_holes_ANDI3, 4},
+    [ORI3] = {stencil_code_ORI3, 55, 12, stencil_holes_ORI3, 4},
+    [XORI3] = {stencil_code_XORI3, 55, 12, stencil_holes_XORI3, 4},
+    [SHLI3] = {stencil_code_SHLI3, 58, 12, stencil_holes_SHLI3, 4},
+    [SHRI3] = {stencil_code_SHRI3, 58, 12, stencil_holes_SHRI3, 4},
+    [SLTI3] = {stencil_code_SLTI3, 61, 12, stencil_holes_SLTI3, 4},
+    [LEA3] = {stencil_code_LEA3, 45, 12, stencil_holes_LEA3, 3},
+    [ENT3] = {stencil_code_ENT3, 219, 0, stencil_holes_ENT3, 6},
+    [ADJ] = {stencil_code_ADJ, 26, 12, stencil_holes_ADJ, 2},
+    [PSH3] = {stencil_code_PSH3, 33, 12, stencil_holes_PSH3, 2},
+    [POP3] = {stencil_code_POP3, 33, 12, stencil_holes_POP3, 2},
+    [LDR_B] = {stencil_code_LDR_B, 49, 12, stencil_holes_LDR_B, 3},
+    [LDR_H] = {stencil_code_LDR_H, 49, 12, stencil_holes_LDR_H, 3},
+    [LDR_W] = {stencil_code_LDR_W, 48, 12, stencil_holes_LDR_W, 3},
+    [LDR_D] = {stencil_code_LDR_D, 48, 12, stencil_holes_LDR_D, 3},
+    [STR_B] = {stencil_code_STR_B, 42, 12, stencil_holes_STR_B, 3},
+    [STR_H] = {stencil_code_STR_H, 43, 12, stencil_holes_STR_H, 3},
+    [STR_W] = {stencil_code_STR_W, 42, 12, stencil_holes_STR_W, 3},
+    [STR_D] = {stencil_code_STR_D, 43, 12, stencil_holes_STR_D, 3},
+    [BCPY] = {stencil_code_BCPY, 88, 0, stencil_holes_BCPY, 5},
+    [FLDR] = {stencil_code_FLDR, 49, 12, stencil_holes_FLDR, 3},
+    [FSTR] = {stencil_code_FSTR, 49, 12, stencil_holes_FSTR, 3},
+    [FLI] = {stencil_code_FLI, 40, 12, stencil_holes_FLI, 3},
+    [FADD3] = {stencil_code_FADD3, 70, 12, stencil_holes_FADD3, 4},
+    [FSUB3] = {stencil_code_FSUB3, 70, 12, stencil_holes_FSUB3, 4},
+    [FMUL3] = {stencil_code_FMUL3, 70, 12, stencil_holes_FMUL3, 4},
+    [FDIV3] = {stencil_code_FDIV3, 343, 0, stencil_holes_FDIV3, 13},
+    [FNEG3] = {stencil_code_FNEG3, 64, 12, stencil_holes_FNEG3, 4},
+    [FEQ3] = {stencil_code_FEQ3, 81, 12, stencil_holes_FEQ3, 4},
+    [FNE3] = {stencil_code_FNE3, 81, 12, stencil_holes_FNE3, 4},
+    [FLT3] = {stencil_code_FLT3, 71, 12, stencil_holes_FLT3, 4},
+    [FLE3] = {stencil_code_FLE3, 71, 12, stencil_holes_FLE3, 4},
+    [FGT3] = {stencil_code_FGT3, 71, 12, stencil_holes_FGT3, 4},
+    [FGE3] = {stencil_code_FGE3, 71, 12, stencil_holes_FGE3, 4},
+    [I2F3] = {stencil_code_I2F3, 51, 12, stencil_holes_I2F3, 3},
+    [F2I3] = {stencil_code_F2I3, 51, 12, stencil_holes_F2I3, 3},
+    [FR2R] = {stencil_code_FR2R, 49, 12, stencil_holes_FR2R, 3},
+    [R2FR] = {stencil_code_R2FR, 44, 12, stencil_holes_R2FR, 3},
+    [SX1] = {stencil_code_SX1, 41, 12, stencil_holes_SX1, 3},
+    [SX2] = {stencil_code_SX2, 41, 12, stencil_holes_SX2, 3},
+    [SX4] = {stencil_code_SX4, 40, 12, stencil_holes_SX4, 3},
+    [ZX1] = {stencil_code_ZX1, 40, 12, stencil_holes_ZX1, 3},
+    [ZX2] = {stencil_code_ZX2, 40, 12, stencil_holes_ZX2, 3},
+    [ZX4] = {stencil_code_ZX4, 39, 12, stencil_holes_ZX4, 3},
+    [JZ3] = {stencil_code_JZ3, 44, 0, stencil_holes_JZ3, 3},
+    [JNZ3] = {stencil_code_JNZ3, 44, 0, stencil_holes_JNZ3, 3},
+    [BEQ] = {stencil_code_BEQ, 60, 0, stencil_holes_BEQ, 4},
+    [BNE] = {stencil_code_BNE, 60, 12, stencil_holes_BNE, 4},
+    [BLT] = {stencil_code_BLT, 60, 0, stencil_holes_BLT, 4},
+    [BGE] = {stencil_code_BGE, 60, 0, stencil_holes_BGE, 4},
+    [BLTU] = {stencil_code_BLTU, 60, 0, stencil_holes_BLTU, 4},
+    [BGEU] = {stencil_code_BGEU, 60, 0, stencil_holes_BGEU, 4},
+    [BEQI] = {stencil_code_BEQI, 60, 0, stencil_holes_BEQI, 4},
+    [BNEI] = {stencil_code_BNEI, 60, 12, stencil_holes_BNEI, 4},
+    [BLTI] = {stencil_code_BLTI, 60, 0, stencil_holes_BLTI, 4},
+    [BGEI] = {stencil_code_BGEI, 60, 0, stencil_holes_BGEI, 4},
+    [BLTUI] = {stencil_code_BLTUI, 60, 0, stencil_holes_BLTUI, 4},
+    [BGEUI] = {stencil_code_BGEUI, 60, 0, stencil_holes_BGEUI, 4},
+    [JMP] = {stencil_code_JMP, 12, 0, stencil_holes_JMP, 1},
+    [MALC] = {stencil_code_MALC, 151, 0, stencil_holes_MALC, 3},
+    [MFRE] = {stencil_code_MFRE, 151, 0, stencil_holes_MFRE, 3},
+    [REALC] = {stencil_code_REALC, 151, 0, stencil_holes_REALC, 3},
+    [CALC] = {stencil_code_CALC, 151, 0, stencil_holes_CALC, 3},
+    [CALLF] = {stencil_code_CALLF, 151, 0, stencil_holes_CALLF, 3},
+    [CHKP3] = {stencil_code_CHKP3, 12, 12, stencil_holes_CHKP3, 1},
+    [CHKA3] = {stencil_code_CHKA3, 12, 12, stencil_holes_CHKA3, 1},
+    [CHKT3] = {stencil_code_CHKT3, 12, 12, stencil_holes_CHKT3, 1},
+    [CHKB] = {stencil_code_CHKB, 12, 12, stencil_holes_CHKB, 1},
+    [CHKI] = {stencil_code_CHKI, 12, 12, stencil_holes_CHKI, 1},
+    [MARKI] = {stencil_code_MARKI, 12, 12, stencil_holes_MARKI, 1},
+    [SCOPEIN] = {stencil_code_SCOPEIN, 12, 12, stencil_holes_SCOPEIN, 1},
+    [SCOPEOUT] = {stencil_code_SCOPEOUT, 12, 12, stencil_holes_SCOPEOUT, 1},
+    [CHKL] = {stencil_code_CHKL, 12, 12, stencil_holes_CHKL, 1},
+    [MARKR] = {stencil_code_MARKR, 12, 12, stencil_holes_MARKR, 1},
+    [MARKW] = {stencil_code_MARKW, 12, 12, stencil_holes_MARKW, 1},
+    [MARKA] = {stencil_code_MARKA, 12, 12, stencil_holes_MARKA, 1},
+    [MARKP] = {stencil_code_MARKP, 12, 12, stencil_holes_MARKP, 1},
+    [CHKPA] = {stencil_code_CHKPA, 12, 12, stencil_holes_CHKPA, 1},
+    [LEV3] = {stencil_code_LEV3, 29, 0, NULL, 0},
+    [RET3] = {stencil_code_RET3, 22, 0, NULL, 0},
+    [CALL] = {stencil_code_CALL, 108, 0, stencil_holes_CALL, 4},
+    [CALLI] = {stencil_code_CALLI, 116, 0, stencil_holes_CALLI, 4},
+    [JITCNT] = {stencil_code_JITCNT, 68, 12, stencil_holes_JITCNT, 4},
+};
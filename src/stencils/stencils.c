@@ -0,0 +1,205 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Stencil sources for the copy-and-patch tier of --jit. This file is not
+ * part of jcc: stencils.py compiles it with the host C compiler and turns
+ * every stencil_<OP> function into a machine code template in stencils.h,
+ * which jit.c copies and patches once per instruction.
+ *
+ * A stencil runs one instruction, like the handler of the unchecked dispatch
+ * loop, from the same opcode body (vm_body.h). Values that are fixed per
+ * instruction are holes: HOLE(NAME) loads the address of the undefined
+ * symbol _JIT_NAME, which stencils.py records as a place to patch. The next
+ * instruction is a tail call to _JIT_CONTINUE, a taken branch one to
+ * _JIT_TARGET.
+ *
+ * Every stencil has the same signature, so the code of a function is a
+ * chain of tail calls that can be entered at any instruction. LEV3 returns
+ * the VM return address, with vm->sp and vm->bp published; failures return
+ * JIT_ERROR with vm->pc at the faulting instruction.
+ */
+
+#include "../jcc.h"
+#include "../internal.h"
+#include <limits.h>
+
+// Checked by jit.c against the structures it runs with: the size of VMInsn
+// and the offsets of the JCC fields used here and in vm_body.h, which
+// stencils.py passes in as STENCIL_FIELDS
+#define FIELD(NAME) offsetof(JCC, NAME),
+const unsigned long stencil_layout[] = {sizeof(VMInsn), STENCIL_FIELDS};
+#undef FIELD
+
+// The value of a hole. The compiler sees an opaque register load, so it
+// cannot assume anything about it as it could about an object's address.
+#define HOLE(NAME)                                                             \
+    ({                                                                         \
+        long long hole_;                                                       \
+        __asm__("movabs $_JIT_" #NAME ", %0" : "=r"(hole_));                   \
+        hole_;                                                                 \
+    })
+
+typedef long long StencilFn(JCC *vm, long long *sp, long long *bp);
+extern StencilFn _JIT_CONTINUE, _JIT_TARGET;
+
+// Runtime helpers in jit.c and ops.c
+int jit_call(JCC *vm, long long addr);
+long long jit_promote(JCC *vm, VMInsn *insn);
+void report_overflow(JCC *vm, const char *what, long long a, const char *op,
+                     long long b);
+int op_MALC_fn(JCC *vm);
+int op_MFRE_fn(JCC *vm);
+int op_REALC_fn(JCC *vm);
+int op_CALC_fn(JCC *vm);
+int op_CALLF_fn(JCC *vm);
+
+// The environment vm_body.h expects, for the unchecked loop
+#define RD HOLE(RD)
+#define RS1 HOLE(RS1)
+#define RS2 HOLE(RS2)
+#define IMM HOLE(IMM)
+#define CMP_IMM HOLE(CMP_IMM)
+#define CUR_PC ((long long *)HOLE(PC))
+#define regs (vm->regs)
+#define fregs (vm->fregs)
+#define VM_FLAG(GROUP, FLAG) 0
+
+#define NEXT() return _JIT_CONTINUE(vm, sp, bp)
+#define TAKE_BRANCH() return _JIT_TARGET(vm, sp, bp)
+
+#include "../vm_body.h"
+
+#define STENCIL(NAME)                                                          \
+    long long stencil_##NAME(JCC *vm, long long *sp, long long *bp)
+
+// Where bodies go on failure, as vm_error in the loop
+#define FAIL_EXIT()                                                            \
+vm_error:                                                                      \
+    vm->pc = CUR_PC;                                                           \
+    vm->sp = sp;                                                               \
+    vm->bp = bp;                                                               \
+    return JIT_ERROR
+
+// Out-of-line handler from ops.c, as CALL_OP in the loop
+#define CALL_OP(NAME)                                                          \
+    do {                                                                       \
+        vm->pc = CUR_PC + 1;                                                   \
+        vm->sp = sp;                                                           \
+        vm->bp = bp;                                                           \
+        if (op_##NAME##_fn(vm) != 0)                                           \
+            goto vm_error;                                                     \
+        sp = vm->sp;                                                           \
+        bp = vm->bp;                                                           \
+    } while (0)
+
+#define BODY(NAME)                                                             \
+    STENCIL(NAME) {                                                            \
+        BODY_##NAME;                                                           \
+        NEXT();                                                                \
+        FAIL_EXIT();                                                           \
+    }
+#define OUT_OF_LINE(NAME)                                                      \
+    STENCIL(NAME) {                                                            \
+        CALL_OP(NAME);                                                         \
+        NEXT();                                                                \
+        FAIL_EXIT();                                                           \
+    }
+// Checks of the safety groups and legacy instrumentation
+#define NOP(NAME)                                                              \
+    STENCIL(NAME) { NEXT(); }
+
+// ========== Opcode Bodies ==========
+
+BODY(ADD3) BODY(SUB3) BODY(MUL3) BODY(DIV3) BODY(MOD3)
+BODY(AND3) BODY(OR3) BODY(XOR3) BODY(SHL3) BODY(SHR3)
+BODY(SEQ3) BODY(SNE3) BODY(SLT3) BODY(SGE3) BODY(SGT3) BODY(SLE3)
+BODY(LI3) BODY(MOV3) BODY(NEG3) BODY(NOT3) BODY(BNOT3)
+BODY(ADDI3) BODY(SUBI3) BODY(MULI3) BODY(ANDI3) BODY(ORI3) BODY(XORI3)
+BODY(SHLI3) BODY(SHRI3) BODY(SLTI3) BODY(LEA3)
+BODY(ENT3) BODY(ADJ) BODY(PSH3) BODY(POP3)
+BODY(LDR_B) BODY(LDR_H) BODY(LDR_W) BODY(LDR_D)
+BODY(STR_B) BODY(STR_H) BODY(STR_W) BODY(STR_D) BODY(BCPY)
+BODY(FLDR) BODY(FSTR) BODY(FLI)
+BODY(FADD3) BODY(FSUB3) BODY(FMUL3) BODY(FDIV3) BODY(FNEG3)
+BODY(FEQ3) BODY(FNE3) BODY(FLT3) BODY(FLE3) BODY(FGT3) BODY(FGE3)
+BODY(I2F3) BODY(F2I3) BODY(FR2R) BODY(R2FR)
+BODY(SX1) BODY(SX2) BODY(SX4) BODY(ZX1) BODY(ZX2) BODY(ZX4)
+BODY(JZ3) BODY(JNZ3)
+BODY(BEQ) BODY(BNE) BODY(BLT) BODY(BGE) BODY(BLTU) BODY(BGEU)
+BODY(BEQI) BODY(BNEI) BODY(BLTI) BODY(BGEI) BODY(BLTUI) BODY(BGEUI)
+BODY(JMP)
+
+OUT_OF_LINE(MALC) OUT_OF_LINE(MFRE) OUT_OF_LINE(REALC) OUT_OF_LINE(CALC)
+OUT_OF_LINE(CALLF)
+
+NOP(CHKP3) NOP(CHKA3) NOP(CHKT3)
+NOP(CHKB) NOP(CHKI) NOP(MARKI) NOP(SCOPEIN) NOP(SCOPEOUT) NOP(CHKL)
+NOP(MARKR) NOP(MARKW) NOP(MARKA) NOP(MARKP) NOP(CHKPA)
+
+// ========== Calls ==========
+
+STENCIL(LEV3) {
+    sp = bp;
+    bp = (long long *)*sp++;
+    long long ret_addr = *sp++;
+    vm->sp = sp;
+    vm->bp = bp;
+    return ret_addr;
+}
+
+STENCIL(RET3) {
+    long long ret_addr = *sp++;
+    vm->sp = sp;
+    vm->bp = bp;
+    return ret_addr;
+}
+
+// The callee runs in whatever tier it has reached; its frame is gone again
+// when jit_call() returns, so sp and bp are unchanged
+STENCIL(CALL) {
+    vm->sp = sp;
+    vm->bp = bp;
+    vm->pc = CUR_PC;
+    if (jit_call(vm, HOLE(CALLEE)) != 0)
+        return JIT_ERROR;
+    NEXT();
+}
+
+STENCIL(CALLI) {
+    vm->sp = sp;
+    vm->bp = bp;
+    vm->pc = CUR_PC;
+    if (jit_call(vm, regs[RD]) != 0)
+        return JIT_ERROR;
+    NEXT();
+}
+
+// ========== Tiering ==========
+
+// Put before function entries and loop headers: counts down, then moves
+// the function on to the optimizing tier (jit_promote)
+STENCIL(JITCNT) {
+    unsigned *count = (unsigned *)HOLE(COUNTER);
+    if (--*count != 0)
+        NEXT();
+    vm->sp = sp;
+    vm->bp = bp;
+    return jit_promote(vm, (VMInsn *)HOLE(INSN));
+}
@@ -0,0 +1,57 @@
+/* Auto-generated by superops.py - DO NOT EDIT */
+/* Profile: superops.prof, 24 of 1709 candidate sequences */
+
+// Fused opcodes, appended to OPS_X in jcc.h
+#define SUPEROPS_X \
+    X(SX4__ADDI3__SX4) /* saves 133278 */ \
+    X(LEA3__LDR_W__SX4) /* saves 81384 */ \
+    X(ADDI3__SX4__BLTI) /* saves 76770 */ \
+    X(ADD3__ADDI3__SX4) /* saves 48490 */ \
+    X(LDR_W__SX4__ADDI3) /* saves 41846 */ \
+    X(LI3__LDR_W__SX4) /* saves 40206 */ \
+    X(ADDI3__SX4__LI3) /* saves 40186 */ \
+    X(SX4__LI3__STR_W) /* saves 40102 */ \
+    X(ENT3__SX4__LI3) /* saves 40040 */ \
+    X(MULI3__SX4__ADDI3) /* saves 40014 */ \
+    X(SX4__LI3__LDR_W) /* saves 40014 */ \
+    X(ANDI3__ADD3__ADDI3) /* saves 40000 */ \
+    X(LI3__STR_W__MULI3) /* saves 40000 */ \
+    X(MOV3__SX4__ANDI3) /* saves 40000 */ \
+    X(STR_W__MULI3__SX4) /* saves 40000 */ \
+    X(SX4__ANDI3__ADD3) /* saves 40000 */ \
+    X(SX4__SUBI3__SX4) /* saves 34884 */ \
+    X(LDR_W__SX4__SUBI3) /* saves 34564 */ \
+    X(ADDI3__SX4) /* saves 102905 */ \
+    X(SX4__ADDI3) /* saves 66642 */ \
+    X(LDR_W__SX4) /* saves 62546 */ \
+    X(SX4__LI3) /* saves 48237 */ \
+    X(LEA3__LDR_W) /* saves 40845 */ \
+    X(SX4__BLTI) /* saves 38715 */
+
+// S2(NAME, A, B) / S3(NAME, A, B, C): components of each fused opcode,
+// in the order opt_superinstructions() tries them
+#define SUPEROPS_DEF \
+    S3(SX4__ADDI3__SX4, SX4, ADDI3, SX4) \
+    S3(LEA3__LDR_W__SX4, LEA3, LDR_W, SX4) \
+    S3(ADDI3__SX4__BLTI, ADDI3, SX4, BLTI) \
+    S3(ADD3__ADDI3__SX4, ADD3, ADDI3, SX4) \
+    S3(LDR_W__SX4__ADDI3, LDR_W, SX4, ADDI3) \
+    S3(LI3__LDR_W__SX4, LI3, LDR_W, SX4) \
+    S3(ADDI3__SX4__LI3, ADDI3, SX4, LI3) \
+    S3(SX4__LI3__STR_W, SX4, LI3, STR_W) \
+    S3(ENT3__SX4__LI3, ENT3, SX4, LI3) \
+    S3(MULI3__SX4__ADDI3, MULI3, SX4, ADDI3) \
+    S3(SX4__LI3__LDR_W, SX4, LI3, LDR_W) \
+    S3(ANDI3__ADD3__ADDI3, ANDI3, ADD3, ADDI3) \
+    S3(LI3__STR_W__MULI3, LI3, STR_W, MULI3) \
+    S3(MOV3__SX4__ANDI3, MOV3, SX4, ANDI3) \
+    S3(STR_W__MULI3__SX4, STR_W, MULI3, SX4) \
+    S3(SX4__ANDI3__ADD3, SX4, ANDI3, ADD3) \
+    S3(SX4__SUBI3__SX4, SX4, SUBI3, SX4) \
+    S3(LDR_W__SX4__SUBI3, LDR_W, SX4, SUBI3) \
+    S2(ADDI3__SX4, ADDI3, SX4) \
+    S2(SX4__ADDI3, SX4, ADDI3) \
+    S2(LDR_W__SX4, LDR_W, SX4) \
+    S2(SX4__LI3, SX4, LI3) \
+    S2(LEA3__LDR_W, LEA3, LDR_W) \
+    S2(SX4__BLTI, SX4, BLTI)
@@ -22,82 +22,577 @@
 
 #include "jcc.h"
 #include "./internal.h"
-
-#define X(NAME) extern int op_##NAME##_fn(JCC *vm);
-OPS_X
+#include <limits.h>
+
+// Cold opcodes that stay out of line in ops.c. Everything else is handled
+// directly inside the dispatch loop below.
+extern int op_CHKP3_fn(JCC *vm);
+extern int op_CHKA3_fn(JCC *vm);
+extern int op_CHKT3_fn(JCC *vm);
+extern int op_MALC_fn(JCC *vm);
+extern int op_MFRE_fn(JCC *vm);
+extern int op_REALC_fn(JCC *vm);
+extern int op_CALC_fn(JCC *vm);
+extern int op_CALLF_fn(JCC *vm);
+
+static const char *op_names[] = {
+#define X(NAME) #NAME,
+    OPS_X
 #undef X
+};
+
+// Opcode whose operand layout a superinstruction borrows: its first
+// component. A fused opcode only replaces that component's opcode word, so
+// the component records and any jumps into them stay valid. Other opcodes
+// are their own base.
+int vm_superop_base(int op) {
+    switch (op) {
+#define S2(NAME, A, B) case NAME: return A;
+#define S3(NAME, A, B, C) case NAME: return A;
+        SUPEROPS_DEF
+#undef S2
+#undef S3
+        default:
+            return op;
+    }
+}
 
-static int eval1(JCC *vm) {
-    vm->cycle++;
+// Number of text words (opcode included) occupied by an instruction
+int vm_insn_size(int op) {
+    switch (vm_superop_base(op)) {
+        case LEV3: case RET3: case CHKPA:
+        case MALC: case MFRE: case REALC: case CALC:
+        case SETJMP: case LONGJMP: case BRK: case JITENT: case JITCNT:
+        case PERFENT:
+            return 1;
+        case LI3: case LEA3: case ADDI3: case SUBI3: case MULI3:
+        case ANDI3: case ORI3: case XORI3: case SHLI3: case SHRI3: case SLTI3:
+        case JZ3: case JNZ3:
+        case BEQ: case BNE: case BLT: case BGE: case BLTU: case BGEU:
+        case ENT3: case CHKA3: case CHKT3: case BCPY: case FLI:
+            return 3;
+        case BEQI: case BNEI: case BLTI: case BGEI: case BLTUI: case BGEUI:
+        case JMPT: case CALLF: case MARKA: case MARKP:
+            return 4;
+        default:
+            return 2;
+    }
+}
 
-    // Debugger hooks - check before executing instruction
-    if (vm->flags & JCC_ENABLE_DEBUGGER) {
-        // Check for breakpoints
-        if (debugger_check_breakpoint(vm)) {
-            printf("\nBreakpoint hit at PC %p (offset: %lld)\n",
-                   (void*)vm->pc, (long long)(vm->pc - vm->text_seg));
-            cc_debug_repl(vm);
+// Word index (relative to the opcode) of an instruction's jump or call
+// target, or 0 if it has none. Targets are absolute text_seg addresses.
+int vm_target_operand(int op) {
+    switch (op) {
+        case JMP: case CALL:
+            return 1;
+        case JZ3: case JNZ3:
+        case BEQ: case BNE: case BLT: case BGE: case BLTU: case BGEU:
+            return 2;
+        case BEQI: case BNEI: case BLTI: case BGEI: case BLTUI: case BGEUI:
+        case JMPT:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+// Resolve a text_seg address to its decoded record (NULL if it is not the
+// start of an instruction)
+static VMInsn *insn_for_addr(JCC *vm, long long addr) {
+    unsigned long long off = (unsigned long long)((long long *)addr - vm->text_seg);
+    if (off >= (unsigned long long)vm->insn_text_size)
+        return NULL;
+    return vm->insn_at[off];
+}
+
+// Translate text_seg into the pre-decoded record array. The stream ends with
+// a sentinel record (op == NUM_OPS) that also catches invalid jump targets.
+// Handlers are bound separately, per dispatch loop, by vm_bind_handlers().
+int vm_predecode(JCC *vm) {
+    if (!vm->text_seg || !vm->text_ptr)
+        return -1;
+
+    long long size = vm->text_ptr - vm->text_seg + 1;
+    jit_free(vm);
+    free(vm->insns);
+    free(vm->insn_at);
+    vm->insns = calloc(size + 1, sizeof(VMInsn));
+    vm->insn_at = calloc(size, sizeof(VMInsn *));
+    if (!vm->insns || !vm->insn_at) {
+        fprintf(stderr, "error: out of memory decoding instruction stream\n");
+        return -1;
+    }
+    vm->insn_text_seg = vm->text_seg;
+    vm->insn_text_size = size;
+    vm->insn_variant = -1;
+
+    // Pass 1: decode operands. text_seg[0] holds main's offset, not code.
+    long long count = 0;
+    for (long long i = 1; i < size;) {
+        long long *pc = vm->text_seg + i;
+        long long word = *pc;
+        VMInsn *insn = &vm->insns[count++];
+        vm->insn_at[i] = insn;
+        insn->text_off = (unsigned int)i;
+        if (word < 0 || word >= NUM_OPS) {
+            insn->op = NUM_OPS;
+            i++;
+            continue;
         }
 
-        if (vm->dbg.single_step)
-            cc_debug_repl(vm);
+        int op = (int)word;
+        int len = vm_insn_size(op);
+        insn->op = op;
+        if (i + len > size) {
+            insn->op = NUM_OPS;
+            break;
+        }
 
-        if (vm->dbg.step_over && vm->pc == vm->dbg.step_over_return_addr) {
-            vm->dbg.step_over = 0;
-            cc_debug_repl(vm);
+        switch (vm_superop_base(op)) {
+            case ENT3: {
+                // [stack_size:32|param_count:32] [float_param_mask]
+                // Only the first 8 parameters arrive in registers.
+                int param_count = (int)((pc[1] >> 32) & 0xFFFFFFFF);
+                insn->imm = (int)(pc[1] & 0xFFFFFFFF);
+                insn->rd = param_count > 8 ? 8 : param_count;
+                insn->rs1 = (unsigned char)(pc[2] & 0xFF);
+                insn->rs2 = (pc[2] & ENT3_NO_FRAME) != 0;
+                break;
+            }
+            case JMP: case CALL: case ADJ:
+                insn->imm = pc[1];
+                break;
+            case BEQI: case BNEI: case BLTI: case BGEI: case BLTUI:
+            case BGEUI: case JMPT:
+                // [rs] [immediate] [target]
+                DECODE_RRR(pc[1], insn->rd, insn->rs1, insn->rs2);
+                insn->cmp_imm = pc[2];
+                insn->imm = pc[3];
+                break;
+            case CALLF: case MARKA: case MARKP: case CHKB: case CHKI:
+            case MARKI: case SCOPEIN: case SCOPEOUT: case CHKL: case MARKR:
+            case MARKW:
+                // Out-of-line or stub opcodes read their own operands
+                break;
+            default:
+                if (len >= 2)
+                    DECODE_RRR(pc[1], insn->rd, insn->rs1, insn->rs2);
+                if (len == 3)
+                    insn->imm = pc[2];
+                break;
         }
+        i += len;
+    }
 
-        if (vm->dbg.step_out && vm->bp != vm->dbg.step_out_bp) {
-            vm->dbg.step_out = 0;
-            cc_debug_repl(vm);
+    // Sentinel: falling off the end of the stream is an invalid instruction
+    vm->insn_count = count;
+    vm->insns[count].op = NUM_OPS;
+    vm->insns[count].text_off = (unsigned int)size;
+
+    // Pass 2: remap branch and call targets to record addresses
+    VMInsn *sentinel = &vm->insns[count];
+    for (long long n = 0; n < count; n++) {
+        VMInsn *insn = &vm->insns[n];
+        if (vm_target_operand(insn->op)) {
+            VMInsn *target = insn_for_addr(vm, insn->imm);
+            insn->imm = (long long)(target ? target : sentinel);
         }
     }
 
-    static void* op_table[] = {
-#define X(NAME) [NAME] = &&op_##NAME,
-        OPS_X
-#undef X
-    };
-    int op = *vm->pc++;
-    if (op < 0 || op >= sizeof(op_table) / sizeof(op_table[0])) {
-        printf("unknown instruction:%d\n", op);
+    return 0;
+}
+
+// Pack up to three opcodes into a non-zero ngram_counts key (C < 0 for a
+// bigram)
+static long long ngram_key(int a, int b, int c) {
+    return (long long)(a + 1) | (long long)(b + 1) << 8 |
+           (long long)(c + 1) << 16;
+}
+
+static void ngram_add(JCC *vm, long long key, long long n) {
+    long long count = (long long)(intptr_t)hashmap_get_int(&vm->ngram_counts, key);
+    hashmap_put_int(&vm->ngram_counts, key, (void *)(intptr_t)(count + n));
+}
+
+// Count the bigram and trigram ending at ip. Only straight-line runs are
+// counted: a jump, call or return starts a new run, since a superinstruction
+// can never span one.
+static void vm_count_ngram(JCC *vm, VMInsn *ip) {
+    int op = vm_superop_base(ip->op);
+    if (ip - 1 != vm->ngram_prev || op >= NUM_OPS)
+        vm->ngram_hist[0] = vm->ngram_hist[1] = -1;
+    vm->ngram_prev = ip;
+    if (op >= NUM_OPS)
+        return;
+
+    if (vm->ngram_hist[1] >= 0)
+        ngram_add(vm, ngram_key(vm->ngram_hist[1], op, -1), 1);
+    if (vm->ngram_hist[0] >= 0)
+        ngram_add(vm, ngram_key(vm->ngram_hist[0], vm->ngram_hist[1], op), 1);
+    vm->ngram_hist[0] = vm->ngram_hist[1];
+    vm->ngram_hist[1] = op;
+}
+
+static int ngram_op(const char *name) {
+    for (int op = 0; op < NUM_OPS; op++)
+        if (vm_superop_base(op) == op && !strcmp(op_names[op], name))
+            return op;
+    return -1;
+}
+
+static int write_ngram(char *key, int keylen, void *val, void *user_data) {
+    long long k = (long long)key;
+    int a = (int)(k & 0xFF) - 1, b = (int)(k >> 8 & 0xFF) - 1;
+    int c = (int)(k >> 16 & 0xFF) - 1;
+    FILE *f = user_data;
+    fprintf(f, "%lld %s %s", (long long)(intptr_t)val, op_names[a],
+            op_names[b]);
+    if (c >= 0)
+        fprintf(f, " %s", op_names[c]);
+    fputc('\n', f);
+    return 0;
+}
+
+// Merge the counts gathered by --ngram-profile into vm->ngram_profile. Counts
+// already in the file are added to, so a whole corpus can be profiled into
+// one file and fed to superops.py.
+int vm_save_ngram_profile(JCC *vm) {
+    if (!vm->ngram_profile)
+        return 0;
+
+    FILE *f = fopen(vm->ngram_profile, "r");
+    if (f) {
+        char line[256], a[32], b[32], c[32];
+        while (fgets(line, sizeof(line), f)) {
+            long long count;
+            int n = sscanf(line, "%lld %31s %31s %31s", &count, a, b, c);
+            if (line[0] == '#' || n < 3)
+                continue;
+            int oa = ngram_op(a), ob = ngram_op(b);
+            int oc = n == 4 ? ngram_op(c) : -1;
+            if (oa < 0 || ob < 0 || (n == 4 && oc < 0))
+                continue;
+            ngram_add(vm, ngram_key(oa, ob, oc), count);
+        }
+        fclose(f);
+    }
+
+    f = fopen(vm->ngram_profile, "w");
+    if (!f) {
+        fprintf(stderr, "error: failed to open %s for writing: %s\n",
+                vm->ngram_profile, strerror(errno));
         return -1;
     }
+    fprintf(f, "# JCC opcode n-gram profile: count OP1 OP2 [OP3]\n");
+    hashmap_foreach(&vm->ngram_counts, write_ngram, f);
+    fclose(f);
+    return 0;
+}
 
-    // Debug printing
-    if (vm->debug_vm) {
-        // Print opcode name (simplified for new opcode set)
-        static const char *names[] = {
-#define X(NAME) #NAME,
-            OPS_X
-#undef X
-        };
-        if (op >= 0 && op < (int)(sizeof(names)/sizeof(names[0]))) {
-            printf("%lld> %s\n", vm->cycle, names[op]);
-        } else {
-            printf("%lld> OP_%d\n", vm->cycle, op);
+// Whether the debugger wants to stop at every instruction, which only the
+// instrumented (hooks) loop can do
+static int vm_stepping(JCC *vm) {
+    return vm->dbg.single_step || vm->dbg.step_over || vm->dbg.step_out;
+}
+
+// Run the debugger hooks for the instruction at vm->pc. trapped is set when
+// its record carries a BRK trap; instructions without one never look at the
+// breakpoint table.
+static void vm_debug_hooks(JCC *vm, int trapped) {
+    // Check for breakpoints
+    if (trapped && debugger_check_breakpoint(vm)) {
+        printf("\nBreakpoint hit at PC %p (offset: %lld)\n",
+               (void*)vm->pc, (long long)(vm->pc - vm->text_seg));
+        cc_debug_repl(vm);
+        return;
+    }
+
+    if (vm->dbg.single_step)
+        cc_debug_repl(vm);
+
+    if (vm->dbg.step_over && vm->pc == vm->dbg.step_over_return_addr) {
+        vm->dbg.step_over = 0;
+        cc_debug_repl(vm);
+    }
+
+    if (vm->dbg.step_out && vm->bp != vm->dbg.step_out_bp) {
+        vm->dbg.step_out = 0;
+        cc_debug_repl(vm);
+    }
+}
+
+// Operands of the current record
+#define RD (ip->rd)
+#define RS1 (ip->rs1)
+#define RS2 (ip->rs2)
+#define IMM (ip->imm)
+#define CMP_IMM (ip->cmp_imm)
+
+// text_seg address of the current instruction and of the one after it
+#define CUR_PC (vm->text_seg + ip->text_off)
+#define NEXT_PC (vm->text_seg + ip[1].text_off)
+
+// Jump to the handler of the current record. In the hooks variant every
+// instruction detours through vm_hooks first.
+#define DISPATCH()                                                             \
+    do {                                                                       \
+        if (VM_HOOKS)                                                          \
+            goto vm_hooks;                                                     \
+        goto *ip->handler;                                                     \
+    } while (0)
+
+// Advance to the following record and jump straight to its handler
+#define NEXT()                                                                 \
+    do {                                                                       \
+        ip++;                                                                  \
+        DISPATCH();                                                            \
+    } while (0)
+
+// Continue at a text_seg address (return address, function pointer, ...)
+#define JUMP_TO_ADDR(ADDR)                                                     \
+    do {                                                                       \
+        VMInsn *target_ = insn_for_addr(vm, (long long)(ADDR));                \
+        if (!target_)                                                          \
+            goto vm_bad_target;                                                \
+        ip = target_;                                                          \
+        if (budget < 0)                                                        \
+            goto vm_preempt;                                                   \
+        DISPATCH();                                                            \
+    } while (0)
+
+// Branch to the record at IMM. Backward branches close loops, so they charge
+// the instruction budget with the length of the loop body and check it;
+// forward branches cost nothing extra.
+#define TAKE_BRANCH()                                                          \
+    do {                                                                       \
+        VMInsn *target_ = (VMInsn *)IMM;                                       \
+        if (target_ <= ip && (budget -= ip - target_ + 1) < 0) {               \
+            ip = target_;                                                      \
+            goto vm_preempt;                                                   \
+        }                                                                      \
+        ip = target_;                                                          \
+        DISPATCH();                                                            \
+    } while (0)
+
+// The loop caches sp, bp and the budget in locals; publish them before anything outside
+// the loop looks at the JCC, and pick up any change it made afterwards
+#define SYNC_STATE() (vm->sp = sp, vm->bp = bp, vm->budget = budget)
+#define RELOAD_STATE() (sp = vm->sp, bp = vm->bp, budget = vm->budget)
+
+// Call an out-of-line handler from ops.c, which reads its operands through
+// vm->pc, and leave on failure
+#define CALL_OP(NAME)                                                          \
+    do {                                                                       \
+        vm->pc = CUR_PC + 1;                                                   \
+        SYNC_STATE();                                                          \
+        if (op_##NAME##_fn(vm) != 0)                                           \
+            goto vm_error;                                                     \
+        RELOAD_STATE();                                                        \
+    } while (0)
+
+static void report_overflow(JCC *vm, const char *what, long long a,
+                            const char *op, long long b) {
+    if (vm->quiet_faults)
+        return;
+    printf("\n========== INTEGER OVERFLOW ==========\n");
+    printf("%s overflow detected\n", what);
+    printf("Operands: %lld %s %lld\n", a, op, b);
+    printf("PC:       0x%llx (offset: %lld)\n", (long long)vm->pc,
+           (long long)(vm->pc - vm->text_seg));
+    printf("======================================\n");
+}
+
+#include "vm_body.h"
+
+// Safety flag groups. Every combination gets its own copy of the dispatch
+// loop; VM_GROUP_HOOKS selects the instrumented copy used for the debugger
+// and --debug tracing, which enables every group and tests flags at runtime.
+#define VM_GROUP_OVERFLOW 1  // JCC_OVERFLOW_CHECKS
+#define VM_GROUP_FRAME 2     // JCC_STACK_CANARIES, JCC_CFI, JCC_STACK_INSTR
+#define VM_GROUP_POINTERS 4  // CHKP3/CHKA3/CHKT3 runtime checks
+#define VM_GROUP_HOOKS 8
+
+#define VM_FRAME_FLAGS (JCC_STACK_CANARIES | JCC_CFI | JCC_STACK_INSTR)
+#define VM_POINTER_FLAGS                                                       \
+    (JCC_POINTER_CHECKS | JCC_ALIGNMENT_CHECKS | JCC_TYPE_CHECKS)
+
+// Opcode whose handler a record runs in the given loop. The hooks loop and a
+// run under the debugger must see every component of a superinstruction (a
+// breakpoint may sit on any of them), so there a fused record runs only its
+// first component.
+static int vm_bound_op(JCC *vm, int variant, int op) {
+    if ((variant & VM_GROUP_HOOKS) || (vm->flags & JCC_ENABLE_DEBUGGER))
+        return vm_superop_base(op);
+    return op;
+}
+
+#define VM_LOOP_NAME_(V) vm_loop_##V
+#define VM_LOOP_NAME(V) VM_LOOP_NAME_(V)
+
+#define VM_VARIANT 0
+#include "vm_loop.h"
+#define VM_VARIANT 1
+#include "vm_loop.h"
+#define VM_VARIANT 2
+#include "vm_loop.h"
+#define VM_VARIANT 3
+#include "vm_loop.h"
+#define VM_VARIANT 4
+#include "vm_loop.h"
+#define VM_VARIANT 5
+#include "vm_loop.h"
+#define VM_VARIANT 6
+#include "vm_loop.h"
+#define VM_VARIANT 7
+#include "vm_loop.h"
+#define VM_VARIANT 8
+#include "vm_loop.h"
+
+static int (*const vm_loops[])(JCC *vm, void *const **labels) = {
+    vm_loop_0, vm_loop_1, vm_loop_2, vm_loop_3, vm_loop_4,
+    vm_loop_5, vm_loop_6, vm_loop_7, vm_loop_8,
+};
+
+// Point every decoded record at the handler labels of the given loop, then
+// re-arm the breakpoint traps. Under --jit, function entries and loop
+// headers get JITCNT, or JITENT once their function is compiled, swapped
+// over them like a trap. Under --perf-trampolines the other function entries
+// get PERFENT.
+static void vm_bind_handlers(JCC *vm, int variant) {
+    void *const *labels;
+    vm_loops[variant](NULL, &labels);
+    for (long long i = 0; i <= vm->insn_count; i++)
+        vm->insns[i].handler = labels[vm_bound_op(vm, variant, vm->insns[i].op)];
+    vm->insn_variant = variant;
+
+    int counted = variant == 0 && vm->jit;
+    if (counted) {
+        for (long long i = 0; i < vm->insn_count; i++) {
+            if (jit_counted(vm, &vm->insns[i]))
+                vm->insns[i].handler =
+                    labels[jit_entry(vm, &vm->insns[i]) ? JITENT : JITCNT];
         }
     }
 
-    goto *op_table[op];
-#define X(NAME) op_##NAME: return op_##NAME##_fn(vm);
-    OPS_X
-#undef X
-    return -1;
+    if ((vm->perf & PERF_TRAMPOLINES) && !(vm->flags & JCC_ENABLE_DEBUGGER)) {
+        for (long long i = 0; i < vm->insn_count; i++) {
+            VMInsn *insn = &vm->insns[i];
+            if (vm_superop_base(insn->op) == ENT3 &&
+                !(counted && jit_counted(vm, insn)) &&
+                perf_trampoline(vm, insn))
+                insn->handler = labels[PERFENT];
+        }
+    }
+
+    if (vm->flags & JCC_ENABLE_DEBUGGER) {
+        for (int i = 0; i < MAX_BREAKPOINTS; i++) {
+            if (vm->dbg.breakpoints[i].enabled)
+                vm_set_trap(vm, vm->dbg.breakpoints[i].pc, 1);
+        }
+    }
+}
+
+// Arm or disarm the BRK trap for a breakpoint at pc. Like a native debugger
+// patching in a trap instruction, the record's handler is swapped for BRK;
+// its op field keeps the original opcode, which BRK runs after the debugger
+// returns. Before the stream is decoded this is a no-op: vm_bind_handlers()
+// arms every enabled breakpoint.
+void vm_set_trap(JCC *vm, long long *pc, int enable) {
+    if (!vm->insns || vm->insn_variant < 0)
+        return;
+    VMInsn *insn = insn_for_addr(vm, (long long)pc);
+    if (!insn)
+        return;
+    void *const *labels;
+    vm_loops[vm->insn_variant](NULL, &labels);
+    insn->handler =
+        labels[enable ? BRK : vm_bound_op(vm, vm->insn_variant, insn->op)];
 }
 
+// Pick the dispatch loop specialised for the active safety flags and run it
+// from the pre-decoded stream, rebuilding the stream if text_seg changed.
+// Under the debugger the normal loop runs until a BRK trap stops; stepping
+// moves execution to the hooks loop, and it comes back once stepping ends.
 int vm_eval(JCC *vm) {
-    int result = 0;
-    vm->cycle = 0;
-    while ((result = eval1(vm)) == 0) {
-        // Check if program has exited (pc set to NULL by LEV3)
-        if (vm->pc == NULL || vm->pc == 0) {
-            return (int)vm->regs[REG_A0];  // Return value in REG_A0
+    vm->hooked = 0;
+    for (;;) {
+        int variant = 0;
+        if (vm->debug_vm || vm->ngram_profile ||
+            ((vm->flags & JCC_ENABLE_DEBUGGER) && vm_stepping(vm))) {
+            variant = VM_GROUP_HOOKS;
+        } else {
+            if (vm->flags & JCC_OVERFLOW_CHECKS)
+                variant |= VM_GROUP_OVERFLOW;
+            if (vm->flags & VM_FRAME_FLAGS)
+                variant |= VM_GROUP_FRAME;
+            if (vm->flags & VM_POINTER_FLAGS)
+                variant |= VM_GROUP_POINTERS;
         }
+
+        if (!vm->insns || vm->insn_text_seg != vm->text_seg ||
+            vm->insn_text_size != vm->text_ptr - vm->text_seg + 1) {
+            if (vm_predecode(vm) != 0)
+                return -1;
+        }
+
+        // --jit compiles hot functions for the unchecked loop. Native code
+        // does not charge the instruction budget, so bounded runs stay in
+        // the interpreter.
+        int native = variant == 0 && (vm->flags & JCC_JIT) &&
+                     !(vm->flags & JCC_ENABLE_DEBUGGER) && !vm->budget_slice;
+        if (native != (vm->jit != NULL)) {
+            if (!native) {
+                jit_free(vm);
+            } else if (jit_init(vm) < 0) {
+                fprintf(stderr, "warning: --jit is not supported on this "
+                                "platform, interpreting instead\n");
+                vm->flags &= ~JCC_JIT;
+            }
+            vm->insn_variant = -1;
+        }
+        if (vm->insn_variant != variant)
+            vm_bind_handlers(vm, variant);
+
+        int ret = vm_loops[variant](vm, NULL);
+        // A loop leaves with hooks_done set to hand over to the other one
+        if (!vm->dbg.hooks_done)
+            return ret;
     }
-    return result;
 }
 
+// Run the function at text address addr in the interpreter for a call from
+// native code (jit.c). It is entered with a zero return address, so its LEV3
+// leaves the loop through vm_exit. Returns -1, with vm->pc at the fault, if
+// it stopped on an error.
+int vm_call(JCC *vm, long long addr) {
+    if (!insn_for_addr(vm, addr)) {
+        printf("invalid jump target\n");
+        return -1;
+    }
+    *--vm->sp = 0;
+    vm->pc = (long long *)addr;
+    vm_loops[vm->insn_variant](vm, NULL);
+    return vm->pc ? -1 : 0;
+}
+
+#undef RD
+#undef RS1
+#undef RS2
+#undef IMM
+#undef CUR_PC
+#undef NEXT_PC
+#undef DISPATCH
+#undef NEXT
+#undef JUMP_TO_ADDR
+#undef TAKE_BRANCH
+#undef SYNC_STATE
+#undef RELOAD_STATE
+#undef CALL_OP
+#undef INT_RRR
+#undef FLT_RRR
+#undef FLT_CMP
+#undef INT_RR
+
 void cc_init(JCC *vm, uint32_t flags) {
     // Zero-initialize the VM struct
     memset(vm, 0, sizeof(JCC));
@@ -107,6 +602,11 @@ void cc_init(JCC *vm, uint32_t flags) {
 
     // Set defaults
     vm->poolsize = 256 * 1024;  // 256KB default
+    vm->budget = LLONG_MAX;     // Unbounded unless cc_run_for() sets one
+    vm->jit_threshold = JIT_CALL_THRESHOLD;
+    vm->osr_threshold = JIT_LOOP_THRESHOLD;
+    vm->jit_tier = 2;
+    vm->jit_cache_limit = JIT_CACHE_LIMIT;
     vm->debug_vm = 0;
 
     // Set #embed directive defaults
@@ -114,14 +614,6 @@ void cc_init(JCC *vm, uint32_t flags) {
     vm->compiler.embed_hard_limit = 50 * 1024 * 1024;  // 50MB secondary warning
     vm->compiler.embed_hard_error = false;              // Default to warnings, not errors
 
-    // Return buffer pool will be allocated in data segment during codegen
-    vm->compiler.return_buffer_size = 1024;
-    vm->compiler.return_buffer_index = 0;  // Compile-time index (unused with RETBUF)
-    vm->runtime_return_buffer_index = 0;   // Runtime rotation index for RETBUF opcode
-    for (int i = 0; i < RETURN_BUFFER_POOL_SIZE; i++) {
-        vm->compiler.return_buffer_pool[i] = NULL;  // Will be set to data segment locations
-    }
-
     // Initialize parser arena BEFORE init_macros to avoid orphaning blocks
     // (init_macros allocates from the arena, so arena must be initialized first)
     arena_init(&vm->compiler.parser_arena, 0);  // 0 = use default (1MB)
@@ -237,7 +729,12 @@ void cc_destroy(JCC *vm) {
         free(vm->heap_seg);
     if (vm->shadow_stack)
         free(vm->shadow_stack);
-    // return_buffer is part of data_seg, no need to free separately
+    jit_free(vm);
+    perf_free(vm);
+    cc_consteval_free(vm);
+    free(vm->insns);
+    free(vm->insn_at);
+    free(vm->ngram_counts.buckets);
 
     // Free init_state HashMap (string keys, no values to free)
     if (vm->init_state.buckets) {
@@ -325,6 +822,12 @@ void cc_destroy(JCC *vm) {
     if (vm->compiler.included_headers.buckets)
         free(vm->compiler.included_headers.buckets);
 
+    // Free codegen patch lists (names and functions belong to the arena)
+    free(vm->compiler.call_patches);
+    free(vm->compiler.func_addr_patches);
+    free(vm->compiler.goto_patches);
+    free(vm->compiler.label_addrs.buckets);
+
     // Free sorted allocation arrays
     if (vm->sorted_allocs.addresses)
         free(vm->sorted_allocs.addresses);
@@ -389,6 +892,7 @@ void cc_destroy(JCC *vm) {
     // Free URL cache directory
     if (vm->compiler.url_cache_dir)
         free(vm->compiler.url_cache_dir);
+    free(vm->jit_cache_dir);
 
     // Free include_cache HashMap
     if (vm->compiler.include_cache.buckets) {
@@ -425,6 +929,10 @@ void cc_destroy(JCC *vm) {
         }
     }
 
+    // Free the file scope index (the scopes themselves are arena-allocated)
+    for (Scope *sc = vm->compiler.scope; sc; sc = sc->next)
+        free(sc->index.buckets);
+
     // Destroy parser arena (frees all tokens, AST nodes, preprocessor state)
     arena_destroy(&vm->compiler.parser_arena);
 }
@@ -723,7 +1231,8 @@ void cc_load_stdlib(JCC *vm) {
     hashmap_put(&vm->compiler.included_headers, "time.h", (void*)1);
 }
 
-int cc_run(JCC *vm, int argc, char **argv) {
+// Point pc at main() and build its initial frame
+static void vm_start(JCC *vm, int argc, char **argv) {
     if (!vm || !vm->text_seg) {
         error("VM not initialized - call cc_compile first");
     }
@@ -755,5 +1264,37 @@ int cc_run(JCC *vm, int argc, char **argv) {
     *--vm->sp = argc;             // argc parameter (will be at bp+2 after ENT)
     *--vm->sp = 0;                // Return address = NULL (signals exit, will be at bp+1 after ENT)
 
-    return (vm->flags & JCC_ENABLE_DEBUGGER) ? debugger_run(vm, argc, argv) : vm_eval(vm);
+    // main() takes its parameters in registers like every other function
+    vm->regs[REG_A0] = argc;
+    vm->regs[REG_A1] = (long long)argv;
+}
+
+int cc_run(JCC *vm, int argc, char **argv) {
+    vm_start(vm, argc, argv);
+    vm->budget = LLONG_MAX;
+    vm->budget_slice = 0;
+    return (vm->flags & JCC_ENABLE_DEBUGGER) ? debugger_run(vm) : vm_eval(vm);
+}
+
+int cc_run_for(JCC *vm, int argc, char **argv, long long max_instructions,
+               int *exit_code) {
+    vm_start(vm, argc, argv);
+    vm->budget_slice = max_instructions;
+    return cc_resume(vm, exit_code);
+}
+
+int cc_resume(JCC *vm, int *exit_code) {
+    // vm_exit clears pc; a stopped run leaves it at the next instruction
+    if (!vm || !vm->pc)
+        return JCC_RUN_ERROR;
+
+    vm->budget = vm->budget_slice;
+    int ret = vm_eval(vm);
+    if (!vm->pc) {
+        if (exit_code)
+            *exit_code = ret;
+        return JCC_RUN_FINISHED;
+    }
+    // vm_preempt is the only way out with the budget overdrawn
+    return vm->budget < 0 ? JCC_RUN_EXHAUSTED : JCC_RUN_ERROR;
 }
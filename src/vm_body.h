@@ -0,0 +1,359 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+ This file was based on c4 by Robert Swierczek (rswier/c4) and the following
+ write-a-C-interpreter tutorial by Jinzhou Zhang (lotabout/write-a-C-interpreter)
+*/
+
+/*
+ * Opcode bodies, shared by the dispatch loops (vm_loop.h, through vm.c) and
+ * the copy-and-patch stencils of --jit (src/stencils/stencils.c).
+ *
+ * The includer defines the operand accessors RD, RS1, RS2, IMM and CMP_IMM,
+ * CUR_PC, the locals regs, fregs, sp and bp next to the JCC *vm, VM_FLAG(),
+ * TAKE_BRANCH() and report_overflow(), and a vm_error label that failures
+ * jump to after printing their report.
+ */
+
+#ifndef VM_BODY_H
+#define VM_BODY_H
+
+// Fault reports are not printed when vm->quiet_faults is set
+#define REPORT(...)                                                            \
+    do {                                                                       \
+        if (!vm->quiet_faults)                                                 \
+            printf(__VA_ARGS__);                                               \
+    } while (0)
+
+#define INT_RRR(EXPR)                                                          \
+    do {                                                                       \
+        long long a = regs[RS1], b = regs[RS2];                                \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = (EXPR);                                                 \
+    } while (0)
+#define FLT_RRR(EXPR)                                                          \
+    do {                                                                       \
+        double a = fregs[RS1], b = fregs[RS2];                                 \
+        fregs[RD] = (EXPR);                                                    \
+    } while (0)
+#define FLT_CMP(EXPR)                                                          \
+    do {                                                                       \
+        double a = fregs[RS1], b = fregs[RS2];                                 \
+        regs[RD] = (EXPR);                                                     \
+    } while (0)
+#define INT_RR(EXPR)                                                           \
+    do {                                                                       \
+        long long a = regs[RS1];                                               \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = (EXPR);                                                 \
+    } while (0)
+
+// Opcode bodies. Each runs one instruction against the record at ip without
+// advancing it; vm_loop.h turns them into handlers (BODY_X; NEXT();) and
+// chains them into superinstructions. superops.py scans this list for the
+// opcodes it may fuse: bodies that DISPATCH transfer control and can only
+// end a superinstruction.
+#define ADD_CHECKED(B)                                                         \
+    do {                                                                       \
+        long long a = regs[RS1], b = (B);                                      \
+        if (VM_FLAG(VM_CHECK_OVERFLOW, JCC_OVERFLOW_CHECKS)) {                 \
+            if ((b > 0 && a > LLONG_MAX - b) ||                                \
+                (b < 0 && a < LLONG_MIN - b)) {                                \
+                vm->pc = CUR_PC;                                               \
+                report_overflow(vm, "Addition", a, "+", b);                    \
+                goto vm_error;                                                 \
+            }                                                                  \
+        }                                                                      \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = a + b;                                                  \
+    } while (0)
+#define SUB_CHECKED(B)                                                         \
+    do {                                                                       \
+        long long a = regs[RS1], b = (B);                                      \
+        if (VM_FLAG(VM_CHECK_OVERFLOW, JCC_OVERFLOW_CHECKS)) {                 \
+            if ((b < 0 && a > LLONG_MAX + b) ||                                \
+                (b > 0 && a < LLONG_MIN + b)) {                                \
+                vm->pc = CUR_PC;                                               \
+                report_overflow(vm, "Subtraction", a, "-", b);                 \
+                goto vm_error;                                                 \
+            }                                                                  \
+        }                                                                      \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = a - b;                                                  \
+    } while (0)
+// LLONG_MIN * anything except 0, 1, -1 overflows
+#define MUL_CHECKED(B)                                                         \
+    do {                                                                       \
+        long long a = regs[RS1], b = (B);                                      \
+        if (VM_FLAG(VM_CHECK_OVERFLOW, JCC_OVERFLOW_CHECKS) && a != 0 &&       \
+            b != 0) {                                                          \
+            int overflow = (a == LLONG_MIN || b == LLONG_MIN)                  \
+                ? ((a == LLONG_MIN && b != 1 && b != -1) ||                    \
+                   (b == LLONG_MIN && a != 1 && a != -1))                      \
+                : ((long long)((unsigned long long)a *                         \
+                               (unsigned long long)b) / a != b);               \
+            if (overflow) {                                                    \
+                vm->pc = CUR_PC;                                               \
+                report_overflow(vm, "Multiplication", a, "*", b);              \
+                goto vm_error;                                                 \
+            }                                                                  \
+        }                                                                      \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = a * b;                                                  \
+    } while (0)
+
+#define BODY_ADD3 ADD_CHECKED(regs[RS2])
+#define BODY_SUB3 SUB_CHECKED(regs[RS2])
+#define BODY_MUL3 MUL_CHECKED(regs[RS2])
+#define BODY_DIV3                                                              \
+    do {                                                                       \
+        long long a = regs[RS1], b = regs[RS2];                                \
+        if (b == 0) {                                                          \
+            REPORT("\n========== DIVISION BY ZERO ==========\n");              \
+            REPORT("Attempted division by zero\n");                            \
+            REPORT("Operands: %lld / 0\n", a);                                 \
+            REPORT("PC:       0x%llx (offset: %lld)\n", (long long)CUR_PC,     \
+                   (long long)(CUR_PC - vm->text_seg));                        \
+            REPORT("======================================\n");                \
+            goto vm_error;                                                     \
+        }                                                                      \
+        /* Check for signed division overflow (LLONG_MIN / -1) */              \
+        if (a == LLONG_MIN && b == -1) {                                       \
+            REPORT("\n========== INTEGER OVERFLOW ==========\n");              \
+            REPORT("Division overflow detected\n");                            \
+            REPORT("Operands: %lld / %lld\n", a, b);                           \
+            REPORT("Result would overflow "                                    \
+                   "(LLONG_MIN / -1 = LLONG_MAX + 1)\n");                      \
+            REPORT("PC:       0x%llx (offset: %lld)\n", (long long)CUR_PC,     \
+                   (long long)(CUR_PC - vm->text_seg));                        \
+            REPORT("======================================\n");                \
+            goto vm_error;                                                     \
+        }                                                                      \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = a / b;                                                  \
+    } while (0)
+#define BODY_MOD3                                                              \
+    do {                                                                       \
+        long long a = regs[RS1], b = regs[RS2];                                \
+        if (b == 0) {                                                          \
+            REPORT("\n========== MODULO BY ZERO ==========\n");                \
+            REPORT("Attempted modulo by zero\n");                              \
+            REPORT("Operands: %lld %% 0\n", a);                                \
+            REPORT("PC:       0x%llx (offset: %lld)\n", (long long)CUR_PC,     \
+                   (long long)(CUR_PC - vm->text_seg));                        \
+            REPORT("======================================\n");                \
+            goto vm_error;                                                     \
+        }                                                                      \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = a % b;                                                  \
+    } while (0)
+
+#define BODY_AND3 INT_RRR(a & b)
+#define BODY_OR3 INT_RRR(a | b)
+#define BODY_XOR3 INT_RRR(a ^ b)
+#define BODY_SHL3 INT_RRR(a << b)
+#define BODY_SHR3 INT_RRR(a >> b)
+
+#define BODY_SEQ3 INT_RRR(a == b)
+#define BODY_SNE3 INT_RRR(a != b)
+#define BODY_SLT3 INT_RRR(a < b)
+#define BODY_SGE3 INT_RRR(a >= b)
+#define BODY_SGT3 INT_RRR(a > b)
+#define BODY_SLE3 INT_RRR(a <= b)
+
+#define BODY_LI3                                                               \
+    do {                                                                       \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = IMM;                                                    \
+    } while (0)
+#define BODY_MOV3 INT_RR(a)
+#define BODY_NEG3 INT_RR(-a)
+#define BODY_NOT3 INT_RR(!a)
+#define BODY_BNOT3 INT_RR(~a)
+// Register-immediate ALU forms; arithmetic is overflow-checked like the
+// register-register forms
+#define BODY_ADDI3 ADD_CHECKED(IMM)
+#define BODY_SUBI3 SUB_CHECKED(IMM)
+#define BODY_MULI3 MUL_CHECKED(IMM)
+#define BODY_ANDI3 INT_RR(a & IMM)
+#define BODY_ORI3 INT_RR(a | IMM)
+#define BODY_XORI3 INT_RR(a ^ IMM)
+#define BODY_SHLI3 INT_RR(a << IMM)
+#define BODY_SHRI3 INT_RR(a >> IMM)
+#define BODY_SLTI3 INT_RR(a < IMM)
+// Load effective address: rd = bp + immediate
+#define BODY_LEA3                                                              \
+    do {                                                                       \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = (long long)(bp + IMM);                                  \
+    } while (0)
+
+#define BODY_ENT3                                                              \
+    do {                                                                       \
+        /* A function without a frame (RS2) returns with RET3 */               \
+        if (RS2)                                                               \
+            break;                                                             \
+                                                                               \
+        /* Save old base pointer */                                            \
+        *--sp = (long long)bp;                                                 \
+        bp = sp;                                                               \
+                                                                               \
+        /* If stack canaries are enabled, write canary after old bp */         \
+        if (VM_FLAG(VM_CHECK_FRAME, JCC_STACK_CANARIES))                       \
+            *--sp = vm->stack_canary;                                          \
+                                                                               \
+        /* Allocate space for local variables AND parameters */                \
+        sp = sp - IMM;                                                         \
+                                                                               \
+        /* Copy register arguments to their stack slots at bp[-1-i]            \
+           (shifted down by one when a canary occupies bp[-1]) */              \
+        long long *param_slot = bp - 1;                                        \
+        if (VM_FLAG(VM_CHECK_FRAME, JCC_STACK_CANARIES))                       \
+            param_slot--;                                                      \
+        int int_reg_idx = 0;                                                   \
+        int float_reg_idx = 0;                                                 \
+        for (int i = 0; i < RD; i++, param_slot--) {                           \
+            if (RS1 & (1 << i)) {                                              \
+                /* Float parameter - store double bits as long long */         \
+                memcpy(param_slot, &fregs[FREG_A0 + float_reg_idx++],          \
+                       sizeof(long long));                                     \
+            } else {                                                           \
+                *param_slot = regs[REG_A0 + int_reg_idx++];                    \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        /* Stack overflow checking (for stack instrumentation) */              \
+        if (VM_FLAG(VM_CHECK_FRAME, JCC_STACK_INSTR)) {                        \
+            long long stack_used = (char *)vm->initial_sp - (char *)sp;        \
+            if (stack_used >                                                   \
+                (long long)(vm->poolsize * sizeof(long long) * 3 / 4)) {       \
+                if (vm->flags & JCC_STACK_INSTR_ERRORS) {                      \
+                    printf("\n=========================================="      \
+                           "=\n");                                             \
+                    printf("STACK OVERFLOW: Stack usage exceeded 75%% "        \
+                           "threshold\n");                                     \
+                    printf("  Stack used: %lld bytes\n", stack_used);          \
+                    printf("  Stack size: %lld bytes\n",                       \
+                           (long long)(vm->poolsize * sizeof(long long)));     \
+                    printf("=========================================="        \
+                           "=\n");                                             \
+                    goto vm_error;                                             \
+                } else if (vm->debug_vm) {                                     \
+                    printf("WARNING: Stack usage %lld bytes exceeds "          \
+                           "threshold\n", stack_used);                         \
+                }                                                              \
+            }                                                                  \
+        }                                                                      \
+    } while (0)
+#define BODY_ADJ (sp = sp + IMM)
+#define BODY_PSH3 (*--sp = regs[RD])
+#define BODY_POP3 (regs[RD] = *sp++)
+
+#define BODY_LDR_B INT_RR(*(char *)a)
+#define BODY_LDR_H INT_RR(*(short *)a)
+#define BODY_LDR_W INT_RR(*(int *)a)
+#define BODY_LDR_D INT_RR(*(long long *)a)
+#define BODY_STR_B (*(char *)regs[RS1] = (char)regs[RD])
+#define BODY_STR_H (*(short *)regs[RS1] = (short)regs[RD])
+#define BODY_STR_W (*(int *)regs[RS1] = (int)regs[RD])
+#define BODY_STR_D (*(long long *)regs[RS1] = regs[RD])
+#define BODY_BCPY memmove((void *)regs[RD], (void *)regs[RS1], (size_t)IMM)
+#define BODY_FLDR (fregs[RD] = *(double *)regs[RS1])
+#define BODY_FSTR (*(double *)regs[RS1] = fregs[RD])
+#define BODY_FLI                                                               \
+    do {                                                                       \
+        long long bits = IMM;                                                  \
+        memcpy(&fregs[RD], &bits, sizeof(double));                             \
+    } while (0)
+
+#define BODY_FADD3 FLT_RRR(a + b)
+#define BODY_FSUB3 FLT_RRR(a - b)
+#define BODY_FMUL3 FLT_RRR(a * b)
+#define BODY_FDIV3                                                             \
+    do {                                                                       \
+        if (fregs[RS2] == 0.0) {                                               \
+            REPORT("\n========== DIVISION BY ZERO ==========\n");              \
+            REPORT("Floating-point division by zero detected!\n");             \
+            REPORT("PC offset: %lld\n", (long long)(CUR_PC - vm->text_seg));   \
+            REPORT("======================================\n");                \
+            goto vm_error;                                                     \
+        }                                                                      \
+        fregs[RD] = fregs[RS1] / fregs[RS2];                                   \
+    } while (0)
+#define BODY_FNEG3 (fregs[RD] = -fregs[RS1])
+#define BODY_FEQ3 FLT_CMP(a == b)
+#define BODY_FNE3 FLT_CMP(a != b)
+#define BODY_FLT3 FLT_CMP(a < b)
+#define BODY_FLE3 FLT_CMP(a <= b)
+#define BODY_FGT3 FLT_CMP(a > b)
+#define BODY_FGE3 FLT_CMP(a >= b)
+
+#define BODY_I2F3 (fregs[RD] = (double)regs[RS1])
+#define BODY_F2I3                                                              \
+    do {                                                                       \
+        if (RD != REG_ZERO)                                                    \
+            regs[RD] = (long long)fregs[RS1];                                  \
+    } while (0)
+// Bit-pattern transfers between the integer and float register files
+#define BODY_FR2R                                                              \
+    do {                                                                       \
+        if (RD != REG_ZERO)                                                    \
+            memcpy(&regs[RD], &fregs[RS1], sizeof(long long));                 \
+    } while (0)
+#define BODY_R2FR memcpy(&fregs[RD], &regs[RS1], sizeof(double))
+
+#define BODY_SX1 (regs[RD] = (long long)(char)regs[RS1])
+#define BODY_SX2 (regs[RD] = (long long)(short)regs[RS1])
+#define BODY_SX4 (regs[RD] = (long long)(int)regs[RS1])
+#define BODY_ZX1 (regs[RD] = (long long)(unsigned char)regs[RS1])
+#define BODY_ZX2 (regs[RD] = (long long)(unsigned short)regs[RS1])
+#define BODY_ZX4 (regs[RD] = (long long)(unsigned int)regs[RS1])
+
+#define BODY_JZ3                                                               \
+    do {                                                                       \
+        if (regs[RD] == 0)                                                     \
+            TAKE_BRANCH();                                                     \
+    } while (0)
+#define BODY_JNZ3                                                              \
+    do {                                                                       \
+        if (regs[RD] != 0)                                                     \
+            TAKE_BRANCH();                                                     \
+    } while (0)
+
+// Compare-and-branch: BODY_BRANCH(regs[RD] < regs[RS1]) etc.
+#define BODY_BRANCH(COND)                                                      \
+    do {                                                                       \
+        if (COND)                                                              \
+            TAKE_BRANCH();                                                     \
+    } while (0)
+#define UREG(R) ((unsigned long long)regs[R])
+#define BODY_BEQ BODY_BRANCH(regs[RD] == regs[RS1])
+#define BODY_BNE BODY_BRANCH(regs[RD] != regs[RS1])
+#define BODY_BLT BODY_BRANCH(regs[RD] < regs[RS1])
+#define BODY_BGE BODY_BRANCH(regs[RD] >= regs[RS1])
+#define BODY_BLTU BODY_BRANCH(UREG(RD) < UREG(RS1))
+#define BODY_BGEU BODY_BRANCH(UREG(RD) >= UREG(RS1))
+#define BODY_BEQI BODY_BRANCH(regs[RD] == CMP_IMM)
+#define BODY_BNEI BODY_BRANCH(regs[RD] != CMP_IMM)
+#define BODY_BLTI BODY_BRANCH(regs[RD] < CMP_IMM)
+#define BODY_BGEI BODY_BRANCH(regs[RD] >= CMP_IMM)
+#define BODY_BLTUI BODY_BRANCH(UREG(RD) < (unsigned long long)CMP_IMM)
+#define BODY_BGEUI BODY_BRANCH(UREG(RD) >= (unsigned long long)CMP_IMM)
+#define BODY_JMP TAKE_BRANCH()
+
+#endif
@@ -0,0 +1,529 @@
+/*
+ JCC: JIT C Compiler
+
+ Copyright (C) 2025 George Watson
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+/*
+ * Dispatch loop template, included by vm.c once per loop variant.
+ *
+ * Define VM_VARIANT to a literal combination of VM_GROUP_* bits before
+ * including. Each variant is a direct-threaded interpreter over the
+ * pre-decoded VMInsn stream: every opcode is a label, ip points at the record
+ * being executed and handlers finish with NEXT(), which jumps straight to the
+ * following record's handler. All failures leave through vm_error.
+ *
+ * Called with vm == NULL the loop only reports its label table, which
+ * vm_bind_handlers() stores into the records.
+ *
+ * ip, sp, bp, the budget and the register file bases live in host locals for
+ * the whole run. They are written back to the JCC only where code outside the
+ * loop can see them: out-of-line handlers (CALL_OP, which covers FFI), the
+ * debugger hooks and BRK traps, vm_error, vm_preempt, vm_switch and vm_exit.
+ *
+ * The instruction budget of cc_run_for() is charged only at backward
+ * branches (TAKE_BRANCH) and calls, and checked there and at indirect
+ * jumps, so unbounded runs pay one compare per taken loop branch.
+ *
+ * Safety flags are tested through VM_FLAG(group, flag), which folds to 0 when
+ * the group is compiled out of this variant, so a run without safety checks
+ * executes no flag tests at all.
+ */
+
+#ifndef VM_VARIANT
+#error "define VM_VARIANT before including vm_loop.h"
+#endif
+
+#define VM_LOOP VM_LOOP_NAME(VM_VARIANT)
+#define VM_HOOKS ((VM_VARIANT) & VM_GROUP_HOOKS)
+#define VM_CHECK_OVERFLOW (VM_HOOKS || ((VM_VARIANT) & VM_GROUP_OVERFLOW))
+#define VM_CHECK_FRAME (VM_HOOKS || ((VM_VARIANT) & VM_GROUP_FRAME))
+#define VM_CHECK_POINTERS (VM_HOOKS || ((VM_VARIANT) & VM_GROUP_POINTERS))
+#define VM_FLAG(GROUP, FLAG) ((GROUP) && (vm->flags & (FLAG)))
+
+static int VM_LOOP(JCC *vm, void *const **labels) {
+    static void *const op_table[NUM_OPS + 1] = {
+#define X(NAME) [NAME] = &&op_##NAME,
+        OPS_X
+#undef X
+        [NUM_OPS] = &&vm_bad_op,
+    };
+    VMInsn *ip;
+    long long *sp, *bp, *regs, budget;
+    double *fregs;
+
+    if (labels) {
+        *labels = op_table;
+        return 0;
+    }
+
+    regs = vm->regs;
+    fregs = vm->fregs;
+    RELOAD_STATE();
+    ip = insn_for_addr(vm, (long long)vm->pc);
+    if (!ip) {
+        if (!vm->quiet_faults)
+            printf("invalid entry point\n");
+        return -1;
+    }
+    if (vm->dbg.hooks_done) {
+        // The debugger already stopped at this instruction
+        vm->dbg.hooks_done = 0;
+        goto *op_table[vm_bound_op(vm, VM_VARIANT, ip->op)];
+    }
+    DISPATCH();
+
+vm_hooks:
+    // Slow path: debugger hooks, n-gram profiling and instruction tracing
+    vm->pc = CUR_PC;
+    vm->hooked++;
+    if (vm->flags & JCC_ENABLE_DEBUGGER) {
+        SYNC_STATE();
+        vm_debug_hooks(vm, ip->handler == op_table[BRK]);
+        RELOAD_STATE();
+        // Once stepping is over, go back to the uninstrumented loop
+        if (!vm_stepping(vm) && !vm->debug_vm && !vm->ngram_profile)
+            goto vm_switch;
+    }
+    if (vm->ngram_profile)
+        vm_count_ngram(vm, ip);
+    if (vm->debug_vm && ip->op < NUM_OPS)
+        printf("%lld> %s\n", vm->hooked, op_names[ip->op]);
+    goto *ip->handler;
+
+    // ========== Arithmetic Operations ==========
+
+op_ADD3: BODY_ADD3; NEXT();
+op_SUB3: BODY_SUB3; NEXT();
+op_MUL3: BODY_MUL3; NEXT();
+op_DIV3: BODY_DIV3; NEXT();
+op_MOD3: BODY_MOD3; NEXT();
+
+    // ========== Bitwise Operations ==========
+
+op_AND3: BODY_AND3; NEXT();
+op_OR3:  BODY_OR3;  NEXT();
+op_XOR3: BODY_XOR3; NEXT();
+op_SHL3: BODY_SHL3; NEXT();
+op_SHR3: BODY_SHR3; NEXT();
+
+    // ========== Comparison Operations ==========
+
+op_SEQ3: BODY_SEQ3; NEXT();
+op_SNE3: BODY_SNE3; NEXT();
+op_SLT3: BODY_SLT3; NEXT();
+op_SGE3: BODY_SGE3; NEXT();
+op_SGT3: BODY_SGT3; NEXT();
+op_SLE3: BODY_SLE3; NEXT();
+
+    // ========== Data Movement ==========
+
+op_LI3:   BODY_LI3;   NEXT();
+op_MOV3:  BODY_MOV3;  NEXT();
+op_NEG3:  BODY_NEG3;  NEXT();
+op_NOT3:  BODY_NOT3;  NEXT();
+op_BNOT3: BODY_BNOT3; NEXT();
+op_ADDI3: BODY_ADDI3; NEXT();
+op_SUBI3: BODY_SUBI3; NEXT();
+op_MULI3: BODY_MULI3; NEXT();
+op_ANDI3: BODY_ANDI3; NEXT();
+op_ORI3:  BODY_ORI3;  NEXT();
+op_XORI3: BODY_XORI3; NEXT();
+op_SHLI3: BODY_SHLI3; NEXT();
+op_SHRI3: BODY_SHRI3; NEXT();
+op_SLTI3: BODY_SLTI3; NEXT();
+op_LEA3:  BODY_LEA3;  NEXT();
+
+    // ========== Register-Based Control Flow ==========
+
+op_JZ3:  BODY_JZ3;  NEXT();
+op_JNZ3: BODY_JNZ3; NEXT();
+
+op_BEQ:   BODY_BEQ;   NEXT();
+op_BNE:   BODY_BNE;   NEXT();
+op_BLT:   BODY_BLT;   NEXT();
+op_BGE:   BODY_BGE;   NEXT();
+op_BLTU:  BODY_BLTU;  NEXT();
+op_BGEU:  BODY_BGEU;  NEXT();
+op_BEQI:  BODY_BEQI;  NEXT();
+op_BNEI:  BODY_BNEI;  NEXT();
+op_BLTI:  BODY_BLTI;  NEXT();
+op_BGEI:  BODY_BGEI;  NEXT();
+op_BLTUI: BODY_BLTUI; NEXT();
+op_BGEUI: BODY_BGEUI; NEXT();
+
+    // ========== Register-Based Calling Convention ==========
+
+op_ENT3:
+    // Enter function: imm = stack_size, rd = register param count,
+    // rs1 = float_param_mask, rs2 = ENT3_NO_FRAME. Creates new stack frame
+    // and copies REG_A0-REG_An and FREG_A0-FREG_An to parameter slots
+    BODY_ENT3;
+    NEXT();
+
+op_RET3:
+    // Leave a function that did not open a frame: only the return address
+    // is on the stack, and bp is still the caller's
+    {
+        long long ret_addr = *sp++;
+
+        if (VM_FLAG(VM_CHECK_FRAME, JCC_CFI)) {
+            long long shadow_ret_addr = *vm->shadow_sp++;
+            if (shadow_ret_addr != ret_addr) {
+                printf("\n========== CFI VIOLATION ==========\n");
+                printf("Control flow integrity violation detected!\n");
+                printf("Expected return address: 0x%llx\n", shadow_ret_addr);
+                printf("Actual return address:   0x%llx\n", ret_addr);
+                printf("Current PC offset:       %lld\n",
+                       (long long)ip->text_off);
+                printf("This indicates a ROP attack or stack corruption.\n");
+                printf("====================================\n");
+                goto vm_error;
+            }
+        }
+
+        if (ret_addr == 0)
+            goto vm_exit;
+        JUMP_TO_ADDR(ret_addr);
+    }
+
+op_LEV3:
+    // Leave function: return value already in REG_A0/FREG_A0, restore frame
+    {
+        sp = bp;
+
+        // If stack canaries are enabled, check canary
+        if (VM_FLAG(VM_CHECK_FRAME, JCC_STACK_CANARIES)) {
+            long long canary = sp[-1];
+            if (canary != vm->stack_canary) {
+                printf("\n========== STACK OVERFLOW DETECTED ==========\n");
+                printf("Stack canary corrupted!\n");
+                printf("Expected: 0x%llx\n", vm->stack_canary);
+                printf("Found:    0x%llx\n", canary);
+                printf("PC:       0x%llx (offset: %lld)\n", (long long)CUR_PC,
+                       (long long)ip->text_off);
+                printf("This indicates a stack buffer overflow.\n");
+                printf("=============================================\n");
+                goto vm_error;
+            }
+        }
+
+        // Restore old base pointer and pop the return address
+        bp = (long long *)*sp++;
+        long long ret_addr = *sp++;
+
+        // CFI validation
+        if (VM_FLAG(VM_CHECK_FRAME, JCC_CFI)) {
+            long long shadow_ret_addr = *vm->shadow_sp++;
+            if (shadow_ret_addr != ret_addr) {
+                printf("\n========== CFI VIOLATION ==========\n");
+                printf("Control flow integrity violation detected!\n");
+                printf("Expected return address: 0x%llx\n", shadow_ret_addr);
+                printf("Actual return address:   0x%llx\n", ret_addr);
+                printf("Current PC offset:       %lld\n",
+                       (long long)ip->text_off);
+                printf("This indicates a ROP attack or stack corruption.\n");
+                printf("====================================\n");
+                goto vm_error;
+            }
+        }
+
+        // Returning from main (ret_addr == 0) ends execution
+        if (ret_addr == 0)
+            goto vm_exit;
+        JUMP_TO_ADDR(ret_addr);
+    }
+
+op_ADJ:  BODY_ADJ;  NEXT();
+op_PSH3: BODY_PSH3; NEXT();
+op_POP3: BODY_POP3; NEXT();
+
+    // ========== Register-Based Load/Store ==========
+
+op_LDR_B: BODY_LDR_B; NEXT();
+op_LDR_H: BODY_LDR_H; NEXT();
+op_LDR_W: BODY_LDR_W; NEXT();
+op_LDR_D: BODY_LDR_D; NEXT();
+op_STR_B: BODY_STR_B; NEXT();
+op_STR_H: BODY_STR_H; NEXT();
+op_STR_W: BODY_STR_W; NEXT();
+op_STR_D: BODY_STR_D; NEXT();
+op_BCPY:  BODY_BCPY;  NEXT();
+op_FLDR:  BODY_FLDR;  NEXT();
+op_FSTR:  BODY_FSTR;  NEXT();
+op_FLI:   BODY_FLI;   NEXT();
+
+    // ========== Floating-Point Operations ==========
+
+op_FADD3: BODY_FADD3; NEXT();
+op_FSUB3: BODY_FSUB3; NEXT();
+op_FMUL3: BODY_FMUL3; NEXT();
+op_FDIV3: BODY_FDIV3; NEXT();
+op_FNEG3: BODY_FNEG3; NEXT();
+op_FEQ3:  BODY_FEQ3;  NEXT();
+op_FNE3:  BODY_FNE3;  NEXT();
+op_FLT3:  BODY_FLT3;  NEXT();
+op_FLE3:  BODY_FLE3;  NEXT();
+op_FGT3:  BODY_FGT3;  NEXT();
+op_FGE3:  BODY_FGE3;  NEXT();
+op_I2F3:  BODY_I2F3;  NEXT();
+op_F2I3:  BODY_F2I3;  NEXT();
+op_FR2R:  BODY_FR2R;  NEXT();
+op_R2FR:  BODY_R2FR;  NEXT();
+
+    // ========== Type Conversion ==========
+
+op_SX1: BODY_SX1; NEXT();
+op_SX2: BODY_SX2; NEXT();
+op_SX4: BODY_SX4; NEXT();
+op_ZX1: BODY_ZX1; NEXT();
+op_ZX2: BODY_ZX2; NEXT();
+op_ZX4: BODY_ZX4; NEXT();
+
+    // ========== Control Flow ==========
+
+op_JMP: BODY_JMP;
+
+op_CALL:
+    // Push return address to main stack (and shadow stack for CFI)
+    *--sp = (long long)NEXT_PC;
+    if (VM_FLAG(VM_CHECK_FRAME, JCC_CFI))
+        *--vm->shadow_sp = (long long)NEXT_PC;
+    ip = (VMInsn *)IMM;
+    // Calls (like backward branches) charge the instruction budget
+    if (--budget < 0)
+        goto vm_preempt;
+    DISPATCH();
+
+op_CALLI:
+    // Call indirect: function address in register
+    *--sp = (long long)NEXT_PC;
+    if (VM_FLAG(VM_CHECK_FRAME, JCC_CFI))
+        *--vm->shadow_sp = (long long)NEXT_PC;
+    budget--;
+    JUMP_TO_ADDR(regs[RD]);
+
+op_JMPT:
+    // Jump table: [rs] [count] [table]. The table is count consecutive JMP
+    // records; an index past its end falls through (to the default jump).
+    if (UREG(RD) < (unsigned long long)CMP_IMM) {
+        ip = (VMInsn *)IMM + regs[RD];
+        DISPATCH();
+    }
+    NEXT();
+
+op_JMPI:
+    JUMP_TO_ADDR(regs[RD]);
+
+    // ========== Memory Operations ==========
+
+op_MALC:  CALL_OP(MALC);  NEXT();
+op_MFRE:  CALL_OP(MFRE);  NEXT();
+op_REALC: CALL_OP(REALC); NEXT();
+op_CALC:  CALL_OP(CALC);  NEXT();
+
+    // ========== Safety Opcodes ==========
+
+op_CHKP3:
+    if (VM_CHECK_POINTERS)
+        CALL_OP(CHKP3);
+    NEXT();
+op_CHKA3:
+    if (VM_CHECK_POINTERS)
+        CALL_OP(CHKA3);
+    NEXT();
+op_CHKT3:
+    if (VM_CHECK_POINTERS)
+        CALL_OP(CHKT3);
+    NEXT();
+
+    // Legacy instrumentation opcodes are stubs
+op_CHKB:
+op_CHKI:
+op_MARKI:
+op_SCOPEIN:
+op_SCOPEOUT:
+op_CHKL:
+op_MARKR:
+op_MARKW:
+op_MARKA:
+op_MARKP:
+op_CHKPA:
+    NEXT();
+
+    // ========== Setjmp/Longjmp ==========
+
+op_SETJMP:
+    // setjmp: jmp_buf address in REG_A0, return 0 in REG_A0
+    {
+        long long *jmp_buf = (long long *)regs[REG_A0];
+        jmp_buf[0] = (long long)NEXT_PC;
+        jmp_buf[1] = (long long)sp;
+        jmp_buf[2] = (long long)bp;
+        // Callee-saved registers, which may hold promoted locals of the
+        // frames a longjmp skips
+        memcpy(&jmp_buf[5], &regs[REG_S0], 8 * sizeof(long long));
+        regs[REG_A0] = 0;
+    }
+    NEXT();
+
+op_LONGJMP:
+    // longjmp: jmp_buf address in REG_A0, value in REG_A1
+    {
+        long long *jmp_buf = (long long *)regs[REG_A0];
+        long long val = regs[REG_A1];
+        sp = (long long *)jmp_buf[1];
+        bp = (long long *)jmp_buf[2];
+        memcpy(&regs[REG_S0], &jmp_buf[5], 8 * sizeof(long long));
+        regs[REG_A0] = val ? val : 1; // Return value (never 0)
+        JUMP_TO_ADDR(jmp_buf[0]);
+    }
+
+    // ========== FFI ==========
+
+op_CALLF: CALL_OP(CALLF); NEXT();
+
+    // ========== Debugger ==========
+
+op_BRK:
+    // Breakpoint trap (see vm_set_trap). The hooks loop has already stopped
+    // in vm_hooks; elsewhere stop now. Then run the record's own opcode, in
+    // the hooks loop if the debugger asked to step.
+    if (!VM_HOOKS) {
+        vm->pc = CUR_PC;
+        SYNC_STATE();
+        vm_debug_hooks(vm, 1);
+        RELOAD_STATE();
+        if (vm_stepping(vm))
+            goto vm_switch;
+    }
+    goto *op_table[vm_bound_op(vm, VM_VARIANT, ip->op)];
+
+    // ========== Native Code ==========
+
+op_JITENT:
+    // Bound over the ENT3 or a loop header of a function compiled by --jit
+    // (see jit.c). The native code runs from here to the function's return
+    // and returns the VM return address.
+    {
+        SYNC_STATE();
+        long long ret_addr = jit_enter(vm, ip);
+        RELOAD_STATE();
+        if (ret_addr == JIT_ERROR) {
+            // vm->pc is at the faulting instruction
+            VMInsn *fault = insn_for_addr(vm, (long long)vm->pc);
+            if (fault)
+                ip = fault;
+            goto vm_error;
+        }
+        if (ret_addr == 0)
+            goto vm_exit;
+        JUMP_TO_ADDR(ret_addr);
+    }
+
+op_JITCNT:
+    // Bound over the ENT3 or a loop header of a function --jit has not
+    // compiled. jit_hot() counts the visit and compiles the function once it
+    // is hot; until then the record runs its own opcode.
+    switch (jit_hot(vm, ip)) {
+        case 1:
+            ip->handler = op_table[JITENT];
+            goto op_JITENT;
+        case -1:
+            // It will never be compiled: stop counting
+            ip->handler = op_table[vm_bound_op(vm, VM_VARIANT, ip->op)];
+            break;
+    }
+    goto *op_table[vm_bound_op(vm, VM_VARIANT, ip->op)];
+
+op_PERFENT:
+    // Bound over the ENT3 of an interpreted function under
+    // --perf-trampolines (see perf.c). The function runs to its return in a
+    // nested loop entered through its trampoline, which starts back at this
+    // record to run its own opcode.
+    if (vm->perf_entry == ip || vm->budget_slice ||
+        vm->perf_depth >= PERF_MAX_DEPTH) {
+        vm->perf_entry = NULL;
+        goto *op_table[vm_bound_op(vm, VM_VARIANT, ip->op)];
+    }
+    {
+        long long ret_addr = *sp++;
+        SYNC_STATE();
+        int failed = perf_enter(vm, ip);
+        RELOAD_STATE();
+        if (failed) {
+            // vm->pc is at the faulting instruction
+            VMInsn *fault = insn_for_addr(vm, (long long)vm->pc);
+            if (fault)
+                ip = fault;
+            goto vm_error;
+        }
+        if (ret_addr == 0)
+            goto vm_exit;
+        JUMP_TO_ADDR(ret_addr);
+    }
+
+    // ========== Superinstructions ==========
+    // Run each component's body against its own record, so operands, error
+    // offsets and jump targets into the middle of a sequence stay valid.
+
+#define S2(NAME, A, B)                                                         \
+    op_##NAME: BODY_##A; ip++; BODY_##B; NEXT();
+#define S3(NAME, A, B, C)                                                      \
+    op_##NAME: BODY_##A; ip++; BODY_##B; ip++; BODY_##C; NEXT();
+    SUPEROPS_DEF
+#undef S2
+#undef S3
+
+vm_bad_target:
+    printf("invalid jump target\n");
+    goto vm_error;
+vm_bad_op:
+    if (ip->text_off < vm->insn_text_size)
+        printf("unknown instruction:%lld\n", vm->text_seg[ip->text_off]);
+    else
+        printf("execution ran past the end of the text segment\n");
+vm_error:
+    vm->pc = CUR_PC;
+    SYNC_STATE();
+    return -1;
+
+vm_preempt:
+    // Instruction budget exhausted: stop before ip; cc_resume() continues
+    vm->pc = CUR_PC;
+    SYNC_STATE();
+    return 0;
+
+vm_switch:
+    // Hand the instruction at ip over to the other loop (vm_eval picks it)
+    vm->pc = CUR_PC;
+    SYNC_STATE();
+    vm->dbg.hooks_done = 1;
+    return 0;
+
+vm_exit:
+    vm->pc = NULL;
+    SYNC_STATE();
+    return (int)regs[REG_A0];  // Return value in REG_A0
+}
+
+#undef VM_LOOP
+#undef VM_HOOKS
+#undef VM_CHECK_OVERFLOW
+#undef VM_CHECK_FRAME
+#undef VM_CHECK_POINTERS
+#undef VM_FLAG
+#undef VM_VARIANT
@@ -0,0 +1,311 @@
+#!/usr/bin/env python3
+# Generate src/stencils.h from src/stencils/stencils.c
+#
+# Usage: stencils.py [cc]
+#
+# Compiles the stencil sources with the host C compiler (default: $CC or cc)
+# for x86-64 and reads the object file directly: every stencil_<OP> function
+# becomes a machine code template, and every relocation in it a hole that
+# jit.c patches when it copies the template (see "Stencil Tier" in jit.c).
+# `make stencils` runs this script.
+
+import os
+import re
+import shlex
+import struct
+import subprocess
+import sys
+import tempfile
+
+STENCIL_SOURCE = "src/stencils/stencils.c"
+OUTPUT_FILE = "src/stencils.h"
+# Sources of the stencil bodies; their vm->field references are the JCC
+# fields whose offsets are compiled into the stencils
+LAYOUT_SOURCES = [STENCIL_SOURCE, "src/vm_body.h"]
+
+CFLAGS = [
+    "-c", "-O2", "-std=gnu99", "-w",
+    # Absolute 64-bit addresses for everything, so every reference to a
+    # hole, a function or constant data is one R_X86_64_64 relocation
+    "-fno-pic", "-fno-pie", "-mcmodel=large",
+    # One section per stencil and per constant, nothing outside of them
+    "-ffunction-sections", "-fdata-sections",
+    "-fno-asynchronous-unwind-tables", "-fno-stack-protector",
+    "-fcf-protection=none", "-fno-jump-tables",
+    "-fno-reorder-blocks-and-partition",
+    # Tail calls must not be given a frame to tear down
+    "-fomit-frame-pointer",
+]
+
+# Per-instruction values patched by jit.c (HOLE(NAME) in stencils.c)
+HOLES = ["CONTINUE", "TARGET", "RD", "RS1", "RS2", "IMM", "CMP_IMM", "PC",
+         "CALLEE", "COUNTER", "INSN"]
+
+R_X86_64_64 = 1
+SHT_SYMTAB = 2
+SHT_RELA = 4
+SHN_UNDEF = 0
+
+
+class ElfError(Exception):
+    pass
+
+
+def read_elf(data):
+    # Sections by name, symbols, and the relocations of each section
+    if data[:4] != b"\x7fELF" or data[4] != 2 or data[5] != 1:
+        raise ElfError("not a little-endian ELF64 object")
+    (e_machine,) = struct.unpack_from("<H", data, 18)
+    if e_machine != 62:
+        raise ElfError("not an x86-64 object")
+    e_shoff, = struct.unpack_from("<Q", data, 40)
+    e_shentsize, e_shnum, e_shstrndx = struct.unpack_from("<HHH", data, 58)
+
+    sections = []
+    for i in range(e_shnum):
+        (name, stype, flags, addr, offset, size, link, info, align,
+         entsize) = struct.unpack_from("<IIQQQQIIQQ", data,
+                                       e_shoff + i * e_shentsize)
+        sections.append({"name": name, "type": stype, "offset": offset,
+                         "size": size, "link": link, "info": info,
+                         "align": max(align, 1)})
+
+    def cstr(table, off):
+        start = sections[table]["offset"] + off
+        return data[start:data.index(b"\0", start)].decode()
+
+    for s in sections:
+        s["name"] = cstr(e_shstrndx, s["name"])
+        s["data"] = data[s["offset"]:s["offset"] + s["size"]]
+
+    symbols = []
+    for s in sections:
+        if s["type"] != SHT_SYMTAB:
+            continue
+        for off in range(0, s["size"], 24):
+            name, info, other, shndx, value, size = struct.unpack_from(
+                "<IBBHQQ", s["data"], off)
+            symbols.append({"name": cstr(s["link"], name), "shndx": shndx,
+                            "value": value, "type": info & 15})
+
+    relocs = {}
+    for s in sections:
+        if s["type"] != SHT_RELA:
+            continue
+        entries = []
+        for off in range(0, s["size"], 24):
+            r_offset, r_info, r_addend = struct.unpack_from("<QQq", s["data"],
+                                                            off)
+            entries.append((r_offset, r_info & 0xffffffff, r_info >> 32,
+                            r_addend))
+        relocs[s["info"]] = entries
+    return sections, symbols, relocs
+
+
+def used_fields():
+    # JCC fields the stencils access, as `vm->field` outside of comments
+    fields = set()
+    for path in LAYOUT_SOURCES:
+        with open(path) as f:
+            text = re.sub(r"/\*.*?\*/|//[^\n]*", "", f.read(), flags=re.S)
+        fields.update(re.findall(r"\bvm->(\w+(?:\.\w+)*)", text))
+    return sorted(fields)
+
+
+def compile_stencils(cc, fields):
+    with tempfile.TemporaryDirectory() as tmp:
+        obj = os.path.join(tmp, "stencils.o")
+        layout = "".join(f"FIELD({name})" for name in fields)
+        cmd = shlex.split(cc) + CFLAGS + [f"-DSTENCIL_FIELDS={layout}",
+                                          "-o", obj, STENCIL_SOURCE]
+        result = subprocess.run(cmd)
+        if result.returncode != 0:
+            raise ElfError(f"{' '.join(cmd)} failed")
+        with open(obj, "rb") as f:
+            return f.read()
+
+
+def tail_jump(code, at):
+    # End of the `jmp reg` that the 8-byte field at `at` is loaded for, or 0.
+    # Only the epilogue (pops and the stack adjustment) may come in between.
+    end = at + 8
+    while end < len(code):
+        if code[end] == 0x41 and end + 1 < len(code):
+            op = code[end + 1]
+            if 0x58 <= op <= 0x5f:
+                end += 2
+                continue
+            if op == 0xff and end + 2 < len(code) and \
+                    code[end + 2] & 0xf8 == 0xe0:
+                return end + 3
+            return 0
+        if 0x58 <= code[end] <= 0x5f:
+            end += 1
+        elif code[end:end + 3] == b"\x48\x83\xc4":
+            end += 4
+        elif code[end] == 0xff and end + 1 < len(code) and \
+                code[end + 1] & 0xf8 == 0xe0:
+            return end + 2
+        else:
+            return 0
+    return 0
+
+
+def main():
+    cc = sys.argv[1] if len(sys.argv) > 1 else os.environ.get("CC", "cc")
+    fields = used_fields()
+    try:
+        sections, symbols, relocs = read_elf(compile_stencils(cc, fields))
+    except ElfError as e:
+        print(f"Error: {e}")
+        sys.exit(1)
+
+    layout = next((s for s in sections
+                   if s["name"] == ".rodata.stencil_layout"), None)
+    if layout is None:
+        print("Error: stencil_layout not found")
+        sys.exit(1)
+    insn_size, *offsets = struct.unpack_from(f"<{1 + len(fields)}Q",
+                                             layout["data"])
+
+    data = bytearray()   # Constant data referenced by the stencils
+    data_at = {}         # Section index -> offset in data
+    externals = []       # Functions called by the stencils
+    stencils = []        # (op, code, trim, holes)
+    errors = []
+
+    for index, s in enumerate(sections):
+        if not s["name"].startswith(".text.stencil_"):
+            continue
+        op = s["name"][len(".text.stencil_"):]
+        code = s["data"]
+        holes = []
+        for r_offset, r_type, r_sym, r_addend in relocs.get(index, []):
+            if r_type != R_X86_64_64:
+                errors.append(f"{op}: unsupported relocation type {r_type}")
+                continue
+            sym = symbols[r_sym]
+            if sym["shndx"] == SHN_UNDEF:
+                name = sym["name"]
+                if name.startswith("_JIT_"):
+                    if name[5:] not in HOLES:
+                        errors.append(f"{op}: unknown hole {name}")
+                        continue
+                    kind = "HOLE_" + name[5:]
+                    if name[5:] in ("CONTINUE", "TARGET") and \
+                            not tail_jump(code, r_offset):
+                        errors.append(f"{op}: {name} is not a tail call")
+                else:
+                    if name not in externals:
+                        externals.append(name)
+                    kind = f"HOLE_SYMBOL + {externals.index(name)}"
+                holes.append((r_offset, kind, r_addend))
+                continue
+
+            target = sections[sym["shndx"]]
+            if not target["name"].startswith(".rodata"):
+                errors.append(f"{op}: reference to {target['name']}")
+                continue
+            if sym["shndx"] not in data_at:
+                data.extend(b"\0" * (-len(data) % target["align"]))
+                data_at[sym["shndx"]] = len(data)
+                data.extend(target["data"])
+            addend = data_at[sym["shndx"]] + sym["value"] + r_addend
+            holes.append((r_offset, "HOLE_DATA", addend))
+
+        # A trailing jump to the next instruction is dropped when it follows
+        trim = 0
+        for r_offset, kind, addend in holes:
+            jump = code[r_offset + 8:]
+            if kind == "HOLE_CONTINUE" and r_offset >= 2 and \
+                    jump[-2:-1] == b"\xff" and jump[-1] & 0xf8 == 0xe0 and \
+                    jump[:-2] in (b"", b"\x41"):
+                trim = len(code) - (r_offset - 2)
+        stencils.append((op, code, trim, sorted(holes)))
+
+    if errors:
+        for e in errors:
+            print(f"Error: {e}")
+        sys.exit(1)
+
+    with open(OUTPUT_FILE, "w") as out:
+        out.write("/* Auto-generated by stencils.py - DO NOT EDIT */\n")
+        out.write(f"/* Source: {STENCIL_SOURCE}, {len(stencils)} stencils */"
+                  "\n\n")
+
+        out.write("// Layout the stencils were compiled against: the size of "
+                  "VMInsn and the\n")
+        out.write("// offset of every JCC field they access\n")
+        out.write(f"#define STENCIL_INSN_SIZE {insn_size}\n")
+        out.write("#define STENCIL_FIELDS_X")
+        for name, offset in zip(fields, offsets):
+            out.write(f" \\\n    X({name}, {offset})")
+        out.write("\n\n")
+
+        out.write("// What goes into a hole: a value of the instruction, an "
+                  "address in\n")
+        out.write("// stencil_data, or the address of entry kind - "
+                  "HOLE_SYMBOL of STENCIL_SYMBOLS_X\n")
+        out.write("enum {\n")
+        for name in HOLES:
+            out.write(f"    HOLE_{name},\n")
+        out.write("    HOLE_DATA,\n")
+        out.write("    HOLE_SYMBOL,\n")
+        out.write("};\n\n")
+
+        out.write("#define STENCIL_SYMBOLS_X")
+        for name in externals:
+            out.write(f" \\\n    X({name})")
+        out.write("\n\n")
+
+        out.write("typedef struct {\n")
+        out.write("    int offset;         // Byte offset of the 64-bit "
+                  "field in code\n")
+        out.write("    int kind;           // HOLE_*\n")
+        out.write("    long long addend;   // Added to the value\n")
+        out.write("} StencilHole;\n\n")
+        out.write("typedef struct {\n")
+        out.write("    const unsigned char *code;\n")
+        out.write("    int size;           // Bytes of code\n")
+        out.write("    int trim;           // Bytes of a trailing jump to "
+                  "HOLE_CONTINUE, 0 if none\n")
+        out.write("    const StencilHole *holes;\n")
+        out.write("    int nholes;\n")
+        out.write("} Stencil;\n\n")
+
+        out.write("static const unsigned char stencil_data[] "
+                  "__attribute__((aligned(16))) = {")
+        write_bytes(out, data or b"\0")
+        out.write("};\n\n")
+
+        for op, code, trim, holes in stencils:
+            out.write(f"static const unsigned char stencil_code_{op}[] = {{")
+            write_bytes(out, code)
+            out.write("};\n")
+            if holes:
+                out.write(f"static const StencilHole stencil_holes_{op}[] = "
+                          "{\n")
+                for r_offset, kind, addend in holes:
+                    out.write(f"    {{{r_offset}, {kind}, {addend}}},\n")
+                out.write("};\n")
+        out.write("\n")
+
+        out.write("static const Stencil stencils[NUM_OPS] = {\n")
+        for op, code, trim, holes in stencils:
+            table = f"stencil_holes_{op}" if holes else "NULL"
+            out.write(f"    [{op}] = {{stencil_code_{op}, {len(code)}, {trim}, "
+                      f"{table}, {len(holes)}}},\n")
+        out.write("};\n")
+
+    print(f"Generated {OUTPUT_FILE} with {len(stencils)} stencils")
+
+
+def write_bytes(out, data):
+    for i in range(0, len(data), 12):
+        row = ", ".join(f"0x{b:02x}" for b in data[i:i + 12])
+        out.write(f"\n    {row},")
+    out.write("\n")
+
+
+if __name__ == "__main__":
+    main()
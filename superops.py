@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+# Generate src/superops.h from an opcode n-gram profile
+#
+# Usage: superops.py [profile] [max]
+#
+# The profile is written by `jcc --ngram-profile=FILE` (one "count OP1 OP2
+# [OP3]" line per executed straight-line sequence). The most profitable
+# sequences of opcodes that have a BODY_ macro in src/vm_body.h become fused
+# opcodes. `make superops` profiles the test suite and runs this script.
+
+import os
+import re
+import sys
+
+VM_SOURCES = ["src/vm_body.h", "src/vm.c"]
+OUTPUT_FILE = "src/superops.h"
+DEFAULT_MAX = 24
+
+
+def read_bodies():
+    # Map opcode -> True if its body transfers control (may only come last)
+    texts = {}  # every macro, so BODY_ helpers can be followed
+    lines = []
+    for path in VM_SOURCES:
+        with open(path) as f:
+            lines += f.read().split("\n")
+    i = 0
+    while i < len(lines):
+        m = re.match(r"#define (\w+)", lines[i])
+        if not m:
+            i += 1
+            continue
+        text = lines[i][m.end():]
+        while lines[i].endswith("\\"):
+            i += 1
+            text += lines[i]
+        texts[m.group(1)] = text
+        i += 1
+
+    # Bodies may be built from helper macros (e.g. BODY_BRANCH, TAKE_BRANCH)
+    def transfers(name, seen=()):
+        text = texts[name]
+        if "DISPATCH" in text:
+            return True
+        return any(transfers(ref, seen + (name,))
+                   for ref in re.findall(r"\w+", text)
+                   if ref in texts and ref not in seen)
+
+    return {name[5:]: transfers(name)
+            for name in texts if name.startswith("BODY_")}
+
+
+def read_profile(path):
+    counts = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if not fields or fields[0].startswith("#") or len(fields) < 3:
+                continue
+            seq = tuple(fields[1:4])
+            counts[seq] = counts.get(seq, 0) + int(fields[0])
+    return counts
+
+
+def main():
+    profile = sys.argv[1] if len(sys.argv) > 1 else "superops.prof"
+    max_ops = int(sys.argv[2]) if len(sys.argv) > 2 else DEFAULT_MAX
+
+    if not os.path.exists(profile):
+        print(f"Error: {profile} not found")
+        sys.exit(1)
+
+    bodies = read_bodies()
+    counts = read_profile(profile)
+
+    # A sequence saves (len - 1) dispatches every time it runs
+    candidates = []
+    for seq, count in counts.items():
+        if not all(op in bodies for op in seq):
+            continue
+        if any(bodies[op] for op in seq[:-1]):
+            continue
+        candidates.append(((len(seq) - 1) * count, seq))
+    candidates.sort(key=lambda c: (-c[0], c[1]))
+    chosen = candidates[:max_ops]
+
+    # The rewrite pass takes the first match, so try long sequences first
+    chosen.sort(key=lambda c: (-len(c[1]), -c[0], c[1]))
+
+    with open(OUTPUT_FILE, "w") as out:
+        out.write("/* Auto-generated by superops.py - DO NOT EDIT */\n")
+        out.write(f"/* Profile: {os.path.basename(profile)}, "
+                  f"{len(chosen)} of {len(candidates)} candidate sequences */\n\n")
+
+        out.write("// Fused opcodes, appended to OPS_X in jcc.h\n")
+        out.write("#define SUPEROPS_X")
+        for score, seq in chosen:
+            out.write(f" \\\n    X({'__'.join(seq)}) /* saves {score} */")
+        out.write("\n\n")
+
+        out.write("// S2(NAME, A, B) / S3(NAME, A, B, C): components of each "
+                  "fused opcode,\n")
+        out.write("// in the order opt_superinstructions() tries them\n")
+        out.write("#define SUPEROPS_DEF")
+        for _, seq in chosen:
+            macro = "S2" if len(seq) == 2 else "S3"
+            out.write(f" \\\n    {macro}({'__'.join(seq)}, {', '.join(seq)})")
+        out.write("\n")
+
+    print(f"Generated {OUTPUT_FILE} with {len(chosen)} superinstructions")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,26 @@
+// Guest program of test_run_for: loops over globals, locals and calls that
+// are preempted and resumed many times, with ITERS set by the host
+int calls;
+long table[64];
+
+int step(int i) {
+    calls++;
+    return i % 7;
+}
+
+int main() {
+    long sum = 0;
+    for (int i = 0; i < ITERS; i++) {
+        table[i % 64] += step(i);
+        sum += i & 3;
+    }
+    long check = 0;
+    for (int i = 0; i < 64; i++)
+        check += table[i];
+    long steps = 0;
+    for (int i = 0; i < ITERS; i++)
+        steps += i % 7;
+    if (calls != ITERS || check != steps || sum != (ITERS / 4) * 6)
+        return 1;
+    return 42;
+}
@@ -0,0 +1,98 @@
+// Host program for the instruction budget API: cc_run_for() preempts a
+// loop, cc_resume() continues it until main() returns, two programs
+// time-sliced against each other keep their own state, and a finished or
+// never started program cannot be resumed. Exits 0 when everything holds.
+
+#include "jcc.h"
+#include <stdio.h>
+
+#define GUEST "tests/host/sliced_loop.c"
+#define SLICE 10000
+
+static int failures;
+
+#define CHECK(COND)                                                            \
+    do {                                                                       \
+        if (!(COND)) {                                                         \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, \
+                    #COND);                                                    \
+            failures++;                                                        \
+        }                                                                      \
+    } while (0)
+
+static int compile(JCC *vm, char *iters) {
+    cc_init(vm, 0);
+    cc_define(vm, "ITERS", iters);
+    Token *tok = cc_preprocess(vm, GUEST);
+    Obj *prog = tok ? cc_parse(vm, tok) : NULL;
+    if (!prog || cc_has_errors(vm)) {
+        cc_print_all_errors(vm);
+        return -1;
+    }
+    Obj *progs[] = {prog};
+    prog = cc_link_progs(vm, progs, 1);
+    if (!prog)
+        return -1;
+    cc_compile(vm, prog);
+    return 0;
+}
+
+int main(void) {
+    static char *argv[] = {GUEST, NULL};
+
+    // One program, run in slices to the end
+    JCC vm;
+    if (compile(&vm, "100000") != 0)
+        return 1;
+    CHECK(cc_resume(&vm, NULL) == JCC_RUN_ERROR); // Not started yet
+    int exit_code = -1, resumes = 0;
+    int status = cc_run_for(&vm, 1, argv, SLICE, &exit_code);
+    while (status == JCC_RUN_EXHAUSTED && resumes < 100000) {
+        resumes++;
+        status = cc_resume(&vm, &exit_code);
+    }
+    CHECK(status == JCC_RUN_FINISHED);
+    CHECK(exit_code == 42);
+    // Three loops of 100000 iterations run for well over a million
+    // instructions, but a slice overruns its budget by at most one loop body
+    CHECK(resumes >= 30 && resumes < 1000);
+    CHECK(cc_resume(&vm, &exit_code) == JCC_RUN_ERROR); // Already finished
+    cc_destroy(&vm);
+
+    // A budget larger than the program finishes in one slice
+    if (compile(&vm, "400") != 0)
+        return 1;
+    exit_code = -1;
+    CHECK(cc_run_for(&vm, 1, argv, 1LL << 40, &exit_code) == JCC_RUN_FINISHED);
+    CHECK(exit_code == 42);
+    cc_destroy(&vm);
+
+    // Two programs interleaved slice by slice
+    JCC a, b;
+    if (compile(&a, "20000") != 0 || compile(&b, "60000") != 0)
+        return 1;
+    int code_a = -1, code_b = -1, slices_a = 1, slices_b = 1;
+    int status_a = cc_run_for(&a, 1, argv, SLICE, &code_a);
+    int status_b = cc_run_for(&b, 1, argv, SLICE, &code_b);
+    while (status_a == JCC_RUN_EXHAUSTED || status_b == JCC_RUN_EXHAUSTED) {
+        if (status_a == JCC_RUN_EXHAUSTED) {
+            status_a = cc_resume(&a, &code_a);
+            slices_a++;
+        }
+        if (status_b == JCC_RUN_EXHAUSTED) {
+            status_b = cc_resume(&b, &code_b);
+            slices_b++;
+        }
+    }
+    CHECK(status_a == JCC_RUN_FINISHED && code_a == 42);
+    CHECK(status_b == JCC_RUN_FINISHED && code_b == 42);
+    CHECK(slices_b > slices_a * 2);
+    cc_destroy(&a);
+    cc_destroy(&b);
+
+    if (failures)
+        return 1;
+    printf("test_run_for: %d resumes, %d and %d interleaved slices\n", resumes,
+           slices_a, slices_b);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Conditions that compile to compare-and-branch opcodes
+int calls = 0;
+
+int next(int x) {
+    calls++;
+    return x + 1;
+}
+
+int main() {
+    int a = 10;
+    int b = 20;
+
+    // Register-register and register-immediate forms, both polarities
+    if (a == b) return 1;
+    if (!(a != b)) return 2;
+    if (b < a) return 3;
+    if (a >= b) return 4;
+    if (a == 11) return 5;
+    if (a <= 9) return 6;
+    if (a > 10) return 7;     // 10 < a: constant on the left
+    if (5 >= a) return 8;     // a <= 5: constant on the left
+    if (!(a < 11)) return 9;
+
+    // Edge constants that cannot be adjusted by one
+    long long big = 9223372036854775807LL;
+    if (big < 9223372036854775807LL) return 10;
+    if (!(9223372036854775807LL <= big)) return 11;
+    long long small = -9223372036854775807LL - 1;
+    if (small > -1) return 12;
+
+    // Unsigned comparisons
+    unsigned long u = 0;
+    if (u - 1 < 5) return 13;
+    unsigned long huge = 18446744073709551615UL;
+    if (!(huge > 1)) return 14;
+    if (huge < 18446744073709551615UL) return 15;
+    unsigned int ui = 4000000000u;
+    if (ui < 5) return 16;
+
+    // Pointers
+    int *p = &a;
+    int *q = 0;
+    if (p == q) return 17;
+    if (q != 0) return 18;
+
+    // Calls on either side of the comparison
+    if (next(a) != 11) return 19;
+    if (11 != next(a)) return 20;
+    if (next(a) < next(a - 1)) return 21;
+    if (calls != 4) return 22;
+
+    // Loops
+    int sum = 0;
+    for (int i = 0; i < 10; i++)
+        sum += i;
+    if (sum != 45) return 23;
+
+    int n = 0;
+    do {
+        n++;
+    } while (n <= 4);
+    if (n != 5) return 24;
+
+    int k = 3;
+    while (k > 0)
+        k--;
+    if (k != 0) return 25;
+
+    // Ternary
+    int t = a < b ? 1 : 2;
+    int f = a >= b ? 1 : 2;
+    if (t != 1 || f != 2) return 26;
+
+    char c = -1;
+    if (c >= 0) return 27;
+    unsigned char uc = 255;
+    if (uc < 200) return 28;
+
+    return 42;
+}
@@ -0,0 +1,129 @@
+// Calls to pure functions evaluated at compile time: global and static
+// tables initialized from calls, calls in array sizes, case labels and
+// enumerators, nested calls, float and narrow unsigned results, and calls
+// that must run at runtime (impure, faulting, recursive, through memory,
+// non-constant)
+
+static unsigned crc_entry(unsigned c) {
+    for (int k = 0; k < 8; k++)
+        c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+    return c;
+}
+
+static int pow2(int n) {
+    int r = 1;
+    while (n-- > 0)
+        r *= 2;
+    return r;
+}
+
+static int add3(int a, int b, int c) { return a + b + c; }
+
+static double poly(double x) { return 0.5 * x * x + 2.0 * x + 1.0; }
+static float half(float x) { return x / 2; }
+
+static unsigned char low_byte(long v) { return v; }
+static short neg(short v) { return -v; }
+
+struct Range {
+    int lo, hi;
+};
+
+static int span(int lo, int hi) {
+    struct Range r = {lo, hi};
+    return r.hi - r.lo;
+}
+
+// Indexing and dereferences could reach outside the sandbox: not pure
+static long sum_squares(int n) {
+    long s = 0;
+    int v[16];
+    for (int i = 0; i < n && i < 16; i++)
+        v[i] = i * i;
+    for (int i = 0; i < n && i < 16; i++)
+        s += v[i];
+    return s;
+}
+
+// Reads a global: not pure
+int bias = 5;
+static int biased(int x) { return x + bias; }
+
+static int nul(int x) {
+    int *p = 0;
+    if (x)
+        return *p;
+    return 1;
+}
+
+static int poke(int i) {
+    int a[4] = {1, 2, 3, 4};
+    a[i] = 0x41414141;
+    return a[0];
+}
+
+static int divide(int a, int b) { return a / b; }
+
+static int fact(int n) { return n <= 1 ? 1 : n * fact(n - 1); }
+
+unsigned crc_table[4] = {crc_entry(0), crc_entry(1), crc_entry(2),
+                         crc_entry(255)};
+int sized[pow2(3)];
+int spanned[span(2, 5)];
+double coeffs[] = {poly(0.0), poly(2.0)};
+
+enum { SMALL = pow2(2), LARGE = pow2(SMALL) };
+
+int classify(int x) {
+    switch (x) {
+    case pow2(0): return 1;
+    case pow2(4): return 2;
+    case add3(1, 2, 3): return 3;
+    }
+    return 0;
+}
+
+int counter(void) {
+    static int start = add3(10, 20, 12);
+    return start++;
+}
+
+int main() {
+    if (crc_table[0] != 0 || crc_table[1] != 0x77073096u ||
+        crc_table[2] != 0xEE0E612Cu || crc_table[3] != 0x2D02EF8Du)
+        return 1;
+    if (sizeof(sized) != 8 * sizeof(int) || sizeof(spanned) != 3 * sizeof(int))
+        return 2;
+    if (coeffs[0] != 1.0 || coeffs[1] != 7.0) return 3;
+    if (SMALL != 4 || LARGE != 16) return 4;
+    if (classify(1) != 1 || classify(16) != 2 || classify(6) != 3 ||
+        classify(2) != 0)
+        return 5;
+    if (counter() != 42 || counter() != 43) return 6;
+
+    // In function bodies, nested and with converted arguments
+    int n = pow2(10);
+    if (n != 1024) return 7;
+    if (add3(pow2(1), pow2(2), -3) != 3) return 8;
+    if (pow2(add3(1, 1, 1)) != 8) return 9;
+    if (half(3.0f) != 1.5f || poly(-1) != -0.5) return 10;
+    if (low_byte(0x1234) != 0x34 || low_byte(-1) != 255) return 11;
+    if (neg(-32768) != -32768 || neg(7) != -7) return 12;
+    if (span(3, 10) != 7) return 13;
+
+    // Left to run at runtime
+    if (biased(1) != 6) return 14;
+    bias = 10;
+    if (biased(1) != 11) return 15;
+    if (n == 0 && divide(1, 0)) return 16;
+    if (divide(84, 2) != 42) return 17;
+    if (fact(5) != 120) return 18;
+    int k = 3;
+    if (pow2(k) != 8) return 19;
+    if (sum_squares(4) != 14 || sum_squares(100) != 1240) return 20;
+    if (n == 0 && nul(1)) return 21;
+    if (n == 0 && poke(200000)) return 22;
+    if (nul(0) != 1 || poke(1) != 1) return 23;
+
+    return 42;
+}
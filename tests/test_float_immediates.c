@@ -0,0 +1,56 @@
+// Floating-point literals loaded as immediates and identical string literals
+// sharing storage: float and double constants, negative zero, infinities,
+// denormals, constants in loops and conditions, and string literals with
+// equal, prefixed and embedded-NUL contents
+
+float scale(float x) { return x * 0.5f; }
+double poly(double x) { return 1.5 * x * x - 0.25 * x + 3.0; }
+
+int main() {
+    double d = 0.1;
+    if (d + 0.2 == 0.3) return 1; // Same rounding as a compiled C program
+    if (0.1 + 0.2 != d + 0.2) return 2;
+
+    float f = 3.75f;
+    if (scale(f) != 1.875f) return 3;
+    if (poly(2.0) != 8.5) return 4;
+
+    // Sign of zero survives
+    union { double d; unsigned long long bits; } u;
+    u.d = -0.0;
+    if (u.d != 0.0 || u.bits != 0x8000000000000000ULL) return 5;
+
+    double inf = 1e308 * 10.0;
+    if (inf <= 1e308 || -inf >= -1e308) return 6;
+
+    double tiny = 4.9406564584124654e-324;
+    if (tiny == 0.0 || tiny / 2 != 0.0) return 8;
+
+    double sum = 0;
+    for (int i = 0; i < 100; i++)
+        sum += 0.5;
+    if (sum != 50.0) return 10;
+    int hits = 0;
+    for (double x = 0.0; x < 1.0; x += 0.25)
+        hits += x > 0.4 ? 1 : 0;
+    if (hits != 2) return 11;
+
+    // Identical literals share storage; different ones do not
+    const char *a = "shared";
+    const char *b = "shared";
+    const char *c = "shared!";
+    const char *e = "";
+    const char *g = "";
+    if (a != b || a == c || e != g) return 12;
+    if (c[6] != '!' || a[6] != 0) return 13;
+    const char *n1 = "a\0b";
+    const char *n2 = "a\0c";
+    if (n1 == n2 || n1[2] != 'b' || n2[2] != 'c') return 14;
+
+    // Arrays initialized from a literal are copies
+    char buf[] = "shared";
+    buf[0] = 'S';
+    if (a[0] != 's' || buf[0] != 'S') return 15;
+
+    return 42;
+}
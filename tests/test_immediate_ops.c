@@ -0,0 +1,52 @@
+// Integer operations with a constant operand (register-immediate opcodes)
+int main() {
+    int a = 12;
+    long long n = -40;
+
+    if (a + 5 != 17) return 1;
+    if (5 + a != 17) return 2;
+    if (a - 20 != -8) return 3;
+    if (20 - a != 8) return 4;      // constant on the left of a non-commutative op
+    if (a * -3 != -36) return 5;
+    if (3 * a != 36) return 6;
+    if ((a & 10) != 8) return 7;
+    if ((10 | a) != 14) return 8;
+    if ((a ^ 5) != 9) return 9;
+    if ((a << 3) != 96) return 10;
+    if ((a >> 2) != 3) return 11;
+    if ((n >> 3) != -5) return 12;  // arithmetic shift keeps the sign
+    if ((n & -8) != -40) return 13;
+
+    // Comparisons producing a value
+    int lt = a < 13;
+    int ge = a < 12;
+    int le = a <= 12;
+    int gt = a <= 11;
+    if (lt != 1 || ge != 0 || le != 1 || gt != 0) return 14;
+    if ((n < -39) != 1) return 15;
+
+    long long big = 9223372036854775807LL;
+    if ((big <= 9223372036854775807LL) != 1) return 16;
+
+    unsigned int u = 4000000000u;
+    if ((u < 5) != 0) return 17;
+
+    // Constants the parser wraps in casts are truncated first
+    char c = 'a';
+    if (c + (char)300 != 'a' + 44) return 18;
+
+    // Chained and nested
+    int x = ((a + 1) * 2 - 6) & 0xff;
+    if (x != 20) return 19;
+    int sum = 0;
+    for (int i = 0; i < 8; i++)
+        sum += (i * 4) ^ 1;
+    if (sum != 120) return 20;
+
+    // The folder sees constants flow through immediate forms
+    int k = 6;
+    k = (k << 2) + 2;
+    if (k != 26) return 21;
+
+    return 42;
+}
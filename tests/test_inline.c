@@ -0,0 +1,130 @@
+// Calls to small functions replaced with their bodies: constant and variable
+// arguments, parameters the callee assigns or takes the address of, early
+// returns, void functions, locals of the callee, arguments with side effects,
+// recursion and mutual recursion, function pointers, static inline functions
+// and callees that cannot be inlined
+
+static inline int sq(int x) { return x * x; }
+static inline int unused_helper(int x) { return x + 1; }
+static int add(int a, int b) { return a + b; }
+int clamp(int v, int lo, int hi) {
+    if (v < lo)
+        return lo;
+    if (v > hi)
+        return hi;
+    return v;
+}
+int sign(long v) {
+    if (v < 0)
+        return -1;
+    else if (v > 0)
+        return 1;
+    return 0;
+}
+int twice(int x) {
+    x *= 2;
+    return x;
+}
+int via_ptr(int x) {
+    int *p = &x;
+    *p += 1;
+    return x;
+}
+int swap_diff(int a, int b) {
+    int t = a;
+    a = b;
+    b = t;
+    return a - b;
+}
+int max3(int a, int b, int c) {
+    int m = a;
+    if (b > m) m = b;
+    if (c > m) m = c;
+    return m;
+}
+double half(double d) { return d / 2; }
+char low(int v) { return v; }
+unsigned char ubyte(int v) { return v; }
+long widen(int v) { return v; }
+
+int counter;
+void bump(int n) {
+    if (n <= 0)
+        return;
+    counter += n;
+}
+int next_id(void) { return ++counter; }
+int first(int a, int b) { return a; }
+
+int fact(int n) { return n <= 1 ? 1 : n * fact(n - 1); }
+int is_odd(int n);
+int is_even(int n) { return n == 0 ? 1 : is_odd(n - 1); }
+int is_odd(int n) { return n == 0 ? 0 : is_even(n - 1); }
+
+int sum_to(int n) {
+    int s = 0;
+    for (int i = 1; i <= n; i++)
+        s += i;
+    return s;
+}
+
+int get(int *p) { return *p; }
+void set(int *p, int v) { *p = v; }
+
+int main() {
+    if (sq(7) != 49) return 1;
+    if (add(40, 2) != 42) return 2;
+    if (clamp(-5, 0, 10) != 0 || clamp(50, 0, 10) != 10 || clamp(5, 0, 10) != 5)
+        return 3;
+    if (sign(-9) != -1 || sign(9) != 1 || sign(0) != 0) return 4;
+
+    // Variable arguments are read in place unless the callee writes them
+    int x = 21;
+    if (twice(x) != 42 || x != 21) return 5;
+    if (via_ptr(x) != 22 || x != 21) return 6;
+    if (swap_diff(x, 1) != -20 || x != 21) return 7;
+    if (max3(1, x, 3) != 21 || max3(x, 50, 3) != 50) return 8;
+
+    // Conversions of arguments and results
+    if (half(9) != 4.5) return 9;
+    if (low(0x141) != 'A' || ubyte(-1) != 255) return 10;
+    if (widen(-1) != -1L) return 11;
+    long big = 0x100000003L;
+    if (sq(big) != 9) return 12;
+
+    // Side effects in arguments happen once, even when the parameter is unused
+    counter = 0;
+    if (first(1, next_id()) != 1 || counter != 1) return 13;
+    if (sq(next_id()) != 4 || counter != 2) return 14;
+    bump(5);
+    bump(-3);
+    if (counter != 7) return 15;
+
+    // Arguments are evaluated before the body, in a nested call too
+    int a = 3;
+    if (add(a, add(a, a)) != 9) return 16;
+    if (clamp(a++, 0, 2) != 2 || a != 4) return 17;
+    if (sq(sq(a)) != 256) return 18;
+
+    // Recursion keeps its calls
+    if (fact(5) != 120) return 19;
+    if (!is_even(10) || is_odd(10)) return 20;
+    if (sum_to(10) != 55) return 21;
+
+    // The address of a variable passed to a callee that writes through it
+    int v = 1;
+    set(&v, 9);
+    if (get(&v) != 9 || v != 9) return 22;
+
+    // Through a function pointer the function itself is called
+    int (*fp)(int) = sq;
+    if (fp(6) != 36) return 23;
+
+    // Nested inside each other in a loop
+    long total = 0;
+    for (int i = 0; i < 100; i++)
+        total += clamp(sq(i) - 50, 0, 1000) + sign(i - 50);
+    if (total != 77049) return 24;
+
+    return 42;
+}
@@ -0,0 +1,80 @@
+// Leaf functions keep their parameters and locals in argument registers and
+// run without a frame: narrowing of char/short/int parameters, results that
+// reuse a parameter's register, float results from integer parameters,
+// parameters whose address is taken, and leaves mixed with calling functions
+
+typedef struct { int x, y; } Point;
+
+int sub(int a, int b) { return b - a; }
+int second(int a, int b, int c) { return b; }
+long mix(char c, unsigned char uc, short s, unsigned short us, int i, long l) {
+    return c + uc + s + us + i + l;
+}
+int get_x(Point *p) { return p->x; }
+int cmp(const void *a, const void *b) {
+    return *(const int *)a - *(const int *)b;
+}
+double avg(int a, int b) { return (double)b / 2 + (double)a / 2; }
+double scale(double x, int k) { return x * k; }
+int swap_sub(int a, int b) {
+    int t = a;
+    a = b;
+    b = t;
+    return a - b;
+}
+int max3(int a, int b, int c) {
+    int m = a;
+    if (b > m) m = b;
+    if (c > m) m = c;
+    return m;
+}
+long sum(int *v, int n) {
+    long s = 0;
+    for (int i = 0; i < n; i++)
+        s += v[i];
+    return s;
+}
+int sum_addr(int a, int b) {
+    int *p = &a;
+    return *p + b;
+}
+int eight(int a, int b, int c, int d, int e, int f, int g, int h) {
+    return h - a;
+}
+int fib(int n) { return n < 2 ? n : fib(n - 1) + fib(n - 2); }
+int twice(int a) { return sub(0, a) + sub(0, a); }
+int unused(int a, int b) { return 7; }
+
+int main() {
+    if (sub(1, 3) != 2) return 1;
+    if (second(1, 2, 3) != 2) return 2;
+    if (mix(-1, 255, -2, 65535, -3, 10) != 65794) return 3;
+    // Values passed in wider than the parameter are narrowed on entry
+    int (*f)(long, long) = (int (*)(long, long))sub;
+    if (f(0x100000000L, 0x100000005L) != 5) return 4;
+
+    Point p = {4, 5};
+    if (get_x(&p) != 4) return 5;
+    int a = 3, b = 9;
+    if (cmp(&a, &b) >= 0 || cmp(&b, &a) <= 0) return 6;
+    if (avg(3, 5) != 4.0) return 7;
+    if (scale(1.5, 4) != 6.0) return 8;
+    if (swap_sub(2, 7) != 5) return 9;
+    if (max3(1, 9, 4) != 9 || max3(9, 1, 4) != 9 || max3(1, 4, 9) != 9)
+        return 10;
+
+    int v[5] = {1, 2, 3, 4, 5};
+    if (sum(v, 5) != 15) return 11;
+    if (sum_addr(20, 22) != 42) return 12;
+    if (eight(1, 2, 3, 4, 5, 6, 7, 9) != 8) return 13;
+    if (fib(15) != 610) return 14;
+    if (twice(21) != 42) return 15;
+    if (unused(1, 2) != 7) return 16;
+
+    long total = 0;
+    for (int i = 0; i < 1000; i++)
+        total += sub(i, 2 * i) + max3(i, -i, 0);
+    if (total != 999000) return 17;
+
+    return 42;
+}
@@ -0,0 +1,170 @@
+// Loops tested at the bottom, with the addresses of globals and local arrays
+// and structs held in registers across them: while, for and do loops,
+// continue and break, conditions with calls and side effects, constant
+// conditions, nested loops, jumps into a loop through a switch, goto, early
+// return, and loops in functions that call and that do not
+
+int g[16];
+struct { int n; long sum; } stats;
+int calls;
+
+int below(int i, int n) {
+    calls++;
+    return i < n;
+}
+
+int fill(int n) {
+    for (int i = 0; i < n; i++)
+        g[i] = i * i;
+    return g[n - 1];
+}
+
+long total(void) {
+    long s = 0;
+    int i = 0;
+    while (i < 16) {
+        s += g[i];
+        i++;
+    }
+    return s;
+}
+
+int find(int v) {
+    for (int i = 0; i < 16; i++) {
+        if (g[i] == v)
+            return i;
+    }
+    return -1;
+}
+
+int count_odd(int *v, int n) {
+    int c = 0;
+    for (int i = 0; i < n; i++) {
+        if (v[i] % 2 == 0)
+            continue;
+        c++;
+    }
+    return c;
+}
+
+// Duff's device enters the loop body through the case labels
+int duff(int n) {
+    int out[16];
+    int *p = out, k = 0;
+    int count = (n + 3) / 4;
+    switch (n % 4) {
+    case 0: do { *p++ = k++;
+    case 3:      *p++ = k++;
+    case 2:      *p++ = k++;
+    case 1:      *p++ = k++;
+            } while (--count > 0);
+    }
+    int s = 0;
+    for (int i = 0; i < n; i++)
+        s += out[i];
+    return s;
+}
+
+int with_goto(int n) {
+    int v[8];
+    for (int k = 0; k < 8; k++)
+        v[k] = 0;
+    int i = 0;
+again:
+    while (i < 8) {
+        v[i] = i;
+        if (i == n) {
+            i += 2;
+            goto again;
+        }
+        i++;
+    }
+    int s = 0;
+    for (i = 0; i < 8; i++)
+        s += v[i];
+    return s;
+}
+
+int main() {
+    if (fill(16) != 225) return 1;
+    if (total() != 1240) return 2;
+    if (find(49) != 7 || find(50) != -1) return 3;
+
+    // A condition that is false on entry runs the body zero times
+    int ran = 0;
+    for (int i = 10; i < 5; i++)
+        ran++;
+    while (ran)
+        ran = 0;
+    if (ran != 0) return 4;
+
+    // The condition is evaluated once per iteration plus the last test
+    calls = 0;
+    int n = 0;
+    for (int i = 0; below(i, 5); i++)
+        n++;
+    if (n != 5 || calls != 6) return 5;
+    calls = 0;
+    do n++; while (below(n, 8));
+    if (n != 8 || calls != 3) return 6;
+
+    // Side effects in the condition
+    int k = 3, iters = 0;
+    while (k--)
+        iters++;
+    if (iters != 3 || k != -1) return 7;
+
+    // Conditions that are always true leave the loop through break
+    int m = 0;
+    for (;;) {
+        if (++m == 4)
+            break;
+    }
+    while (1) {
+        if (m++ > 6)
+            break;
+    }
+    if (m != 8) return 8;
+
+    // A condition too large to copy, with a statement expression
+    int s = 0;
+    for (int i = 0; ({ int t = i * 2; t < 10; }); i++)
+        s += i;
+    if (s != 10) return 9;
+
+    int odd[] = {1, 2, 3, 5, 8, 13};
+    if (count_odd(odd, 6) != 4) return 10;
+
+    // Nested loops over a global, a global struct and a local array
+    int loc[4][4];
+    stats.n = 0;
+    stats.sum = 0;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            loc[i][j] = g[i * 4 + j];
+            stats.n++;
+        }
+        stats.sum += loc[i][3];
+    }
+    if (stats.n != 16 || stats.sum != 9 + 49 + 121 + 225) return 11;
+    long diag = 0;
+    int i = 0;
+    do {
+        diag += loc[i][i];
+        i++;
+    } while (i < 4);
+    if (diag != 0 + 25 + 100 + 225) return 12;
+
+    if (duff(16) != 120 || duff(7) != 21 || duff(1) != 0) return 13;
+    if (with_goto(3) != 0 + 1 + 2 + 3 + 5 + 6 + 7) return 14;
+
+    // Globals changed inside a loop through a call
+    stats.n = 0;
+    for (int i = 0; i < 3; i++) {
+        fill(16);
+        stats.n += g[15] + i;
+    }
+    if (stats.n != 225 * 3 + 3) return 15;
+
+    return 42;
+}
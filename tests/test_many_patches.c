@@ -0,0 +1,60 @@
+// More labels, jumps, calls and function addresses than the old fixed-size
+// patch tables held: 256 labels and 1024 jumps per function, 1024 calls and
+// 1024 function address references per program
+
+int one(int x) { return x + 1; }
+int two(int x) { return x + 2; }
+
+// Each loop defines a break and a continue label and jumps to both, and the
+// named labels share the table with them
+#define L1 for (int i = 0; i < 3; i++) { if (i == 1) continue; if (i == 2) break; n++; }
+#define L4 L1 L1 L1 L1
+#define L16 L4 L4 L4 L4
+#define L64 L16 L16 L16 L16
+
+int many_labels(void) {
+    int n = 0;
+    goto first;
+    n += 1000;
+first:
+    L64 L64 L64 L64 L64 L64 L64 L64 L64
+    int back = 0;
+again:
+    if (++back < 3) goto again;
+    if (n == 576) goto done;
+    n += 1000;
+done:
+    return n + back;
+}
+
+#define C1 s += one(s) - s;
+#define C4 C1 C1 C1 C1
+#define C16 C4 C4 C4 C4
+#define C64 C16 C16 C16 C16
+#define C256 C64 C64 C64 C64
+
+int many_calls(void) {
+    int s = 0;
+    C256 C256 C256 C256 C256
+    return s;
+}
+
+#define A1 fp = (i++ & 1) ? one : two; s += fp(0);
+#define A4 A1 A1 A1 A1
+#define A16 A4 A4 A4 A4
+#define A64 A16 A16 A16 A16
+#define A256 A64 A64 A64 A64
+
+int many_addresses(void) {
+    int (*fp)(int);
+    int s = 0, i = 0;
+    A256 A256 A256 A256 A256
+    return s;
+}
+
+int main() {
+    if (many_labels() != 579) return 1;
+    if (many_calls() != 1280) return 2;
+    if (many_addresses() != 1920) return 3;
+    return 42;
+}
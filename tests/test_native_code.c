@@ -0,0 +1,58 @@
+// JCC_ARGS: --jit --jit-threshold=1 --osr-threshold=1
+// Operations whose native translation (--jit) differs most from the loop:
+// calls in both directions, byte registers, float compares and division
+int add(int a, int b) { return a + b; }
+int sub(int a, int b) { return a - b; }
+
+int apply(int (*f)(int, int), int a, int b) {
+    return f(a, b);
+}
+
+int depth(int n) {
+    return n == 0 ? 0 : 1 + depth(n - 1);
+}
+
+double scale(int a, double b, int c, double d) {
+    return a * b + c * d;
+}
+
+int main() {
+    // Indirect calls and deep recursion
+    int (*ops[2])(int, int) = {add, sub};
+    if (apply(ops[0], 6, 7) != 13) return 1;
+    if (apply(ops[1], 6, 7) != -1) return 2;
+    if (depth(5000) != 5000) return 3;
+
+    // Mixed integer and float parameters
+    if (scale(2, 1.5, 3, 2.25) != 9.75) return 4;
+
+    // Narrow loads and stores through every temporary
+    char c[8];
+    short h[4];
+    for (int i = 0; i < 8; i++)
+        c[i] = (char)(i * 40);
+    h[3] = -5;
+    if (c[7] != 24 || c[4] != -96) return 5;
+    if (h[3] != -5) return 6;
+    unsigned char uc = (unsigned char)c[4];
+    if (uc != 160) return 7;
+
+    // Division and modulo follow C truncation
+    long long n = -17;
+    if (n / 5 != -3 || n % 5 != -2) return 8;
+    if (n / -5 != 3 || n % -5 != -2) return 9;
+    if ((n >> 2) != -5 || (n << 3) != -136) return 10;
+
+    // Float compares in both directions
+    double zero = 0.0;
+    double half = 0.5;
+    if (zero == half || !(zero != half)) return 11;
+    if (half < zero || half <= zero || zero > half || zero >= half) return 12;
+    if (!(zero < 1) || !(1 >= zero) || -zero != 0) return 13;
+
+    // Float <-> integer conversions
+    double d = -7.9;
+    if ((int)d != -7 || (double)(long long)d != -7.0) return 14;
+
+    return 42;
+}
@@ -0,0 +1,54 @@
+// JCC_ARGS: --perf-trampolines
+// Calls that --perf-trampolines runs in nested dispatch loops: returns,
+// recursion past the nesting limit, indirect calls and struct returns have
+// to behave exactly as in a single loop
+struct Point {
+    long x;
+    long y;
+};
+
+struct Point make_point(long x, long y) {
+    struct Point p;
+    p.x = x;
+    p.y = y;
+    return p;
+}
+
+int fib(int n) {
+    return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+
+int depth(int n) {
+    return n == 0 ? 0 : 1 + depth(n - 1);
+}
+
+double half(double x) {
+    return x / 2.0;
+}
+
+long twice(long x) {
+    return x * 2;
+}
+
+long apply(long (*fn)(long), long x) {
+    return fn(x);
+}
+
+int main() {
+    if (fib(15) != 610) return 1;
+
+    // Deeper than PERF_MAX_DEPTH
+    if (depth(5000) != 5000) return 2;
+
+    long sum = 0;
+    for (int i = 0; i < 100; i++)
+        sum += apply(twice, i);
+    if (sum != 9900) return 3;
+
+    if (half(5.0) != 2.5) return 4;
+
+    struct Point p = make_point(3, 4);
+    if (p.x * p.y != 12) return 5;
+
+    return 42;
+}
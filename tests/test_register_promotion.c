@@ -0,0 +1,119 @@
+// Scalar locals kept in S registers: more live variables than registers,
+// narrowing on every write, compound assignment, goto, switch, recursion and
+// a longjmp past frames that hold promoted locals
+#include <setjmp.h>
+
+jmp_buf env;
+
+int many_live(int n) {
+    int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7, h = 8, i2 = 9, j = 10;
+    for (int i = 0; i < n; i++) {
+        a += b; b += c; c += d; d += e; e += f;
+        f += g; g += h; h += i2; i2 += j; j += 1;
+    }
+    return (a + b + c + d + e + f + g + h + i2 + j) & 0x7fff;
+}
+
+// Same computation with every variable kept in memory
+int many_live_mem(int n) {
+    volatile int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6, g = 7, h = 8,
+                 i2 = 9, j = 10;
+    for (volatile int i = 0; i < n; i++) {
+        a += b; b += c; c += d; d += e; e += f;
+        f += g; g += h; h += i2; i2 += j; j += 1;
+    }
+    return (a + b + c + d + e + f + g + h + i2 + j) & 0x7fff;
+}
+
+int narrow(void) {
+    char c = 0;
+    unsigned char uc = 250;
+    short s = 32767;
+    unsigned int u = 0;
+    for (int i = 0; i < 10; i++) {
+        c += 20;  // wraps past 127
+        uc++;     // wraps past 255
+    }
+    s++;
+    u--;
+    if (c != (char)200) return 1;
+    if (uc != 4) return 2;
+    if (s != -32768) return 3;
+    if (u != 4294967295u) return 4;
+    return 0;
+}
+
+long pointers(void) {
+    long buf[8];
+    for (int i = 0; i < 8; i++) buf[i] = i * i;
+    long sum = 0;
+    for (long *p = buf; p < buf + 8; p++) sum += *p;
+    return sum; // 140
+}
+
+int with_goto(int n) {
+    int i = 0, acc = 0;
+top:
+    acc += i;
+    if (++i < n) goto top;
+    return acc;
+}
+
+int with_switch(int n) {
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        switch (i % 3) {
+        case 0: total += 1; break;
+        case 1: total += 10; break;
+        default: total += 100; break;
+        }
+    }
+    return total;
+}
+
+int escape_addr(void) {
+    int x = 0;
+    int *px = &x;
+    for (int i = 0; i < 5; i++) *px += i;
+    return x; // 10
+}
+
+int sum_rec(int n) {
+    int local = 0;
+    for (int i = 0; i <= n; i++) local += i;
+    return n == 0 ? 0 : local - sum_rec(n - 1) + sum_rec(n - 1);
+}
+
+void thrower(int depth) {
+    int junk = 0;
+    for (int i = 0; i < 100; i++) junk += i * depth;
+    if (depth == 0) longjmp(env, junk + 1);
+    thrower(depth - 1);
+}
+
+int catcher(void) {
+    int kept = 0;
+    for (int i = 0; i < 50; i++) kept += 2;
+    if (setjmp(env) == 0) thrower(3);
+    return kept; // S registers restored by longjmp
+}
+
+int main() {
+    if (many_live(20) != many_live_mem(20)) return 1;
+    if (narrow() != 0) return 2;
+    if (pointers() != 140) return 3;
+    if (with_goto(10) != 45) return 4;
+    if (with_switch(9) != 333) return 5;
+    if (escape_addr() != 10) return 6;
+    if (sum_rec(6) != 21) return 7;
+
+    int outer = 0;
+    for (int i = 0; i < 30; i++) outer += 3;
+    if (catcher() != 100) return 8;
+    if (outer != 90) return 9;
+
+    int k = 7;
+    long v = (k += 3) * 2;
+    if (k != 10 || v != 20) return 10;
+    return 42;
+}
@@ -0,0 +1,80 @@
+// JCC_ARGS: --jit --jit-tier=1 --jit-threshold=1 --osr-threshold=1
+// Code that --jit runs as stencils before it gets hot enough for native
+// code: every opcode family has to behave exactly as in the interpreter
+// (--jit-tier=1 keeps it in stencil code)
+void *malloc(unsigned long size);
+void free(void *ptr);
+
+struct Pair {
+    long a;
+    double b;
+};
+
+struct Pair make_pair(long a, double b) {
+    struct Pair p;
+    p.a = a;
+    p.b = b;
+    return p;
+}
+
+double average(double *v, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++)
+        sum += v[i];
+    return sum / n;
+}
+
+int classify(long x) {
+    if (x < -5) return 0;
+    if (x == 3) return 1;
+    if (x >= 100) return 2;
+    if ((unsigned long)x > 50) return 3;
+    return 4;
+}
+
+int apply(int (*fn)(long), long x) {
+    return fn(x);
+}
+
+int main() {
+    // Integer arithmetic, shifts, narrowing and sign extension
+    long acc = 0;
+    for (int i = 0; i < 3000; i++) {
+        char c = (char)(i * 7);
+        unsigned short s = (unsigned short)(i * 1000);
+        acc += (c ^ (i << 3)) + (s >> 2) - i % 13 + i / 5;
+    }
+    if (acc != 25151655) return 1;
+
+    // Doubles, conversions and division
+    double v[16];
+    for (int i = 0; i < 16; i++)
+        v[i] = i * 0.5 - 1.0;
+    double total = 0.0;
+    for (int k = 0; k < 500; k++)
+        total += average(v, 16);
+    if ((long)total != 1375) return 2;
+    if (-v[3] != -0.5) return 3;
+
+    // Branches with immediates, direct and indirect calls
+    int counts[5] = {0, 0, 0, 0, 0};
+    for (long x = -20; x < 200; x++) {
+        counts[classify(x)]++;
+        counts[apply(classify, -x) == 0] += 0;
+    }
+    if (counts[0] != 15 || counts[1] != 1 || counts[2] != 100) return 4;
+    if (counts[3] != 54 || counts[4] != 50) return 5;
+
+    // Struct copies and returns, heap allocation
+    long sum = 0;
+    for (int i = 0; i < 400; i++) {
+        struct Pair p = make_pair(i, i * 2.0);
+        struct Pair *q = malloc(sizeof(struct Pair));
+        *q = p;
+        sum += q->a + (long)q->b;
+        free(q);
+    }
+    if (sum != 239400) return 6;
+
+    return 42;
+}
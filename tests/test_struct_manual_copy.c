@@ -6,7 +6,7 @@ int main() {
     struct Point dst;
     
     src.x = 42;
-    dst = src;  // Should use MCPY
+    dst = src;  // Should use BCPY
     
     return dst.x;  // Should return 42
 }
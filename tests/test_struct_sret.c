@@ -0,0 +1,109 @@
+// Struct and union returns written straight to the caller's destination:
+// results over 1KB, chained and nested calls, a = f(a), member access on
+// call results, recursion, function pointers, blocks and many live results
+// at once (more than the old pool of eight return buffers)
+
+typedef struct { long x, y; } Pair;
+typedef struct { int v[300]; } Big;  // 1200 bytes
+typedef struct { char c[3]; } Odd;   // Not a multiple of 8
+typedef union { long l; char b[8]; } U;
+
+Pair pair(long x, long y) {
+    Pair p;
+    p.x = x;
+    p.y = y;
+    return p;
+}
+
+Pair add(Pair a, Pair b) { return pair(a.x + b.x, a.y + b.y); }
+Pair swap(Pair p) { return pair(p.y, p.x); }
+Pair forward(Pair p) { return swap(swap(p)); }
+
+Big make_big(int seed) {
+    Big b;
+    for (int i = 0; i < 300; i++)
+        b.v[i] = seed + i;
+    return b;
+}
+
+Odd make_odd(char a) {
+    Odd o = {{a, a + 1, a + 2}};
+    return o;
+}
+
+U make_u(long l) {
+    U u;
+    u.l = l;
+    return u;
+}
+
+// Sum of 1..n through n + 1 live results
+Pair fib_pair(int n) {
+    if (n == 0)
+        return pair(0, 1);
+    Pair p = fib_pair(n - 1);
+    return pair(p.y, p.x + p.y);
+}
+
+Pair global;
+
+int main() {
+    Pair a = pair(1, 2);
+    if (a.x != 1 || a.y != 2) return 1;
+
+    // Chained calls whose results are all live at once
+    Pair s = add(add(pair(1, 2), pair(3, 4)), add(pair(5, 6), pair(7, 8)));
+    if (s.x != 16 || s.y != 20) return 2;
+    Pair t = add(add(add(add(add(pair(1, 0), pair(1, 0)), pair(1, 0)),
+                         add(pair(1, 0), pair(1, 0))),
+                     add(add(pair(1, 0), pair(1, 0)), pair(1, 0))),
+                 add(pair(1, 0), pair(1, 0)));
+    if (t.x != 10) return 3;
+
+    // The result may alias an argument
+    a = swap(a);
+    if (a.x != 2 || a.y != 1) return 4;
+    a = add(a, a);
+    if (a.x != 4 || a.y != 2) return 5;
+    a = forward(a);
+    if (a.x != 4 || a.y != 2) return 6;
+
+    // Member access on a call result and results assigned to globals
+    if (pair(7, 9).y != 9 || swap(pair(7, 9)).x != 9) return 7;
+    global = pair(5, 6);
+    global = swap(global);
+    if (global.x != 6 || global.y != 5) return 8;
+
+    // Over 1KB, copied both ways
+    Big b = make_big(10);
+    if (b.v[0] != 10 || b.v[299] != 309) return 9;
+    Big c;
+    c = make_big(b.v[1]);
+    if (c.v[0] != 11 || c.v[299] != 310) return 10;
+    if (make_big(3).v[150] != 153) return 11;
+
+    Odd o = make_odd('a');
+    if (o.c[0] != 'a' || o.c[2] != 'c') return 12;
+
+    U u = make_u(0x0102030405060708L);
+    if (u.l != 0x0102030405060708L) return 13;
+
+    Pair f = fib_pair(20);
+    if (f.x != 6765) return 14;
+
+    Pair (*fp)(Pair) = swap;
+    Pair g = fp(pair(3, 4));
+    if (g.x != 4 || g.y != 3) return 15;
+
+    // The value of the assignment is the assigned struct
+    Pair h;
+    if ((h = pair(8, 9)).y != 9 || h.x != 8) return 16;
+
+    // Struct results in a loop
+    Pair acc = pair(0, 0);
+    for (int i = 0; i < 100; i++)
+        acc = add(acc, pair(i, 1));
+    if (acc.x != 4950 || acc.y != 100) return 17;
+
+    return 42;
+}
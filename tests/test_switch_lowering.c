@@ -0,0 +1,177 @@
+// Switch dispatch: dense jump tables, binary search over sparse cases, GNU
+// case ranges, unsigned and negative values, nesting, fallthrough and more
+// than 256 cases
+
+int dense(int x) {
+    switch (x) {
+    case 0: return 10;
+    case 1: return 11;
+    case 2: return 12;
+    case 4: return 14;
+    case 5: return 15;
+    case 7: return 17;
+    default: return -1;
+    }
+}
+
+// No default: unmatched values skip the body
+int dense_no_default(int x) {
+    int r = 0;
+    switch (x) {
+    case 3: r = 3; break;
+    case 4: r = 4; break;
+    case 5: r = 5; break;
+    case 6: r = 6; break;
+    }
+    return r;
+}
+
+int sparse(long x) {
+    switch (x) {
+    case -1000000: return 1;
+    case -7: return 2;
+    case 0: return 3;
+    case 99: return 4;
+    case 4096: return 5;
+    case 100000: return 6;
+    case 123456789: return 7;
+    case 0x7fffffffffffffffL: return 8;
+    default: return 0;
+    }
+}
+
+// A dense cluster in the middle of sparse cases, with ranges
+int mixed(int x) {
+    switch (x) {
+    case -500: return 1;
+    case 10 ... 19: return 2;
+    case 20: return 3;
+    case 21: return 4;
+    case 23 ... 25: return 5;
+    case 26: return 6;
+    case 1000: return 7;
+    case 2000 ... 2999: return 8;
+    default: return 0;
+    }
+}
+
+int with_fallthrough(int x) {
+    int n = 0;
+    switch (x) {
+    case 1: n += 1;
+    case 2: n += 2;
+    case 3: n += 3; break;
+    case 4: n += 4;
+    default: n += 100;
+    }
+    return n;
+}
+
+int on_unsigned(unsigned x) {
+    switch (x) {
+    case 0: return 1;
+    case 1: return 2;
+    case 2: return 3;
+    case 3: return 4;
+    case 0x80000000u: return 5;
+    case 0xfffffffeu: return 6;
+    case 0xffffffffu: return 7;
+    default: return 0;
+    }
+}
+
+int on_char(char c) {
+    switch (c) {
+    case 'a' ... 'z': return 1;
+    case 'A' ... 'Z': return 2;
+    case '0' ... '9': return 3;
+    case ' ': case '\t': case '\n': return 4;
+    default: return 0;
+    }
+}
+
+int nested(int a, int b) {
+    switch (a) {
+    case 0:
+        switch (b) {
+        case 0: return 1;
+        case 1: return 2;
+        case 2: return 3;
+        case 3: return 4;
+        default: return 5;
+        }
+    case 1: return 6;
+    case 2: return 7;
+    case 3: return 8;
+    }
+    return 9;
+}
+
+// Duff's device: case labels inside a loop
+int duff(int count) {
+    int n = 0;
+    int loops = (count + 3) / 4;
+    switch (count % 4) {
+    case 0: do { n++;
+    case 3: n++;
+    case 2: n++;
+    case 1: n++;
+            } while (--loops > 0);
+    }
+    return n;
+}
+
+#define C1(N) case N: return (N) * 3;
+#define C4(N) C1(N) C1((N) + 1) C1((N) + 2) C1((N) + 3)
+#define C16(N) C4(N) C4((N) + 4) C4((N) + 8) C4((N) + 12)
+#define C64(N) C16(N) C16((N) + 16) C16((N) + 32) C16((N) + 48)
+
+int many(int x) {
+    switch (x) {
+    C64(0) C64(64) C64(128) C64(192) C64(256)
+    default: return -1;
+    }
+}
+
+int main() {
+    static const int dense_want[] = {10, 11, 12, -1, 14, 15, -1, 17, -1};
+    for (int i = 0; i < 9; i++)
+        if (dense(i) != dense_want[i]) return 1;
+    if (dense(-1) != -1 || dense(-2147483647 - 1) != -1) return 2;
+
+    if (dense_no_default(2) != 0 || dense_no_default(4) != 4 ||
+        dense_no_default(6) != 6 || dense_no_default(7) != 0) return 3;
+
+    if (sparse(-1000000) != 1 || sparse(-7) != 2 || sparse(0) != 3 ||
+        sparse(99) != 4 || sparse(4096) != 5 || sparse(100000) != 6 ||
+        sparse(123456789) != 7 || sparse(0x7fffffffffffffffL) != 8) return 4;
+    if (sparse(1) != 0 || sparse(-8) != 0 || sparse(100) != 0) return 5;
+
+    static const int mixed_in[] = {-500, 10, 19, 20, 21, 22, 24,
+                                   26, 27, 1000, 2500, 3000, 9};
+    static const int mixed_want[] = {1, 2, 2, 3, 4, 0, 5, 6, 0, 7, 8, 0, 0};
+    for (int i = 0; i < 13; i++)
+        if (mixed(mixed_in[i]) != mixed_want[i]) return 6;
+
+    if (with_fallthrough(1) != 6 || with_fallthrough(3) != 3 ||
+        with_fallthrough(4) != 104 || with_fallthrough(5) != 100) return 7;
+
+    if (on_unsigned(0) != 1 || on_unsigned(3) != 4 || on_unsigned(4) != 0 ||
+        on_unsigned(0x80000000u) != 5 || on_unsigned(0xfffffffeu) != 6 ||
+        on_unsigned(0xffffffffu) != 7) return 8;
+
+    if (on_char('q') != 1 || on_char('Q') != 2 || on_char('5') != 3 ||
+        on_char('\t') != 4 || on_char('!') != 0) return 9;
+
+    if (nested(0, 2) != 3 || nested(0, 7) != 5 || nested(2, 0) != 7 ||
+        nested(4, 0) != 9) return 10;
+
+    if (duff(1) != 1 || duff(4) != 4 || duff(7) != 7 || duff(10) != 10)
+        return 11;
+
+    for (int i = 0; i < 320; i++)
+        if (many(i) != i * 3) return 12;
+    if (many(320) != -1 || many(-1) != -1) return 13;
+
+    return 42;
+}
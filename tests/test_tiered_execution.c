@@ -0,0 +1,52 @@
+// JCC_ARGS: --jit --jit-threshold=1 --osr-threshold=1
+// Functions and loops that run long enough for --jit to compile them while
+// they are active: values live across the switch must carry over
+int calls = 0;
+
+int step(int x) {
+    calls++;
+    return x * 3 + 1;
+}
+
+int collatz(long long n) {
+    int steps = 0;
+    while (n != 1) {
+        n = n % 2 ? n * 3 + 1 : n / 2;
+        steps++;
+    }
+    return steps;
+}
+
+int down(int n) {
+    // Compiled while earlier activations are still interpreted
+    if (n == 0)
+        return 0;
+    return down(n - 1) + (n & 1);
+}
+
+int main() {
+    // A loop in main is replaced on the stack partway through
+    long long sum = 0;
+    int last = 0;
+    for (int i = 0; i < 20000; i++) {
+        last = step(i);
+        sum += last & 15;
+    }
+    if (calls != 20000 || last != 59998) return 1;
+    if (sum != 150000) return 2;
+
+    // Nested loops, with the inner header getting hot first
+    int total = 0;
+    for (int i = 0; i < 50; i++)
+        for (int j = 0; j < 200; j++)
+            total += (i ^ j) & 1;
+    if (total != 5000) return 3;
+
+    if (collatz(27) != 111) return 4;
+    if (collatz(97) != 118) return 5;
+
+    if (down(3001) != 1501) return 6;
+    if (down(10) != 5) return 7;
+
+    return 42;
+}